@@ -10,6 +10,8 @@
     Include headers
 \*====================================================================================================================*/
 #include "string.h"
+#include <stddef.h>
+#include <stdint.h>
 #include "Std_Types.h"	//[SWS_CanNm_00146]
 
 /* [AUTOSAR 14 and 15 of 96 page]
@@ -37,7 +39,7 @@
 #include "CanNm.h"
 //#include "CanNm_Cbk.h"
 //#include "CanNm_MemMap.h"
-//#include "SchM_CanNm.h"
+#include "SchM_CanNm.h"
 
 #include "fff.h"
 
@@ -52,10 +54,108 @@
 
 #define NO_PDU_RECEIVED -1
 
+/* Arena layout: channel state, then the two ChannelHot banks, each starting on CANNM_ARENA_ALIGN */
+#define CANNM_ARENA_ROUND(size)			(((size) + CANNM_ARENA_ALIGN - 1U) & ~(uint32)(CANNM_ARENA_ALIGN - 1U))
+
+/* Statistics counters, empty statements without CANNM_STATISTICS_ENABLED */
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+#define CANNM_STATISTICS_COUNT(ChannelInternal, counter)			((ChannelInternal)->Statistics.counter++)
+#define CANNM_STATISTICS_TRANSITION(ChannelInternal, from, to)		((ChannelInternal)->Statistics.Transitions[from][to]++)
+#else
+#define CANNM_STATISTICS_COUNT(ChannelInternal, counter)			((void)0)
+#define CANNM_STATISTICS_TRANSITION(ChannelInternal, from, to)		((void)0)
+#endif
+
+/* Trace events, see CanNm_Trace.h. Without CANNM_TRACE_ENABLED the arguments are not evaluated. */
+#if (CANNM_TRACE_ENABLED == STD_ON)
+#define CANNM_TRACE(ChannelInternal, type, arg8, arg32)				CanNm_Internal_Trace(ChannelInternal, type, arg8, arg32)
+#else
+#define CANNM_TRACE(ChannelInternal, type, arg8, arg32)				((void)0)
+#endif
+
+/* Execution time of a timed API function, see CanNm_Timing.h. CANNM_TIMING_START opens the measurement at the top
+ * of the function, CANNM_TIMING_STOP records it before each return. */
+#if (CANNM_TIMING_ENABLED == STD_ON)
+#define CANNM_TIMING_START()										uint64 timingStart = CANNM_TIMING_CYCLES()
+#define CANNM_TIMING_STOP(Instance, function)						\
+	CanNm_TimingRecord(&(Instance)->Timing[function], CANNM_TIMING_CYCLES() - timingStart)
+#else
+#define CANNM_TIMING_START()										((void)0)
+#define CANNM_TIMING_STOP(Instance, function)						((void)0)
+#endif
+
+/* Bus load counts, empty statements without CANNM_BUS_LOAD_ENABLED */
+#define CANNM_BUS_LOAD_RX											0U
+#define CANNM_BUS_LOAD_TX											1U
+#define CANNM_BUS_LOAD_ONE											((uint64)1 << 24)	//1.0 in the rates
+
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+#define CANNM_BUS_LOAD_COUNT(ChannelInternal, direction, length)	\
+	CanNm_Internal_BusLoadCount(&(ChannelInternal)->BusLoad[direction], length)
+#else
+#define CANNM_BUS_LOAD_COUNT(ChannelInternal, direction, length)	((void)0)
+#endif
+
+/* Captured NM PDUs, see CanNm_Pcap.h. Without CANNM_PCAP_ENABLED the arguments are not evaluated. */
+#if (CANNM_PCAP_ENABLED == STD_ON)
+#define CANNM_PCAP(ChannelHot, ChannelInternal, point, drop, data, length)	\
+	CanNm_Internal_Pcap(ChannelHot, ChannelInternal, point, drop, data, length)
+#define CANNM_PCAP_TX_PDU(Instance, TxPduId, drop, PduInfoPtr)	CanNm_Internal_PcapTxPdu(Instance, TxPduId, drop, PduInfoPtr)
+#else
+#define CANNM_PCAP(ChannelHot, ChannelInternal, point, drop, data, length)	((void)0)
+#define CANNM_PCAP_TX_PDU(Instance, TxPduId, drop, PduInfoPtr)	((void)0)
+#endif
+
+/* Wake-up latency milestones, empty statements without CANNM_WAKEUP_LATENCY_ENABLED */
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+#define CANNM_WAKEUP_MILESTONE(ChannelInternal, milestone)			CanNm_Internal_WakeupMilestone(ChannelInternal, milestone)
+#else
+#define CANNM_WAKEUP_MILESTONE(ChannelInternal, milestone)			((void)0)
+#endif
+
+/* Global configuration switches. In the pre-compile variant they are constants from CanNm_Cfg.h, so the compiler
+ * removes the disabled branches and callouts. In the post-build variant they are read from CanNm_ConfigPtr. */
+#if (CANNM_CONFIG_VARIANT == CANNM_VARIANT_PRE_COMPILE)
+#define CANNM_CFG_PASSIVE_MODE_ENABLED				(CANNM_PASSIVE_MODE_ENABLED == STD_ON)
+#define CANNM_CFG_IMMEDIATE_RESTART_ENABLED			(CANNM_IMMEDIATE_RESTART_ENABLED == STD_ON)
+#define CANNM_CFG_REMOTE_SLEEP_IND_ENABLED			(CANNM_REMOTE_SLEEP_IND_ENABLED == STD_ON)
+#define CANNM_CFG_USER_DATA_ENABLED					(CANNM_USER_DATA_ENABLED == STD_ON)
+#define CANNM_CFG_COM_USER_DATA_SUPPORT				(CANNM_COM_USER_DATA_SUPPORT == STD_ON)
+#define CANNM_CFG_GLOBAL_PN_SUPPORT					(CANNM_GLOBAL_PN_SUPPORT == STD_ON)
+#define CANNM_CFG_COORDINATION_SYNC_SUPPORT			(CANNM_COORDINATION_SYNC_SUPPORT == STD_ON)
+#define CANNM_CFG_PDU_RX_INDICATION_ENABLED			(CANNM_PDU_RX_INDICATION_ENABLED == STD_ON)
+#define CANNM_CFG_STATE_CHANGE_IND_ENABLED			(CANNM_STATE_CHANGE_IND_ENABLED == STD_ON)
+#define CANNM_CFG_MAIN_FUNCTION_PERIOD				(CANNM_MAIN_FUNCTION_PERIOD)
+#else
+#define CANNM_CFG_PASSIVE_MODE_ENABLED				(Instance->ConfigPtr->PassiveModeEnabled)
+#define CANNM_CFG_IMMEDIATE_RESTART_ENABLED			(Instance->ConfigPtr->ImmediateRestartEnabled)
+#define CANNM_CFG_REMOTE_SLEEP_IND_ENABLED			(Instance->ConfigPtr->RemoteSleepIndEnabled)
+#define CANNM_CFG_USER_DATA_ENABLED					(Instance->ConfigPtr->UserDataEnabled)
+#define CANNM_CFG_COM_USER_DATA_SUPPORT				(Instance->ConfigPtr->ComUserDataSupport)
+#define CANNM_CFG_GLOBAL_PN_SUPPORT					(Instance->ConfigPtr->GlobalPnSupport)
+#define CANNM_CFG_COORDINATION_SYNC_SUPPORT			(Instance->ConfigPtr->CoordinationSyncSupport)
+#define CANNM_CFG_PDU_RX_INDICATION_ENABLED			(Instance->ConfigPtr->PduRxIndicationEnabled)
+#define CANNM_CFG_STATE_CHANGE_IND_ENABLED			(Instance->ConfigPtr->StateChangeIndEnabled)
+#define CANNM_CFG_MAIN_FUNCTION_PERIOD				(Instance->ConfigPtr->MainFunctionPeriod)
+#endif
+
 /*====================================================================================================================*\
     Local types
 \*====================================================================================================================*/
-typedef void (*CanNm_TimerCallback)(void* Timer, const uint8 channel);
+typedef struct CanNm_Internal_Channel CanNm_Internal_ChannelType;
+
+typedef void (*CanNm_TimerCallback)(void* Timer, CanNm_Internal_ChannelType* ChannelInternal);
+
+/* NM traffic of one direction. The counts are only written by the indication and confirmation, the rates only by
+ * the main function, so an interrupt counting a frame needs no lock. */
+typedef struct {
+	uint32						Frames;					//Since initialization, modulo 2^32
+	uint32						Bits;
+	uint32						LastFrames;				//Counts at the last main function
+	uint32						LastBits;
+	uint64						FrameRate;				//Per main function period, 24 bit fraction
+	uint64						BitRate;
+} CanNm_Internal_BusLoadType;
 
 typedef enum {
 	CANNM_TIMER_STOPPED,
@@ -63,19 +163,17 @@ typedef enum {
 } CanNm_TimerState;
 
 typedef struct {
-	uint8						Channel;
 	CanNm_TimerCallback 		ExpiredCallback;
 	CanNm_TimerState			State;
-	float32						TimeLeft;
+	uint32						TimeLeft;				//Main function ticks
+#if (CANNM_TRACE_ENABLED == STD_ON)
+	uint8						Id;						//CANNM_TRACE_TIMER_*
+#endif
 } CanNm_Timer;
 
-typedef enum {
-	CANNM_INIT,
-	CANNM_UNINIT
-} CanNm_InitStatusType;
-
-typedef struct {
-	uint8						Channel;
+struct CanNm_Internal_Channel {
+	CanNm_InstanceType*			Instance;
+	uint16						Channel;
 	Nm_ModeType					Mode;					//[SWS_CanNm_00092]
 	Nm_StateType				State;					//[SWS_CanNm_00089]
 	boolean						Requested;
@@ -91,24 +189,48 @@ typedef struct {
 	boolean						RemoteSleepInd;
 	boolean						RemoteSleepIndEnabled;
 	boolean						NmPduFilterAlgorithm;
-} CanNm_Internal_ChannelType;
-
-typedef struct {
-	CanNm_InitStatusType 		InitStatus;
-	CanNm_Internal_ChannelType	Channels[CANNM_CHANNEL_COUNT];
-} CanNm_InternalType;
+	Std_ReturnType				LastTxStatus;
+	const PduInfoType*			TxPduRef;
+	uint8*						TxUserDataSduPtr;
+	const CanNm_RxPdu* const*	RxPdu;
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+	CanNm_StatisticsType		Statistics;
+#endif
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+	CanNm_Internal_BusLoadType	BusLoad[2];				//CANNM_BUS_LOAD_RX, CANNM_BUS_LOAD_TX
+#endif
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+	uint64						WakeupStart;			//CANNM_WAKEUP_CLOCK of the waking request
+	uint8						WakeupPending;			//Milestones not reached yet, bit per CANNM_WAKEUP_*
+	CanNm_WakeupLatencyType		WakeupLatency;
+#endif
+};
 
 /*====================================================================================================================*\
     Global variables
 \*====================================================================================================================*/
-CanNm_InternalType CanNm_Internal = {
-		.InitStatus = CANNM_UNINIT
+_Static_assert(_Alignof(CanNm_Internal_ChannelType) <= CANNM_ARENA_ALIGN, "CANNM_ARENA_ALIGN too small");
+_Static_assert(_Alignof(CanNm_ChannelHotType) <= CANNM_ARENA_ALIGN, "CANNM_ARENA_ALIGN too small");
+
+static CanNm_Internal_ChannelType CanNm_ChannelStorage[CANNM_CHANNEL_COUNT];
+#ifndef CANNM_GENERATED_CFG
+static CanNm_ChannelHotType CanNm_ChannelHot[CANNM_CHANNEL_COUNT];
+static CanNm_ChannelHotType CanNm_ChannelHotSwap[CANNM_CHANNEL_COUNT];	//Second bank for CanNm_SwitchConfig
+#endif
+
+/* Default instance behind the global API */
+CanNm_InstanceType CanNm_Internal = {
+		.InitStatus = CANNM_UNINIT,
+		.ChannelCount = CANNM_CHANNEL_COUNT,
+		.Channels = CanNm_ChannelStorage,
+#ifndef CANNM_GENERATED_CFG
+		.ChannelHotBank = { CanNm_ChannelHot, CanNm_ChannelHotSwap }
+#endif
 };
 
 /*====================================================================================================================*\
     Local variables (static)
 \*====================================================================================================================*/
-static const CanNm_ConfigType* CanNm_ConfigPtr;
 
 /*====================================================================================================================*\
     Local functions declarations
@@ -118,57 +240,129 @@ static inline void CanNm_Internal_TimerStart( CanNm_Timer* Timer, uint32 timeout
 static inline void CanNm_Internal_TimerResume( CanNm_Timer* Timer );
 static inline void CanNm_Internal_TimerStop( CanNm_Timer* Timer );
 static inline void CanNm_Internal_TimerReset( CanNm_Timer* Timer, uint32 timeoutValue );
-static inline void CanNm_Internal_TimerTick( CanNm_Timer* Timer, const uint8 channel, const float32 period );
-
-static inline void CanNm_Internal_TimersInit( uint8 channel );
-static inline void CanNm_Internal_TimeoutTimerExpiredCallback( void* Timer, const uint8 channel );
-static inline void CanNm_Internal_MessageCycleTimerExpiredCallback( void* Timer, const uint8 channel );
-static inline void CanNm_Internal_RepeatMessageTimerExpiredCallback( void* Timer, const uint8 channel );
-static inline void CanNm_Internal_WaitBusSleepTimerExpiredCallback( void* Timer, const uint8 channel );
-static inline void CanNm_Internal_RemoteSleepIndTimerExpiredCallback( void* Timer, const uint8 channel );
+static inline void CanNm_Internal_TimerTick( CanNm_Timer* Timer, CanNm_Internal_ChannelType* ChannelInternal );
+static inline uint32 CanNm_Internal_TimerTicksToExpiry( const CanNm_Timer* Timer, uint8 ticksPerCall, uint32 ticks );
+static inline void CanNm_Internal_TimerSkip( CanNm_Timer* Timer, uint32 ticks );
+static inline uint32 CanNm_Internal_TimeToTicks( const float32 time, const float32 period );
+
+static inline void CanNm_Internal_TimersInit( CanNm_Internal_ChannelType* ChannelInternal );
+static inline void CanNm_Internal_TimeoutTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal );
+static inline void CanNm_Internal_MessageCycleTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal );
+static inline void CanNm_Internal_RepeatMessageTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal );
+static inline void CanNm_Internal_WaitBusSleepTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal );
+static inline void CanNm_Internal_RemoteSleepIndTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal );
 
 /* State Machine functions */
-static inline void CanNm_Internal_BusSleep_to_BusSleep( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_Transition( CanNm_Internal_ChannelType* ChannelInternal, Nm_StateType previous,
+ 												Nm_StateType current );
+static inline void CanNm_Internal_BusSleep_to_BusSleep( const CanNm_ChannelHotType* ChannelHot,
  														CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_BusSleep_to_RepeatMessage( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_BusSleep_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot,
  																CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_RepeatMessage_to_RepeatMessage( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_RepeatMessage_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot,
  																	CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_RepeatMessage_to_ReadySleep( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_RepeatMessage_to_ReadySleep( const CanNm_ChannelHotType* ChannelHot,
  																CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_RepeatMessage_to_NormalOperation( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_RepeatMessage_to_NormalOperation( const CanNm_ChannelHotType* ChannelHot,
  																	CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_NormalOperation_to_RepeatMessage( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_NormalOperation_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot,
  																	CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_NormalOperation_to_NormalOperation( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_NormalOperation_to_NormalOperation( const CanNm_ChannelHotType* ChannelHot,
  																		CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_NormalOperation_to_ReadySleep( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_NormalOperation_to_ReadySleep( const CanNm_ChannelHotType* ChannelHot,
  																	CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_ReadySleep_to_NormalOperation( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_ReadySleep_to_NormalOperation( const CanNm_ChannelHotType* ChannelHot,
  																	CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_ReadySleep_to_RepeatMessage( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_ReadySleep_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot,
  																CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_ReadySleep_to_PrepareBusSleep( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_ReadySleep_to_PrepareBusSleep( const CanNm_ChannelHotType* ChannelHot,
  																	CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_PrepareBusSleep_to_RepeatMessage( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_PrepareBusSleep_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot,
  																	CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_PrepareBusSleep_to_BusSleep( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_PrepareBusSleep_to_BusSleep( const CanNm_ChannelHotType* ChannelHot,
  																CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_NetworkMode_to_NetworkMode( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_NetworkMode_to_NetworkMode( const CanNm_ChannelHotType* ChannelHot,
  																CanNm_Internal_ChannelType* ChannelInternal );
 
 /* Additional functions */
-static inline Std_ReturnType CanNm_Internal_TxDisable( CanNm_Internal_ChannelType* ChannelInternal );
-static inline Std_ReturnType CanNm_Internal_TxEnable( CanNm_Internal_ChannelType* ChannelInternal );
-static inline Std_ReturnType CanNm_Internal_TransmitMessage( const CanNm_ChannelType* ChannelConf,
+static inline Std_ReturnType CanNm_Internal_TxDisable( const CanNm_InstanceType* Instance,
+ 														CanNm_Internal_ChannelType* ChannelInternal );
+static inline Std_ReturnType CanNm_Internal_TxEnable( const CanNm_InstanceType* Instance,
+ 														CanNm_Internal_ChannelType* ChannelInternal );
+static inline Std_ReturnType CanNm_Internal_TransmitMessage( const CanNm_ChannelHotType* ChannelHot,
  																CanNm_Internal_ChannelType* ChannelInternal );
-static inline void CanNm_Internal_SetPduCbvBit( const CanNm_ChannelType* ChannelConf, const uint8 PduCbvBitPosition );
-static inline void CanNm_Internal_ClearPduCbvBit( const CanNm_ChannelType* ChannelConf, const uint8 PduCbvBitPosition );
-static inline void CanNm_Internal_ClearPduCbv( const CanNm_ChannelType* ChannelConf,
+static inline void CanNm_Internal_SetPduCbvBit( const CanNm_ChannelHotType* ChannelHot,
+ 												CanNm_Internal_ChannelType* ChannelInternal, const uint8 PduCbvBitPosition );
+static inline void CanNm_Internal_ClearPduCbvBit( const CanNm_ChannelHotType* ChannelHot,
+ 												CanNm_Internal_ChannelType* ChannelInternal, const uint8 PduCbvBitPosition );
+static inline void CanNm_Internal_ClearPduCbv( const CanNm_ChannelHotType* ChannelHot,
  												CanNm_Internal_ChannelType* ChannelInternal );
-static inline uint8 CanNm_Internal_GetUserDataOffset( const CanNm_ChannelType* ChannelConf );
-static inline uint8* CanNm_Internal_GetUserDataPtr( const CanNm_ChannelType* ChannelConf, uint8* MessageSduPtr );
-static inline uint8 CanNm_Internal_GetUserDataLength( const CanNm_ChannelType* ChannelConf );
+static inline void CanNm_Internal_ChannelHotInit( const CanNm_ChannelType* ChannelConf, const float32 period,
+ 													CanNm_ChannelHotType* ChannelHot );
+static inline void CanNm_Internal_ChannelPduBind( const uint16 channel, CanNm_Internal_ChannelType* ChannelInternal );
+static inline void CanNm_Internal_ChannelPduRebind( const CanNm_ChannelHotType* OldChannelHot,
+ 													const CanNm_ChannelHotType* ChannelHot,
+ 													CanNm_Internal_ChannelType* ChannelInternal );
+static inline void CanNm_Internal_TimerClamp( CanNm_Timer* Timer, uint32 timeoutValue );
+static inline uint16 CanNm_Internal_ConfigChannelCount( const CanNm_ConfigType* cannmConfigPtr );
+static inline boolean CanNm_Internal_ConfigRxPduValid( const CanNm_ConfigType* cannmConfigPtr, uint16 channelCount );
+static inline void CanNm_Internal_ApplyConfig( CanNm_InstanceType* Instance, const CanNm_ConfigType* cannmConfigPtr );
+static inline void CanNm_Internal_Init( CanNm_InstanceType* Instance, const CanNm_ConfigType* cannmConfigPtr );
+static inline uint8* CanNm_Internal_GetUserDataPtr( const CanNm_ChannelHotType* ChannelHot, uint8* MessageSduPtr );
+static inline uint8 CanNm_Internal_GetUserDataLength( const CanNm_ChannelHotType* ChannelHot );
+#if (CANNM_TRACE_ENABLED == STD_ON)
+static inline void CanNm_Internal_Trace( const CanNm_Internal_ChannelType* ChannelInternal, uint8 type, uint8 arg8,
+ 										uint32 arg32 );
+static inline void CanNm_Internal_TraceTimer( const CanNm_Timer* Timer, uint8 type, uint32 arg32 );
+#endif
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+static inline void CanNm_Internal_WakeupMilestone( CanNm_Internal_ChannelType* ChannelInternal, uint8 milestone );
+#endif
+#if (CANNM_PCAP_ENABLED == STD_ON)
+static inline void CanNm_Internal_Pcap( const CanNm_ChannelHotType* ChannelHot,
+ 										const CanNm_Internal_ChannelType* ChannelInternal, uint8 point, uint8 drop,
+ 										const uint8* data, PduLengthType length );
+static inline void CanNm_Internal_PcapTxPdu( const CanNm_InstanceType* Instance, PduIdType TxPduId, uint8 drop,
+ 											const PduInfoType* PduInfoPtr );
+#endif
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+static inline void CanNm_Internal_BusLoadCount( CanNm_Internal_BusLoadType* BusLoad, PduLengthType length );
+static inline void CanNm_Internal_BusLoadTick( CanNm_Internal_BusLoadType* BusLoad );
+static inline void CanNm_Internal_BusLoadDecay( CanNm_Internal_BusLoadType* BusLoad, uint32 ticks );
+#endif
+
+/* Default callouts */
+static Std_ReturnType CanNm_Internal_CanIfTransmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+ 													const PduInfoType* PduInfoPtr );
+static void CanNm_Internal_NmBusSleepMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Internal_NmNetworkMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Internal_NmNetworkStartIndication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Internal_NmPduRxIndication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Internal_NmPrepareBusSleepMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Internal_NmRemoteSleepCancellation( CanNm_InstanceType* Instance,
+ 													NetworkHandleType nmChannelHandle );
+static void CanNm_Internal_NmRemoteSleepInd( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Internal_NmStateChangeNotification( CanNm_InstanceType* Instance,
+ 													NetworkHandleType nmChannelHandle, Nm_StateType nmPreviousState,
+ 													Nm_StateType nmCurrentState );
+static void CanNm_Internal_NmTxTimeoutException( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Internal_PduRCanNmRxIndication( CanNm_InstanceType* Instance, PduIdType RxPduId,
+ 												const PduInfoType* PduInfoPtr );
+
+/* Callouts of instances without own callbacks, the global functions of the surrounding stack */
+static const CanNm_CallbacksType CanNm_Internal_Callouts = {
+	.CanIfTransmit = CanNm_Internal_CanIfTransmit,
+	.BusSleepMode = CanNm_Internal_NmBusSleepMode,
+	.NetworkMode = CanNm_Internal_NmNetworkMode,
+	.NetworkStartIndication = CanNm_Internal_NmNetworkStartIndication,
+	.PduRxIndication = CanNm_Internal_NmPduRxIndication,
+	.PrepareBusSleepMode = CanNm_Internal_NmPrepareBusSleepMode,
+	.RemoteSleepCancellation = CanNm_Internal_NmRemoteSleepCancellation,
+	.RemoteSleepInd = CanNm_Internal_NmRemoteSleepInd,
+	.StateChangeNotification = CanNm_Internal_NmStateChangeNotification,
+	.TxTimeoutException = CanNm_Internal_NmTxTimeoutException,
+	.PduRRxIndication = CanNm_Internal_PduRCanNmRxIndication
+};
 
 /*====================================================================================================================*\
 	Global inline functions and function macros code
@@ -198,7 +392,7 @@ MOCK_VOID_FUNC(Nm_RemoteSleepInd, NetworkHandleType);
 MOCK_VOID_FUNC(Nm_RepeatMessageIndication, NetworkHandleType);
 MOCK_VOID_FUNC(Nm_StateChangeNotification, NetworkHandleType, Nm_StateType, Nm_StateType);
 MOCK_VOID_FUNC(Nm_TxTimeoutException, NetworkHandleType);
-MOCK_VOID_FUNC(PduR_CanNmRxIndication, PduIdType, PduInfoType*);
+MOCK_VOID_FUNC(PduR_CanNmRxIndication, PduIdType, const PduInfoType*);
 MOCK_VOID_FUNC(PduR_CanNmTriggerTransmit, PduIdType, PduInfoType*);
 MOCK_VOID_FUNC(PduR_CanNmTxConfirmation, PduIdType);
 
@@ -208,76 +402,102 @@ MOCK_VOID_FUNC(PduR_CanNmTxConfirmation, PduIdType);
     Global functions code
 \*====================================================================================================================*/
 
-/** @brief CanNm_Init [SWS_CanNm_00208]
+/** @brief CanNm_ChannelArenaSize
  *
- * Initialize the CanNm module.
+ * Size of the arena CanNm_InstanceInit and CanNm_InitArena need for channelCount channels: the channel state and
+ * the two banks of derived channel parameters.
  */
-void CanNm_Init(const CanNm_ConfigType* cannmConfigPtr)
+uint32 CanNm_ChannelArenaSize(uint16 channelCount)
 {
-    CanNm_ConfigPtr = cannmConfigPtr;
-    uint8 channel;
-	for (channel = 0; channel < CANNM_CHANNEL_COUNT; channel++) {
-		const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[channel];
-		CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[channel];
-
-		ChannelInternal->Channel = channel;
-		ChannelInternal->Mode = NM_MODE_BUS_SLEEP;														//[SWS_CanNm_00144]
-		ChannelInternal->State = NM_STATE_BUS_SLEEP;													//[SWS_CanNm_00141][SWS_CanNm_00094]
-		ChannelInternal->Requested = FALSE;																//[SWS_CanNm_00143]
-		ChannelInternal->TxEnabled = FALSE;
-		ChannelInternal->RxLastPdu = NO_PDU_RECEIVED;
-		ChannelInternal->ImmediateTransmissions = 0;
-		ChannelInternal->BusLoadReduction = FALSE;														//[SWS_CanNm_00023]
-		ChannelInternal->RemoteSleepInd = FALSE;
-		ChannelInternal->RemoteSleepIndEnabled = CanNm_ConfigPtr->RemoteSleepIndEnabled;
-		ChannelInternal->NmPduFilterAlgorithm = FALSE;
-
-		if (ChannelConf->NodeIdEnabled && ChannelConf->PduNidPosition != CANNM_PDU_OFF) {
-			ChannelConf->TxPdu->TxPduRef->SduDataPtr[ChannelConf->PduNidPosition] = ChannelConf->NodeId;//[SWS_CanNm_00013]
-		}
-
-		CanNm_Internal_ClearPduCbv(ChannelConf, ChannelInternal);										//[SWS_CanNm_00085]
-
-		uint8* destUserData = CanNm_Internal_GetUserDataPtr(ChannelConf, ChannelConf->UserDataTxPdu->TxUserDataPduRef->SduDataPtr);
-		uint8 userDataLength = CanNm_Internal_GetUserDataLength(ChannelConf);
-		memset(destUserData, 0xFF, userDataLength);														//[SWS_CanNm_00025]
+	return CANNM_ARENA_ROUND((uint32)channelCount * sizeof(CanNm_Internal_ChannelType)) +
+			(uint32)channelCount * 2 * sizeof(CanNm_ChannelHotType);
+}
 
-		CanNm_Internal_TimersInit(channel);																//[SWS_CanNm_00061][SWS_CanNm_00033]
+/** @brief CanNm_InstanceInit
+ *
+ * Initialize an independent CanNm instance with the channel state in the caller supplied arena, aligned to
+ * CANNM_ARENA_ALIGN and CanNm_ChannelArenaSize bytes long. The instance serves CanNm_Internal_ConfigChannelCount
+ * channels: ChannelCount of the configuration, or CANNM_CHANNEL_COUNT if it is 0. More than CANNM_CHANNEL_COUNT
+ * channels need the ChannelHot and ChannelPdu tables. Callbacks and Context are set by the caller before, NULL
+ * Callbacks selects the global callouts.
+ */
+Std_ReturnType CanNm_InstanceInit(CanNm_InstanceType* Instance, const CanNm_ConfigType* cannmConfigPtr, void* arena,
+ 									uint32 arenaSize)
+{
+	if (Instance == NULL || cannmConfigPtr == NULL || arena == NULL || ((uintptr_t)arena % CANNM_ARENA_ALIGN) != 0) {
+		return E_NOT_OK;
+	}
+	uint16 channelCount = CanNm_Internal_ConfigChannelCount(cannmConfigPtr);
+	if (channelCount == 0 || arenaSize < CanNm_ChannelArenaSize(channelCount)) {
+		return E_NOT_OK;
 	}
-	CanNm_Internal.InitStatus = CANNM_INIT;
+	Instance->ChannelCount = channelCount;
+	Instance->Channels = (CanNm_Internal_ChannelType*)arena;
+	Instance->ChannelHotBank[0] = (CanNm_ChannelHotType*)((uint8*)arena +
+									CANNM_ARENA_ROUND((uint32)channelCount * sizeof(CanNm_Internal_ChannelType)));
+	Instance->ChannelHotBank[1] = &Instance->ChannelHotBank[0][channelCount];
+	CanNm_Internal_Init(Instance, cannmConfigPtr);
+	return E_OK;
 }
 
-/** @brief CanNm_DeInit [SWS_CanNm_91002]
+/** @brief CanNm_InstanceDeInit [SWS_CanNm_91002]
  *
- * De-initializes the CanNm module.
+ * De-initializes the CanNm instance.
  */
-void CanNm_DeInit(void)
+void CanNm_InstanceDeInit(CanNm_InstanceType* Instance)
 {
-    for (uint8 channel = 0; channel < CANNM_CHANNEL_COUNT; channel++) {
-		CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[channel];
-
-		if (ChannelInternal->State != NM_STATE_BUS_SLEEP) {
+    for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		if (Instance->Channels[channel].State != NM_STATE_BUS_SLEEP) {
 			return;
 		}
-		CanNm_Internal_TimersInit(channel);
+	}
+	for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[channel];
+
+		CanNm_Internal_TimersInit(ChannelInternal);
 		ChannelInternal->State = NM_STATE_UNINIT;
 	}
-	CanNm_Internal.InitStatus = CANNM_UNINIT;
+	Instance->InitStatus = CANNM_UNINIT;
+}
+
+/** @brief CanNm_InstanceSwitchConfig
+ *
+ * Replace the configuration of an initialized instance without a DeInit/Init cycle. The switch is applied at the start
+ * of the next main function: the state, mode and running timers of every channel are kept, only the derived
+ * timing and the PDU layout are rebuilt. Running timers longer than their new period are shortened to it.
+ * The new configuration must have the same channel count. A later call before the switch replaces the earlier one.
+ * An instance without ChannelHotBank only accepts configurations with the ChannelHot table.
+ */
+Std_ReturnType CanNm_InstanceSwitchConfig(CanNm_InstanceType* Instance, const CanNm_ConfigType* cannmConfigPtr)
+{
+	if (Instance->InitStatus != CANNM_INIT || cannmConfigPtr == NULL ||
+		(cannmConfigPtr->ChannelHot == NULL && Instance->ChannelHotBank[0] == NULL) ||
+		CanNm_Internal_ConfigChannelCount(cannmConfigPtr) != Instance->ChannelCount) {
+		return E_NOT_OK;
+	}
+	SchM_Enter_CanNm_CANNM_EXCLUSIVE_AREA_0();
+	Instance->PendingConfigPtr = cannmConfigPtr;
+	SchM_Exit_CanNm_CANNM_EXCLUSIVE_AREA_0();
+	return E_OK;
 }
 
-/** @brief CanNm_PassiveStartUp [SWS_CanNm_00211]
+/** @brief CanNm_InstancePassiveStartUp [SWS_CanNm_00211]
  *
  * Passive startup of the AUTOSAR CAN NM. It triggers the transition from Bus-Sleep Mode
  *  or Prepare Bus Sleep Mode to the Network Mode in Repeat Message State.
  */
-Std_ReturnType CanNm_PassiveStartUp(NetworkHandleType nmChannelHandle)
+Std_ReturnType CanNm_InstancePassiveStartUp(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 	Std_ReturnType status = E_OK;
 
-	if (CanNm_ConfigPtr->PassiveModeEnabled && ChannelInternal->Mode != NM_MODE_NETWORK) {				//[SWS_CanNm_00161]
-        CanNm_Internal_BusSleep_to_RepeatMessage(ChannelConf, ChannelInternal);							//[SWS_CanNm_00128][SWS_CanNm_00314][SWS_CanNm_00315]
+	if (CANNM_CFG_PASSIVE_MODE_ENABLED && ChannelInternal->Mode == NM_MODE_BUS_SLEEP) {				//[SWS_CanNm_00161]
+		CanNm_Internal_BusSleep_to_RepeatMessage(ChannelHot, ChannelInternal);							//[SWS_CanNm_00128][SWS_CanNm_00314]
+		status = E_OK;
+	}
+	else if (CANNM_CFG_PASSIVE_MODE_ENABLED && ChannelInternal->Mode == NM_MODE_PREPARE_BUS_SLEEP) {
+		CanNm_Internal_PrepareBusSleep_to_RepeatMessage(ChannelHot, ChannelInternal);					//[SWS_CanNm_00128][SWS_CanNm_00315]
 		status = E_OK;
 	}
 	else {
@@ -286,74 +506,75 @@ Std_ReturnType CanNm_PassiveStartUp(NetworkHandleType nmChannelHandle)
 	return status;
 }
 
-/** @brief CanNm_NetworkRequest [SWS_CanNm_00213]
+/** @brief CanNm_InstanceNetworkRequest [SWS_CanNm_00213]
  *
  * Request the network, since ECU needs to communicate on the bus.
  */
-Std_ReturnType CanNm_NetworkRequest(NetworkHandleType nmChannelHandle)
+Std_ReturnType CanNm_InstanceNetworkRequest(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
 	ChannelInternal->Requested = TRUE;
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+	if (ChannelInternal->Mode != NM_MODE_NETWORK) {
+		ChannelInternal->WakeupStart = CANNM_WAKEUP_CLOCK();
+		ChannelInternal->WakeupPending = (1U << CANNM_WAKEUP_MILESTONE_COUNT) - 1U;
+	}
+#endif
 
 	if (ChannelInternal->Mode == NM_MODE_BUS_SLEEP) {
-		if (!CanNm_ConfigPtr->PassiveModeEnabled) {
+		if (!CANNM_CFG_PASSIVE_MODE_ENABLED) {
 			ChannelInternal->TxEnabled = TRUE;															//[SWS_CanNm_00072]
 		}
-		CanNm_Internal_BusSleep_to_RepeatMessage(ChannelConf, ChannelInternal);							//[SWS_CanNm_00129][SWS_CanNm_00314]
-		if (ChannelConf->ActiveWakeupBitEnabled) {
-			CanNm_Internal_SetPduCbvBit(ChannelConf, ACTIVE_WAKEUP_BIT);								//[SWS_CanNm_00401]
-			if (ChannelConf->ImmediateNmTransmissions) {												//[SWS_CanNm_00005][SWS_CanNm_00334]
-				ChannelInternal->ImmediateTransmissions = ChannelConf->ImmediateNmTransmissions;
-				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer,
-				 ChannelInternal->MessageCycleTimer.Channel);
+		CanNm_Internal_BusSleep_to_RepeatMessage(ChannelHot, ChannelInternal);							//[SWS_CanNm_00129][SWS_CanNm_00314]
+		if (ChannelHot->ActiveWakeupBitEnabled) {
+			CanNm_Internal_SetPduCbvBit(ChannelHot, ChannelInternal, ACTIVE_WAKEUP_BIT);								//[SWS_CanNm_00401]
+			if (ChannelHot->ImmediateNmTransmissions) {												//[SWS_CanNm_00005][SWS_CanNm_00334]
+				ChannelInternal->ImmediateTransmissions = ChannelHot->ImmediateNmTransmissions;
+				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer, ChannelInternal);
 			}
 		}
 	}
 	else if (ChannelInternal->Mode == NM_MODE_PREPARE_BUS_SLEEP) {
-		if (!CanNm_ConfigPtr->PassiveModeEnabled) {
+		if (!CANNM_CFG_PASSIVE_MODE_ENABLED) {
 			ChannelInternal->TxEnabled = TRUE;															//[SWS_CanNm_00072]
 		}
-		CanNm_Internal_PrepareBusSleep_to_RepeatMessage(ChannelConf, ChannelInternal);					//[SWS_CanNm_00123][SWS_CanNm_00315]
-		if (ChannelConf->ActiveWakeupBitEnabled) {
-			CanNm_Internal_SetPduCbvBit(ChannelConf, ACTIVE_WAKEUP_BIT);								//[SWS_CanNm_00401]
-			if (CanNm_ConfigPtr->ImmediateRestartEnabled || ChannelConf->ImmediateNmTransmissions) {	//[SWS_CanNm_00005][SWS_CanNm_00122][SWS_CanNm_00334]
-				ChannelInternal->ImmediateTransmissions = ChannelConf->ImmediateNmTransmissions;
-				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer,
-				 ChannelInternal->MessageCycleTimer.Channel);
+		CanNm_Internal_PrepareBusSleep_to_RepeatMessage(ChannelHot, ChannelInternal);					//[SWS_CanNm_00123][SWS_CanNm_00315]
+		if (ChannelHot->ActiveWakeupBitEnabled) {
+			CanNm_Internal_SetPduCbvBit(ChannelHot, ChannelInternal, ACTIVE_WAKEUP_BIT);								//[SWS_CanNm_00401]
+			if (CANNM_CFG_IMMEDIATE_RESTART_ENABLED || ChannelHot->ImmediateNmTransmissions) {	//[SWS_CanNm_00005][SWS_CanNm_00122][SWS_CanNm_00334]
+				ChannelInternal->ImmediateTransmissions = ChannelHot->ImmediateNmTransmissions;
+				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer, ChannelInternal);
 			}
 		}
 	}
 	else if (ChannelInternal->Mode == NM_MODE_NETWORK) {
 		if (ChannelInternal->State == NM_STATE_READY_SLEEP) {
-			if (ChannelConf->PnHandleMultipleNetworkRequests && ChannelConf->ImmediateNmTransmissions) {//[SWS_CanNm_00444][SWS_CanNm_00454]
-				CanNm_Internal_ReadySleep_to_RepeatMessage(ChannelConf, ChannelInternal);
-				ChannelInternal->ImmediateTransmissions = ChannelConf->ImmediateNmTransmissions;
-				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer,
-				 ChannelInternal->MessageCycleTimer.Channel);
+			if (ChannelHot->PnHandleMultipleNetworkRequests && ChannelHot->ImmediateNmTransmissions) {//[SWS_CanNm_00444][SWS_CanNm_00454]
+				CanNm_Internal_ReadySleep_to_RepeatMessage(ChannelHot, ChannelInternal);
+				ChannelInternal->ImmediateTransmissions = ChannelHot->ImmediateNmTransmissions;
+				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer, ChannelInternal);
 			}
 			else {
-				CanNm_Internal_ReadySleep_to_NormalOperation(ChannelConf, ChannelInternal);				//[SWS_CanNm_00110]
-				if (CanNm_ConfigPtr->RemoteSleepIndEnabled) {											//[SWS_CanNm_00149]
-					CanNm_Internal_TimerStart(&ChannelInternal->RemoteSleepIndTimer, ChannelConf->RemoteSleepIndTime);
+				CanNm_Internal_ReadySleep_to_NormalOperation(ChannelHot, ChannelInternal);				//[SWS_CanNm_00110]
+				if (CANNM_CFG_REMOTE_SLEEP_IND_ENABLED) {											//[SWS_CanNm_00149]
+					CanNm_Internal_TimerStart(&ChannelInternal->RemoteSleepIndTimer, ChannelHot->RemoteSleepIndTicks);
 				}
 			}
 		}
 		else if (ChannelInternal->State == NM_STATE_NORMAL_OPERATION) {
-			if (ChannelConf->PnHandleMultipleNetworkRequests && ChannelConf->ImmediateNmTransmissions) {//[SWS_CanNm_00444][SWS_CanNm_00454]
-				CanNm_Internal_NormalOperation_to_RepeatMessage(ChannelConf, ChannelInternal);
-				ChannelInternal->ImmediateTransmissions = ChannelConf->ImmediateNmTransmissions;
-				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer,
-				 ChannelInternal->MessageCycleTimer.Channel);
+			if (ChannelHot->PnHandleMultipleNetworkRequests && ChannelHot->ImmediateNmTransmissions) {//[SWS_CanNm_00444][SWS_CanNm_00454]
+				CanNm_Internal_NormalOperation_to_RepeatMessage(ChannelHot, ChannelInternal);
+				ChannelInternal->ImmediateTransmissions = ChannelHot->ImmediateNmTransmissions;
+				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer, ChannelInternal);
 			}
 		}
 		else if (ChannelInternal->State == NM_STATE_REPEAT_MESSAGE) {
-			if (ChannelConf->PnHandleMultipleNetworkRequests && ChannelConf->ImmediateNmTransmissions) {//[SWS_CanNm_00444][SWS_CanNm_00454]
-				CanNm_Internal_RepeatMessage_to_RepeatMessage(ChannelConf, ChannelInternal);
-				ChannelInternal->ImmediateTransmissions = ChannelConf->ImmediateNmTransmissions;
-				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer,
-				 ChannelInternal->MessageCycleTimer.Channel);
+			if (ChannelHot->PnHandleMultipleNetworkRequests && ChannelHot->ImmediateNmTransmissions) {//[SWS_CanNm_00444][SWS_CanNm_00454]
+				CanNm_Internal_RepeatMessage_to_RepeatMessage(ChannelHot, ChannelInternal);
+				ChannelInternal->ImmediateTransmissions = ChannelHot->ImmediateNmTransmissions;
+				CanNm_Internal_MessageCycleTimerExpiredCallback(&ChannelInternal->MessageCycleTimer, ChannelInternal);
 			}
 		}
 		else {
@@ -366,52 +587,52 @@ Std_ReturnType CanNm_NetworkRequest(NetworkHandleType nmChannelHandle)
 	return E_OK;
 }
 
-/** @brief CanNm_NetworkRelease [SWS_CanNm_00214]
+/** @brief CanNm_InstanceNetworkRelease [SWS_CanNm_00214]
  *
  * Release the network, since ECU doesn't have to communicate on the bus.
  */
-Std_ReturnType CanNm_NetworkRelease(NetworkHandleType nmChannelHandle)
+Std_ReturnType CanNm_InstanceNetworkRelease(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
 	ChannelInternal->Requested = FALSE;	//[SWS_CanNm_00105]
 
 	if (ChannelInternal->Mode == NM_MODE_NETWORK) {
 		if (ChannelInternal->State == NM_STATE_NORMAL_OPERATION) {
-			CanNm_Internal_NormalOperation_to_ReadySleep(ChannelConf, ChannelInternal);
+			CanNm_Internal_NormalOperation_to_ReadySleep(ChannelHot, ChannelInternal);
 		}
 	}
 	return E_OK;
 }
 
-/** @brief CanNm_DisableCommunication [SWS_CanNm_00215]
+/** @brief CanNm_InstanceDisableCommunication [SWS_CanNm_00215]
  *
  * Disable the NM PDU transmission ability due to a ISO14229 Communication Control (28hex) service.
  */
-Std_ReturnType CanNm_DisableCommunication(NetworkHandleType nmChannelHandle)
+Std_ReturnType CanNm_InstanceDisableCommunication(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-	if (ChannelInternal->Mode == NM_MODE_NETWORK && !(CanNm_ConfigPtr->PassiveModeEnabled)) {
-		return CanNm_Internal_TxDisable(ChannelInternal);
+	if (ChannelInternal->Mode == NM_MODE_NETWORK && !CANNM_CFG_PASSIVE_MODE_ENABLED) {
+		return CanNm_Internal_TxDisable(Instance, ChannelInternal);
 	}
 	else {
 		return E_NOT_OK;
 	}
 }
 
-/** @brief CanNm_EnableCommunication [SWS_CanNm_00216]
+/** @brief CanNm_InstanceEnableCommunication [SWS_CanNm_00216]
  *
  * Enable the NM PDU transmission ability due to a ISO14229 Communication Control (28hex) service.
  */
-Std_ReturnType CanNm_EnableCommunication(NetworkHandleType nmChannelHandle)
+Std_ReturnType CanNm_InstanceEnableCommunication(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-	if (ChannelInternal->Mode == NM_MODE_NETWORK && !(CanNm_ConfigPtr->PassiveModeEnabled)) {
+	if (ChannelInternal->Mode == NM_MODE_NETWORK && !CANNM_CFG_PASSIVE_MODE_ENABLED) {
 		if (ChannelInternal->MessageCycleTimer.State == CANNM_TIMER_STOPPED) {
-			return CanNm_Internal_TxEnable(ChannelInternal);
+			return CanNm_Internal_TxEnable(Instance, ChannelInternal);
 		}
 		else {
 			return E_NOT_OK;
@@ -422,18 +643,18 @@ Std_ReturnType CanNm_EnableCommunication(NetworkHandleType nmChannelHandle)
 	}
 }
 
-/** @brief CanNm_SetUserData [SWS_CanNm_00217]
+/** @brief CanNm_InstanceSetUserData [SWS_CanNm_00217]
  *
  * Set user data for NM PDUs transmitted next on the bus.
  */
-Std_ReturnType CanNm_SetUserData(NetworkHandleType nmChannelHandle, const uint8* nmUserDataPtr)
+Std_ReturnType CanNm_InstanceSetUserData(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, const uint8* nmUserDataPtr)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-	if (CanNm_ConfigPtr->UserDataEnabled && !CanNm_ConfigPtr->ComUserDataSupport) {
-		uint8* destUserData = CanNm_Internal_GetUserDataPtr(ChannelConf, ChannelConf->UserDataTxPdu->TxUserDataPduRef->SduDataPtr);
-		uint8 userDataLength = CanNm_Internal_GetUserDataLength(ChannelConf);
+	if (CANNM_CFG_USER_DATA_ENABLED && !CANNM_CFG_COM_USER_DATA_SUPPORT) {
+		uint8* destUserData = CanNm_Internal_GetUserDataPtr(ChannelHot, ChannelInternal->TxUserDataSduPtr);
+		uint8 userDataLength = CanNm_Internal_GetUserDataLength(ChannelHot);
 		memcpy(destUserData, nmUserDataPtr, userDataLength);
 		return E_OK;
 	}
@@ -442,18 +663,18 @@ Std_ReturnType CanNm_SetUserData(NetworkHandleType nmChannelHandle, const uint8*
 	}
 }
 
-/** @brief CanNm_GetUserData [SWS_CanNm_00218]
+/** @brief CanNm_InstanceGetUserData [SWS_CanNm_00218]
  *
  * Get user data out of the most recently received NM PDU.
  */
-Std_ReturnType CanNm_GetUserData(NetworkHandleType nmChannelHandle, uint8* nmUserDataPtr)
+Std_ReturnType CanNm_InstanceGetUserData(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, uint8* nmUserDataPtr)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-	if (CanNm_ConfigPtr->UserDataEnabled && ChannelInternal->RxLastPdu != NO_PDU_RECEIVED) {
-		uint8* srcUserData = CanNm_Internal_GetUserDataPtr(ChannelConf, ChannelConf->RxPdu[ChannelInternal->RxLastPdu]->RxPduRef->SduDataPtr);
-		uint8 userDataLength = CanNm_Internal_GetUserDataLength(ChannelConf);
+	if (CANNM_CFG_USER_DATA_ENABLED && ChannelInternal->RxLastPdu != NO_PDU_RECEIVED) {
+		uint8* srcUserData = CanNm_Internal_GetUserDataPtr(ChannelHot, ChannelInternal->RxPdu[ChannelInternal->RxLastPdu]->RxPduRef->SduDataPtr);
+		uint8 userDataLength = CanNm_Internal_GetUserDataLength(ChannelHot);
 		memcpy(nmUserDataPtr, srcUserData, userDataLength);
 		return E_OK;
 	} else {
@@ -461,32 +682,36 @@ Std_ReturnType CanNm_GetUserData(NetworkHandleType nmChannelHandle, uint8* nmUse
 	}
 }
 
-/** @brief CanNm_Transmit [SWS_CanNm_00331]
+/** @brief CanNm_InstanceTransmit [SWS_CanNm_00331]
  *
  * Requests transmission of a PDU.
  */
-Std_ReturnType CanNm_Transmit(PduIdType TxPduId, const PduInfoType* PduInfoPtr)
+Std_ReturnType CanNm_InstanceTransmit(CanNm_InstanceType* Instance, PduIdType TxPduId, const PduInfoType* PduInfoPtr)
 {
-	if (CanNm_ConfigPtr->ComUserDataSupport || CanNm_ConfigPtr->GlobalPnSupport) {
-		return CanIf_Transmit(TxPduId, PduInfoPtr);
+	if (CANNM_CFG_COM_USER_DATA_SUPPORT || CANNM_CFG_GLOBAL_PN_SUPPORT) {
+		Std_ReturnType status = Instance->Callbacks->CanIfTransmit(Instance, TxPduId, PduInfoPtr);
+
+		CANNM_PCAP_TX_PDU(Instance, TxPduId, (status == E_OK) ? CANNM_PCAP_DROP_NONE : CANNM_PCAP_DROP_CANIF_REJECTED,
+			PduInfoPtr);
+		return status;
 	} else {
 		return E_NOT_OK;
 	}
 }
 
-/** @brief CanNm_GetNodeIdentifier [SWS_CanNm_00219]
+/** @brief CanNm_InstanceGetNodeIdentifier [SWS_CanNm_00219]
  *
  * Get node identifier out of the most recently received NM PDU.
  */
-Std_ReturnType CanNm_GetNodeIdentifier(NetworkHandleType nmChannelHandle, uint8*nmNodeIdPtr)
+Std_ReturnType CanNm_InstanceGetNodeIdentifier(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, uint8*nmNodeIdPtr)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-	if (ChannelConf->PduNidPosition != CANNM_PDU_OFF) {
+	if (ChannelHot->PduNidPosition != CANNM_PDU_OFF) {
 		if (ChannelInternal->RxLastPdu != NO_PDU_RECEIVED) {
-			uint8 *pduNidPtr = ChannelConf->RxPdu[ChannelInternal->RxLastPdu]->RxPduRef->SduDataPtr;
-			pduNidPtr += ChannelConf->PduNidPosition;
+			uint8 *pduNidPtr = ChannelInternal->RxPdu[ChannelInternal->RxLastPdu]->RxPduRef->SduDataPtr;
+			pduNidPtr += ChannelHot->PduNidPosition;
 			*nmNodeIdPtr = *pduNidPtr;
 			return E_OK;
 		} else {
@@ -497,32 +722,32 @@ Std_ReturnType CanNm_GetNodeIdentifier(NetworkHandleType nmChannelHandle, uint8*
 	}
 }
 
-/** @brief CanNm_GetNodeIdentifier [SWS_CanNm_00220]
+/** @brief CanNm_InstanceGetLocalNodeIdentifier [SWS_CanNm_00220]
  *
  * Get node identifier configured for the local node.
  */
-Std_ReturnType CanNm_GetLocalNodeIdentifier(NetworkHandleType nmChannelHandle, uint8* nmNodeIdPtr)
+Std_ReturnType CanNm_InstanceGetLocalNodeIdentifier(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, uint8* nmNodeIdPtr)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
 
-	*nmNodeIdPtr = ChannelConf->NodeId;
+	*nmNodeIdPtr = ChannelHot->NodeId;
 	return E_OK;
 }
 
-/** @brief CanNm_RepeatMessageRequest [SWS_CanNm_00221]
+/** @brief CanNm_InstanceRepeatMessageRequest [SWS_CanNm_00221]
  *
  * Set Repeat Message Request Bit for NM PDUs transmitted next on the bus.
  */
-Std_ReturnType CanNm_RepeatMessageRequest(NetworkHandleType nmChannelHandle)
+Std_ReturnType CanNm_InstanceRepeatMessageRequest(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-	if (ChannelConf->PduCbvPosition != CANNM_PDU_OFF) {
+	if (ChannelHot->PduCbvPosition != CANNM_PDU_OFF) {
 		if (ChannelInternal->State == NM_STATE_READY_SLEEP) {
-			if (ChannelConf->NodeDetectionEnabled) {
-				CanNm_Internal_SetPduCbvBit(ChannelConf, REPEAT_MESSAGE_REQUEST);
-				CanNm_Internal_ReadySleep_to_RepeatMessage(ChannelConf, ChannelInternal);
+			if (ChannelHot->NodeDetectionEnabled) {
+				CanNm_Internal_SetPduCbvBit(ChannelHot, ChannelInternal, REPEAT_MESSAGE_REQUEST);
+				CanNm_Internal_ReadySleep_to_RepeatMessage(ChannelHot, ChannelInternal);
 				return E_OK;
 			}
 			else {
@@ -530,9 +755,9 @@ Std_ReturnType CanNm_RepeatMessageRequest(NetworkHandleType nmChannelHandle)
 			}
 		}
 		else if (ChannelInternal->State == NM_STATE_NORMAL_OPERATION) {
-			if (ChannelConf->NodeDetectionEnabled) {
-				CanNm_Internal_SetPduCbvBit(ChannelConf, REPEAT_MESSAGE_REQUEST);
-				CanNm_Internal_NormalOperation_to_RepeatMessage(ChannelConf, ChannelInternal);
+			if (ChannelHot->NodeDetectionEnabled) {
+				CanNm_Internal_SetPduCbvBit(ChannelHot, ChannelInternal, REPEAT_MESSAGE_REQUEST);
+				CanNm_Internal_NormalOperation_to_RepeatMessage(ChannelHot, ChannelInternal);
 				return E_OK;
 			}
 			else {
@@ -548,18 +773,19 @@ Std_ReturnType CanNm_RepeatMessageRequest(NetworkHandleType nmChannelHandle)
 	}
 }
 
-/** @brief CanNm_GetPduData [SWS_CanNm_00222]
+/** @brief CanNm_InstanceGetPduData [SWS_CanNm_00222]
  *
  * Get the whole PDU data out of the most recently received NM PDU.
  */
-Std_ReturnType CanNm_GetPduData(NetworkHandleType nmChannelHandle, uint8* nmPduDataPtr)
+Std_ReturnType CanNm_InstanceGetPduData(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, uint8* nmPduDataPtr)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-	if (ChannelConf->NodeDetectionEnabled || CanNm_ConfigPtr->UserDataEnabled || ChannelConf->NodeIdEnabled) {
+	if (ChannelHot->NodeDetectionEnabled || CANNM_CFG_USER_DATA_ENABLED || ChannelHot->NodeIdEnabled) {
 		if (ChannelInternal->RxLastPdu != NO_PDU_RECEIVED) {
-			memcpy(nmPduDataPtr, ChannelConf->RxPdu[0]->RxPduRef->SduDataPtr, ChannelConf->RxPdu[0]->RxPduRef->SduLength);
+			memcpy(nmPduDataPtr, ChannelInternal->RxPdu[ChannelInternal->RxLastPdu]->RxPduRef->SduDataPtr,
+				ChannelHot->RxSduLength);
 			return E_OK;
 		}
 		else {
@@ -572,13 +798,13 @@ Std_ReturnType CanNm_GetPduData(NetworkHandleType nmChannelHandle, uint8* nmPduD
 	}
 }
 
-/** @brief CanNm_GetState [SWS_CanNm_00223]
+/** @brief CanNm_InstanceGetState [SWS_CanNm_00223]
  *
  * Returns the state and the mode of the network management.
  */
-Std_ReturnType CanNm_GetState(NetworkHandleType nmChannelHandle, Nm_StateType* nmStatePtr, Nm_ModeType* nmModePtr)
+Std_ReturnType CanNm_InstanceGetState(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, Nm_StateType* nmStatePtr, Nm_ModeType* nmModePtr)
 {
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
 	*nmStatePtr = ChannelInternal->State;
 	*nmModePtr = ChannelInternal->Mode;
@@ -594,18 +820,18 @@ void CanNm_GetVersionInfo(Std_VersionInfoType* versioninfo)
 	//Nothing to do
 }
 
-/** @brief CanNm_RequestBusSynchronization [SWS_CanNm_00226]
+/** @brief CanNm_InstanceRequestBusSynchronization [SWS_CanNm_00226]
  *
  * Request bus synchronization.
  */
-Std_ReturnType CanNm_RequestBusSynchronization(NetworkHandleType nmChannelHandle)
+Std_ReturnType CanNm_InstanceRequestBusSynchronization(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-    if (!CanNm_ConfigPtr->PassiveModeEnabled) {
+    if (!CANNM_CFG_PASSIVE_MODE_ENABLED) {
 		if (ChannelInternal->Mode == NM_MODE_NETWORK && ChannelInternal->TxEnabled) {
-			CanNm_Internal_TransmitMessage(ChannelConf, ChannelInternal);
+			CanNm_Internal_TransmitMessage(ChannelHot, ChannelInternal);
 			return E_OK;
 		}
 		else {
@@ -617,13 +843,13 @@ Std_ReturnType CanNm_RequestBusSynchronization(NetworkHandleType nmChannelHandle
 	}
 }
 
-/** @brief CanNm_CheckRemoteSleepInd [SWS_CanNm_00227]
+/** @brief CanNm_InstanceCheckRemoteSleepInd [SWS_CanNm_00227]
  *
  * Check if remote sleep indication takes place or not.
  */
-Std_ReturnType CanNm_CheckRemoteSleepInd(NetworkHandleType nmChannelHandle, boolean* nmRemoteSleepIndPtr)
+Std_ReturnType CanNm_InstanceCheckRemoteSleepInd(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, boolean* nmRemoteSleepIndPtr)
 {
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
 	if (ChannelInternal->State != NM_STATE_BUS_SLEEP && ChannelInternal->State != NM_STATE_PREPARE_BUS_SLEEP
 		&& ChannelInternal->State != NM_STATE_REPEAT_MESSAGE) {
@@ -635,18 +861,18 @@ Std_ReturnType CanNm_CheckRemoteSleepInd(NetworkHandleType nmChannelHandle, bool
 	}
 }
 
-/** @brief CanNm_SetSleepReadyBit [SWS_CanNm_00338]
+/** @brief CanNm_InstanceSetSleepReadyBit [SWS_CanNm_00338]
  *
  * Set the NM Coordinator Sleep Ready bit in the Control Bit Vector
  */
-Std_ReturnType CanNm_SetSleepReadyBit(NetworkHandleType nmChannelHandle,boolean nmSleepReadyBit)
+Std_ReturnType CanNm_InstanceSetSleepReadyBit(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,boolean nmSleepReadyBit)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[nmChannelHandle];
-    CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[nmChannelHandle];
+    CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-	if (ChannelConf->PduCbvPosition != CANNM_PDU_OFF && CanNm_ConfigPtr->CoordinationSyncSupport) {
-		CanNm_Internal_SetPduCbvBit(ChannelConf, NM_COORDINATOR_SLEEP_READY_BIT);
-		CanNm_Internal_TransmitMessage(ChannelConf, ChannelInternal);
+	if (ChannelHot->PduCbvPosition != CANNM_PDU_OFF && CANNM_CFG_COORDINATION_SYNC_SUPPORT) {
+		CanNm_Internal_SetPduCbvBit(ChannelHot, ChannelInternal, NM_COORDINATOR_SLEEP_READY_BIT);
+		CanNm_Internal_TransmitMessage(ChannelHot, ChannelInternal);
 		return E_OK;
 	}
 	else {
@@ -654,57 +880,86 @@ Std_ReturnType CanNm_SetSleepReadyBit(NetworkHandleType nmChannelHandle,boolean
 	}
 }
 
-/** @brief CanNm_TxConfirmation [SWS_CanNm_00228]
+/** @brief CanNm_InstanceTxConfirmation [SWS_CanNm_00228]
  *
  * The lower layer communication interface module confirms the transmission of a PDU, or the failure to transmit a PDU.
  */
-void CanNm_TxConfirmation(PduIdType TxPduId, Std_ReturnType result)
+void CanNm_InstanceTxConfirmation(CanNm_InstanceType* Instance, PduIdType TxPduId, Std_ReturnType result)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[TxPduId];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[TxPduId];
+	CANNM_TIMING_START();
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[TxPduId];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[TxPduId];
 
+	CANNM_TRACE(ChannelInternal, CANNM_TRACE_TX, CANNM_TRACE_TX_CONFIRMATION, result);
 	if (result == E_OK) {
-		CanNm_Internal_NetworkMode_to_NetworkMode(ChannelConf, ChannelInternal);
+		CANNM_STATISTICS_COUNT(ChannelInternal, TxConfirmations);
+		CANNM_BUS_LOAD_COUNT(ChannelInternal, CANNM_BUS_LOAD_TX, ChannelHot->TxSduLength);
+		CANNM_WAKEUP_MILESTONE(ChannelInternal, CANNM_WAKEUP_FIRST_CONFIRMATION);
+		if (ChannelInternal->Mode == NM_MODE_NETWORK) {												//Late confirmations do not wake
+			CanNm_Internal_NetworkMode_to_NetworkMode(ChannelHot, ChannelInternal);
+		}
 	}
-	if (CanNm_ConfigPtr->ComUserDataSupport) {
-		PduR_CanNmRxIndication(TxPduId, ChannelConf->TxPdu->TxPduRef);
+	else {
+		CANNM_STATISTICS_COUNT(ChannelInternal, TxFailures);
+	}
+	if (CANNM_CFG_COM_USER_DATA_SUPPORT) {
+		Instance->Callbacks->PduRRxIndication(Instance, TxPduId, ChannelInternal->TxPduRef);
 	}
+	CANNM_TIMING_STOP(Instance, CANNM_TIMING_TX_CONFIRMATION);
 }
 
-/** @brief CanNm_TxConfirmation [SWS_CanNm_00231]
+/** @brief CanNm_InstanceRxIndication [SWS_CanNm_00231]
  *
  * Indication of a received PDU from a lower layer communication interface module.
  */
-void CanNm_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr)
+void CanNm_InstanceRxIndication(CanNm_InstanceType* Instance, PduIdType RxPduId, const PduInfoType* PduInfoPtr)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[RxPduId];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[RxPduId];
-
-	ChannelInternal->RxLastPdu = (ChannelInternal->RxLastPdu + 1) % (CANNM_RXPDU_MAX_COUNT);
-	memcpy(ChannelConf->RxPdu[ChannelInternal->RxLastPdu]->RxPduRef->SduDataPtr, PduInfoPtr->SduDataPtr,
-	 ChannelConf->RxPdu[ChannelInternal->RxLastPdu]->RxPduRef->SduLength);
+	CANNM_TIMING_START();
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[RxPduId];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[RxPduId];
+
+	CANNM_STATISTICS_COUNT(ChannelInternal, RxFrames);
+	CANNM_BUS_LOAD_COUNT(ChannelInternal, CANNM_BUS_LOAD_RX, PduInfoPtr->SduLength);
+	CANNM_PCAP(ChannelHot, ChannelInternal, CANNM_PCAP_RX_INDICATION, CANNM_PCAP_DROP_NONE, PduInfoPtr->SduDataPtr,
+		PduInfoPtr->SduLength);
+	ChannelInternal->RxLastPdu = (ChannelInternal->RxLastPdu + 1) % ChannelHot->RxPduCount;
+
+	/* A PDU of another length than configured is cut or padded with zeros, so the PDU kept and everything read from
+	 * it below stays inside the configured length */
+	uint8* rxSdu = ChannelInternal->RxPdu[ChannelInternal->RxLastPdu]->RxPduRef->SduDataPtr;
+	PduLengthType rxLength = (PduInfoPtr->SduLength < ChannelHot->RxSduLength) ? PduInfoPtr->SduLength :
+		ChannelHot->RxSduLength;
+	memcpy(rxSdu, PduInfoPtr->SduDataPtr, rxLength);
+	memset(rxSdu + rxLength, 0, ChannelHot->RxSduLength - rxLength);
+	CANNM_TRACE(ChannelInternal, CANNM_TRACE_RX,
+		(ChannelHot->PduCbvPosition != CANNM_PDU_OFF) ? rxSdu[ChannelHot->PduCbvPosition] : 0,
+		((ChannelHot->PduNidPosition != CANNM_PDU_OFF) ? rxSdu[ChannelHot->PduNidPosition] : 0) |
+		(((ChannelHot->PduNidPosition != CANNM_PDU_OFF) ? CANNM_TRACE_RX_NID_VALID : 0) << 8) |
+		(((ChannelHot->PduCbvPosition != CANNM_PDU_OFF) ? CANNM_TRACE_RX_CBV_VALID : 0) << 8) |
+		((uint32)RxPduId << 16));
 
 	boolean repeatMessageBitIndication = FALSE;
-	if (ChannelConf->PduCbvPosition != CANNM_PDU_OFF && ChannelConf->NodeDetectionEnabled) {
-		uint8 cbv = PduInfoPtr->SduDataPtr[ChannelConf->PduCbvPosition];
+	if (ChannelHot->PduCbvPosition != CANNM_PDU_OFF && ChannelHot->NodeDetectionEnabled) {
+		uint8 cbv = rxSdu[ChannelHot->PduCbvPosition];
 		repeatMessageBitIndication = cbv & (1 << REPEAT_MESSAGE_REQUEST);
 	}
 
 	if (ChannelInternal->Mode == NM_MODE_BUS_SLEEP) {
-		CanNm_Internal_BusSleep_to_BusSleep(ChannelConf, ChannelInternal);
-		Nm_NetworkStartIndication(RxPduId);
+		CanNm_Internal_BusSleep_to_BusSleep(ChannelHot, ChannelInternal);
+		CANNM_TRACE(ChannelInternal, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_NETWORK_START, 0);
+		Instance->Callbacks->NetworkStartIndication(Instance, RxPduId);
 	}
 	else if (ChannelInternal->Mode == NM_MODE_PREPARE_BUS_SLEEP) {
-		CanNm_Internal_PrepareBusSleep_to_RepeatMessage(ChannelConf, ChannelInternal);
+		CanNm_Internal_PrepareBusSleep_to_RepeatMessage(ChannelHot, ChannelInternal);
 	}
 	else if (ChannelInternal->Mode == NM_MODE_NETWORK) {
-		CanNm_Internal_NetworkMode_to_NetworkMode(ChannelConf, ChannelInternal);
+		CanNm_Internal_NetworkMode_to_NetworkMode(ChannelHot, ChannelInternal);
 		if (repeatMessageBitIndication) {
 			if (ChannelInternal->State == NM_STATE_READY_SLEEP) {
-				CanNm_Internal_ReadySleep_to_RepeatMessage(ChannelConf, ChannelInternal);
+				CanNm_Internal_ReadySleep_to_RepeatMessage(ChannelHot, ChannelInternal);
 			}
 			else if (ChannelInternal->State == NM_STATE_NORMAL_OPERATION) {
-				CanNm_Internal_NormalOperation_to_RepeatMessage(ChannelConf, ChannelInternal);
+				CanNm_Internal_NormalOperation_to_RepeatMessage(ChannelHot, ChannelInternal);
 			}
 			else {
 				//Nothing to do
@@ -712,10 +967,11 @@ void CanNm_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr)
 		}
 		if (ChannelInternal->RemoteSleepInd) {
 			ChannelInternal->RemoteSleepInd = FALSE;
-			Nm_RemoteSleepCancellation(RxPduId);											//[SWS_CanNm_00151]
+			CANNM_TRACE(ChannelInternal, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_REMOTE_SLEEP_CANCEL, 0);
+			Instance->Callbacks->RemoteSleepCancellation(Instance, RxPduId);											//[SWS_CanNm_00151]
 		}
 		else if (ChannelInternal->RemoteSleepIndEnabled) {
-			CanNm_Internal_TimerStart(&ChannelInternal->RemoteSleepIndTimer, ChannelConf->RemoteSleepIndTime);
+			CanNm_Internal_TimerStart(&ChannelInternal->RemoteSleepIndTimer, ChannelHot->RemoteSleepIndTicks);
 		}
 		else {
 			//Nothing to do
@@ -725,30 +981,31 @@ void CanNm_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr)
 		//Nothing to do
 	}
 
-	if (ChannelInternal->BusLoadReduction) {
-		CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelConf->MsgReducedTime);	//[SWS_CanNm_00069]
+	if (ChannelInternal->BusLoadReduction && ChannelInternal->State == NM_STATE_NORMAL_OPERATION) {	//Reduced cycle only here
+		CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelHot->MsgReducedTicks);	//[SWS_CanNm_00069]
 	}
 
-	if (CanNm_ConfigPtr->PduRxIndicationEnabled) {
-		Nm_PduRxIndication(RxPduId);																	//[SWS_CanNm_00037]
+	if (CANNM_CFG_PDU_RX_INDICATION_ENABLED) {
+		Instance->Callbacks->PduRxIndication(Instance, RxPduId);																	//[SWS_CanNm_00037]
 	}
+	CANNM_TIMING_STOP(Instance, CANNM_TIMING_RX_INDICATION);
 }
 
-/** @brief CanNm_ConfirmPnAvailability [SWS_CanNm_00344]
+/** @brief CanNm_InstanceConfirmPnAvailability [SWS_CanNm_00344]
  *
  * Enables the PN filter functionality on the indicated NM channel.
  * Availability: The API is only available if CanNmGlobalPnSupport is TRUE.
  */
-void CanNm_ConfirmPnAvailability(NetworkHandleType nmChannelHandle)
+void CanNm_InstanceConfirmPnAvailability(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[nmChannelHandle];
 
-    if (CanNm_ConfigPtr->GlobalPnSupport) {
+    if (CANNM_CFG_GLOBAL_PN_SUPPORT) {
 		ChannelInternal->NmPduFilterAlgorithm = TRUE;
 	}
 }
 
-/** @brief CanNm_TriggerTransmit [SWS_CanNm_91001]
+/** @brief CanNm_InstanceTriggerTransmit [SWS_CanNm_91001]
  *
  * Within this API, the upper layer module (called module) shall check whether the
  * available data fits into the buffer size reported by PduInfoPtr->SduLength.
@@ -756,375 +1013,918 @@ void CanNm_ConfirmPnAvailability(NetworkHandleType nmChannelHandle)
  * and update the length of the actual copied data in PduInfoPtr->SduLength.
  * If not, it returns E_NOT_OK without changing PduInfoPtr.
  */
-Std_ReturnType CanNm_TriggerTransmit(PduIdType TxPduId, PduInfoType* PduInfoPtr)
+Std_ReturnType CanNm_InstanceTriggerTransmit(CanNm_InstanceType* Instance, PduIdType TxPduId, PduInfoType* PduInfoPtr)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[TxPduId];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[TxPduId];
-
-	if (ChannelConf->TxPdu->TxPduRef->SduLength <= PduInfoPtr->SduLength) {
-		memcpy(PduInfoPtr->SduDataPtr, ChannelConf->TxPdu->TxPduRef->SduDataPtr, ChannelConf->TxPdu->TxPduRef->SduLength);
-		PduInfoPtr->SduLength = ChannelConf->TxPdu->TxPduRef->SduLength;
-		return E_OK;
-	} else {
-		return E_NOT_OK;
+	CANNM_TIMING_START();
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[TxPduId];
+	CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[TxPduId];
+	Std_ReturnType status = E_NOT_OK;
+
+	if (ChannelHot->TxSduLength <= PduInfoPtr->SduLength) {
+		memcpy(PduInfoPtr->SduDataPtr, ChannelInternal->TxPduRef->SduDataPtr, ChannelHot->TxSduLength);
+		PduInfoPtr->SduLength = ChannelHot->TxSduLength;
+		status = E_OK;
 	}
+	CANNM_PCAP(ChannelHot, ChannelInternal, CANNM_PCAP_TRIGGER_TRANSMIT,
+		(status == E_OK) ? CANNM_PCAP_DROP_NONE : CANNM_PCAP_DROP_BUFFER_TOO_SMALL,
+		ChannelInternal->TxPduRef->SduDataPtr, ChannelHot->TxSduLength);
+	CANNM_TIMING_STOP(Instance, CANNM_TIMING_TRIGGER_TRANSMIT);
+	return status;
 }
 
-/** @brief CanNm_MainFunction [SWS_CanNm_00234]
+/** @brief CanNm_InstanceMainFunction [SWS_CanNm_00234]
  *
- * Main function of the CanNm.
+ * Main function of the CanNm instance.
  */
-void CanNm_MainFunction(void)
+void CanNm_InstanceMainFunction(CanNm_InstanceType* Instance)
 {
-	for (uint8 channel = 0; channel < CANNM_CHANNEL_COUNT; channel++) {
-		CanNm_Internal_TimerTick(&CanNm_Internal.Channels[channel].TimeoutTimer, channel, CanNm_ConfigPtr->MainFunctionPeriod);			//[SWS_CanNm_00089]
-		CanNm_Internal_TimerTick(&CanNm_Internal.Channels[channel].MessageCycleTimer, channel, CanNm_ConfigPtr->MainFunctionPeriod);
-		CanNm_Internal_TimerTick(&CanNm_Internal.Channels[channel].RepeatMessageTimer, channel, CanNm_ConfigPtr->MainFunctionPeriod);
-		CanNm_Internal_TimerTick(&CanNm_Internal.Channels[channel].WaitBusSleepTimer, channel, CanNm_ConfigPtr->MainFunctionPeriod);
-		CanNm_Internal_TimerTick(&CanNm_Internal.Channels[channel].RepeatMessageTimer, channel, CanNm_ConfigPtr->MainFunctionPeriod);
+	CANNM_TIMING_START();
+
+	/* Checked with a single read first, so the exclusive area is only entered with a switch pending. Taken in one
+	 * step, a switch requested meanwhile is applied at the next main function instead of lost. */
+	if (*(const CanNm_ConfigType* volatile*)&Instance->PendingConfigPtr != NULL) {
+		SchM_Enter_CanNm_CANNM_EXCLUSIVE_AREA_0();
+		const CanNm_ConfigType* PendingConfigPtr = Instance->PendingConfigPtr;
+		Instance->PendingConfigPtr = NULL;
+		SchM_Exit_CanNm_CANNM_EXCLUSIVE_AREA_0();
+		CanNm_Internal_ApplyConfig(Instance, PendingConfigPtr);
 	}
-}
 
-/*====================================================================================================================*\
-    Local functions (static) code
-\*====================================================================================================================*/
+	for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[channel];
+
+		CanNm_Internal_TimerTick(&ChannelInternal->TimeoutTimer, ChannelInternal);					//[SWS_CanNm_00089]
+		CanNm_Internal_TimerTick(&ChannelInternal->MessageCycleTimer, ChannelInternal);
+		CanNm_Internal_TimerTick(&ChannelInternal->RepeatMessageTimer, ChannelInternal);
+		CanNm_Internal_TimerTick(&ChannelInternal->WaitBusSleepTimer, ChannelInternal);
+		CanNm_Internal_TimerTick(&ChannelInternal->RepeatMessageTimer, ChannelInternal);
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+		CanNm_Internal_BusLoadTick(&ChannelInternal->BusLoad[CANNM_BUS_LOAD_RX]);
+		CanNm_Internal_BusLoadTick(&ChannelInternal->BusLoad[CANNM_BUS_LOAD_TX]);
+#endif
+	}
+	CANNM_TIMING_STOP(Instance, CANNM_TIMING_MAIN_FUNCTION);
+}
 
-/*******************/
-/* Timer functions */
-/*******************/
-static inline void CanNm_Internal_TimerStart( CanNm_Timer* Timer, uint32 timeoutValue )
+/** @brief CanNm_InstanceTicksToNextEvent
+ *
+ * Number of CanNm_InstanceMainFunction calls up to and including the first one that can change more than timer
+ * counts, CANNM_TICKS_INFINITE if no timer runs. API calls and received frames may bring the next event forward.
+ */
+uint32 CanNm_InstanceTicksToNextEvent(const CanNm_InstanceType* Instance)
 {
-	Timer->State = CANNM_TIMER_STARTED;
-	Timer->TimeLeft = timeoutValue;	//[SWS_CanNm_00206]
+	uint32 ticks = CANNM_TICKS_INFINITE;
+
+	if (*(const CanNm_ConfigType* const volatile*)&Instance->PendingConfigPtr != NULL) {
+		return 1;
+	}
+	for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		const CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[channel];
+
+		ticks = CanNm_Internal_TimerTicksToExpiry(&ChannelInternal->TimeoutTimer, 1, ticks);
+		ticks = CanNm_Internal_TimerTicksToExpiry(&ChannelInternal->MessageCycleTimer, 1, ticks);
+		ticks = CanNm_Internal_TimerTicksToExpiry(&ChannelInternal->RepeatMessageTimer, 2, ticks);
+		ticks = CanNm_Internal_TimerTicksToExpiry(&ChannelInternal->WaitBusSleepTimer, 1, ticks);
+	}
+	return ticks;
 }
 
-static inline void CanNm_Internal_TimerResume( CanNm_Timer* Timer )
+/** @brief CanNm_InstanceSkipTicks
+ *
+ * Same effect as ticks calls of CanNm_InstanceMainFunction that expire no timer, ticks must be less than
+ * CanNm_InstanceTicksToNextEvent. Lets a simulation or a tickless scheduler jump over idle periods.
+ */
+void CanNm_InstanceSkipTicks(CanNm_InstanceType* Instance, uint32 ticks)
 {
-	Timer->State = CANNM_TIMER_STARTED;
+	for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[channel];
+
+		CanNm_Internal_TimerSkip(&ChannelInternal->TimeoutTimer, ticks);
+		CanNm_Internal_TimerSkip(&ChannelInternal->MessageCycleTimer, ticks);
+		CanNm_Internal_TimerSkip(&ChannelInternal->RepeatMessageTimer, 2 * ticks);
+		CanNm_Internal_TimerSkip(&ChannelInternal->WaitBusSleepTimer, ticks);
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+		CanNm_Internal_BusLoadDecay(&ChannelInternal->BusLoad[CANNM_BUS_LOAD_RX], ticks);
+		CanNm_Internal_BusLoadDecay(&ChannelInternal->BusLoad[CANNM_BUS_LOAD_TX], ticks);
+#endif
+	}
 }
 
-static inline void CanNm_Internal_TimerStop( CanNm_Timer* Timer )
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+/** @brief CanNm_InstanceGetStatistics
+ *
+ * Copy the statistics counters of a channel. Call it from the context of the main function, or the copy may mix
+ * counts from before and after a concurrent CanNm call.
+ */
+Std_ReturnType CanNm_InstanceGetStatistics(const CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 											CanNm_StatisticsType* statisticsPtr)
 {
-	Timer->State = CANNM_TIMER_STOPPED;
+	if (Instance->InitStatus != CANNM_INIT || nmChannelHandle >= Instance->ChannelCount || statisticsPtr == NULL) {
+		return E_NOT_OK;
+	}
+	*statisticsPtr = Instance->Channels[nmChannelHandle].Statistics;
+	return E_OK;
 }
 
-static inline void CanNm_Internal_TimerReset( CanNm_Timer* Timer, uint32 timeoutValue )
+/** @brief CanNm_InstanceResetStatistics
+ *
+ * Set all statistics counters of a channel to 0.
+ */
+Std_ReturnType CanNm_InstanceResetStatistics(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	Timer->State = CANNM_TIMER_STOPPED;
-	Timer->TimeLeft = timeoutValue;
+	if (Instance->InitStatus != CANNM_INIT || nmChannelHandle >= Instance->ChannelCount) {
+		return E_NOT_OK;
+	}
+	memset(&Instance->Channels[nmChannelHandle].Statistics, 0, sizeof(CanNm_StatisticsType));
+	return E_OK;
 }
+#endif
 
-static inline void CanNm_Internal_TimerTick( CanNm_Timer* Timer, const uint8 channel, const float32 period )
+#if (CANNM_TIMING_ENABLED == STD_ON)
+/** @brief CanNm_InstanceGetTiming
+ *
+ * Count, mean, p50, p99 and maximum execution time of one of the CANNM_TIMING_* functions, in cycles of
+ * CANNM_TIMING_CYCLES. Like the statistics, read it from the context of the main function.
+ */
+Std_ReturnType CanNm_InstanceGetTiming(const CanNm_InstanceType* Instance, uint8 function,
+ 										CanNm_TimingSummaryType* timingPtr)
 {
-	if (Timer->State == CANNM_TIMER_STARTED) {
-		if (period >= Timer->TimeLeft) {
-			CanNm_Internal_TimerStop(Timer);
-			Timer->ExpiredCallback(Timer, channel);
-		}
-		else {
-			Timer->TimeLeft -= period;
-		}
-	}
-	else {
-		//Nothing to do
+	if (Instance->InitStatus != CANNM_INIT || function >= CANNM_TIMING_FUNCTION_COUNT || timingPtr == NULL) {
+		return E_NOT_OK;
 	}
+	CanNm_TimingSummary(&Instance->Timing[function], timingPtr);
+	return E_OK;
 }
 
-static inline void CanNm_Internal_TimersInit( uint8 channel )
+/** @brief CanNm_InstanceResetTiming
+ *
+ * Empty the histograms of all timed functions.
+ */
+void CanNm_InstanceResetTiming(CanNm_InstanceType* Instance)
 {
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[channel];
-
-	ChannelInternal->TimeoutTimer.Channel = channel;
-	ChannelInternal->TimeoutTimer.ExpiredCallback = CanNm_Internal_TimeoutTimerExpiredCallback;
-	ChannelInternal->TimeoutTimer.State = CANNM_TIMER_STOPPED;
-	ChannelInternal->TimeoutTimer.TimeLeft = 0;
-
-	ChannelInternal->MessageCycleTimer.Channel = channel;
-	ChannelInternal->MessageCycleTimer.ExpiredCallback = CanNm_Internal_MessageCycleTimerExpiredCallback;
-	ChannelInternal->MessageCycleTimer.State = CANNM_TIMER_STOPPED;
-	ChannelInternal->MessageCycleTimer.TimeLeft = 0;
+	memset(Instance->Timing, 0, sizeof(Instance->Timing));
+}
+#endif
 
-	ChannelInternal->RepeatMessageTimer.Channel = channel;
-	ChannelInternal->RepeatMessageTimer.ExpiredCallback = CanNm_Internal_RepeatMessageTimerExpiredCallback;
-	ChannelInternal->RepeatMessageTimer.State = CANNM_TIMER_STOPPED;
-	ChannelInternal->RepeatMessageTimer.TimeLeft = 0;
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+/** @brief CanNm_InstanceGetBusLoad
+ *
+ * NM frames and bits per second of a channel, received and transmitted, averaged over the last
+ * 2^CANNM_BUS_LOAD_WINDOW_SHIFT main function periods.
+ */
+Std_ReturnType CanNm_InstanceGetBusLoad(const CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 										CanNm_BusLoadType* busLoadPtr)
+{
+	if (Instance->InitStatus != CANNM_INIT || nmChannelHandle >= Instance->ChannelCount || busLoadPtr == NULL) {
+		return E_NOT_OK;
+	}
 
-	ChannelInternal->WaitBusSleepTimer.Channel = channel;
-	ChannelInternal->WaitBusSleepTimer.ExpiredCallback = CanNm_Internal_WaitBusSleepTimerExpiredCallback;
-	ChannelInternal->WaitBusSleepTimer.State = CANNM_TIMER_STOPPED;
-	ChannelInternal->WaitBusSleepTimer.TimeLeft = 0;
+	const CanNm_Internal_BusLoadType* BusLoad = Instance->Channels[nmChannelHandle].BusLoad;
+	float32 scale = CANNM_BUS_LOAD_TIME_UNITS_PER_SECOND / CANNM_CFG_MAIN_FUNCTION_PERIOD / (float32)CANNM_BUS_LOAD_ONE;
 
-	ChannelInternal->RemoteSleepIndTimer.Channel = channel;
-	ChannelInternal->RemoteSleepIndTimer.ExpiredCallback = CanNm_Internal_RemoteSleepIndTimerExpiredCallback;
-	ChannelInternal->RemoteSleepIndTimer.State = CANNM_TIMER_STOPPED;
-	ChannelInternal->RemoteSleepIndTimer.TimeLeft = 0;
+	busLoadPtr->RxFramesPerSecond = (float32)BusLoad[CANNM_BUS_LOAD_RX].FrameRate * scale;
+	busLoadPtr->RxBitsPerSecond = (float32)BusLoad[CANNM_BUS_LOAD_RX].BitRate * scale;
+	busLoadPtr->TxFramesPerSecond = (float32)BusLoad[CANNM_BUS_LOAD_TX].FrameRate * scale;
+	busLoadPtr->TxBitsPerSecond = (float32)BusLoad[CANNM_BUS_LOAD_TX].BitRate * scale;
+	return E_OK;
 }
+#endif
 
-static inline void CanNm_Internal_TimeoutTimerExpiredCallback( void* Timer, const uint8 channel )
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+/** @brief CanNm_InstanceGetWakeupLatency
+ *
+ * Copy the wake-up latency histograms of a channel, to be reduced with CanNm_TimingSummary or
+ * CanNm_TimingPercentile. Like the statistics, read them from the context of the main function.
+ */
+Std_ReturnType CanNm_InstanceGetWakeupLatency(const CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 												CanNm_WakeupLatencyType* latencyPtr)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[channel];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[channel];
-
-	if (ChannelInternal->State == NM_STATE_REPEAT_MESSAGE) {
-		Nm_TxTimeoutException(ChannelInternal->Channel);
-		CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelConf->TimeoutTime);
-	} else if (ChannelInternal->State == NM_STATE_NORMAL_OPERATION) {
-		Nm_TxTimeoutException(ChannelInternal->Channel);
-		CanNm_Internal_NormalOperation_to_NormalOperation(ChannelConf, ChannelInternal);
-	} else if (ChannelInternal->State == NM_STATE_READY_SLEEP) {
-		if (ChannelConf->ActiveWakeupBitEnabled) {
-			CanNm_Internal_ClearPduCbvBit(ChannelConf, ACTIVE_WAKEUP_BIT);
-		}
-		CanNm_Internal_ReadySleep_to_PrepareBusSleep(ChannelConf, ChannelInternal);
-	} else {
-		//Nothing to be done
+	if (Instance->InitStatus != CANNM_INIT || nmChannelHandle >= Instance->ChannelCount || latencyPtr == NULL) {
+		return E_NOT_OK;
 	}
+	*latencyPtr = Instance->Channels[nmChannelHandle].WakeupLatency;
+	return E_OK;
 }
 
-static inline void CanNm_Internal_MessageCycleTimerExpiredCallback( void* Timer, const uint8 channel )
+/** @brief CanNm_InstanceResetWakeupLatency
+ *
+ * Empty the wake-up latency histograms of a channel. A wake-up in progress is still counted.
+ */
+Std_ReturnType CanNm_InstanceResetWakeupLatency(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[channel];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[channel];
-	Std_ReturnType txStatus = E_OK;
-	static Std_ReturnType lastTxStatus;
-
-	if ((ChannelInternal->State == NM_STATE_REPEAT_MESSAGE) || (ChannelInternal->State == NM_STATE_NORMAL_OPERATION)) {
-		txStatus = CanNm_Internal_TransmitMessage(ChannelConf, ChannelInternal);
-		if (ChannelInternal->ImmediateTransmissions) {
-			if (txStatus == E_NOT_OK) {
-				if (lastTxStatus == E_NOT_OK) {
-					ChannelInternal->ImmediateTransmissions = 0;
-					CanNm_Internal_TimerStart((CanNm_Timer*)Timer, ChannelConf->MsgCycleTime);
-				}
-				else {
-					CanNm_Internal_TimerStart((CanNm_Timer*)Timer, 1);
-				}
-			}
-			else {
-				CanNm_Internal_TimerStart((CanNm_Timer*)Timer, ChannelConf->ImmediateNmCycleTime);
-				ChannelInternal->ImmediateTransmissions--;
-			}
-		}
-		else {
-			CanNm_Internal_TimerStart((CanNm_Timer*)Timer, ChannelConf->MsgCycleTime);
-		}
+	if (Instance->InitStatus != CANNM_INIT || nmChannelHandle >= Instance->ChannelCount) {
+		return E_NOT_OK;
 	}
-	lastTxStatus = txStatus;
+	memset(&Instance->Channels[nmChannelHandle].WakeupLatency, 0, sizeof(CanNm_WakeupLatencyType));
+	return E_OK;
 }
+#endif
 
-static inline void CanNm_Internal_RepeatMessageTimerExpiredCallback( void* Timer, const uint8 channel )
-{
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[channel];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[channel];
+/*====================================================================================================================*\
+    Global API on the default instance CanNm_Internal
+\*====================================================================================================================*/
 
-	if (ChannelInternal->State == NM_STATE_REPEAT_MESSAGE) {
-		if (ChannelInternal->Requested) {
-			CanNm_Internal_RepeatMessage_to_NormalOperation(ChannelConf, ChannelInternal);
-		} else {
-			CanNm_Internal_RepeatMessage_to_ReadySleep(ChannelConf, ChannelInternal);
-		}
+/** @brief CanNm_Init [SWS_CanNm_00208]
+ *
+ * Initialize the CanNm module. A configuration with a channel without Rx PDU is rejected, the module is left
+ * uninitialized then. With CANNM_GENERATED_CFG there is no RAM to derive the ChannelHot table into, so a
+ * configuration without it is rejected as well.
+ */
+void CanNm_Init(const CanNm_ConfigType* cannmConfigPtr)
+{
+#ifdef CANNM_GENERATED_CFG
+	if (cannmConfigPtr == NULL || cannmConfigPtr->ChannelHot == NULL ||
+		!CanNm_Internal_ConfigRxPduValid(cannmConfigPtr, CANNM_CHANNEL_COUNT)) {
+#else
+	if (cannmConfigPtr == NULL || !CanNm_Internal_ConfigRxPduValid(cannmConfigPtr, CANNM_CHANNEL_COUNT)) {
+#endif
+		CanNm_Internal.InitStatus = CANNM_UNINIT;
+		return;
 	}
+	CanNm_Internal.ChannelCount = CANNM_CHANNEL_COUNT;
+	CanNm_Internal.Channels = CanNm_ChannelStorage;
+#ifdef CANNM_GENERATED_CFG
+	CanNm_Internal.ChannelHotBank[0] = NULL;
+	CanNm_Internal.ChannelHotBank[1] = NULL;
+#else
+	CanNm_Internal.ChannelHotBank[0] = CanNm_ChannelHot;
+	CanNm_Internal.ChannelHotBank[1] = CanNm_ChannelHotSwap;
+#endif
+	CanNm_Internal_Init(&CanNm_Internal, cannmConfigPtr);
 }
 
-static inline void CanNm_Internal_WaitBusSleepTimerExpiredCallback( void* Timer, const uint8 channel )
+/** @brief CanNm_InitArena
+ *
+ * Initialize the CanNm module for cannmConfigPtr->ChannelCount channels, with the channel state in the caller
+ * supplied arena instead of the CANNM_CHANNEL_COUNT sized storage. The configuration must carry the ChannelHot and
+ * ChannelPdu tables, the arena must be aligned to CANNM_ARENA_ALIGN and CanNm_ChannelArenaSize bytes long.
+ */
+Std_ReturnType CanNm_InitArena(const CanNm_ConfigType* cannmConfigPtr, void* arena, uint32 arenaSize)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[channel];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[channel];
-
-	if (ChannelInternal->Mode == NM_MODE_PREPARE_BUS_SLEEP) {
-		CanNm_Internal_PrepareBusSleep_to_BusSleep(ChannelConf, ChannelInternal);					//[SWS_CanNm_00088]
+	if (cannmConfigPtr == NULL || cannmConfigPtr->ChannelHot == NULL || cannmConfigPtr->ChannelPdu == NULL ||
+		cannmConfigPtr->ChannelCount == 0) {
+		return E_NOT_OK;
 	}
+	return CanNm_InstanceInit(&CanNm_Internal, cannmConfigPtr, arena, arenaSize);
 }
 
-static inline void CanNm_Internal_RemoteSleepIndTimerExpiredCallback( void* Timer, const uint8 channel )
+/** @brief CanNm_DeInit [SWS_CanNm_91002] */
+void CanNm_DeInit(void)
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[channel];
-	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[channel];
+	CanNm_InstanceDeInit(&CanNm_Internal);
+}
 
-	ChannelInternal->RemoteSleepInd = TRUE;
-	Nm_RemoteSleepInd(channel);
-	CanNm_Internal_TimerStart(Timer, ChannelConf->RemoteSleepIndTime);								//[SWS_CanNm_00150]
+/** @brief CanNm_SwitchConfig
+ *
+ * Replace the configuration of the module at the next CanNm_MainFunction, see CanNm_InstanceSwitchConfig.
+ */
+Std_ReturnType CanNm_SwitchConfig(const CanNm_ConfigType* cannmConfigPtr)
+{
+	return CanNm_InstanceSwitchConfig(&CanNm_Internal, cannmConfigPtr);
 }
 
-/***************************/
+/** @brief CanNm_PassiveStartUp [SWS_CanNm_00211] */
+Std_ReturnType CanNm_PassiveStartUp(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstancePassiveStartUp(&CanNm_Internal, nmChannelHandle);
+}
+
+/** @brief CanNm_NetworkRequest [SWS_CanNm_00213] */
+Std_ReturnType CanNm_NetworkRequest(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstanceNetworkRequest(&CanNm_Internal, nmChannelHandle);
+}
+
+/** @brief CanNm_NetworkRelease [SWS_CanNm_00214] */
+Std_ReturnType CanNm_NetworkRelease(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstanceNetworkRelease(&CanNm_Internal, nmChannelHandle);
+}
+
+/** @brief CanNm_DisableCommunication [SWS_CanNm_00215] */
+Std_ReturnType CanNm_DisableCommunication(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstanceDisableCommunication(&CanNm_Internal, nmChannelHandle);
+}
+
+/** @brief CanNm_EnableCommunication [SWS_CanNm_00216] */
+Std_ReturnType CanNm_EnableCommunication(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstanceEnableCommunication(&CanNm_Internal, nmChannelHandle);
+}
+
+/** @brief CanNm_SetUserData [SWS_CanNm_00217] */
+Std_ReturnType CanNm_SetUserData(NetworkHandleType nmChannelHandle, const uint8* nmUserDataPtr)
+{
+	return CanNm_InstanceSetUserData(&CanNm_Internal, nmChannelHandle, nmUserDataPtr);
+}
+
+/** @brief CanNm_GetUserData [SWS_CanNm_00218] */
+Std_ReturnType CanNm_GetUserData(NetworkHandleType nmChannelHandle, uint8* nmUserDataPtr)
+{
+	return CanNm_InstanceGetUserData(&CanNm_Internal, nmChannelHandle, nmUserDataPtr);
+}
+
+/** @brief CanNm_Transmit [SWS_CanNm_00331] */
+Std_ReturnType CanNm_Transmit(PduIdType TxPduId, const PduInfoType* PduInfoPtr)
+{
+	return CanNm_InstanceTransmit(&CanNm_Internal, TxPduId, PduInfoPtr);
+}
+
+/** @brief CanNm_GetNodeIdentifier [SWS_CanNm_00219] */
+Std_ReturnType CanNm_GetNodeIdentifier(NetworkHandleType nmChannelHandle, uint8*nmNodeIdPtr)
+{
+	return CanNm_InstanceGetNodeIdentifier(&CanNm_Internal, nmChannelHandle, nmNodeIdPtr);
+}
+
+/** @brief CanNm_GetLocalNodeIdentifier [SWS_CanNm_00220] */
+Std_ReturnType CanNm_GetLocalNodeIdentifier(NetworkHandleType nmChannelHandle, uint8* nmNodeIdPtr)
+{
+	return CanNm_InstanceGetLocalNodeIdentifier(&CanNm_Internal, nmChannelHandle, nmNodeIdPtr);
+}
+
+/** @brief CanNm_RepeatMessageRequest [SWS_CanNm_00221] */
+Std_ReturnType CanNm_RepeatMessageRequest(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstanceRepeatMessageRequest(&CanNm_Internal, nmChannelHandle);
+}
+
+/** @brief CanNm_GetPduData [SWS_CanNm_00222] */
+Std_ReturnType CanNm_GetPduData(NetworkHandleType nmChannelHandle, uint8* nmPduDataPtr)
+{
+	return CanNm_InstanceGetPduData(&CanNm_Internal, nmChannelHandle, nmPduDataPtr);
+}
+
+/** @brief CanNm_GetState [SWS_CanNm_00223] */
+Std_ReturnType CanNm_GetState(NetworkHandleType nmChannelHandle, Nm_StateType* nmStatePtr, Nm_ModeType* nmModePtr)
+{
+	return CanNm_InstanceGetState(&CanNm_Internal, nmChannelHandle, nmStatePtr, nmModePtr);
+}
+
+/** @brief CanNm_RequestBusSynchronization [SWS_CanNm_00226] */
+Std_ReturnType CanNm_RequestBusSynchronization(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstanceRequestBusSynchronization(&CanNm_Internal, nmChannelHandle);
+}
+
+/** @brief CanNm_CheckRemoteSleepInd [SWS_CanNm_00227] */
+Std_ReturnType CanNm_CheckRemoteSleepInd(NetworkHandleType nmChannelHandle, boolean* nmRemoteSleepIndPtr)
+{
+	return CanNm_InstanceCheckRemoteSleepInd(&CanNm_Internal, nmChannelHandle, nmRemoteSleepIndPtr);
+}
+
+/** @brief CanNm_SetSleepReadyBit [SWS_CanNm_00338] */
+Std_ReturnType CanNm_SetSleepReadyBit(NetworkHandleType nmChannelHandle,boolean nmSleepReadyBit)
+{
+	return CanNm_InstanceSetSleepReadyBit(&CanNm_Internal, nmChannelHandle, nmSleepReadyBit);
+}
+
+/** @brief CanNm_TxConfirmation [SWS_CanNm_00228] */
+void CanNm_TxConfirmation(PduIdType TxPduId, Std_ReturnType result)
+{
+	CanNm_InstanceTxConfirmation(&CanNm_Internal, TxPduId, result);
+}
+
+/** @brief CanNm_RxIndication [SWS_CanNm_00231] */
+void CanNm_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr)
+{
+	CanNm_InstanceRxIndication(&CanNm_Internal, RxPduId, PduInfoPtr);
+}
+
+/** @brief CanNm_ConfirmPnAvailability [SWS_CanNm_00344] */
+void CanNm_ConfirmPnAvailability(NetworkHandleType nmChannelHandle)
+{
+	CanNm_InstanceConfirmPnAvailability(&CanNm_Internal, nmChannelHandle);
+}
+
+/** @brief CanNm_TriggerTransmit [SWS_CanNm_91001] */
+Std_ReturnType CanNm_TriggerTransmit(PduIdType TxPduId, PduInfoType* PduInfoPtr)
+{
+	return CanNm_InstanceTriggerTransmit(&CanNm_Internal, TxPduId, PduInfoPtr);
+}
+
+/** @brief CanNm_MainFunction [SWS_CanNm_00234] */
+void CanNm_MainFunction(void)
+{
+	CanNm_InstanceMainFunction(&CanNm_Internal);
+}
+
+/** @brief CanNm_TicksToNextEvent */
+uint32 CanNm_TicksToNextEvent(void)
+{
+	return CanNm_InstanceTicksToNextEvent(&CanNm_Internal);
+}
+
+/** @brief CanNm_SkipTicks */
+void CanNm_SkipTicks(uint32 ticks)
+{
+	CanNm_InstanceSkipTicks(&CanNm_Internal, ticks);
+}
+
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+/** @brief CanNm_GetStatistics */
+Std_ReturnType CanNm_GetStatistics(NetworkHandleType nmChannelHandle, CanNm_StatisticsType* statisticsPtr)
+{
+	return CanNm_InstanceGetStatistics(&CanNm_Internal, nmChannelHandle, statisticsPtr);
+}
+
+/** @brief CanNm_ResetStatistics */
+Std_ReturnType CanNm_ResetStatistics(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstanceResetStatistics(&CanNm_Internal, nmChannelHandle);
+}
+#endif
+
+#if (CANNM_TIMING_ENABLED == STD_ON)
+/** @brief CanNm_GetTiming */
+Std_ReturnType CanNm_GetTiming(uint8 function, CanNm_TimingSummaryType* timingPtr)
+{
+	return CanNm_InstanceGetTiming(&CanNm_Internal, function, timingPtr);
+}
+
+/** @brief CanNm_ResetTiming */
+void CanNm_ResetTiming(void)
+{
+	CanNm_InstanceResetTiming(&CanNm_Internal);
+}
+#endif
+
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+/** @brief CanNm_GetBusLoad */
+Std_ReturnType CanNm_GetBusLoad(NetworkHandleType nmChannelHandle, CanNm_BusLoadType* busLoadPtr)
+{
+	return CanNm_InstanceGetBusLoad(&CanNm_Internal, nmChannelHandle, busLoadPtr);
+}
+#endif
+
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+/** @brief CanNm_GetWakeupLatency */
+Std_ReturnType CanNm_GetWakeupLatency(NetworkHandleType nmChannelHandle, CanNm_WakeupLatencyType* latencyPtr)
+{
+	return CanNm_InstanceGetWakeupLatency(&CanNm_Internal, nmChannelHandle, latencyPtr);
+}
+
+/** @brief CanNm_ResetWakeupLatency */
+Std_ReturnType CanNm_ResetWakeupLatency(NetworkHandleType nmChannelHandle)
+{
+	return CanNm_InstanceResetWakeupLatency(&CanNm_Internal, nmChannelHandle);
+}
+#endif
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+/*******************/
+/* Timer functions */
+/*******************/
+static inline void CanNm_Internal_TimerStart( CanNm_Timer* Timer, uint32 timeoutValue )
+{
+	Timer->State = CANNM_TIMER_STARTED;
+	Timer->TimeLeft = timeoutValue;	//[SWS_CanNm_00206]
+#if (CANNM_TRACE_ENABLED == STD_ON)
+	CanNm_Internal_TraceTimer(Timer, CANNM_TRACE_TIMER_START, timeoutValue);
+#endif
+}
+
+static inline void CanNm_Internal_TimerResume( CanNm_Timer* Timer )
+{
+	Timer->State = CANNM_TIMER_STARTED;
+}
+
+static inline void CanNm_Internal_TimerStop( CanNm_Timer* Timer )
+{
+#if (CANNM_TRACE_ENABLED == STD_ON)
+	if (Timer->State == CANNM_TIMER_STARTED) {
+		CanNm_Internal_TraceTimer(Timer, CANNM_TRACE_TIMER_STOP, Timer->TimeLeft);
+	}
+#endif
+	Timer->State = CANNM_TIMER_STOPPED;
+}
+
+static inline void CanNm_Internal_TimerReset( CanNm_Timer* Timer, uint32 timeoutValue )
+{
+	Timer->State = CANNM_TIMER_STOPPED;
+	Timer->TimeLeft = timeoutValue;
+}
+
+static inline void CanNm_Internal_TimerClamp( CanNm_Timer* Timer, uint32 timeoutValue )
+{
+	if (Timer->TimeLeft > timeoutValue) {
+		Timer->TimeLeft = timeoutValue;
+	}
+}
+
+static inline void CanNm_Internal_TimerTick( CanNm_Timer* Timer, CanNm_Internal_ChannelType* ChannelInternal )
+{
+	if (Timer->State == CANNM_TIMER_STARTED) {
+		if (Timer->TimeLeft <= 1) {
+			Timer->State = CANNM_TIMER_STOPPED;
+			CANNM_TRACE(ChannelInternal, CANNM_TRACE_TIMER_EXPIRED, Timer->Id, 0);
+			Timer->ExpiredCallback(Timer, ChannelInternal);
+		}
+		else {
+			Timer->TimeLeft--;
+		}
+	}
+	else {
+		//Nothing to do
+	}
+}
+
+/** @brief CanNm_Internal_TimerTicksToExpiry
+ *
+ * Minimum of ticks and the main function call that expires Timer, ticked ticksPerCall times per call.
+ */
+static inline uint32 CanNm_Internal_TimerTicksToExpiry( const CanNm_Timer* Timer, uint8 ticksPerCall, uint32 ticks )
+{
+	if (Timer->State == CANNM_TIMER_STARTED) {
+		uint32 calls = (Timer->TimeLeft <= 1) ? 1 : (Timer->TimeLeft + ticksPerCall - 1) / ticksPerCall;
+		if (calls < ticks) {
+			ticks = calls;
+		}
+	}
+	return ticks;
+}
+
+static inline void CanNm_Internal_TimerSkip( CanNm_Timer* Timer, uint32 ticks )
+{
+	if (Timer->State == CANNM_TIMER_STARTED) {
+		Timer->TimeLeft -= ticks;
+	}
+}
+
+static inline uint32 CanNm_Internal_TimeToTicks( const float32 time, const float32 period )
+{
+	uint32 ticks = (uint32)(time / period);
+	if ((float32)ticks * period < time) {
+		ticks++;																					//Round up, a timer never expires early
+	}
+	return ticks;
+}
+
+static inline void CanNm_Internal_TimersInit( CanNm_Internal_ChannelType* ChannelInternal )
+{
+	ChannelInternal->TimeoutTimer.ExpiredCallback = CanNm_Internal_TimeoutTimerExpiredCallback;
+	ChannelInternal->TimeoutTimer.State = CANNM_TIMER_STOPPED;
+	ChannelInternal->TimeoutTimer.TimeLeft = 0;
+
+	ChannelInternal->MessageCycleTimer.ExpiredCallback = CanNm_Internal_MessageCycleTimerExpiredCallback;
+	ChannelInternal->MessageCycleTimer.State = CANNM_TIMER_STOPPED;
+	ChannelInternal->MessageCycleTimer.TimeLeft = 0;
+
+	ChannelInternal->RepeatMessageTimer.ExpiredCallback = CanNm_Internal_RepeatMessageTimerExpiredCallback;
+	ChannelInternal->RepeatMessageTimer.State = CANNM_TIMER_STOPPED;
+	ChannelInternal->RepeatMessageTimer.TimeLeft = 0;
+
+	ChannelInternal->WaitBusSleepTimer.ExpiredCallback = CanNm_Internal_WaitBusSleepTimerExpiredCallback;
+	ChannelInternal->WaitBusSleepTimer.State = CANNM_TIMER_STOPPED;
+	ChannelInternal->WaitBusSleepTimer.TimeLeft = 0;
+
+	ChannelInternal->RemoteSleepIndTimer.ExpiredCallback = CanNm_Internal_RemoteSleepIndTimerExpiredCallback;
+	ChannelInternal->RemoteSleepIndTimer.State = CANNM_TIMER_STOPPED;
+	ChannelInternal->RemoteSleepIndTimer.TimeLeft = 0;
+
+#if (CANNM_TRACE_ENABLED == STD_ON)
+	ChannelInternal->TimeoutTimer.Id = CANNM_TRACE_TIMER_TIMEOUT;
+	ChannelInternal->MessageCycleTimer.Id = CANNM_TRACE_TIMER_MESSAGE_CYCLE;
+	ChannelInternal->RepeatMessageTimer.Id = CANNM_TRACE_TIMER_REPEAT_MESSAGE;
+	ChannelInternal->WaitBusSleepTimer.Id = CANNM_TRACE_TIMER_WAIT_BUS_SLEEP;
+	ChannelInternal->RemoteSleepIndTimer.Id = CANNM_TRACE_TIMER_REMOTE_SLEEP_IND;
+#endif
+}
+
+static inline void CanNm_Internal_TimeoutTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal )
+{
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[ChannelInternal->Channel];
+
+	if (ChannelInternal->State == NM_STATE_REPEAT_MESSAGE) {
+		CANNM_STATISTICS_COUNT(ChannelInternal, TxTimeouts);
+		CANNM_TRACE(ChannelInternal, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_TX_TIMEOUT, 0);
+		Instance->Callbacks->TxTimeoutException(Instance, ChannelInternal->Channel);
+		CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelHot->TimeoutTicks);
+	} else if (ChannelInternal->State == NM_STATE_NORMAL_OPERATION) {
+		CANNM_STATISTICS_COUNT(ChannelInternal, TxTimeouts);
+		CANNM_TRACE(ChannelInternal, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_TX_TIMEOUT, 0);
+		Instance->Callbacks->TxTimeoutException(Instance, ChannelInternal->Channel);
+		CanNm_Internal_NormalOperation_to_NormalOperation(ChannelHot, ChannelInternal);
+	} else if (ChannelInternal->State == NM_STATE_READY_SLEEP) {
+		if (ChannelHot->ActiveWakeupBitEnabled) {
+			CanNm_Internal_ClearPduCbvBit(ChannelHot, ChannelInternal, ACTIVE_WAKEUP_BIT);
+		}
+		CanNm_Internal_ReadySleep_to_PrepareBusSleep(ChannelHot, ChannelInternal);
+	} else {
+		//Nothing to be done
+	}
+}
+
+static inline void CanNm_Internal_MessageCycleTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal )
+{
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[ChannelInternal->Channel];
+	Std_ReturnType txStatus = E_OK;
+
+	if ((ChannelInternal->State == NM_STATE_REPEAT_MESSAGE) || (ChannelInternal->State == NM_STATE_NORMAL_OPERATION)) {
+		txStatus = CanNm_Internal_TransmitMessage(ChannelHot, ChannelInternal);
+		if (ChannelInternal->ImmediateTransmissions) {
+			if (txStatus == E_NOT_OK) {
+				if (ChannelInternal->LastTxStatus == E_NOT_OK) {
+					ChannelInternal->ImmediateTransmissions = 0;
+					CanNm_Internal_TimerStart((CanNm_Timer*)Timer, ChannelHot->MsgCycleTicks);
+				}
+				else {
+					CanNm_Internal_TimerStart((CanNm_Timer*)Timer, 1);
+				}
+			}
+			else {
+				CanNm_Internal_TimerStart((CanNm_Timer*)Timer, ChannelHot->ImmediateNmCycleTicks);
+				ChannelInternal->ImmediateTransmissions--;
+			}
+		}
+		else {
+			CanNm_Internal_TimerStart((CanNm_Timer*)Timer, ChannelHot->MsgCycleTicks);
+		}
+	}
+	ChannelInternal->LastTxStatus = txStatus;
+}
+
+static inline void CanNm_Internal_RepeatMessageTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal )
+{
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[ChannelInternal->Channel];
+
+	if (ChannelInternal->State == NM_STATE_REPEAT_MESSAGE) {
+		if (ChannelInternal->Requested) {
+			CanNm_Internal_RepeatMessage_to_NormalOperation(ChannelHot, ChannelInternal);
+		} else {
+			CanNm_Internal_RepeatMessage_to_ReadySleep(ChannelHot, ChannelInternal);
+		}
+	}
+}
+
+static inline void CanNm_Internal_WaitBusSleepTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal )
+{
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[ChannelInternal->Channel];
+
+	if (ChannelInternal->Mode == NM_MODE_PREPARE_BUS_SLEEP) {
+		CanNm_Internal_PrepareBusSleep_to_BusSleep(ChannelHot, ChannelInternal);					//[SWS_CanNm_00088]
+	}
+}
+
+static inline void CanNm_Internal_RemoteSleepIndTimerExpiredCallback( void* Timer, CanNm_Internal_ChannelType* ChannelInternal )
+{
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[ChannelInternal->Channel];
+
+	ChannelInternal->RemoteSleepInd = TRUE;
+	CANNM_TRACE(ChannelInternal, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_REMOTE_SLEEP_IND, 0);
+	Instance->Callbacks->RemoteSleepInd(Instance, ChannelInternal->Channel);
+	CanNm_Internal_TimerStart(Timer, ChannelHot->RemoteSleepIndTicks);								//[SWS_CanNm_00150]
+}
+
+/***************************/
 /* State machine functions */
 /***************************/
-static inline void CanNm_Internal_BusSleep_to_BusSleep( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+
+/* Every state change notification of the functions below, counted and traced even without a notification callout */
+static inline void CanNm_Internal_Transition( CanNm_Internal_ChannelType* ChannelInternal, Nm_StateType previous,
+ 												Nm_StateType current )
 {
-	Nm_NetworkStartIndication(ChannelInternal->Channel);
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_BUS_SLEEP, NM_STATE_BUS_SLEEP);
+	CANNM_STATISTICS_TRANSITION(ChannelInternal, previous, current);
+	CANNM_TRACE(ChannelInternal, CANNM_TRACE_STATE, (uint8)((previous << 4) | current), 0);
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+	if (current == NM_STATE_NORMAL_OPERATION) {
+		CanNm_Internal_WakeupMilestone(ChannelInternal, CANNM_WAKEUP_NORMAL_OPERATION);
+	}
+	else if (current != NM_STATE_REPEAT_MESSAGE) {
+		ChannelInternal->WakeupPending = 0;									//Released or asleep before the milestones
 	}
+#endif
 }
 
-static inline void CanNm_Internal_BusSleep_to_RepeatMessage( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_BusSleep_to_BusSleep( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
+	CANNM_TRACE(ChannelInternal, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_NETWORK_START, 0);
+	Instance->Callbacks->NetworkStartIndication(Instance, ChannelInternal->Channel);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_BUS_SLEEP, NM_STATE_BUS_SLEEP);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_BUS_SLEEP, NM_STATE_BUS_SLEEP);
+	}
+}
+
+static inline void CanNm_Internal_BusSleep_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
+{
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_NETWORK;
 	ChannelInternal->State = NM_STATE_REPEAT_MESSAGE;
 	ChannelInternal->BusLoadReduction = FALSE;														//[SWS_CanNm_00156]
-	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelConf->TimeoutTime);			//[SWS_CanNm_00096]
-	CanNm_Internal_TimerStart(&ChannelInternal->RepeatMessageTimer, ChannelConf->RepeatMessageTime);//[SWS_CanNm_00102]
-	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelConf->MsgCycleOffset);	//[SWS_CanNm_00100]
-	Nm_NetworkMode(ChannelInternal->Channel);														//[SWS_CanNm_00097]
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_BUS_SLEEP, NM_STATE_REPEAT_MESSAGE);
+	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelHot->TimeoutTicks);			//[SWS_CanNm_00096]
+	CanNm_Internal_TimerStart(&ChannelInternal->RepeatMessageTimer, ChannelHot->RepeatMessageTicks);//[SWS_CanNm_00102]
+	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelHot->MsgCycleOffsetTicks);	//[SWS_CanNm_00100]
+	Instance->Callbacks->NetworkMode(Instance, ChannelInternal->Channel);														//[SWS_CanNm_00097]
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_BUS_SLEEP, NM_STATE_REPEAT_MESSAGE);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_BUS_SLEEP, NM_STATE_REPEAT_MESSAGE);
 	}
 }
 
-static inline void CanNm_Internal_RepeatMessage_to_RepeatMessage( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_RepeatMessage_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
-	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelConf->TimeoutTime);			//[SWS_CanNm_00101]
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_REPEAT_MESSAGE, NM_STATE_REPEAT_MESSAGE);
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
+	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelHot->TimeoutTicks);			//[SWS_CanNm_00101]
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_REPEAT_MESSAGE, NM_STATE_REPEAT_MESSAGE);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_REPEAT_MESSAGE, NM_STATE_REPEAT_MESSAGE);
 	}
 }
 
-static inline void CanNm_Internal_RepeatMessage_to_ReadySleep( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_RepeatMessage_to_ReadySleep( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_NETWORK;
 	ChannelInternal->State = NM_STATE_READY_SLEEP;
 	ChannelInternal->TxEnabled = FALSE;																//[SWS_CanNm_00108]
-	if (ChannelConf->NodeDetectionEnabled) {
-		CanNm_Internal_ClearPduCbv(ChannelConf, ChannelInternal);									//[SWS_CanNm_00107]
+	CanNm_Internal_TimerStop(&ChannelInternal->MessageCycleTimer);
+	if (ChannelHot->NodeDetectionEnabled) {
+		CanNm_Internal_ClearPduCbv(ChannelHot, ChannelInternal);									//[SWS_CanNm_00107]
 	}
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_REPEAT_MESSAGE, NM_STATE_READY_SLEEP);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_REPEAT_MESSAGE, NM_STATE_READY_SLEEP);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_REPEAT_MESSAGE, NM_STATE_READY_SLEEP);
 	}
 }
 
-static inline void CanNm_Internal_RepeatMessage_to_NormalOperation( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_RepeatMessage_to_NormalOperation( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_NETWORK;
 	ChannelInternal->State = NM_STATE_NORMAL_OPERATION;
-	if (ChannelConf->BusLoadReductionActive) {
+	if (ChannelHot->BusLoadReductionActive) {
 		ChannelInternal->BusLoadReduction = TRUE;													//[SWS_CanNm_00157]
 	}
-	if (ChannelConf->NodeDetectionEnabled) {
-		CanNm_Internal_ClearPduCbv(ChannelConf, ChannelInternal);									//[SWS_CanNm_00107]
+	if (ChannelHot->NodeDetectionEnabled) {
+		CanNm_Internal_ClearPduCbv(ChannelHot, ChannelInternal);									//[SWS_CanNm_00107]
 	}
-	if (CanNm_ConfigPtr->RemoteSleepIndEnabled) {													//[SWS_CanNm_00149]
-		CanNm_Internal_TimerStart(&ChannelInternal->RemoteSleepIndTimer, ChannelConf->RemoteSleepIndTime);
+	if (CANNM_CFG_REMOTE_SLEEP_IND_ENABLED) {													//[SWS_CanNm_00149]
+		CanNm_Internal_TimerStart(&ChannelInternal->RemoteSleepIndTimer, ChannelHot->RemoteSleepIndTicks);
 	}
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_REPEAT_MESSAGE, NM_STATE_NORMAL_OPERATION);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_REPEAT_MESSAGE, NM_STATE_NORMAL_OPERATION);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_REPEAT_MESSAGE, NM_STATE_NORMAL_OPERATION);
 	}
 }
 
-static inline void CanNm_Internal_NormalOperation_to_RepeatMessage( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_NormalOperation_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_NETWORK;
 	ChannelInternal->State = NM_STATE_REPEAT_MESSAGE;
 	ChannelInternal->BusLoadReduction = FALSE;
-	CanNm_Internal_TimerStart(&ChannelInternal->RepeatMessageTimer, ChannelConf->RepeatMessageTime);
-	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelConf->MsgCycleOffset);
+	CanNm_Internal_TimerStart(&ChannelInternal->RepeatMessageTimer, ChannelHot->RepeatMessageTicks);
+	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelHot->MsgCycleOffsetTicks);
 	if (ChannelInternal->RemoteSleepInd) {
 		ChannelInternal->RemoteSleepInd = FALSE;
-		Nm_RemoteSleepCancellation(ChannelInternal->Channel);
+		CANNM_TRACE(ChannelInternal, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_REMOTE_SLEEP_CANCEL, 0);
+		Instance->Callbacks->RemoteSleepCancellation(Instance, ChannelInternal->Channel);
 	}
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_NORMAL_OPERATION, NM_STATE_REPEAT_MESSAGE);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_NORMAL_OPERATION, NM_STATE_REPEAT_MESSAGE);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_NORMAL_OPERATION, NM_STATE_REPEAT_MESSAGE);
 	}
 }
 
-static inline void CanNm_Internal_NormalOperation_to_NormalOperation( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_NormalOperation_to_NormalOperation( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
-	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelConf->TimeoutTime);
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_NORMAL_OPERATION, NM_STATE_NORMAL_OPERATION);
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
+	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelHot->TimeoutTicks);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_NORMAL_OPERATION, NM_STATE_NORMAL_OPERATION);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_NORMAL_OPERATION, NM_STATE_NORMAL_OPERATION);
 	}
 }
 
-static inline void CanNm_Internal_NormalOperation_to_ReadySleep( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_NormalOperation_to_ReadySleep( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_NETWORK;
 	ChannelInternal->State = NM_STATE_READY_SLEEP;
 	ChannelInternal->TxEnabled = FALSE;
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_NORMAL_OPERATION, NM_STATE_READY_SLEEP);
+	CanNm_Internal_TimerStop(&ChannelInternal->MessageCycleTimer);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_NORMAL_OPERATION, NM_STATE_READY_SLEEP);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_NORMAL_OPERATION, NM_STATE_READY_SLEEP);
 	}
 }
 
-static inline void CanNm_Internal_ReadySleep_to_NormalOperation( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_ReadySleep_to_NormalOperation( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_NETWORK;
 	ChannelInternal->State = NM_STATE_NORMAL_OPERATION;
-	if (!CanNm_ConfigPtr->PassiveModeEnabled) {
+	if (!CANNM_CFG_PASSIVE_MODE_ENABLED) {
 		ChannelInternal->TxEnabled = TRUE;
 	}
-	if (ChannelConf->BusLoadReductionActive) {
+	if (ChannelHot->BusLoadReductionActive) {
 		ChannelInternal->BusLoadReduction = TRUE;
 	}
-	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelConf->MsgCycleOffset);
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_READY_SLEEP, NM_STATE_NORMAL_OPERATION);
+	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelHot->MsgCycleOffsetTicks);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_READY_SLEEP, NM_STATE_NORMAL_OPERATION);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_READY_SLEEP, NM_STATE_NORMAL_OPERATION);
 	}
 }
 
-static inline void CanNm_Internal_ReadySleep_to_RepeatMessage( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_ReadySleep_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_NETWORK;
 	ChannelInternal->State = NM_STATE_REPEAT_MESSAGE;
-	if (!CanNm_ConfigPtr->PassiveModeEnabled) {
+	if (!CANNM_CFG_PASSIVE_MODE_ENABLED) {
 		ChannelInternal->TxEnabled = TRUE;
 	}
 	ChannelInternal->BusLoadReduction = FALSE;
-	CanNm_Internal_TimerStart(&ChannelInternal->RepeatMessageTimer, ChannelConf->RepeatMessageTime);
-	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelConf->MsgCycleOffset);
+	CanNm_Internal_TimerStart(&ChannelInternal->RepeatMessageTimer, ChannelHot->RepeatMessageTicks);
+	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelHot->MsgCycleOffsetTicks);
 	if (ChannelInternal->RemoteSleepInd) {
 		ChannelInternal->RemoteSleepInd = FALSE;
-		Nm_RemoteSleepCancellation(ChannelInternal->Channel);
+		CANNM_TRACE(ChannelInternal, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_REMOTE_SLEEP_CANCEL, 0);
+		Instance->Callbacks->RemoteSleepCancellation(Instance, ChannelInternal->Channel);
 	}
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_READY_SLEEP, NM_STATE_REPEAT_MESSAGE);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_READY_SLEEP, NM_STATE_REPEAT_MESSAGE);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_READY_SLEEP, NM_STATE_REPEAT_MESSAGE);
 	}
 }
 
-static inline void CanNm_Internal_ReadySleep_to_PrepareBusSleep( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal ) {
+static inline void CanNm_Internal_ReadySleep_to_PrepareBusSleep( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal ) {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_PREPARE_BUS_SLEEP;
 	ChannelInternal->State = NM_STATE_PREPARE_BUS_SLEEP;
-	CanNm_Internal_TimerStart(&ChannelInternal->WaitBusSleepTimer, ChannelConf->WaitBusSleepTime);
-	Nm_PrepareBusSleepMode(ChannelInternal->Channel);
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_READY_SLEEP, NM_STATE_PREPARE_BUS_SLEEP);
+	CanNm_Internal_TimerStart(&ChannelInternal->WaitBusSleepTimer, ChannelHot->WaitBusSleepTicks);
+	Instance->Callbacks->PrepareBusSleepMode(Instance, ChannelInternal->Channel);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_READY_SLEEP, NM_STATE_PREPARE_BUS_SLEEP);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_READY_SLEEP, NM_STATE_PREPARE_BUS_SLEEP);
 	}
 }
 
-static inline void CanNm_Internal_PrepareBusSleep_to_RepeatMessage( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_PrepareBusSleep_to_RepeatMessage( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_NETWORK;
 	ChannelInternal->State = NM_STATE_REPEAT_MESSAGE;
 	ChannelInternal->BusLoadReduction = FALSE;
-	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelConf->TimeoutTime);
-	CanNm_Internal_TimerStart(&ChannelInternal->RepeatMessageTimer, ChannelConf->RepeatMessageTime);
-	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelConf->MsgCycleOffset);
-	Nm_NetworkMode(ChannelInternal->Channel);
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_PREPARE_BUS_SLEEP, NM_STATE_REPEAT_MESSAGE);
+	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelHot->TimeoutTicks);
+	CanNm_Internal_TimerStart(&ChannelInternal->RepeatMessageTimer, ChannelHot->RepeatMessageTicks);
+	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, ChannelHot->MsgCycleOffsetTicks);
+	Instance->Callbacks->NetworkMode(Instance, ChannelInternal->Channel);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_PREPARE_BUS_SLEEP, NM_STATE_REPEAT_MESSAGE);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_PREPARE_BUS_SLEEP, NM_STATE_REPEAT_MESSAGE);
 	}
 }
 
-static inline void CanNm_Internal_PrepareBusSleep_to_BusSleep( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_PrepareBusSleep_to_BusSleep( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	ChannelInternal->Mode = NM_MODE_BUS_SLEEP;
 	ChannelInternal->State = NM_STATE_BUS_SLEEP;
-	Nm_BusSleepMode(ChannelInternal->Channel);
-	if (CanNm_ConfigPtr->StateChangeIndEnabled) {
-		Nm_StateChangeNotification(ChannelInternal->Channel, NM_STATE_PREPARE_BUS_SLEEP, NM_STATE_BUS_SLEEP);
+	Instance->Callbacks->BusSleepMode(Instance, ChannelInternal->Channel);
+	CanNm_Internal_Transition(ChannelInternal, NM_STATE_PREPARE_BUS_SLEEP, NM_STATE_BUS_SLEEP);
+	if (CANNM_CFG_STATE_CHANGE_IND_ENABLED) {
+		Instance->Callbacks->StateChangeNotification(Instance, ChannelInternal->Channel, NM_STATE_PREPARE_BUS_SLEEP, NM_STATE_BUS_SLEEP);
 	}
 }
 
-static inline void CanNm_Internal_NetworkMode_to_NetworkMode( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline void CanNm_Internal_NetworkMode_to_NetworkMode( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
-	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelConf->TimeoutTime);
+	CanNm_Internal_TimerStart(&ChannelInternal->TimeoutTimer, ChannelHot->TimeoutTicks);
 }
 
 /************************/
 /* Additional functions */
 /************************/
-static inline Std_ReturnType CanNm_Internal_TxDisable( CanNm_Internal_ChannelType* ChannelInternal )
+static inline Std_ReturnType CanNm_Internal_TxDisable( const CanNm_InstanceType* Instance,
+ 														CanNm_Internal_ChannelType* ChannelInternal )
 {
 	ChannelInternal->TxEnabled = FALSE;
-	if (CanNm_ConfigPtr->RemoteSleepIndEnabled) {
+	if (CANNM_CFG_REMOTE_SLEEP_IND_ENABLED) {
 		ChannelInternal->RemoteSleepIndEnabled = FALSE;
 		CanNm_Internal_TimerStop(&ChannelInternal->RemoteSleepIndTimer);
 	}
@@ -1133,15 +1933,16 @@ static inline Std_ReturnType CanNm_Internal_TxDisable( CanNm_Internal_ChannelTyp
 	return E_OK;
 }
 
-static inline Std_ReturnType CanNm_Internal_TxEnable( CanNm_Internal_ChannelType* ChannelInternal )
+static inline Std_ReturnType CanNm_Internal_TxEnable( const CanNm_InstanceType* Instance,
+ 														CanNm_Internal_ChannelType* ChannelInternal )
 {
-	const CanNm_ChannelType* ChannelConf = CanNm_ConfigPtr->ChannelConfig[ChannelInternal->Channel];
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[ChannelInternal->Channel];
 
-	if (!CanNm_ConfigPtr->PassiveModeEnabled) {
+	if (!CANNM_CFG_PASSIVE_MODE_ENABLED) {
 		ChannelInternal->TxEnabled = TRUE;
-		if (CanNm_ConfigPtr->RemoteSleepIndEnabled) {
+		if (CANNM_CFG_REMOTE_SLEEP_IND_ENABLED) {
 			ChannelInternal->RemoteSleepIndEnabled = TRUE;
-			CanNm_Internal_TimerStart(&ChannelInternal->RemoteSleepIndTimer, ChannelConf->RemoteSleepIndTime);
+			CanNm_Internal_TimerStart(&ChannelInternal->RemoteSleepIndTimer, ChannelHot->RemoteSleepIndTicks);
 		}
 		CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, 1);
 		return E_OK;
@@ -1151,49 +1952,469 @@ static inline Std_ReturnType CanNm_Internal_TxEnable( CanNm_Internal_ChannelType
 	}
 }
 
-static inline Std_ReturnType CanNm_Internal_TransmitMessage( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+static inline Std_ReturnType CanNm_Internal_TransmitMessage( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
 {
+	CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
 	if (ChannelInternal->TxEnabled) {
-		return CanIf_Transmit(ChannelConf->TxPdu->TxConfirmationPduId, ChannelConf->TxPdu->TxPduRef);
+		Std_ReturnType status = Instance->Callbacks->CanIfTransmit(Instance, ChannelHot->TxPduId, ChannelInternal->TxPduRef);
+
+		CANNM_STATISTICS_COUNT(ChannelInternal, TxAttempts);
+		CANNM_TRACE(ChannelInternal, CANNM_TRACE_TX, CANNM_TRACE_TX_TRANSMIT, status);
+		CANNM_WAKEUP_MILESTONE(ChannelInternal, CANNM_WAKEUP_FIRST_TRANSMIT);
+		CANNM_PCAP(ChannelHot, ChannelInternal, CANNM_PCAP_TRANSMIT,
+			(status == E_OK) ? CANNM_PCAP_DROP_NONE : CANNM_PCAP_DROP_CANIF_REJECTED,
+			ChannelInternal->TxPduRef->SduDataPtr, ChannelHot->TxSduLength);
+		if (status != E_OK) {
+			CANNM_STATISTICS_COUNT(ChannelInternal, TxFailures);
+		}
+		return status;
 	}
 	else {
+		CANNM_PCAP(ChannelHot, ChannelInternal, CANNM_PCAP_TRANSMIT, CANNM_PCAP_DROP_TX_DISABLED,
+			ChannelInternal->TxPduRef->SduDataPtr, ChannelHot->TxSduLength);
 		return E_OK;
 	}
 }
 
-static inline void CanNm_Internal_SetPduCbvBit( const CanNm_ChannelType* ChannelConf, const uint8 PduCbvBitPosition )
+static inline void CanNm_Internal_SetPduCbvBit( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal,
+ 												const uint8 PduCbvBitPosition )
+{
+	if (ChannelHot->PduCbvPosition != CANNM_PDU_OFF) {
+		ChannelInternal->TxPduRef->SduDataPtr[ChannelHot->PduCbvPosition] |= (1 << PduCbvBitPosition);
+	}
+}
+
+static inline void CanNm_Internal_ClearPduCbvBit( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal,
+ 												const uint8 PduCbvBitPosition )
+{
+	if (ChannelHot->PduCbvPosition != CANNM_PDU_OFF) {
+		ChannelInternal->TxPduRef->SduDataPtr[ChannelHot->PduCbvPosition] &= ~(1 << PduCbvBitPosition);
+	}
+}
+
+static inline void CanNm_Internal_ClearPduCbv( const CanNm_ChannelHotType* ChannelHot, CanNm_Internal_ChannelType* ChannelInternal )
+{
+	if (ChannelHot->PduCbvPosition != CANNM_PDU_OFF) {
+		ChannelInternal->TxPduRef->SduDataPtr[ChannelHot->PduCbvPosition] = 0x00;
+	}
+}
+
+static inline void CanNm_Internal_ChannelHotInit( const CanNm_ChannelType* ChannelConf, const float32 period,
+ 													CanNm_ChannelHotType* ChannelHot )
+{
+	uint8 userDataOffset = 0;
+	uint8 rxPduCount = 0;
+
+	/* User data start behind the last control byte, a byte 0 left free by a CBV or NID in byte 1 stays unused */
+	if (ChannelConf->PduNidPosition != CANNM_PDU_OFF) {
+		userDataOffset = ChannelConf->PduNidPosition + 1;
+	}
+	if (ChannelConf->PduCbvPosition != CANNM_PDU_OFF && ChannelConf->PduCbvPosition + 1 > userDataOffset) {
+		userDataOffset = ChannelConf->PduCbvPosition + 1;
+	}
+	while (rxPduCount < CANNM_RXPDU_MAX_COUNT && ChannelConf->RxPdu[rxPduCount] != NULL) {
+		rxPduCount++;
+	}
+
+	ChannelHot->TimeoutTicks = CanNm_Internal_TimeToTicks(ChannelConf->TimeoutTime, period);
+	ChannelHot->MsgCycleTicks = CanNm_Internal_TimeToTicks(ChannelConf->MsgCycleTime, period);
+	ChannelHot->MsgCycleOffsetTicks = CanNm_Internal_TimeToTicks(ChannelConf->MsgCycleOffset, period);
+	ChannelHot->MsgReducedTicks = CanNm_Internal_TimeToTicks(ChannelConf->MsgReducedTime, period);
+	ChannelHot->ImmediateNmCycleTicks = CanNm_Internal_TimeToTicks(ChannelConf->ImmediateNmCycleTime, period);
+	ChannelHot->RepeatMessageTicks = CanNm_Internal_TimeToTicks(ChannelConf->RepeatMessageTime, period);
+	ChannelHot->WaitBusSleepTicks = CanNm_Internal_TimeToTicks(ChannelConf->WaitBusSleepTime, period);
+	ChannelHot->RemoteSleepIndTicks = CanNm_Internal_TimeToTicks(ChannelConf->RemoteSleepIndTime, period);
+	ChannelHot->TxPduId = ChannelConf->TxPdu->TxConfirmationPduId;
+	ChannelHot->TxSduLength = ChannelConf->TxPdu->TxPduRef->SduLength;
+	ChannelHot->RxSduLength = (rxPduCount > 0) ? ChannelConf->RxPdu[0]->RxPduRef->SduLength : 0;
+	ChannelHot->PduCbvPosition = ChannelConf->PduCbvPosition;
+	ChannelHot->PduNidPosition = ChannelConf->PduNidPosition;
+	ChannelHot->UserDataOffset = userDataOffset;
+	ChannelHot->UserDataLength = ChannelConf->UserDataTxPdu->TxUserDataPduRef->SduLength - userDataOffset;
+	ChannelHot->RxPduCount = rxPduCount;
+	ChannelHot->ImmediateNmTransmissions = ChannelConf->ImmediateNmTransmissions;
+	ChannelHot->NodeId = ChannelConf->NodeId;
+	ChannelHot->NodeIdEnabled = ChannelConf->NodeIdEnabled;
+	ChannelHot->NodeDetectionEnabled = ChannelConf->NodeDetectionEnabled;
+	ChannelHot->ActiveWakeupBitEnabled = ChannelConf->ActiveWakeupBitEnabled;
+	ChannelHot->BusLoadReductionActive = ChannelConf->BusLoadReductionActive;
+	ChannelHot->PnHandleMultipleNetworkRequests = ChannelConf->PnHandleMultipleNetworkRequests;
+}
+
+static inline uint8* CanNm_Internal_GetUserDataPtr( const CanNm_ChannelHotType* ChannelHot, uint8* MessageSduPtr )
+{
+	return &MessageSduPtr[ChannelHot->UserDataOffset];
+}
+
+static inline uint8 CanNm_Internal_GetUserDataLength( const CanNm_ChannelHotType* ChannelHot )
 {
-	ChannelConf->TxPdu->TxPduRef->SduDataPtr[ChannelConf->PduCbvPosition] |= (1 << PduCbvBitPosition);
+	return ChannelHot->UserDataLength;
 }
 
-static inline void CanNm_Internal_ClearPduCbvBit( const CanNm_ChannelType* ChannelConf, const uint8 PduCbvBitPosition )
+static inline void CanNm_Internal_ChannelPduBind( const uint16 channel, CanNm_Internal_ChannelType* ChannelInternal )
 {
-	ChannelConf->TxPdu->TxPduRef->SduDataPtr[ChannelConf->PduCbvPosition] &= ~(1 << PduCbvBitPosition);
+	const CanNm_InstanceType* Instance = ChannelInternal->Instance;
+
+	if (Instance->ConfigPtr->ChannelPdu != NULL) {
+		const CanNm_ChannelPduType* ChannelPdu = &Instance->ConfigPtr->ChannelPdu[channel];
+		ChannelInternal->TxPduRef = ChannelPdu->TxPduRef;
+		ChannelInternal->TxUserDataSduPtr = ChannelPdu->TxUserDataPduRef->SduDataPtr;
+		ChannelInternal->RxPdu = ChannelPdu->RxPdu;
+	} else {
+		const CanNm_ChannelType* ChannelConf = Instance->ConfigPtr->ChannelConfig[channel];
+		ChannelInternal->TxPduRef = ChannelConf->TxPdu->TxPduRef;
+		ChannelInternal->TxUserDataSduPtr = ChannelConf->UserDataTxPdu->TxUserDataPduRef->SduDataPtr;
+		ChannelInternal->RxPdu = ChannelConf->RxPdu;
+	}
 }
 
-static inline void CanNm_Internal_ClearPduCbv( const CanNm_ChannelType* ChannelConf, CanNm_Internal_ChannelType* ChannelInternal )
+/* Rebind a running channel to the PDU buffers of the current configuration. The CBV and user data of the TX PDU
+ * are carried over into the new layout, the RX ring is dropped if it moved or shrank. */
+static inline void CanNm_Internal_ChannelPduRebind( const CanNm_ChannelHotType* OldChannelHot,
+ 													const CanNm_ChannelHotType* ChannelHot,
+ 													CanNm_Internal_ChannelType* ChannelInternal )
 {
-	if (ChannelConf->PduCbvPosition != CANNM_PDU_OFF) {
-		ChannelConf->TxPdu->TxPduRef->SduDataPtr[ChannelConf->PduCbvPosition] = 0x00;
+	const CanNm_RxPdu* const* oldRxPdu = ChannelInternal->RxPdu;
+	uint8* oldUserData = CanNm_Internal_GetUserDataPtr(OldChannelHot, ChannelInternal->TxUserDataSduPtr);
+	uint8 oldUserDataLength = CanNm_Internal_GetUserDataLength(OldChannelHot);
+	uint8 cbv = 0x00;
+
+	if (OldChannelHot->PduCbvPosition != CANNM_PDU_OFF) {
+		cbv = ChannelInternal->TxPduRef->SduDataPtr[OldChannelHot->PduCbvPosition];
 	}
+
+	CanNm_Internal_ChannelPduBind(ChannelInternal->Channel, ChannelInternal);
+
+	uint8* userData = CanNm_Internal_GetUserDataPtr(ChannelHot, ChannelInternal->TxUserDataSduPtr);
+	uint8 userDataLength = CanNm_Internal_GetUserDataLength(ChannelHot);
+	uint8 keptLength = (userDataLength < oldUserDataLength) ? userDataLength : oldUserDataLength;
+	memmove(userData, oldUserData, keptLength);
+	memset(&userData[keptLength], 0xFF, userDataLength - keptLength);
+
+	if (ChannelHot->NodeIdEnabled && ChannelHot->PduNidPosition != CANNM_PDU_OFF) {
+		ChannelInternal->TxPduRef->SduDataPtr[ChannelHot->PduNidPosition] = ChannelHot->NodeId;
+	}
+	if (ChannelHot->PduCbvPosition != CANNM_PDU_OFF) {
+		ChannelInternal->TxPduRef->SduDataPtr[ChannelHot->PduCbvPosition] = cbv;
+	}
+	if (ChannelInternal->RxPdu != oldRxPdu || ChannelInternal->RxLastPdu >= ChannelHot->RxPduCount) {
+		ChannelInternal->RxLastPdu = NO_PDU_RECEIVED;
+	}
+}
+
+/* Switch to a new configuration at a main function boundary, keeping the channel state (see CanNm_SwitchConfig).
+ * The derived parameters are built in the bank not in use, so ChannelHotPtr changes with a single store. */
+static inline void CanNm_Internal_ApplyConfig( CanNm_InstanceType* Instance, const CanNm_ConfigType* cannmConfigPtr )
+{
+	const CanNm_ChannelHotType* OldChannelHotPtr = Instance->ChannelHotPtr;
+	CanNm_ChannelHotType* SpareChannelHot = (OldChannelHotPtr == Instance->ChannelHotBank[0]) ?
+												Instance->ChannelHotBank[1] : Instance->ChannelHotBank[0];
+
+	Instance->ConfigPtr = cannmConfigPtr;
+	if (cannmConfigPtr->ChannelHot == NULL) {
+		for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+			CanNm_Internal_ChannelHotInit(cannmConfigPtr->ChannelConfig[channel], CANNM_CFG_MAIN_FUNCTION_PERIOD,
+											&SpareChannelHot[channel]);
+		}
+	}
+	Instance->ChannelHotPtr = (cannmConfigPtr->ChannelHot != NULL) ? cannmConfigPtr->ChannelHot : SpareChannelHot;
+
+	for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[channel];
+		CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[channel];
+		uint32 msgCycleTicks = ChannelInternal->BusLoadReduction ? ChannelHot->MsgReducedTicks : ChannelHot->MsgCycleTicks;
+
+		if (ChannelInternal->ImmediateTransmissions > 0) {
+			msgCycleTicks = ChannelHot->ImmediateNmCycleTicks;
+		}
+
+		CanNm_Internal_ChannelPduRebind(&OldChannelHotPtr[channel], ChannelHot, ChannelInternal);
+		CanNm_Internal_TimerClamp(&ChannelInternal->TimeoutTimer, ChannelHot->TimeoutTicks);
+		CanNm_Internal_TimerClamp(&ChannelInternal->MessageCycleTimer, msgCycleTicks);
+		CanNm_Internal_TimerClamp(&ChannelInternal->RepeatMessageTimer, ChannelHot->RepeatMessageTicks);
+		CanNm_Internal_TimerClamp(&ChannelInternal->WaitBusSleepTimer, ChannelHot->WaitBusSleepTicks);
+		CanNm_Internal_TimerClamp(&ChannelInternal->RemoteSleepIndTimer, ChannelHot->RemoteSleepIndTicks);
+	}
+}
+
+/* Number of channels an instance serves with this configuration, 0 if it has too few channel tables or a channel
+ * without Rx PDU */
+static inline uint16 CanNm_Internal_ConfigChannelCount( const CanNm_ConfigType* cannmConfigPtr )
+{
+	uint16 channelCount = (cannmConfigPtr->ChannelCount == 0) ? CANNM_CHANNEL_COUNT : cannmConfigPtr->ChannelCount;
+
+	if (channelCount > CANNM_CHANNEL_COUNT &&
+		(cannmConfigPtr->ChannelHot == NULL || cannmConfigPtr->ChannelPdu == NULL)) {
+		return 0;
+	}
+	return CanNm_Internal_ConfigRxPduValid(cannmConfigPtr, channelCount) ? channelCount : 0;
+}
+
+/* Every channel needs at least one Rx PDU, CanNm_RxIndication keeps each received PDU in one of them */
+static inline boolean CanNm_Internal_ConfigRxPduValid( const CanNm_ConfigType* cannmConfigPtr, uint16 channelCount )
+{
+	for (uint16 channel = 0; channel < channelCount; channel++) {
+		if (cannmConfigPtr->ChannelHot != NULL) {
+			if (cannmConfigPtr->ChannelHot[channel].RxPduCount == 0) {
+				return FALSE;
+			}
+		}
+		else if (cannmConfigPtr->ChannelConfig[channel] == NULL ||
+			cannmConfigPtr->ChannelConfig[channel]->RxPdu[0] == NULL) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/* Common part of CanNm_Init and CanNm_InstanceInit, Channels, ChannelCount and ChannelHotBank are already set */
+static inline void CanNm_Internal_Init( CanNm_InstanceType* Instance, const CanNm_ConfigType* cannmConfigPtr )
+{
+	if (Instance->Callbacks == NULL) {
+		Instance->Callbacks = &CanNm_Internal_Callouts;
+	}
+    Instance->ConfigPtr = cannmConfigPtr;
+	Instance->ChannelHotPtr = (Instance->ConfigPtr->ChannelHot != NULL) ? Instance->ConfigPtr->ChannelHot :
+								Instance->ChannelHotBank[0];
+#if (CANNM_TIMING_ENABLED == STD_ON)
+	memset(Instance->Timing, 0, sizeof(Instance->Timing));
+#endif
+	for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[channel];
+		CanNm_Internal_ChannelType* ChannelInternal = &Instance->Channels[channel];
+
+		if (Instance->ConfigPtr->ChannelHot == NULL) {
+			CanNm_Internal_ChannelHotInit(Instance->ConfigPtr->ChannelConfig[channel], CANNM_CFG_MAIN_FUNCTION_PERIOD,
+											&Instance->ChannelHotBank[0][channel]);
+		}
+		ChannelInternal->Instance = Instance;
+		CanNm_Internal_ChannelPduBind(channel, ChannelInternal);
+
+		ChannelInternal->Channel = channel;
+		ChannelInternal->Mode = NM_MODE_BUS_SLEEP;														//[SWS_CanNm_00144]
+		ChannelInternal->State = NM_STATE_BUS_SLEEP;													//[SWS_CanNm_00141][SWS_CanNm_00094]
+		ChannelInternal->Requested = FALSE;																//[SWS_CanNm_00143]
+		ChannelInternal->TxEnabled = FALSE;
+		ChannelInternal->RxLastPdu = NO_PDU_RECEIVED;
+		ChannelInternal->ImmediateTransmissions = 0;
+		ChannelInternal->BusLoadReduction = FALSE;														//[SWS_CanNm_00023]
+		ChannelInternal->RemoteSleepInd = FALSE;
+		ChannelInternal->RemoteSleepIndEnabled = CANNM_CFG_REMOTE_SLEEP_IND_ENABLED;
+		ChannelInternal->NmPduFilterAlgorithm = FALSE;
+		ChannelInternal->LastTxStatus = E_OK;
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+		memset(&ChannelInternal->Statistics, 0, sizeof(CanNm_StatisticsType));
+#endif
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+		memset(ChannelInternal->BusLoad, 0, sizeof(ChannelInternal->BusLoad));
+#endif
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+		ChannelInternal->WakeupPending = 0;
+		memset(&ChannelInternal->WakeupLatency, 0, sizeof(CanNm_WakeupLatencyType));
+#endif
+
+		if (ChannelHot->NodeIdEnabled && ChannelHot->PduNidPosition != CANNM_PDU_OFF) {
+			ChannelInternal->TxPduRef->SduDataPtr[ChannelHot->PduNidPosition] = ChannelHot->NodeId;	//[SWS_CanNm_00013]
+		}
+
+		CanNm_Internal_ClearPduCbv(ChannelHot, ChannelInternal);										//[SWS_CanNm_00085]
+
+		uint8* destUserData = CanNm_Internal_GetUserDataPtr(ChannelHot, ChannelInternal->TxUserDataSduPtr);
+		uint8 userDataLength = CanNm_Internal_GetUserDataLength(ChannelHot);
+		memset(destUserData, 0xFF, userDataLength);														//[SWS_CanNm_00025]
+
+		CanNm_Internal_TimersInit(ChannelInternal);														//[SWS_CanNm_00061][SWS_CanNm_00033]
+	}
+	Instance->PendingConfigPtr = NULL;
+	Instance->InitStatus = CANNM_INIT;
+}
+
+#if (CANNM_TRACE_ENABLED == STD_ON)
+/*******************/
+/* Trace functions */
+/*******************/
+static inline void CanNm_Internal_Trace( const CanNm_Internal_ChannelType* ChannelInternal, uint8 type, uint8 arg8,
+ 										uint32 arg32 )
+{
+	CanNm_TraceRingType* Ring = ChannelInternal->Instance->TraceRing;
+
+	if (Ring != NULL) {
+		CanNm_TraceRecord(Ring, ChannelInternal->Channel, type, arg8, arg32);
+	}
+}
+
+/* Timer start and stop, the channel is found from the position of the timer in its channel state */
+static inline void CanNm_Internal_TraceTimer( const CanNm_Timer* Timer, uint8 type, uint32 arg32 )
+{
+	static const uint16 timerOffset[] = {
+		offsetof(CanNm_Internal_ChannelType, TimeoutTimer),
+		offsetof(CanNm_Internal_ChannelType, MessageCycleTimer),
+		offsetof(CanNm_Internal_ChannelType, RepeatMessageTimer),
+		offsetof(CanNm_Internal_ChannelType, WaitBusSleepTimer),
+		offsetof(CanNm_Internal_ChannelType, RemoteSleepIndTimer)
+	};
+	const CanNm_Internal_ChannelType* ChannelInternal =
+		(const CanNm_Internal_ChannelType*)((const uint8*)Timer - timerOffset[Timer->Id]);
+
+	CanNm_Internal_Trace(ChannelInternal, type, Timer->Id, arg32);
+}
+#endif
+
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+/*****************************/
+/* Wake-up latency functions */
+/*****************************/
+static inline void CanNm_Internal_WakeupMilestone( CanNm_Internal_ChannelType* ChannelInternal, uint8 milestone )
+{
+	if ((ChannelInternal->WakeupPending & (1U << milestone)) != 0) {
+		ChannelInternal->WakeupPending &= (uint8)~(1U << milestone);
+		CanNm_TimingRecord(&ChannelInternal->WakeupLatency.Milestones[milestone],
+			CANNM_WAKEUP_CLOCK() - ChannelInternal->WakeupStart);
+	}
+}
+#endif
+
+#if (CANNM_PCAP_ENABLED == STD_ON)
+/*********************/
+/* Capture functions */
+/*********************/
+static inline void CanNm_Internal_Pcap( const CanNm_ChannelHotType* ChannelHot,
+ 										const CanNm_Internal_ChannelType* ChannelInternal, uint8 point, uint8 drop,
+ 										const uint8* data, PduLengthType length )
+{
+	CanNm_PcapRingType* Ring = ChannelInternal->Instance->PcapRing;
+	boolean nidValid = (ChannelHot->PduNidPosition != CANNM_PDU_OFF) && (ChannelHot->PduNidPosition < length);
+
+	if (Ring != NULL) {
+		CanNm_PcapRecord(Ring, ChannelInternal->Channel, point, drop, nidValid ? CANNM_PCAP_NID_VALID : 0U,
+			nidValid ? data[ChannelHot->PduNidPosition] : 0U, data, length);
+	}
+}
+
+/* CanNm_Transmit only gets the PDU id: capture on the channel owning it, nothing for an unknown id */
+static inline void CanNm_Internal_PcapTxPdu( const CanNm_InstanceType* Instance, PduIdType TxPduId, uint8 drop,
+ 											const PduInfoType* PduInfoPtr )
+{
+	for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		if (Instance->ChannelHotPtr[channel].TxPduId == TxPduId) {
+			CanNm_Internal_Pcap(&Instance->ChannelHotPtr[channel], &Instance->Channels[channel], CANNM_PCAP_TRANSMIT,
+				drop, PduInfoPtr->SduDataPtr, PduInfoPtr->SduLength);
+			return;
+		}
+	}
+}
+#endif
+
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+/**********************/
+/* Bus load functions */
+/**********************/
+static inline void CanNm_Internal_BusLoadCount( CanNm_Internal_BusLoadType* BusLoad, PduLengthType length )
+{
+	BusLoad->Frames++;
+	BusLoad->Bits += CANNM_BUS_LOAD_FRAME_BITS(length);
+}
+
+/* One main function period of the exponential average: rate += (count - rate) / 2^CANNM_BUS_LOAD_WINDOW_SHIFT */
+static inline void CanNm_Internal_BusLoadTick( CanNm_Internal_BusLoadType* BusLoad )
+{
+	uint32 frames = BusLoad->Frames;
+	uint32 bits = BusLoad->Bits;
+
+	BusLoad->FrameRate += (((uint64)(frames - BusLoad->LastFrames) * CANNM_BUS_LOAD_ONE) >> CANNM_BUS_LOAD_WINDOW_SHIFT) -
+							(BusLoad->FrameRate >> CANNM_BUS_LOAD_WINDOW_SHIFT);
+	BusLoad->BitRate += (((uint64)(bits - BusLoad->LastBits) * CANNM_BUS_LOAD_ONE) >> CANNM_BUS_LOAD_WINDOW_SHIFT) -
+							(BusLoad->BitRate >> CANNM_BUS_LOAD_WINDOW_SHIFT);
+	BusLoad->LastFrames = frames;
+	BusLoad->LastBits = bits;
+}
+
+/* ticks periods without traffic at once, by (1 - 2^-CANNM_BUS_LOAD_WINDOW_SHIFT)^ticks in 32 bit fixed point */
+static inline void CanNm_Internal_BusLoadDecay( CanNm_Internal_BusLoadType* BusLoad, uint32 ticks )
+{
+	uint64 base = ((uint64)1 << 32) - ((uint64)1 << (32 - CANNM_BUS_LOAD_WINDOW_SHIFT));
+	uint64 factor = (uint64)1 << 32;
+
+	for (; ticks > 0 && factor != 0; ticks >>= 1) {
+		if (ticks & 1U) {
+			factor = (factor >> 16) * (base >> 16);
+		}
+		base = (base >> 16) * (base >> 16);
+	}
+	BusLoad->FrameRate = (BusLoad->FrameRate >> 16) * (factor >> 16);
+	BusLoad->BitRate = (BusLoad->BitRate >> 16) * (factor >> 16);
+}
+#endif
+
+/********************/
+/* Default callouts */
+/********************/
+static Std_ReturnType CanNm_Internal_CanIfTransmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+ 													const PduInfoType* PduInfoPtr )
+{
+	(void)Instance;
+	return CanIf_Transmit(TxPduId, PduInfoPtr);
+}
+
+static void CanNm_Internal_NmBusSleepMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	Nm_BusSleepMode(nmChannelHandle);
+}
+
+static void CanNm_Internal_NmNetworkMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	Nm_NetworkMode(nmChannelHandle);
+}
+
+static void CanNm_Internal_NmNetworkStartIndication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	Nm_NetworkStartIndication(nmChannelHandle);
+}
+
+static void CanNm_Internal_NmPduRxIndication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	Nm_PduRxIndication(nmChannelHandle);
+}
+
+static void CanNm_Internal_NmPrepareBusSleepMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	Nm_PrepareBusSleepMode(nmChannelHandle);
+}
+
+static void CanNm_Internal_NmRemoteSleepCancellation( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	Nm_RemoteSleepCancellation(nmChannelHandle);
+}
+
+static void CanNm_Internal_NmRemoteSleepInd( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	Nm_RemoteSleepInd(nmChannelHandle);
 }
 
-static inline uint8 CanNm_Internal_GetUserDataOffset( const CanNm_ChannelType* ChannelConf )
+static void CanNm_Internal_NmStateChangeNotification( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 													Nm_StateType nmPreviousState, Nm_StateType nmCurrentState )
 {
-	uint8 userDataPos = 0;
-	userDataPos += (ChannelConf->PduNidPosition == CANNM_PDU_OFF) ? 0 : 1;
-	userDataPos += (ChannelConf->PduCbvPosition == CANNM_PDU_OFF) ? 0 : 1;
-	return userDataPos;
+	(void)Instance;
+	Nm_StateChangeNotification(nmChannelHandle, nmPreviousState, nmCurrentState);
 }
 
-static inline uint8* CanNm_Internal_GetUserDataPtr( const CanNm_ChannelType* ChannelConf, uint8* MessageSduPtr )
+static void CanNm_Internal_NmTxTimeoutException( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
 {
-	uint8 userDataOffset = CanNm_Internal_GetUserDataOffset(ChannelConf);
-	return &MessageSduPtr[userDataOffset];
+	(void)Instance;
+	Nm_TxTimeoutException(nmChannelHandle);
 }
 
-static inline uint8 CanNm_Internal_GetUserDataLength( const CanNm_ChannelType* ChannelConf )
+static void CanNm_Internal_PduRCanNmRxIndication( CanNm_InstanceType* Instance, PduIdType RxPduId,
+ 												const PduInfoType* PduInfoPtr )
 {
-	uint8 userDataOffset = CanNm_Internal_GetUserDataOffset(ChannelConf);
-	return ChannelConf->UserDataTxPdu->TxUserDataPduRef->SduLength - userDataOffset;
+	(void)Instance;
+	PduR_CanNmRxIndication(RxPduId, PduInfoPtr);
 }
@@ -20,7 +20,19 @@
 /* [SWS_CanNm_00309] */
 #include "NmStack_Types.h"
 
-//#include "CanNm_Cfg.h
+#include "CanNm_Cfg.h"
+
+#if (CANNM_TRACE_ENABLED == STD_ON)
+#include "CanNm_Trace.h"
+#endif
+
+#if (CANNM_TIMING_ENABLED == STD_ON) || (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+#include "CanNm_Timing.h"
+#endif
+
+#if (CANNM_PCAP_ENABLED == STD_ON)
+#include "CanNm_Pcap.h"
+#endif
 
 /*====================================================================================================================*\
     Local macros Makra globalne
@@ -33,22 +45,26 @@
 #define CANNM_RXPDU_MAX_COUNT 128
 #endif
 
+#define CANNM_TICKS_INFINITE 0xFFFFFFFFUL		//CanNm_TicksToNextEvent with no timer running
+#define CANNM_ARENA_ALIGN 8U					//Arena alignment of CanNm_InstanceInit, the channel state holds uint64
+#define CANNM_STATE_COUNT (NM_STATE_SYNCHRONIZE + 1)	//Number of Nm_StateType values
+
 /*====================================================================================================================*\
     Global types
 \*====================================================================================================================*/
 typedef struct {
-	PduIdType	 RxPduId;
-	PduInfoType* RxPduRef;
+	PduIdType			RxPduId;
+	const PduInfoType*	RxPduRef;
 } CanNm_RxPdu;
 
 typedef struct {
-	PduIdType	 TxConfirmationPduId;
-	PduInfoType* TxPduRef;
+	PduIdType			TxConfirmationPduId;
+	const PduInfoType*	TxPduRef;
 } CanNm_TxPdu;
 
 typedef struct {
-	PduIdType	 TxUserDataPduId;
-	PduInfoType* TxUserDataPduRef;
+	PduIdType			TxUserDataPduId;
+	const PduInfoType*	TxUserDataPduRef;
 } CanNm_UserDataTxPdu;
 
 typedef enum {
@@ -62,6 +78,11 @@ typedef struct {
 	uint8 PnFilterMaskByteValue;
 } CanNm_PnFilterMaskByte;
 
+/** @brief CanNm_ChannelType
+ *
+ * Channel configuration as written by the integrator. Parameters used on every main function tick or received frame
+ * are copied into CanNm_ChannelHotType by CanNm_Init, the RxPdu array is kept at the end so it does not split them.
+ */
 typedef struct {
 	boolean						ActiveWakeupBitEnabled;
 	boolean						AllNmMessagesKeepAwake;
@@ -87,15 +108,62 @@ typedef struct {
 	float32						RemoteSleepIndTime;
 	float32						RepeatMessageTime;
 	boolean						RepeatMsgIndEnabled;
-	CanNm_RxPdu*				RxPdu[CANNM_RXPDU_MAX_COUNT];
 	float32						TimeoutTime;
-	CanNm_TxPdu*				TxPdu;
-	CanNm_UserDataTxPdu*		UserDataTxPdu;
+	const CanNm_TxPdu*			TxPdu;
+	const CanNm_UserDataTxPdu*	UserDataTxPdu;
 	float32						WaitBusSleepTime;
 	NetworkHandleType			ComMNetworkHandleRef;
 	PduInfoType					PnEraRxNSduRef;
+	const CanNm_RxPdu*			RxPdu[CANNM_RXPDU_MAX_COUNT];
 } CanNm_ChannelType;
 
+/** @brief CanNm_ChannelHotType
+ *
+ * Per channel parameters read by CanNm_MainFunction, CanNm_RxIndication and the state machine. Times are stored
+ * in main function ticks and the user data layout is precomputed, so the hot paths never touch CanNm_ChannelType.
+ * User data start at UserDataOffset, the byte behind the last control byte: with the CBV or NID in byte 1 they start
+ * at byte 2 even if byte 0 holds no control byte, which is then sent as 0.
+ * The block holds no pointers and is smaller than a 64 byte cache line, but the tables are not aligned to cache lines,
+ * so a block may span two of them. What this saves in cache misses per CanNm_RxIndication has not been measured; the
+ * RxIndication benchmarks of CanNm_Bench.c report L1D misses per call on hosts with hardware counters.
+ */
+typedef struct {
+	uint32						TimeoutTicks;
+	uint32						MsgCycleTicks;
+	uint32						MsgCycleOffsetTicks;
+	uint32						MsgReducedTicks;
+	uint32						ImmediateNmCycleTicks;
+	uint32						RepeatMessageTicks;
+	uint32						WaitBusSleepTicks;
+	uint32						RemoteSleepIndTicks;
+	PduIdType					TxPduId;
+	PduLengthType				TxSduLength;
+	PduLengthType				RxSduLength;
+	uint8						PduCbvPosition;
+	uint8						PduNidPosition;
+	uint8						UserDataOffset;
+	uint8						UserDataLength;
+	uint8						RxPduCount;
+	uint8						ImmediateNmTransmissions;
+	uint8						NodeId;
+	boolean						NodeIdEnabled;
+	boolean						NodeDetectionEnabled;
+	boolean						ActiveWakeupBitEnabled;
+	boolean						BusLoadReductionActive;
+	boolean						PnHandleMultipleNetworkRequests;
+} CanNm_ChannelHotType;
+
+/** @brief CanNm_ChannelPduType
+ *
+ * PDU buffers of one channel. Used by CanNm_Init instead of the buffer references in CanNm_ChannelType for
+ * configurations that carry no channel containers, e.g. a binary configuration blob (see CanNm_Blob.h).
+ */
+typedef struct {
+	const PduInfoType*			TxPduRef;
+	const PduInfoType*			TxUserDataPduRef;
+	const CanNm_RxPdu* const*	RxPdu;
+} CanNm_ChannelPduType;
+
 typedef struct {
 	const uint8 					PnInfoLength;
 	const uint8 					PnInfoOffset;
@@ -106,10 +174,10 @@ typedef struct {
  * 
  * This type shall contain at least all parameters that are post-build able according to chapter 10.
  */
-typedef struct {
+typedef struct CanNm_Config {
 	boolean				BusLoadReductionEnabled;
 	boolean				BusSynchronizationEnabled;
-	CanNm_ChannelType*	ChannelConfig[CANNM_CHANNEL_COUNT];
+	const CanNm_ChannelType*	ChannelConfig[CANNM_CHANNEL_COUNT];
 	boolean				ComControlEnabled;
 	boolean				ComUserDataSupport;
 	boolean				CoordinationSyncSupport;
@@ -121,18 +189,104 @@ typedef struct {
 	boolean				PassiveModeEnabled;
 	boolean				PduRxIndicationEnabled;
 	boolean				PnEiraCalcEnabled;
-	CanNm_PnInfo*		PnInfo;
+	const CanNm_PnInfo*	PnInfo;
 	float32				PnResetTime;
 	boolean				RemoteSleepIndEnabled;
 	boolean				StateChangeIndEnabled;
 	boolean				UserDataEnabled;
 	boolean				VersionInfoApi;
-	PduInfoType*		PnEiraRxNSduRef;
+	const PduInfoType*	PnEiraRxNSduRef;
+	const CanNm_ChannelHotType*	ChannelHot;						//Optional, precomputed by CanNm_CfgGen.py
+	const CanNm_ChannelPduType*	ChannelPdu;						//Optional, replaces ChannelConfig, requires ChannelHot
+	uint16						ChannelCount;					//Length of ChannelHot and ChannelPdu, 0 for CANNM_CHANNEL_COUNT
 } CanNm_ConfigType;
 
+/** @brief CanNm_StatisticsType
+ *
+ * Counters of one channel since initialization or the last reset, modulo 2^32. Transitions is indexed by the
+ * previous and the new Nm_StateType and counts every state change notification, including those staying in a state.
+ */
+typedef struct {
+	uint32						RxFrames;				//NM PDUs received
+	uint32						TxAttempts;				//NM PDUs passed to CanIf_Transmit
+	uint32						TxFailures;				//Rejected by CanIf_Transmit or negatively confirmed
+	uint32						TxConfirmations;		//Positively confirmed
+	uint32						TxTimeouts;				//Nm_TxTimeoutException calls
+	uint32						Transitions[CANNM_STATE_COUNT][CANNM_STATE_COUNT];
+} CanNm_StatisticsType;
+
+/** @brief CanNm_BusLoadType
+ *
+ * NM traffic of one channel, exponentially averaged over 2^CANNM_BUS_LOAD_WINDOW_SHIFT main function periods. Received
+ * frames are counted by CanNm_RxIndication, transmitted ones by a positive CanNm_TxConfirmation.
+ */
+typedef struct {
+	float32						RxFramesPerSecond;
+	float32						RxBitsPerSecond;
+	float32						TxFramesPerSecond;
+	float32						TxBitsPerSecond;
+} CanNm_BusLoadType;
+
+typedef enum {
+	CANNM_INIT,
+	CANNM_UNINIT
+} CanNm_InitStatusType;
+
+typedef struct CanNm_Instance CanNm_InstanceType;
+
+/** @brief CanNm_CallbacksType
+ *
+ * Callouts of one instance, each gets the calling instance first. They replace CanIf_Transmit, the Nm_* callbacks
+ * and PduR_CanNmRxIndication, so instances in one address space can be wired to different stacks or buses.
+ */
+typedef struct {
+	Std_ReturnType	(*CanIfTransmit)(CanNm_InstanceType* Instance, PduIdType TxPduId, const PduInfoType* PduInfoPtr);
+	void			(*BusSleepMode)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+	void			(*NetworkMode)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+	void			(*NetworkStartIndication)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+	void			(*PduRxIndication)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+	void			(*PrepareBusSleepMode)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+	void			(*RemoteSleepCancellation)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+	void			(*RemoteSleepInd)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+	void			(*StateChangeNotification)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 												Nm_StateType nmPreviousState, Nm_StateType nmCurrentState);
+	void			(*TxTimeoutException)(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+	void			(*PduRRxIndication)(CanNm_InstanceType* Instance, PduIdType RxPduId, const PduInfoType* PduInfoPtr);
+} CanNm_CallbacksType;
+
+/** @brief CanNm_InstanceType
+ *
+ * Complete state of one CanNm, the global API works on the default instance CanNm_Internal. The fields up to
+ * PendingConfigPtr and Timing belong to the module, Callbacks, Context, TraceRing and PcapRing to the caller.
+ */
+struct CanNm_Instance {
+	CanNm_InitStatusType					InitStatus;
+	uint16									ChannelCount;
+	struct CanNm_Internal_Channel*			Channels;					//Channel state, in the arena of CanNm_InstanceInit
+	const CanNm_ConfigType*					ConfigPtr;
+	const CanNm_ChannelHotType*				ChannelHotPtr;				//ConfigPtr->ChannelHot or a ChannelHotBank
+	CanNm_ChannelHotType*					ChannelHotBank[2];			//Derived parameters, second bank for SwitchConfig,
+																		//NULL with CANNM_GENERATED_CFG
+	const CanNm_ConfigType*					PendingConfigPtr;			//Set by CanNm_SwitchConfig, taken by the main function,
+																		//both in CANNM_EXCLUSIVE_AREA_0
+	const CanNm_CallbacksType*				Callbacks;					//NULL selects CanIf_Transmit, Nm_* and PduR_*
+	void*									Context;					//Free for the owner of the instance
+#if (CANNM_TRACE_ENABLED == STD_ON)
+	CanNm_TraceRingType*					TraceRing;					//Ring of the calling core, NULL records nothing
+#endif
+#if (CANNM_PCAP_ENABLED == STD_ON)
+	CanNm_PcapRingType*						PcapRing;					//Capture ring, NULL captures nothing
+#endif
+#if (CANNM_TIMING_ENABLED == STD_ON)
+	CanNm_TimingType						Timing[CANNM_TIMING_FUNCTION_COUNT];
+#endif
+};
+
 /*====================================================================================================================*\
     Global variables export
 \*====================================================================================================================*/
+/* Default instance of the global API */
+extern CanNm_InstanceType CanNm_Internal;
 
 /*====================================================================================================================*\
     Global functions declarations
@@ -142,7 +296,10 @@ typedef struct {
     Global inline functions and function macros code
 \*====================================================================================================================*/
 void CanNm_Init(const CanNm_ConfigType* cannmConfigPtr);
+uint32 CanNm_ChannelArenaSize(uint16 channelCount);
+Std_ReturnType CanNm_InitArena(const CanNm_ConfigType* cannmConfigPtr, void* arena, uint32 arenaSize);
 void CanNm_DeInit(void);
+Std_ReturnType CanNm_SwitchConfig(const CanNm_ConfigType* cannmConfigPtr);
 Std_ReturnType CanNm_PassiveStartUp(NetworkHandleType nmChannelHandle);
 Std_ReturnType CanNm_NetworkRequest(NetworkHandleType nmChannelHandle);
 Std_ReturnType CanNm_NetworkRelease(NetworkHandleType nmChannelHandle);
@@ -165,5 +322,71 @@ void CanNm_TxConfirmation(PduIdType TxPduId, Std_ReturnType result);
 void CanNm_RxIndication(PduIdType RxPduId, const PduInfoType* PduInfoPtr);
 void CanNm_ConfirmPnAvailability(NetworkHandleType nmChannelHandle);
 Std_ReturnType CanNm_TriggerTransmit(PduIdType TxPduId, PduInfoType* PduInfoPtr);
+void CanNm_MainFunction(void);
+uint32 CanNm_TicksToNextEvent(void);
+void CanNm_SkipTicks(uint32 ticks);
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+Std_ReturnType CanNm_GetStatistics(NetworkHandleType nmChannelHandle, CanNm_StatisticsType* statisticsPtr);
+Std_ReturnType CanNm_ResetStatistics(NetworkHandleType nmChannelHandle);
+#endif
+#if (CANNM_TIMING_ENABLED == STD_ON)
+Std_ReturnType CanNm_GetTiming(uint8 function, CanNm_TimingSummaryType* timingPtr);
+void CanNm_ResetTiming(void);
+#endif
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+Std_ReturnType CanNm_GetWakeupLatency(NetworkHandleType nmChannelHandle, CanNm_WakeupLatencyType* latencyPtr);
+Std_ReturnType CanNm_ResetWakeupLatency(NetworkHandleType nmChannelHandle);
+#endif
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+Std_ReturnType CanNm_GetBusLoad(NetworkHandleType nmChannelHandle, CanNm_BusLoadType* busLoadPtr);
+#endif
+
+/* Multi-instance API, the functions above on an explicit instance */
+Std_ReturnType CanNm_InstanceInit(CanNm_InstanceType* Instance, const CanNm_ConfigType* cannmConfigPtr, void* arena,
+ 									uint32 arenaSize);
+void CanNm_InstanceDeInit(CanNm_InstanceType* Instance);
+Std_ReturnType CanNm_InstanceSwitchConfig(CanNm_InstanceType* Instance, const CanNm_ConfigType* cannmConfigPtr);
+Std_ReturnType CanNm_InstancePassiveStartUp(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+Std_ReturnType CanNm_InstanceNetworkRequest(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+Std_ReturnType CanNm_InstanceNetworkRelease(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+Std_ReturnType CanNm_InstanceDisableCommunication(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+Std_ReturnType CanNm_InstanceEnableCommunication(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+Std_ReturnType CanNm_InstanceSetUserData(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, const uint8* nmUserDataPtr);
+Std_ReturnType CanNm_InstanceGetUserData(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, uint8* nmUserDataPtr);
+Std_ReturnType CanNm_InstanceTransmit(CanNm_InstanceType* Instance, PduIdType TxPduId, const PduInfoType* PduInfoPtr);
+Std_ReturnType CanNm_InstanceGetNodeIdentifier(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, uint8*nmNodeIdPtr);
+Std_ReturnType CanNm_InstanceGetLocalNodeIdentifier(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, uint8* nmNodeIdPtr);
+Std_ReturnType CanNm_InstanceRepeatMessageRequest(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+Std_ReturnType CanNm_InstanceGetPduData(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, uint8* nmPduDataPtr);
+Std_ReturnType CanNm_InstanceGetState(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, Nm_StateType* nmStatePtr, Nm_ModeType* nmModePtr);
+Std_ReturnType CanNm_InstanceRequestBusSynchronization(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+Std_ReturnType CanNm_InstanceCheckRemoteSleepInd(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle, boolean* nmRemoteSleepIndPtr);
+Std_ReturnType CanNm_InstanceSetSleepReadyBit(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,boolean nmSleepReadyBit);
+void CanNm_InstanceTxConfirmation(CanNm_InstanceType* Instance, PduIdType TxPduId, Std_ReturnType result);
+void CanNm_InstanceRxIndication(CanNm_InstanceType* Instance, PduIdType RxPduId, const PduInfoType* PduInfoPtr);
+void CanNm_InstanceConfirmPnAvailability(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+Std_ReturnType CanNm_InstanceTriggerTransmit(CanNm_InstanceType* Instance, PduIdType TxPduId, PduInfoType* PduInfoPtr);
+void CanNm_InstanceMainFunction(CanNm_InstanceType* Instance);
+uint32 CanNm_InstanceTicksToNextEvent(const CanNm_InstanceType* Instance);
+void CanNm_InstanceSkipTicks(CanNm_InstanceType* Instance, uint32 ticks);
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+Std_ReturnType CanNm_InstanceGetStatistics(const CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 											CanNm_StatisticsType* statisticsPtr);
+Std_ReturnType CanNm_InstanceResetStatistics(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+#endif
+#if (CANNM_TIMING_ENABLED == STD_ON)
+Std_ReturnType CanNm_InstanceGetTiming(const CanNm_InstanceType* Instance, uint8 function,
+ 										CanNm_TimingSummaryType* timingPtr);
+void CanNm_InstanceResetTiming(CanNm_InstanceType* Instance);
+#endif
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+Std_ReturnType CanNm_InstanceGetWakeupLatency(const CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 												CanNm_WakeupLatencyType* latencyPtr);
+Std_ReturnType CanNm_InstanceResetWakeupLatency(CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle);
+#endif
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+Std_ReturnType CanNm_InstanceGetBusLoad(const CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 										CanNm_BusLoadType* busLoadPtr);
+#endif
 
 #endif /* CANNM_H */
@@ -0,0 +1,649 @@
+/** ==================================================================================================================*\
+  @file CanNm_Bench.c
+
+  @brief Can Network Management Module - hot path microbenchmarks
+
+  Measures nanoseconds and TSC cycles per call of CanNm_MainFunction with 1, 16, 256 and 1024 channels, idle (all
+  channels in Bus-Sleep Mode) and active (all channels requested, timers and transmissions running), of
+  CanNm_RxIndication in Normal Operation with and without node detection, user data and partial networking, of
+  CanNm_TriggerTransmit and of CanNm_SetUserData. Every benchmark runs on its own instance with empty callouts, so
+  only CanNm itself is measured. Each of CANNM_BENCH_SAMPLES samples times a batch of calls sized to about
+  CANNM_BENCH_SAMPLE_TIME, and all per call samples are written as JSON for later comparison:
+
+      gcc -O2 -DUNIT_TEST -DCANNM_CHANNEL_COUNT=1024 -o CanNm_Bench CanNm_Bench.c CanNm.c
+      ./CanNm_Bench [result.json]
+
+  The benchmark names are stable, "unit" is ns per call and "cycles" is null where no TSC is available.
+
+  On Linux the user space hardware counters of perf_event_open (cycles, instructions, L1D read misses, branches and
+  branch misses) run around the timed samples of every benchmark and are reported per call, together with the IPC,
+  L1D misses per 1000 instructions and the branch miss rate. Counters that cannot be opened, as in most containers
+  and virtual machines or with kernel.perf_event_paranoid > 2, are reported as null and the top level "counters"
+  entry gives the reason; the timing results are not affected.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#if defined(__linux__)
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "CanNm.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_BENCH_MAX_CHANNELS					1024U
+#define CANNM_BENCH_SAMPLES							31U
+#define CANNM_BENCH_SAMPLE_TIME						2000000ULL	//ns
+#define CANNM_BENCH_WARMUP_TIME						20000000ULL	//ns
+#define CANNM_BENCH_SDU_LENGTH						8U
+#define CANNM_BENCH_MAX_RESULTS						32U
+
+#define CANNM_BENCH_COUNTER_CYCLES					0U
+#define CANNM_BENCH_COUNTER_INSTRUCTIONS			1U
+#define CANNM_BENCH_COUNTER_L1D_MISSES				2U
+#define CANNM_BENCH_COUNTER_BRANCHES				3U
+#define CANNM_BENCH_COUNTER_BRANCH_MISSES			4U
+#define CANNM_BENCH_COUNTERS						5U
+
+#if CANNM_CHANNEL_COUNT < CANNM_BENCH_MAX_CHANNELS
+#error "Build the benchmarks with -DCANNM_CHANNEL_COUNT=1024"
+#endif
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+typedef struct CanNm_Bench_Case CanNm_Bench_CaseType;
+
+/* Instance under test with its configuration and buffers */
+struct CanNm_Bench_Case {
+	const char*					Name;
+	uint16						ChannelCount;
+	void						(*Call)(CanNm_Bench_CaseType* Case);
+	CanNm_InstanceType			Instance;
+	CanNm_ConfigType			Config;
+	CanNm_ChannelType*			Channels;
+	uint8*						Sdu;					//Tx, Rx and user data SDU of every channel
+	PduInfoType*				PduInfo;				//Tx and Rx PduInfo of every channel
+	CanNm_TxPdu*				TxPdu;
+	CanNm_UserDataTxPdu*		UserDataTxPdu;
+	CanNm_RxPdu*				RxPdu;
+	void*						Arena;
+	uint8						Frame[CANNM_BENCH_SDU_LENGTH];
+	PduInfoType					FrameInfo;
+};
+
+/* Result of one benchmark */
+typedef struct {
+	const char*					Name;
+	uint16						ChannelCount;
+	uint32						CallsPerSample;
+	float64						Samples[CANNM_BENCH_SAMPLES];	//ns per call
+	float64						Cycles;					//TSC cycles per call, median sample, negative if none
+	float64						Counters[CANNM_BENCH_COUNTERS];	//Events per call, negative if not counted
+} CanNm_Bench_ResultType;
+
+/* perf_event_open group, the first open counter is the leader */
+typedef struct {
+	int							Fd[CANNM_BENCH_COUNTERS];	//-1 if not open
+	uint8						Slot[CANNM_BENCH_COUNTERS];	//Position in the group read
+	uint8						Count;
+	const char*					Status;
+} CanNm_Bench_CountersType;
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static Std_ReturnType CanNm_Bench_Setup( CanNm_Bench_CaseType* Case, uint16 channelCount, boolean nodeDetection,
+ 											boolean userData, boolean pn );
+static void CanNm_Bench_Teardown( CanNm_Bench_CaseType* Case );
+static void CanNm_Bench_Measure( CanNm_Bench_CaseType* Case, CanNm_Bench_ResultType* Result );
+static uint64 CanNm_Bench_Time( void );
+static uint64 CanNm_Bench_Cycles( void );
+static int CanNm_Bench_Compare( const void* A, const void* B );
+static void CanNm_Bench_Write( FILE* File, const CanNm_Bench_ResultType* Results, uint32 resultCount );
+static void CanNm_Bench_WriteCounters( FILE* File, const CanNm_Bench_ResultType* Result );
+static void CanNm_Bench_CountersOpen( void );
+static void CanNm_Bench_CountersStart( void );
+static void CanNm_Bench_CountersStop( float64* Counters, uint64 calls );
+
+static void CanNm_Bench_MainFunction( CanNm_Bench_CaseType* Case );
+static void CanNm_Bench_RxIndication( CanNm_Bench_CaseType* Case );
+static void CanNm_Bench_TriggerTransmit( CanNm_Bench_CaseType* Case );
+static void CanNm_Bench_SetUserData( CanNm_Bench_CaseType* Case );
+
+static Std_ReturnType CanNm_Bench_Transmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+ 											const PduInfoType* PduInfoPtr );
+static void CanNm_Bench_Indication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Bench_StateChange( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 										Nm_StateType nmPreviousState, Nm_StateType nmCurrentState );
+static void CanNm_Bench_PduIndication( CanNm_InstanceType* Instance, PduIdType PduId, const PduInfoType* PduInfoPtr );
+
+/*====================================================================================================================*\
+    Local variables (static)
+\*====================================================================================================================*/
+
+/* Empty callouts, the benchmarks measure CanNm only */
+static const CanNm_CallbacksType CanNm_Bench_Callbacks = {
+	.CanIfTransmit = CanNm_Bench_Transmit,
+	.BusSleepMode = CanNm_Bench_Indication,
+	.NetworkMode = CanNm_Bench_Indication,
+	.NetworkStartIndication = CanNm_Bench_Indication,
+	.PduRxIndication = CanNm_Bench_Indication,
+	.PrepareBusSleepMode = CanNm_Bench_Indication,
+	.RemoteSleepCancellation = CanNm_Bench_Indication,
+	.RemoteSleepInd = CanNm_Bench_Indication,
+	.StateChangeNotification = CanNm_Bench_StateChange,
+	.TxTimeoutException = CanNm_Bench_Indication,
+	.PduRRxIndication = CanNm_Bench_PduIndication
+};
+
+static const CanNm_PnFilterMaskByte CanNm_Bench_PnFilterMaskByte = {
+	.PnFilterMaskByteIndex = 0,
+	.PnFilterMaskByteValue = 0x81
+};
+
+static const CanNm_PnInfo CanNm_Bench_PnInfo = {
+	.PnInfoLength = 1,
+	.PnInfoOffset = 2,
+	.PnFilterMaskByte = &CanNm_Bench_PnFilterMaskByte
+};
+
+/* JSON names of the counters */
+static const char* const CanNm_Bench_CounterNames[CANNM_BENCH_COUNTERS] = {
+	"cycles", "instructions", "l1d_misses", "branches", "branch_misses"
+};
+
+static CanNm_Bench_CountersType CanNm_Bench_Counters;
+
+/* volatile sink so the compiler keeps the calls */
+static volatile uint32 CanNm_Bench_Sink;
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+int main(int argc, char** argv)
+{
+	static const uint16 channelCounts[] = { 1, 16, 256, 1024 };
+	static const struct {
+		const char* Name;
+		boolean NodeDetection;
+		boolean UserData;
+		boolean Pn;
+	} rxVariants[] = {
+		{ "RxIndication/plain", FALSE, FALSE, FALSE },
+		{ "RxIndication/node_detection", TRUE, FALSE, FALSE },
+		{ "RxIndication/user_data", FALSE, TRUE, FALSE },
+		{ "RxIndication/pn", FALSE, FALSE, TRUE },
+		{ "RxIndication/all", TRUE, TRUE, TRUE }
+	};
+	static CanNm_Bench_ResultType Results[CANNM_BENCH_MAX_RESULTS];
+	static char names[8][48];
+	CanNm_Bench_CaseType Case;
+	uint32 resultCount = 0;
+	FILE* File = stdout;
+
+	CanNm_Bench_CountersOpen();
+	for (uint8 index = 0; index < 4; index++) {
+		for (uint8 active = 0; active < 2; active++) {
+			snprintf(names[index * 2 + active], sizeof(names[0]), "MainFunction/%s/channels=%u",
+				active ? "active" : "idle", channelCounts[index]);
+			if (CanNm_Bench_Setup(&Case, channelCounts[index], TRUE, TRUE, FALSE) != E_OK) {
+				fprintf(stderr, "setup failed\n");
+				return EXIT_FAILURE;
+			}
+			for (uint16 channel = 0; channel < channelCounts[index] && active; channel++) {
+				CanNm_InstanceNetworkRequest(&Case.Instance, channel);
+			}
+			Case.Name = names[index * 2 + active];
+			Case.Call = CanNm_Bench_MainFunction;
+			CanNm_Bench_Measure(&Case, &Results[resultCount++]);
+			CanNm_Bench_Teardown(&Case);
+		}
+	}
+
+	for (uint8 index = 0; index < sizeof(rxVariants) / sizeof(rxVariants[0]); index++) {
+		if (CanNm_Bench_Setup(&Case, 1, rxVariants[index].NodeDetection, rxVariants[index].UserData,
+								rxVariants[index].Pn) != E_OK) {
+			return EXIT_FAILURE;
+		}
+		/* Normal Operation, the frame of a remote node without repeat message request */
+		CanNm_InstanceNetworkRequest(&Case.Instance, 0);
+		for (uint16 tick = 0; tick < 2000; tick++) {
+			CanNm_InstanceMainFunction(&Case.Instance);
+		}
+		Case.Frame[0] = 0x42;
+		Case.Frame[1] = 0x00;
+		Case.Frame[2] = 0x81;
+		Case.Name = rxVariants[index].Name;
+		Case.Call = CanNm_Bench_RxIndication;
+		CanNm_Bench_Measure(&Case, &Results[resultCount++]);
+		CanNm_Bench_Teardown(&Case);
+	}
+
+	if (CanNm_Bench_Setup(&Case, 1, TRUE, TRUE, FALSE) != E_OK) {
+		return EXIT_FAILURE;
+	}
+	Case.Name = "TriggerTransmit";
+	Case.Call = CanNm_Bench_TriggerTransmit;
+	CanNm_Bench_Measure(&Case, &Results[resultCount++]);
+	Case.Name = "SetUserData";
+	Case.Call = CanNm_Bench_SetUserData;
+	CanNm_Bench_Measure(&Case, &Results[resultCount++]);
+	CanNm_Bench_Teardown(&Case);
+
+	if (argc > 1 && (File = fopen(argv[1], "w")) == NULL) {
+		perror(argv[1]);
+		return EXIT_FAILURE;
+	}
+	CanNm_Bench_Write(File, Results, resultCount);
+	if (File != stdout) {
+		fclose(File);
+	}
+	return EXIT_SUCCESS;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+/** @brief CanNm_Bench_Setup
+ *
+ * Instance of channelCount channels like the "Body" channel of CanNm_Cfg.json, times in ms with a 10 ms period.
+ * Channel n sends after an offset of n ms modulo the cycle, so active channels do not all transmit in one period.
+ */
+static Std_ReturnType CanNm_Bench_Setup( CanNm_Bench_CaseType* Case, uint16 channelCount, boolean nodeDetection,
+ 											boolean userData, boolean pn )
+{
+	memset(Case, 0, sizeof(CanNm_Bench_CaseType));
+	Case->ChannelCount = channelCount;
+	Case->Channels = calloc(channelCount, sizeof(CanNm_ChannelType));
+	Case->Sdu = calloc(channelCount, 3 * CANNM_BENCH_SDU_LENGTH);
+	Case->PduInfo = calloc(channelCount, 2 * sizeof(PduInfoType));
+	Case->TxPdu = calloc(channelCount, sizeof(CanNm_TxPdu));
+	Case->UserDataTxPdu = calloc(channelCount, sizeof(CanNm_UserDataTxPdu));
+	Case->RxPdu = calloc(channelCount, sizeof(CanNm_RxPdu));
+	Case->Arena = aligned_alloc(64, (CanNm_ChannelArenaSize(channelCount) + 63) & ~63U);
+	if (Case->Channels == NULL || Case->Sdu == NULL || Case->PduInfo == NULL || Case->TxPdu == NULL ||
+		Case->UserDataTxPdu == NULL || Case->RxPdu == NULL || Case->Arena == NULL) {
+		CanNm_Bench_Teardown(Case);
+		return E_NOT_OK;
+	}
+
+	Case->Config.MainFunctionPeriod = 10.0;
+	Case->Config.UserDataEnabled = userData;
+	Case->Config.GlobalPnSupport = pn;
+	Case->Config.PnInfo = pn ? &CanNm_Bench_PnInfo : NULL;
+	Case->Config.RemoteSleepIndEnabled = TRUE;
+	Case->Config.ChannelCount = channelCount;
+	for (uint16 channel = 0; channel < channelCount; channel++) {
+		CanNm_ChannelType* Channel = &Case->Channels[channel];
+		PduInfoType* TxPduInfo = &Case->PduInfo[2 * channel];
+		PduInfoType* RxPduInfo = &Case->PduInfo[2 * channel + 1];
+
+		TxPduInfo->SduDataPtr = &Case->Sdu[3 * CANNM_BENCH_SDU_LENGTH * channel];
+		TxPduInfo->SduLength = CANNM_BENCH_SDU_LENGTH;
+		RxPduInfo->SduDataPtr = TxPduInfo->SduDataPtr + CANNM_BENCH_SDU_LENGTH;
+		RxPduInfo->SduLength = CANNM_BENCH_SDU_LENGTH;
+		Case->TxPdu[channel].TxConfirmationPduId = channel;
+		Case->TxPdu[channel].TxPduRef = TxPduInfo;
+		Case->UserDataTxPdu[channel].TxUserDataPduId = channel;
+		Case->UserDataTxPdu[channel].TxUserDataPduRef = TxPduInfo;
+		Case->RxPdu[channel].RxPduId = channel;
+		Case->RxPdu[channel].RxPduRef = RxPduInfo;
+
+		Channel->ActiveWakeupBitEnabled = TRUE;
+		Channel->ImmediateNmCycleTime = 20;
+		Channel->ImmediateNmTransmissions = 3;
+		Channel->MsgCycleOffset = (float32)(channel % 1000);
+		Channel->MsgCycleTime = 1000;
+		Channel->NodeDetectionEnabled = nodeDetection;
+		Channel->NodeId = (uint8)channel;
+		Channel->NodeIdEnabled = TRUE;
+		Channel->PduCbvPosition = CANNM_PDU_BYTE_1;
+		Channel->PduNidPosition = CANNM_PDU_BYTE_0;
+		Channel->PnEnabled = pn;
+		Channel->RemoteSleepIndTime = 3000;
+		Channel->RepeatMessageTime = 1500;
+		Channel->TimeoutTime = 2000;
+		Channel->TxPdu = &Case->TxPdu[channel];
+		Channel->UserDataTxPdu = &Case->UserDataTxPdu[channel];
+		Channel->WaitBusSleepTime = 2000;
+		Channel->RxPdu[0] = &Case->RxPdu[channel];
+		Case->Config.ChannelConfig[channel] = Channel;
+	}
+
+	Case->Instance.Callbacks = &CanNm_Bench_Callbacks;
+	Case->FrameInfo.SduDataPtr = Case->Frame;
+	Case->FrameInfo.SduLength = CANNM_BENCH_SDU_LENGTH;
+	return CanNm_InstanceInit(&Case->Instance, &Case->Config, Case->Arena, CanNm_ChannelArenaSize(channelCount));
+}
+
+static void CanNm_Bench_Teardown( CanNm_Bench_CaseType* Case )
+{
+	free(Case->Channels);
+	free(Case->Sdu);
+	free(Case->PduInfo);
+	free(Case->TxPdu);
+	free(Case->UserDataTxPdu);
+	free(Case->RxPdu);
+	free(Case->Arena);
+}
+
+/** @brief CanNm_Bench_Measure
+ *
+ * Warm up, size the batch to CANNM_BENCH_SAMPLE_TIME and time CANNM_BENCH_SAMPLES batches.
+ */
+static void CanNm_Bench_Measure( CanNm_Bench_CaseType* Case, CanNm_Bench_ResultType* Result )
+{
+	float64 cycles[CANNM_BENCH_SAMPLES];
+	uint64 calls = 0;
+	uint64 start = CanNm_Bench_Time();
+	uint64 elapsed;
+
+	do {
+		Case->Call(Case);
+		calls++;
+		elapsed = CanNm_Bench_Time() - start;
+	} while (elapsed < CANNM_BENCH_WARMUP_TIME);
+
+	Result->Name = Case->Name;
+	Result->ChannelCount = Case->ChannelCount;
+	Result->CallsPerSample = (uint32)((calls * CANNM_BENCH_SAMPLE_TIME) / elapsed);
+	Result->CallsPerSample = (Result->CallsPerSample > 0) ? Result->CallsPerSample : 1;
+
+	CanNm_Bench_CountersStart();
+	for (uint32 sample = 0; sample < CANNM_BENCH_SAMPLES; sample++) {
+		uint64 startCycles = CanNm_Bench_Cycles();
+		start = CanNm_Bench_Time();
+		for (uint32 call = 0; call < Result->CallsPerSample; call++) {
+			Case->Call(Case);
+		}
+		elapsed = CanNm_Bench_Time() - start;
+		cycles[sample] = (float64)(CanNm_Bench_Cycles() - startCycles) / Result->CallsPerSample;
+		Result->Samples[sample] = (float64)elapsed / Result->CallsPerSample;
+	}
+	CanNm_Bench_CountersStop(Result->Counters, (uint64)Result->CallsPerSample * CANNM_BENCH_SAMPLES);
+	qsort(cycles, CANNM_BENCH_SAMPLES, sizeof(float64), CanNm_Bench_Compare);
+	Result->Cycles = (CanNm_Bench_Cycles() != 0) ? cycles[CANNM_BENCH_SAMPLES / 2] : -1.0;
+}
+
+static uint64 CanNm_Bench_Time( void )
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64)now.tv_sec * 1000000000ULL + (uint64)now.tv_nsec;
+}
+
+static uint64 CanNm_Bench_Cycles( void )
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static int CanNm_Bench_Compare( const void* A, const void* B )
+{
+	float64 a = *(const float64*)A;
+	float64 b = *(const float64*)B;
+
+	return (a > b) - (a < b);
+}
+
+/** @brief CanNm_Bench_Write
+ *
+ * JSON result file: host information and per benchmark the raw samples with their summary.
+ */
+static void CanNm_Bench_Write( FILE* File, const CanNm_Bench_ResultType* Results, uint32 resultCount )
+{
+	fprintf(File, "{\n  \"suite\": \"CanNm\",\n  \"schema\": 1,\n  \"timestamp\": %lld,\n", (long long)time(NULL));
+	fprintf(File, "  \"compiler\": \"%s\",\n  \"counters\": \"%s\",\n  \"benchmarks\": [\n", __VERSION__,
+		CanNm_Bench_Counters.Status);
+	for (uint32 index = 0; index < resultCount; index++) {
+		const CanNm_Bench_ResultType* Result = &Results[index];
+		float64 sorted[CANNM_BENCH_SAMPLES];
+		float64 mean = 0;
+
+		memcpy(sorted, Result->Samples, sizeof(sorted));
+		qsort(sorted, CANNM_BENCH_SAMPLES, sizeof(float64), CanNm_Bench_Compare);
+		for (uint32 sample = 0; sample < CANNM_BENCH_SAMPLES; sample++) {
+			mean += sorted[sample] / CANNM_BENCH_SAMPLES;
+		}
+
+		fprintf(File, "    {\"name\": \"%s\", \"channels\": %u, \"unit\": \"ns\", \"calls_per_sample\": %u,\n",
+			Result->Name, Result->ChannelCount, Result->CallsPerSample);
+		fprintf(File, "     \"median\": %.3f, \"mean\": %.3f, \"min\": %.3f, \"max\": %.3f, ",
+			sorted[CANNM_BENCH_SAMPLES / 2], mean, sorted[0], sorted[CANNM_BENCH_SAMPLES - 1]);
+		if (Result->Cycles >= 0) {
+			fprintf(File, "\"cycles\": %.1f,\n", Result->Cycles);
+		}
+		else {
+			fprintf(File, "\"cycles\": null,\n");
+		}
+		CanNm_Bench_WriteCounters(File, Result);
+		fprintf(File, "     \"samples\": [");
+		for (uint32 sample = 0; sample < CANNM_BENCH_SAMPLES; sample++) {
+			fprintf(File, "%s%.3f", (sample > 0) ? ", " : "", Result->Samples[sample]);
+		}
+		fprintf(File, "]}%s\n", (index + 1 < resultCount) ? "," : "");
+	}
+	fprintf(File, "  ]\n}\n");
+}
+
+/** @brief CanNm_Bench_WriteCounters
+ *
+ * Counter events per call and the derived IPC, L1D misses per 1000 instructions and branch miss rate, null where a
+ * counter is missing.
+ */
+static void CanNm_Bench_WriteCounters( FILE* File, const CanNm_Bench_ResultType* Result )
+{
+	static const char* const derivedNames[3] = { "ipc", "l1d_mpki", "branch_miss_rate" };
+	const float64* Counters = Result->Counters;
+	float64 derived[3] = { -1.0, -1.0, -1.0 };
+
+	if (Counters[CANNM_BENCH_COUNTER_CYCLES] > 0 && Counters[CANNM_BENCH_COUNTER_INSTRUCTIONS] >= 0) {
+		derived[0] = Counters[CANNM_BENCH_COUNTER_INSTRUCTIONS] / Counters[CANNM_BENCH_COUNTER_CYCLES];
+	}
+	if (Counters[CANNM_BENCH_COUNTER_INSTRUCTIONS] > 0 && Counters[CANNM_BENCH_COUNTER_L1D_MISSES] >= 0) {
+		derived[1] = 1000.0 * Counters[CANNM_BENCH_COUNTER_L1D_MISSES] / Counters[CANNM_BENCH_COUNTER_INSTRUCTIONS];
+	}
+	if (Counters[CANNM_BENCH_COUNTER_BRANCHES] > 0 && Counters[CANNM_BENCH_COUNTER_BRANCH_MISSES] >= 0) {
+		derived[2] = Counters[CANNM_BENCH_COUNTER_BRANCH_MISSES] / Counters[CANNM_BENCH_COUNTER_BRANCHES];
+	}
+
+	fprintf(File, "     \"counters\": {");
+	for (uint8 counter = 0; counter < CANNM_BENCH_COUNTERS; counter++) {
+		if (Counters[counter] >= 0) {
+			fprintf(File, "\"%s\": %.3f, ", CanNm_Bench_CounterNames[counter], Counters[counter]);
+		}
+		else {
+			fprintf(File, "\"%s\": null, ", CanNm_Bench_CounterNames[counter]);
+		}
+	}
+	for (uint8 index = 0; index < 3; index++) {
+		if (derived[index] >= 0) {
+			fprintf(File, "\"%s\": %.4f%s", derivedNames[index], derived[index], (index < 2) ? ", " : "},\n");
+		}
+		else {
+			fprintf(File, "\"%s\": null%s", derivedNames[index], (index < 2) ? ", " : "},\n");
+		}
+	}
+}
+
+/** @brief CanNm_Bench_CountersOpen
+ *
+ * Open one perf_event_open group of the user space counters of this thread. Counters the PMU or the kernel refuses
+ * are left out, without any counter Status names the reason.
+ */
+static void CanNm_Bench_CountersOpen( void )
+{
+	CanNm_Bench_CountersType* Counters = &CanNm_Bench_Counters;
+
+	for (uint8 counter = 0; counter < CANNM_BENCH_COUNTERS; counter++) {
+		Counters->Fd[counter] = -1;
+	}
+#if defined(__linux__)
+	static const struct {
+		uint32 Type;
+		uint64 Config;
+	} events[CANNM_BENCH_COUNTERS] = {
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+								(PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+	};
+	int leader = -1;
+	int error = 0;
+
+	for (uint8 counter = 0; counter < CANNM_BENCH_COUNTERS; counter++) {
+		struct perf_event_attr attr;
+
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = events[counter].Type;
+		attr.config = events[counter].Config;
+		attr.disabled = (leader < 0);
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		Counters->Fd[counter] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+		if (Counters->Fd[counter] < 0) {
+			error = (error == 0) ? errno : error;
+			continue;
+		}
+		leader = (leader < 0) ? Counters->Fd[counter] : leader;
+		Counters->Slot[counter] = Counters->Count++;
+	}
+	if (Counters->Count == 0) {
+		Counters->Status = (error == EACCES || error == EPERM) ? "unavailable: permission denied" :
+							(error == ENOSYS) ? "unavailable: no perf_event_open" :
+							"unavailable: no hardware counters";
+	}
+	else {
+		Counters->Status = (Counters->Count < CANNM_BENCH_COUNTERS) ? "perf_event (partial)" : "perf_event";
+	}
+#else
+	Counters->Status = "unavailable: not Linux";
+#endif
+}
+
+static void CanNm_Bench_CountersStart( void )
+{
+#if defined(__linux__)
+	for (uint8 counter = 0; counter < CANNM_BENCH_COUNTERS; counter++) {
+		if (CanNm_Bench_Counters.Fd[counter] >= 0) {
+			ioctl(CanNm_Bench_Counters.Fd[counter], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+			ioctl(CanNm_Bench_Counters.Fd[counter], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+			break;
+		}
+	}
+#endif
+}
+
+/** @brief CanNm_Bench_CountersStop
+ *
+ * Stop the group and store events per call, scaled up if the kernel multiplexed the group.
+ */
+static void CanNm_Bench_CountersStop( float64* Counters, uint64 calls )
+{
+	for (uint8 counter = 0; counter < CANNM_BENCH_COUNTERS; counter++) {
+		Counters[counter] = -1.0;
+	}
+#if defined(__linux__)
+	uint64 values[3 + CANNM_BENCH_COUNTERS];
+	int leader = -1;
+
+	for (uint8 counter = 0; counter < CANNM_BENCH_COUNTERS && leader < 0; counter++) {
+		leader = CanNm_Bench_Counters.Fd[counter];
+	}
+	if (leader < 0) {
+		return;
+	}
+	ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	/* nr, time enabled, time running, then the values in open order */
+	if (read(leader, values, sizeof(values)) < (ssize_t)(3 * sizeof(uint64)) || values[2] == 0) {
+		return;
+	}
+	for (uint8 counter = 0; counter < CANNM_BENCH_COUNTERS; counter++) {
+		if (CanNm_Bench_Counters.Fd[counter] >= 0) {
+			float64 scale = (float64)values[1] / (float64)values[2];
+
+			Counters[counter] = (float64)values[3 + CanNm_Bench_Counters.Slot[counter]] * scale / (float64)calls;
+		}
+	}
+#endif
+}
+
+static void CanNm_Bench_MainFunction( CanNm_Bench_CaseType* Case )
+{
+	CanNm_InstanceMainFunction(&Case->Instance);
+}
+
+static void CanNm_Bench_RxIndication( CanNm_Bench_CaseType* Case )
+{
+	CanNm_InstanceRxIndication(&Case->Instance, 0, &Case->FrameInfo);
+}
+
+static void CanNm_Bench_TriggerTransmit( CanNm_Bench_CaseType* Case )
+{
+	uint8 sdu[CANNM_BENCH_SDU_LENGTH];
+	PduInfoType PduInfo = { .SduDataPtr = sdu, .SduLength = sizeof(sdu) };
+
+	CanNm_Bench_Sink += CanNm_InstanceTriggerTransmit(&Case->Instance, 0, &PduInfo) + sdu[0];
+}
+
+static void CanNm_Bench_SetUserData( CanNm_Bench_CaseType* Case )
+{
+	Case->Frame[7]++;
+	CanNm_Bench_Sink += CanNm_InstanceSetUserData(&Case->Instance, 0, Case->Frame);
+}
+
+static Std_ReturnType CanNm_Bench_Transmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+ 											const PduInfoType* PduInfoPtr )
+{
+	(void)Instance;
+	(void)TxPduId;
+	(void)PduInfoPtr;
+	return E_OK;
+}
+
+static void CanNm_Bench_Indication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	(void)nmChannelHandle;
+}
+
+static void CanNm_Bench_StateChange( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 										Nm_StateType nmPreviousState, Nm_StateType nmCurrentState )
+{
+	(void)Instance;
+	(void)nmChannelHandle;
+	(void)nmPreviousState;
+	(void)nmCurrentState;
+}
+
+static void CanNm_Bench_PduIndication( CanNm_InstanceType* Instance, PduIdType PduId, const PduInfoType* PduInfoPtr )
+{
+	(void)Instance;
+	(void)PduId;
+	(void)PduInfoPtr;
+}
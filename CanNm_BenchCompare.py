@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+"""
+  @file CanNm_BenchCompare.py
+
+  @brief Can Network Management Module - benchmark result comparison
+
+  Compares two result files of CanNm_Bench benchmark by benchmark. For each name present in both, the change is the
+  ratio of the median ns per call, new over base, with a 95 % percentile bootstrap confidence interval obtained by
+  resampling both sample sets. A two-sided Mann-Whitney U test on the raw samples gives the p-value, and the p-values
+  of all benchmarks are Holm-Bonferroni adjusted, so a suite of 15 benchmarks does not report one regression in
+  every third run by chance.
+
+  A benchmark is flagged as a regression only if the adjusted p-value is below alpha and the whole confidence
+  interval lies above the threshold, i.e. the slowdown is both real and larger than the noise a shared host adds to
+  a median. Improvements are reported the same way but never fail the comparison. The exit status is 1 if any
+  regression was flagged, so the tool can gate a build.
+
+  Usage: CanNm_BenchCompare.py [--threshold PERCENT] [--alpha P] [--resamples N] <base.json> <new.json>
+"""
+import argparse
+import json
+import math
+import random
+import sys
+
+CONFIDENCE = 0.95
+SEED = 0x43616E4E6D
+
+
+class ResultError(Exception):
+    pass
+
+
+def load(path):
+    with open(path) as f:
+        result = json.load(f)
+    if result.get("suite") != "CanNm" or not isinstance(result.get("benchmarks"), list):
+        raise ResultError("%s: not a CanNm_Bench result file" % path)
+    benchmarks = {}
+    for benchmark in result["benchmarks"]:
+        samples = benchmark.get("samples")
+        if not samples or any(not isinstance(value, (int, float)) or value <= 0 for value in samples):
+            raise ResultError("%s: %s has no valid samples" % (path, benchmark.get("name")))
+        benchmarks[benchmark["name"]] = samples
+    return benchmarks
+
+
+def median(values):
+    ordered = sorted(values)
+    middle = len(ordered) // 2
+    return ordered[middle] if len(ordered) % 2 else (ordered[middle - 1] + ordered[middle]) / 2
+
+
+def bootstrap(base, new, resamples, rng):
+    """Percentile interval of median(new) / median(base) - 1."""
+    ratios = []
+    for _ in range(resamples):
+        base_median = median([base[rng.randrange(len(base))] for _ in base])
+        new_median = median([new[rng.randrange(len(new))] for _ in new])
+        ratios.append(new_median / base_median - 1)
+    ratios.sort()
+    tail = (1 - CONFIDENCE) / 2
+    return ratios[int(tail * (resamples - 1))], ratios[int(math.ceil((1 - tail) * (resamples - 1)))]
+
+
+def mann_whitney(base, new):
+    """Two-sided p-value of the U test, normal approximation with tie correction."""
+    ranked = sorted([(value, 0) for value in base] + [(value, 1) for value in new])
+    ranks = [0.0] * len(ranked)
+    ties = 0.0
+    index = 0
+    while index < len(ranked):
+        end = index
+        while end + 1 < len(ranked) and ranked[end + 1][0] == ranked[index][0]:
+            end += 1
+        for position in range(index, end + 1):
+            ranks[position] = (index + end) / 2 + 1
+        count = end - index + 1
+        ties += count ** 3 - count
+        index = end + 1
+
+    n1, n2 = len(base), len(new)
+    n = n1 + n2
+    u = sum(rank for rank, (_, group) in zip(ranks, ranked) if group == 0) - n1 * (n1 + 1) / 2
+    variance = n1 * n2 / 12 * ((n + 1) - ties / (n * (n - 1)))
+    if variance <= 0:
+        return 1.0
+    z = (abs(u - n1 * n2 / 2) - 0.5) / math.sqrt(variance)
+    return min(1.0, math.erfc(max(z, 0) / math.sqrt(2)))
+
+
+def holm(pvalues):
+    """Holm-Bonferroni adjusted p-values, in input order."""
+    order = sorted(range(len(pvalues)), key=lambda index: pvalues[index])
+    adjusted = [1.0] * len(pvalues)
+    running = 0.0
+    for rank, index in enumerate(order):
+        running = max(running, min(1.0, (len(pvalues) - rank) * pvalues[index]))
+        adjusted[index] = running
+    return adjusted
+
+
+def compare(base, new, threshold, alpha, resamples):
+    rng = random.Random(SEED)
+    rows = []
+    for name in base:
+        if name not in new:
+            continue
+        low, high = bootstrap(base[name], new[name], resamples, rng)
+        rows.append({
+            "name": name,
+            "base": median(base[name]),
+            "new": median(new[name]),
+            "low": low,
+            "high": high,
+            "p": mann_whitney(base[name], new[name]),
+        })
+    for row, adjusted in zip(rows, holm([row["p"] for row in rows])):
+        row["p"] = adjusted
+        row["verdict"] = ""
+        if adjusted < alpha and row["low"] > threshold:
+            row["verdict"] = "REGRESSION"
+        elif adjusted < alpha and row["high"] < -threshold:
+            row["verdict"] = "improvement"
+    return rows
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Compare two CanNm_Bench result files.")
+    parser.add_argument("--threshold", type=float, default=2.0,
+                        help="smallest change in percent of the median that counts (default 2)")
+    parser.add_argument("--alpha", type=float, default=0.05, help="significance level (default 0.05)")
+    parser.add_argument("--resamples", type=int, default=2000, help="bootstrap resamples (default 2000)")
+    parser.add_argument("base")
+    parser.add_argument("new")
+    args = parser.parse_args(argv[1:])
+
+    try:
+        base = load(args.base)
+        new = load(args.new)
+    except (ResultError, OSError, ValueError, KeyError) as error:
+        sys.stderr.write("%s\n" % error)
+        return 2
+
+    rows = compare(base, new, args.threshold / 100, args.alpha, max(args.resamples, 100))
+    width = max([len(row["name"]) for row in rows] + [9])
+    print("%-*s %12s %12s %9s %21s %8s" % (width, "benchmark", "base ns", "new ns", "delta", "95% CI", "p"))
+    for row in rows:
+        print("%-*s %12.3f %12.3f %+8.2f%% [%+8.2f%%, %+8.2f%%] %8.4f %s" % (
+            width, row["name"], row["base"], row["new"], 100 * (row["new"] / row["base"] - 1),
+            100 * row["low"], 100 * row["high"], row["p"], row["verdict"]))
+    for name in sorted(set(base) ^ set(new)):
+        print("%-*s %s" % (width, name, "only in base" if name in base else "only in new"))
+
+    regressions = sum(row["verdict"] == "REGRESSION" for row in rows)
+    print("%d benchmarks, %d significant regressions" % (len(rows), regressions))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,300 @@
+/** ==================================================================================================================*\
+  @file CanNm_Blob.c
+
+  @brief Can Network Management Module - binary post-build configuration
+
+  Validation and in place use of the configuration image described in CanNm_Blob.h. Host (POSIX) only.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "CanNm_Blob.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_BLOB_ALIGN(size)						\
+	(((size) + CANNM_ARENA_ALIGN - 1) & ~(uintptr_t)(CANNM_ARENA_ALIGN - 1))
+#define CANNM_BLOB_MAX_SDU_LENGTH					64U
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static uint32 CanNm_Blob_Crc32( const uint8* data, uint32 size );
+static Std_ReturnType CanNm_Blob_CheckChannel( const CanNm_ChannelHotType* ChannelHot );
+static uint32 CanNm_Blob_ChannelRamSize( const CanNm_ChannelHotType* ChannelHot );
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief CanNm_BlobCheck
+ *
+ * Validate header, bounds, CRC and every channel record of an image. Nothing is copied.
+ */
+Std_ReturnType CanNm_BlobCheck(const uint8* data, uint32 size)
+{
+	const CanNm_BlobHeaderType* Header = (const CanNm_BlobHeaderType*)data;
+
+	if (data == NULL || size < sizeof(CanNm_BlobHeaderType) || ((uintptr_t)data % sizeof(uint32)) != 0) {
+		return E_NOT_OK;
+	}
+	if (Header->Magic != CANNM_BLOB_MAGIC || Header->Version != CANNM_BLOB_VERSION ||
+		Header->HeaderSize < sizeof(CanNm_BlobHeaderType) || Header->TotalSize != size) {
+		return E_NOT_OK;
+	}
+	if (Header->ChannelCount == 0 || Header->ChannelHotSize != sizeof(CanNm_ChannelHotType)) {
+		return E_NOT_OK;
+	}
+	if (Header->GlobalOffset < Header->HeaderSize || Header->GlobalOffset % sizeof(uint32) != 0 ||
+		Header->GlobalOffset > size - sizeof(CanNm_BlobGlobalType)) {
+		return E_NOT_OK;
+	}
+	if (Header->ChannelHotOffset < Header->HeaderSize || Header->ChannelHotOffset % sizeof(uint32) != 0 ||
+		Header->ChannelHotOffset > size ||
+		(uint64)Header->ChannelCount * sizeof(CanNm_ChannelHotType) > size - Header->ChannelHotOffset) {
+		return E_NOT_OK;
+	}
+	if (CanNm_Blob_Crc32(data + Header->HeaderSize, size - Header->HeaderSize) != Header->Crc) {
+		return E_NOT_OK;
+	}
+
+	const CanNm_BlobGlobalType* Global = (const CanNm_BlobGlobalType*)(data + Header->GlobalOffset);
+	if (!(Global->MainFunctionPeriod > 0.0F)) {
+		return E_NOT_OK;
+	}
+
+	const CanNm_ChannelHotType* ChannelHot = (const CanNm_ChannelHotType*)(data + Header->ChannelHotOffset);
+	for (uint32 channel = 0; channel < Header->ChannelCount; channel++) {
+		if (CanNm_Blob_CheckChannel(&ChannelHot[channel]) != E_OK) {
+			return E_NOT_OK;
+		}
+	}
+	return E_OK;
+}
+
+/** @brief CanNm_BlobBind
+ *
+ * Validate an image already in memory and point blob->Config at it. The image must stay valid while in use.
+ */
+Std_ReturnType CanNm_BlobBind(CanNm_BlobType* blob, const uint8* data, uint32 size)
+{
+	if (CanNm_BlobCheck(data, size) != E_OK) {
+		return E_NOT_OK;
+	}
+
+	const CanNm_BlobHeaderType* Header = (const CanNm_BlobHeaderType*)data;
+	const CanNm_BlobGlobalType* Global = (const CanNm_BlobGlobalType*)(data + Header->GlobalOffset);
+	CanNm_ConfigType* Config = &blob->Config;
+
+	memset(blob, 0, sizeof(CanNm_BlobType));
+	blob->Base = data;
+	blob->Size = size;
+	Config->BusLoadReductionEnabled = Global->BusLoadReductionEnabled;
+	Config->BusSynchronizationEnabled = Global->BusSynchronizationEnabled;
+	Config->ComControlEnabled = Global->ComControlEnabled;
+	Config->ComUserDataSupport = Global->ComUserDataSupport;
+	Config->CoordinationSyncSupport = Global->CoordinationSyncSupport;
+	Config->DevErrorDetect = Global->DevErrorDetect;
+	Config->GlobalPnSupport = Global->GlobalPnSupport;
+	Config->ImmediateRestartEnabled = Global->ImmediateRestartEnabled;
+	Config->ImmediateTxConfEnabled = Global->ImmediateTxConfEnabled;
+	Config->MainFunctionPeriod = Global->MainFunctionPeriod;
+	Config->PassiveModeEnabled = Global->PassiveModeEnabled;
+	Config->PduRxIndicationEnabled = Global->PduRxIndicationEnabled;
+	Config->PnEiraCalcEnabled = Global->PnEiraCalcEnabled;
+	Config->PnResetTime = Global->PnResetTime;
+	Config->RemoteSleepIndEnabled = Global->RemoteSleepIndEnabled;
+	Config->StateChangeIndEnabled = Global->StateChangeIndEnabled;
+	Config->UserDataEnabled = Global->UserDataEnabled;
+	Config->VersionInfoApi = Global->VersionInfoApi;
+	Config->ChannelHot = (const CanNm_ChannelHotType*)(data + Header->ChannelHotOffset);
+	Config->ChannelCount = Header->ChannelCount;
+	return E_OK;
+}
+
+/** @brief CanNm_BlobOpen
+ *
+ * Map an image file read-only and bind it. The pages are shared with the page cache, nothing is parsed or copied.
+ */
+Std_ReturnType CanNm_BlobOpen(CanNm_BlobType* blob, const char* path)
+{
+	struct stat st;
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return E_NOT_OK;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64)st.st_size > 0xFFFFFFFFU) {
+		close(fd);
+		return E_NOT_OK;
+	}
+
+	void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		return E_NOT_OK;
+	}
+	if (CanNm_BlobBind(blob, (const uint8*)data, (uint32)st.st_size) != E_OK) {
+		munmap(data, (size_t)st.st_size);
+		return E_NOT_OK;
+	}
+	blob->Mapped = TRUE;
+	return E_OK;
+}
+
+/** @brief CanNm_BlobClose
+ *
+ * Release an image mapped by CanNm_BlobOpen. The module must be de-initialized first.
+ */
+void CanNm_BlobClose(CanNm_BlobType* blob)
+{
+	if (blob->Mapped) {
+		munmap((void*)blob->Base, blob->Size);
+	}
+	memset(blob, 0, sizeof(CanNm_BlobType));
+}
+
+/** @brief CanNm_BlobRamSize
+ *
+ * Size of the memory CanNm_BlobInit needs for the channel state and PDU buffers of a bound image.
+ */
+uint32 CanNm_BlobRamSize(const CanNm_BlobType* blob)
+{
+	uint16 channelCount = blob->Config.ChannelCount;
+	uint32 size = CANNM_BLOB_ALIGN(channelCount * sizeof(CanNm_ChannelPduType));
+
+	size += CANNM_BLOB_ALIGN(CanNm_ChannelArenaSize(channelCount));
+	for (uint32 channel = 0; channel < channelCount; channel++) {
+		size += CanNm_Blob_ChannelRamSize(&blob->Config.ChannelHot[channel]);
+	}
+	return size;
+}
+
+/** @brief CanNm_BlobInit
+ *
+ * Lay out the channel state and the PDU buffers of every channel in ram and initialize the module with the bound
+ * image through CanNm_InitArena. ram must be aligned to CANNM_ARENA_ALIGN and at least CanNm_BlobRamSize bytes long.
+ */
+Std_ReturnType CanNm_BlobInit(CanNm_BlobType* blob, uint8* ram, uint32 ramSize)
+{
+	if (blob->Base == NULL || ram == NULL || ((uintptr_t)ram % CANNM_ARENA_ALIGN) != 0 ||
+		ramSize < CanNm_BlobRamSize(blob)) {
+		return E_NOT_OK;
+	}
+
+	uint16 channelCount = blob->Config.ChannelCount;
+	uint32 arenaSize = CanNm_ChannelArenaSize(channelCount);
+	CanNm_ChannelPduType* ChannelPduTable = (CanNm_ChannelPduType*)ram;
+	uint8* arena = ram + CANNM_BLOB_ALIGN(channelCount * sizeof(CanNm_ChannelPduType));
+
+	ram = arena + CANNM_BLOB_ALIGN(arenaSize);
+	for (uint32 channel = 0; channel < channelCount; channel++) {
+		const CanNm_ChannelHotType* ChannelHot = &blob->Config.ChannelHot[channel];
+		CanNm_ChannelPduType* ChannelPdu = &ChannelPduTable[channel];
+		uint8 rxPduCount = ChannelHot->RxPduCount;
+
+		PduInfoType* TxPduInfo = (PduInfoType*)ram;
+		PduInfoType* RxPduInfo = TxPduInfo + 1;
+		CanNm_RxPdu* RxPdu = (CanNm_RxPdu*)(RxPduInfo + rxPduCount);
+		const CanNm_RxPdu** RxPduRef = (const CanNm_RxPdu**)CANNM_BLOB_ALIGN((uintptr_t)(RxPdu + rxPduCount));
+		uint8* Sdu = (uint8*)CANNM_BLOB_ALIGN((uintptr_t)(RxPduRef + rxPduCount));
+
+		memset(Sdu, 0, ChannelHot->TxSduLength + rxPduCount * ChannelHot->RxSduLength);
+		TxPduInfo->SduDataPtr = Sdu;
+		TxPduInfo->SduLength = ChannelHot->TxSduLength;
+		Sdu += ChannelHot->TxSduLength;
+		for (uint8 rx = 0; rx < rxPduCount; rx++) {
+			RxPduInfo[rx].SduDataPtr = Sdu;
+			RxPduInfo[rx].SduLength = ChannelHot->RxSduLength;
+			RxPdu[rx].RxPduId = (PduIdType)channel;
+			RxPdu[rx].RxPduRef = &RxPduInfo[rx];
+			RxPduRef[rx] = &RxPdu[rx];
+			Sdu += ChannelHot->RxSduLength;
+		}
+
+		ChannelPdu->TxPduRef = TxPduInfo;
+		ChannelPdu->TxUserDataPduRef = TxPduInfo;
+		ChannelPdu->RxPdu = RxPduRef;
+		ram += CanNm_Blob_ChannelRamSize(ChannelHot);
+	}
+
+	blob->Config.ChannelPdu = ChannelPduTable;
+	return CanNm_InitArena(&blob->Config, arena, arenaSize);
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+/** @brief CanNm_Blob_Crc32
+ *
+ * CRC-32 (IEEE 802.3, reflected, as zlib.crc32).
+ */
+static uint32 CanNm_Blob_Crc32( const uint8* data, uint32 size )
+{
+	static uint32 table[256];
+	uint32 crc = 0xFFFFFFFFU;
+
+	if (table[1] == 0) {
+		for (uint32 index = 0; index < 256; index++) {
+			uint32 value = index;
+			for (uint8 bit = 0; bit < 8; bit++) {
+				value = (value & 1) ? (value >> 1) ^ 0xEDB88320U : value >> 1;
+			}
+			table[index] = value;
+		}
+	}
+	for (uint32 index = 0; index < size; index++) {
+		crc = table[(crc ^ data[index]) & 0xFF] ^ (crc >> 8);
+	}
+	return crc ^ 0xFFFFFFFFU;
+}
+
+/** @brief CanNm_Blob_CheckChannel
+ *
+ * Reject channel records the module could not use safely: empty RX ring, SDU or CBV/NID/user data out of bounds.
+ */
+static Std_ReturnType CanNm_Blob_CheckChannel( const CanNm_ChannelHotType* ChannelHot )
+{
+	PduLengthType sduLength = (ChannelHot->TxSduLength < ChannelHot->RxSduLength) ?
+								ChannelHot->TxSduLength : ChannelHot->RxSduLength;
+
+	if (ChannelHot->RxPduCount == 0 || ChannelHot->RxPduCount > CANNM_RXPDU_MAX_COUNT) {
+		return E_NOT_OK;
+	}
+	if (sduLength == 0 || ChannelHot->TxSduLength > CANNM_BLOB_MAX_SDU_LENGTH ||
+		ChannelHot->RxSduLength > CANNM_BLOB_MAX_SDU_LENGTH) {
+		return E_NOT_OK;
+	}
+	if ((ChannelHot->PduCbvPosition != CANNM_PDU_OFF && ChannelHot->PduCbvPosition >= sduLength) ||
+		(ChannelHot->PduNidPosition != CANNM_PDU_OFF && ChannelHot->PduNidPosition >= sduLength)) {
+		return E_NOT_OK;
+	}
+	if (ChannelHot->UserDataOffset + ChannelHot->UserDataLength > sduLength) {
+		return E_NOT_OK;
+	}
+	return E_OK;
+}
+
+/** @brief CanNm_Blob_ChannelRamSize
+ *
+ * RAM used by one channel in CanNm_BlobInit: PDU descriptors, RX ring references, then the SDU bytes.
+ */
+static uint32 CanNm_Blob_ChannelRamSize( const CanNm_ChannelHotType* ChannelHot )
+{
+	uint32 rxPduCount = ChannelHot->RxPduCount;
+	uint32 size = CANNM_BLOB_ALIGN((1 + rxPduCount) * sizeof(PduInfoType) + rxPduCount * sizeof(CanNm_RxPdu));
+
+	size += CANNM_BLOB_ALIGN(rxPduCount * sizeof(CanNm_RxPdu*));
+	size += CANNM_BLOB_ALIGN(ChannelHot->TxSduLength + rxPduCount * ChannelHot->RxSduLength);
+	return size;
+}
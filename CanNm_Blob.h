@@ -0,0 +1,100 @@
+#ifndef CANNM_BLOB_H
+#define CANNM_BLOB_H
+
+/**===================================================================================================================*\
+  @file CanNm_Blob.h
+
+  @brief Can Network Management Module - binary post-build configuration
+
+  Position independent configuration image produced by CanNm_CfgGen.py (CanNm_Cfg.bin). It holds offsets instead
+  of pointers, so it is used in place from a read-only mapping: the channel records are CanNm_ChannelHotType and
+  CanNm_Init reads them directly. Only the PDU buffers and the channel state, which must be writable, are laid out
+  in caller memory sized from the channel count of the image, so one binary serves any number of channels.
+
+  Layout (little endian, all offsets from the start of the image):
+
+    CanNm_BlobHeaderType    at 0
+    CanNm_BlobGlobalType    at GlobalOffset
+    CanNm_ChannelHotType[]  at ChannelHotOffset, ChannelCount records of ChannelHotSize bytes
+
+  Crc is the CRC-32 (IEEE 802.3) of the bytes from HeaderSize up to TotalSize.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include "CanNm.h"
+
+/*====================================================================================================================*\
+    Global macros
+\*====================================================================================================================*/
+#define CANNM_BLOB_MAGIC							0x424D4E43U		/* "CNMB" */
+#define CANNM_BLOB_VERSION							1U
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+/** @brief CanNm_BlobHeaderType
+ *
+ * Versioned header at the start of the image.
+ */
+typedef struct {
+	uint32						Magic;
+	uint16						Version;
+	uint16						HeaderSize;
+	uint32						TotalSize;
+	uint32						Crc;
+	uint16						ChannelCount;
+	uint16						ChannelHotSize;			//sizeof(CanNm_ChannelHotType) of the generator
+	uint32						GlobalOffset;
+	uint32						ChannelHotOffset;
+	uint32						Reserved;
+} CanNm_BlobHeaderType;
+
+/** @brief CanNm_BlobGlobalType
+ *
+ * Global parameters of CanNm_ConfigType, flags in the order of CanNm_ConfigType.
+ */
+typedef struct {
+	float32						MainFunctionPeriod;
+	float32						PnResetTime;
+	boolean						BusLoadReductionEnabled;
+	boolean						BusSynchronizationEnabled;
+	boolean						ComControlEnabled;
+	boolean						ComUserDataSupport;
+	boolean						CoordinationSyncSupport;
+	boolean						DevErrorDetect;
+	boolean						GlobalPnSupport;
+	boolean						ImmediateRestartEnabled;
+	boolean						ImmediateTxConfEnabled;
+	boolean						PassiveModeEnabled;
+	boolean						PduRxIndicationEnabled;
+	boolean						PnEiraCalcEnabled;
+	boolean						RemoteSleepIndEnabled;
+	boolean						StateChangeIndEnabled;
+	boolean						UserDataEnabled;
+	boolean						VersionInfoApi;
+} CanNm_BlobGlobalType;
+
+/** @brief CanNm_BlobType
+ *
+ * A validated image and the CanNm_ConfigType pointing into it. Must outlive the use of the module.
+ */
+typedef struct {
+	const uint8*				Base;
+	uint32						Size;
+	boolean						Mapped;
+	CanNm_ConfigType			Config;
+} CanNm_BlobType;
+
+/*====================================================================================================================*\
+    Global functions declarations
+\*====================================================================================================================*/
+Std_ReturnType CanNm_BlobCheck(const uint8* data, uint32 size);
+Std_ReturnType CanNm_BlobBind(CanNm_BlobType* blob, const uint8* data, uint32 size);
+Std_ReturnType CanNm_BlobOpen(CanNm_BlobType* blob, const char* path);
+void CanNm_BlobClose(CanNm_BlobType* blob);
+uint32 CanNm_BlobRamSize(const CanNm_BlobType* blob);
+Std_ReturnType CanNm_BlobInit(CanNm_BlobType* blob, uint8* ram, uint32 ramSize);
+
+#endif /* CANNM_BLOB_H */
@@ -0,0 +1,127 @@
+#ifndef CANNM_CFG_H
+#define CANNM_CFG_H
+
+/**===================================================================================================================*\
+  @file CanNm_Cfg.h
+
+  @brief Can Network Management Module - pre-compile configuration
+
+  Selects the configuration variant and, for the pre-compile variant, fixes the global switches of
+  CanNm_ConfigType at compile time. With CANNM_GENERATED_CFG defined, the values come from CanNm_GenCfg.h
+  produced by CanNm_CfgGen.py, the defaults below only fill in what it does not define.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include "Std_Types.h"
+
+#ifdef CANNM_GENERATED_CFG
+#include "CanNm_GenCfg.h"
+#endif
+
+/*====================================================================================================================*\
+    Global macros
+\*====================================================================================================================*/
+/* Configuration variants */
+#define CANNM_VARIANT_PRE_COMPILE					0x00U
+#define CANNM_VARIANT_POST_BUILD					0x01U
+
+#ifndef CANNM_CONFIG_VARIANT
+#define CANNM_CONFIG_VARIANT						CANNM_VARIANT_POST_BUILD
+#endif
+
+/* Global switches, only used in CANNM_VARIANT_PRE_COMPILE. In CANNM_VARIANT_POST_BUILD they are read from
+ * the CanNm_ConfigType passed to CanNm_Init. */
+#ifndef CANNM_PASSIVE_MODE_ENABLED
+#define CANNM_PASSIVE_MODE_ENABLED					STD_OFF
+#endif
+
+#ifndef CANNM_IMMEDIATE_RESTART_ENABLED
+#define CANNM_IMMEDIATE_RESTART_ENABLED				STD_OFF
+#endif
+
+#ifndef CANNM_REMOTE_SLEEP_IND_ENABLED
+#define CANNM_REMOTE_SLEEP_IND_ENABLED				STD_OFF
+#endif
+
+#ifndef CANNM_USER_DATA_ENABLED
+#define CANNM_USER_DATA_ENABLED						STD_OFF
+#endif
+
+#ifndef CANNM_COM_USER_DATA_SUPPORT
+#define CANNM_COM_USER_DATA_SUPPORT					STD_OFF
+#endif
+
+#ifndef CANNM_GLOBAL_PN_SUPPORT
+#define CANNM_GLOBAL_PN_SUPPORT						STD_OFF
+#endif
+
+#ifndef CANNM_COORDINATION_SYNC_SUPPORT
+#define CANNM_COORDINATION_SYNC_SUPPORT				STD_OFF
+#endif
+
+#ifndef CANNM_PDU_RX_INDICATION_ENABLED
+#define CANNM_PDU_RX_INDICATION_ENABLED				STD_OFF
+#endif
+
+#ifndef CANNM_STATE_CHANGE_IND_ENABLED
+#define CANNM_STATE_CHANGE_IND_ENABLED				STD_OFF
+#endif
+
+/* Per channel statistics counters and CanNm_GetStatistics/CanNm_ResetStatistics. STD_OFF removes counters, code
+ * and API completely. */
+#ifndef CANNM_STATISTICS_ENABLED
+#define CANNM_STATISTICS_ENABLED					STD_OFF
+#endif
+
+/* Binary event trace into CanNm_InstanceType::TraceRing, see CanNm_Trace.h. STD_OFF removes it completely. */
+#ifndef CANNM_TRACE_ENABLED
+#define CANNM_TRACE_ENABLED							STD_OFF
+#endif
+
+/* Execution time histograms of the main function, RxIndication, TxConfirmation and TriggerTransmit, see
+ * CanNm_Timing.h. STD_OFF removes them completely. */
+#ifndef CANNM_TIMING_ENABLED
+#define CANNM_TIMING_ENABLED						STD_OFF
+#endif
+
+/* Per channel wake-up latency histograms and CanNm_GetWakeupLatency/CanNm_ResetWakeupLatency, see CanNm_Timing.h.
+ * STD_OFF removes them completely. */
+#ifndef CANNM_WAKEUP_LATENCY_ENABLED
+#define CANNM_WAKEUP_LATENCY_ENABLED				STD_OFF
+#endif
+
+/* Per channel NM bus load estimate and CanNm_GetBusLoad. STD_OFF removes it completely. */
+#ifndef CANNM_BUS_LOAD_ENABLED
+#define CANNM_BUS_LOAD_ENABLED						STD_OFF
+#endif
+
+/* Averaging window of the bus load estimate as a power of two of main function periods, 7 for 1.28 s at 10 ms */
+#ifndef CANNM_BUS_LOAD_WINDOW_SHIFT
+#define CANNM_BUS_LOAD_WINDOW_SHIFT					7U
+#endif
+
+/* Time units of the channel timing parameters per second, 1000 for ms as in CanNm_Cfg.json, 1 for s */
+#ifndef CANNM_BUS_LOAD_TIME_UNITS_PER_SECOND
+#define CANNM_BUS_LOAD_TIME_UNITS_PER_SECOND		1000.0F
+#endif
+
+/* Bits on the bus of an NM PDU of length bytes. Defaults to a classic CAN base frame with interframe space and
+ * without stuff bits, can be defined for extended identifiers or CAN FD. */
+#ifndef CANNM_BUS_LOAD_FRAME_BITS
+#define CANNM_BUS_LOAD_FRAME_BITS(length)			(47U + 8U * (uint32)(length))
+#endif
+
+/* Capture of the NM PDUs passing CanNm into CanNm_InstanceType::PcapRing, see CanNm_Pcap.h. STD_OFF removes it
+ * completely. */
+#ifndef CANNM_PCAP_ENABLED
+#define CANNM_PCAP_ENABLED							STD_OFF
+#endif
+
+/* Main function period in the time unit of the channel timing parameters */
+#ifndef CANNM_MAIN_FUNCTION_PERIOD
+#define CANNM_MAIN_FUNCTION_PERIOD					1.0F
+#endif
+
+#endif /* CANNM_CFG_H */
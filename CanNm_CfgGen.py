@@ -0,0 +1,324 @@
+#!/usr/bin/env python3
+"""
+  @file CanNm_CfgGen.py
+
+  @brief Can Network Management Module - configuration generator
+
+  Reads a declarative JSON description of the CanNm channels, PDUs, partial network masks and timings and emits
+  two files into the output directory:
+
+    CanNm_GenCfg.h  - pre-compile switches, channel count and configuration variant, picked up by CanNm_Cfg.h
+                      when CANNM_GENERATED_CFG is defined, and the declaration of CanNm_Config
+    CanNm_PBcfg.c   - const, fully linked CanNm_ConfigType named CanNm_Config, with the CanNm_ChannelHotType table
+                      precomputed (times in main function ticks, user data layout), so CanNm_Init derives nothing,
+                      and the CanNm_ChannelPduType table, so it can also be passed to CanNm_InitArena
+
+    CanNm_Cfg.bin   - position independent image of the same configuration for CanNm_BlobOpen (see CanNm_Blob.h),
+                      to change a post-build configuration without rebuilding
+
+  Times in the description use the same unit as MainFunctionPeriod. See CanNm_Cfg.json for an example.
+
+  Usage: CanNm_CfgGen.py <description.json> <output directory>
+"""
+import json
+import math
+import os
+import struct
+import sys
+import zlib
+
+PDU_BYTE = {"BYTE_0": 0, "BYTE_1": 1, "OFF": 0xFF}
+PDU_BYTE_ENUM = {0: "CANNM_PDU_BYTE_0", 1: "CANNM_PDU_BYTE_1", 0xFF: "CANNM_PDU_OFF"}
+MAX_PDU_LENGTH = 64
+
+GLOBAL_SWITCHES = [
+    ("PassiveModeEnabled", "CANNM_PASSIVE_MODE_ENABLED"),
+    ("ImmediateRestartEnabled", "CANNM_IMMEDIATE_RESTART_ENABLED"),
+    ("RemoteSleepIndEnabled", "CANNM_REMOTE_SLEEP_IND_ENABLED"),
+    ("UserDataEnabled", "CANNM_USER_DATA_ENABLED"),
+    ("ComUserDataSupport", "CANNM_COM_USER_DATA_SUPPORT"),
+    ("GlobalPnSupport", "CANNM_GLOBAL_PN_SUPPORT"),
+    ("CoordinationSyncSupport", "CANNM_COORDINATION_SYNC_SUPPORT"),
+    ("PduRxIndicationEnabled", "CANNM_PDU_RX_INDICATION_ENABLED"),
+    ("StateChangeIndEnabled", "CANNM_STATE_CHANGE_IND_ENABLED"),
+]
+
+GLOBAL_FLAGS = [
+    "BusLoadReductionEnabled", "BusSynchronizationEnabled", "ComControlEnabled", "ComUserDataSupport",
+    "CoordinationSyncSupport", "DevErrorDetect", "GlobalPnSupport", "ImmediateRestartEnabled",
+    "ImmediateTxConfEnabled", "PassiveModeEnabled", "PduRxIndicationEnabled", "PnEiraCalcEnabled",
+    "RemoteSleepIndEnabled", "StateChangeIndEnabled", "UserDataEnabled", "VersionInfoApi",
+]
+
+CHANNEL_FLAGS = [
+    "ActiveWakeupBitEnabled", "AllNmMessagesKeepAwake", "BusLoadReductionActive", "CarWakeUpFilterEnabled",
+    "CarWakeUpRxEnabled", "NodeDetectionEnabled", "NodeIdEnabled", "PnEnabled", "PnEraCalcEnabled",
+    "PnHandleMultipleNetworkRequests", "RepeatMsgIndEnabled",
+]
+
+CHANNEL_TIMES = [
+    "ImmediateNmCycleTime", "MsgCycleOffset", "MsgCycleTime", "MsgReducedTime", "MsgTimeoutTime",
+    "RemoteSleepIndTime", "RepeatMessageTime", "TimeoutTime", "WaitBusSleepTime",
+]
+
+
+class ConfigError(Exception):
+    pass
+
+
+def to_ticks(time, period):
+    """Same rounding as CanNm_Internal_TimeToTicks: round up, a timer never expires early."""
+    ticks = time / period
+    return int(math.ceil(ticks - 1e-9)) if ticks > 0 else 0
+
+
+def c_bool(value):
+    return "TRUE" if value else "FALSE"
+
+
+def c_float(value):
+    return repr(float(value)) + "F"
+
+
+def pdu_byte(channel, key, default):
+    value = channel.get(key, default)
+    if value not in PDU_BYTE:
+        raise ConfigError("%s: %s must be one of %s" % (channel["Name"], key, ", ".join(PDU_BYTE)))
+    return PDU_BYTE[value]
+
+
+def check_range(name, value, low, high):
+    if not isinstance(value, int) or value < low or value > high:
+        raise ConfigError("%s must be an integer in [%d, %d], got %r" % (name, low, high, value))
+    return value
+
+
+def load(path):
+    with open(path) as f:
+        desc = json.load(f)
+
+    period = float(desc.get("MainFunctionPeriod", 0))
+    if period <= 0:
+        raise ConfigError("MainFunctionPeriod must be positive")
+
+    channels = desc.get("Channels", [])
+    if not 1 <= len(channels) <= 255:
+        raise ConfigError("1 to 255 channels required, got %d" % len(channels))
+
+    for index, channel in enumerate(channels):
+        channel.setdefault("Name", "Channel%d" % index)
+        name = channel["Name"]
+        cbv = pdu_byte(channel, "PduCbvPosition", "OFF")
+        nid = pdu_byte(channel, "PduNidPosition", "OFF")
+        if cbv != 0xFF and cbv == nid:
+            raise ConfigError("%s: PduCbvPosition and PduNidPosition overlap" % name)
+        length = check_range(name + ".PduLength", channel.get("PduLength", 8), 1, MAX_PDU_LENGTH)
+        offset = max([position + 1 for position in (cbv, nid) if position != 0xFF], default=0)
+        if length < offset:
+            raise ConfigError("%s: PduLength %d is shorter than the CBV and NID bytes" % (name, length))
+        rx_count = check_range(name + ".RxPduCount", channel.get("RxPduCount", 1), 1, 128)
+        check_range(name + ".NodeId", channel.get("NodeId", 0), 0, 255)
+        check_range(name + ".ImmediateNmTransmissions", channel.get("ImmediateNmTransmissions", 0), 0, 255)
+        check_range(name + ".TxPduId", channel.get("TxPduId", index), 0, 0xFFFF)
+        for key in CHANNEL_TIMES:
+            value = channel.get(key, 0)
+            if value < 0 or to_ticks(value, period) > 0xFFFFFFFF:
+                raise ConfigError("%s.%s out of range" % (name, key))
+
+        channel["_cbv"], channel["_nid"], channel["_length"] = cbv, nid, length
+        channel["_offset"], channel["_rx_count"] = offset, rx_count
+
+    pn = desc.get("PnInfo")
+    if pn is not None:
+        mask = pn.get("FilterMask", [])
+        check_range("PnInfo.Offset", pn.get("Offset", 0), 0, MAX_PDU_LENGTH - 1)
+        check_range("PnInfo.Length", len(mask), 1, MAX_PDU_LENGTH)
+        for value in mask:
+            check_range("PnInfo.FilterMask byte", value, 0, 255)
+        for channel in channels:
+            if channel.get("PnEnabled") and pn.get("Offset", 0) + len(mask) > channel["_length"]:
+                raise ConfigError("%s: PN info does not fit into the PDU" % channel["Name"])
+
+    return desc, period, channels
+
+
+def emit_header(desc, period, channels, source):
+    variant = desc.get("Variant", "POST_BUILD")
+    if variant not in ("PRE_COMPILE", "POST_BUILD"):
+        raise ConfigError("Variant must be PRE_COMPILE or POST_BUILD")
+    out = []
+    out.append("#ifndef CANNM_GENCFG_H")
+    out.append("#define CANNM_GENCFG_H")
+    out.append("")
+    out.append("/* Generated by CanNm_CfgGen.py from %s, do not edit */" % os.path.basename(source))
+    out.append("")
+    out.append("#define %-44sCANNM_VARIANT_%s" % ("CANNM_CONFIG_VARIANT", variant))
+    out.append("#define %-44s%d" % ("CANNM_CHANNEL_COUNT", len(channels)))
+    out.append("#define %-44s%d" % ("CANNM_RXPDU_MAX_COUNT", max(c["_rx_count"] for c in channels)))
+    out.append("")
+    for key, macro in GLOBAL_SWITCHES:
+        out.append("#define %-44sSTD_%s" % (macro, "ON" if desc.get(key) else "OFF"))
+    out.append("#define %-44s%s" % ("CANNM_MAIN_FUNCTION_PERIOD", c_float(period)))
+    out.append("")
+    out.append("/* Configuration of CanNm_PBcfg.c, CanNm_ConfigType is completed by CanNm.h */")
+    out.append("typedef struct CanNm_Config CanNm_ConfigType;")
+    out.append("extern const CanNm_ConfigType CanNm_Config;")
+    out.append("")
+    out.append("#endif /* CANNM_GENCFG_H */")
+    return "\n".join(out) + "\n"
+
+
+def emit_source(desc, period, channels, source):
+    out = []
+    w = out.append
+    w("/* Generated by CanNm_CfgGen.py from %s, do not edit */" % os.path.basename(source))
+    w("#include \"CanNm.h\"")
+    w("")
+
+    for index, channel in enumerate(channels):
+        length, offset = channel["_length"], channel["_offset"]
+        tx_init = [0xFF] * length
+        if channel["_nid"] != 0xFF:
+            tx_init[channel["_nid"]] = channel.get("NodeId", 0) if channel.get("NodeIdEnabled") else 0xFF
+        if channel["_cbv"] != 0xFF:
+            tx_init[channel["_cbv"]] = 0x00
+        w("/* Channel %d: %s */" % (index, channel["Name"]))
+        w("static uint8 CanNm_TxSdu_%d[%d] = { %s };" % (index, length, ", ".join("0x%02X" % b for b in tx_init)))
+        for rx in range(channel["_rx_count"]):
+            w("static uint8 CanNm_RxSdu_%d_%d[%d];" % (index, rx, length))
+        w("static const PduInfoType CanNm_TxPduInfo_%d = { CanNm_TxSdu_%d, %d };" % (index, index, length))
+        for rx in range(channel["_rx_count"]):
+            w("static const PduInfoType CanNm_RxPduInfo_%d_%d = { CanNm_RxSdu_%d_%d, %d };" % (index, rx, index, rx, length))
+        w("static const CanNm_TxPdu CanNm_TxPdu_%d = { %d, &CanNm_TxPduInfo_%d };" % (index, channel.get("TxPduId", index), index))
+        w("static const CanNm_UserDataTxPdu CanNm_UserDataTxPdu_%d = { %d, &CanNm_TxPduInfo_%d };"
+          % (index, channel.get("UserDataTxPduId", index), index))
+        for rx in range(channel["_rx_count"]):
+            w("static const CanNm_RxPdu CanNm_RxPdu_%d_%d = { %d, &CanNm_RxPduInfo_%d_%d };"
+              % (index, rx, channel.get("RxPduId", index), index, rx))
+        w("static const CanNm_RxPdu* const CanNm_RxPduRefs_%d[%d] = { %s };"
+          % (index, channel["_rx_count"], ", ".join("&CanNm_RxPdu_%d_%d" % (index, rx) for rx in range(channel["_rx_count"]))))
+        w("")
+        w("static const CanNm_ChannelType CanNm_Channel_%d = {" % index)
+        for key in CHANNEL_FLAGS:
+            w("\t.%-32s= %s," % (key, c_bool(channel.get(key))))
+        for key in CHANNEL_TIMES:
+            w("\t.%-32s= %s," % (key, c_float(channel.get(key, 0))))
+        w("\t.%-32s= %d," % ("CarWakeUpBitPosition", channel.get("CarWakeUpBitPosition", 0)))
+        w("\t.%-32s= %d," % ("CarWakeUpFilterNodeId", channel.get("CarWakeUpFilterNodeId", 0)))
+        w("\t.%-32s= %d," % ("ImmediateNmTransmissions", channel.get("ImmediateNmTransmissions", 0)))
+        w("\t.%-32s= %d," % ("NodeId", channel.get("NodeId", 0)))
+        w("\t.%-32s= %s," % ("PduCbvPosition", PDU_BYTE_ENUM[channel["_cbv"]]))
+        w("\t.%-32s= %s," % ("PduNidPosition", PDU_BYTE_ENUM[channel["_nid"]]))
+        w("\t.%-32s= &CanNm_TxPdu_%d," % ("TxPdu", index))
+        w("\t.%-32s= &CanNm_UserDataTxPdu_%d," % ("UserDataTxPdu", index))
+        w("\t.%-32s= %d," % ("ComMNetworkHandleRef", channel.get("ComMNetworkHandleRef", index)))
+        w("\t.%-32s= { %s }" % ("RxPdu", ", ".join("&CanNm_RxPdu_%d_%d" % (index, rx) for rx in range(channel["_rx_count"]))))
+        w("};")
+        w("")
+
+    w("static const CanNm_ChannelHotType CanNm_ChannelHotCfg[%d] = {" % len(channels))
+    for index, channel in enumerate(channels):
+        t = lambda key: to_ticks(channel.get(key, 0), period)
+        w("\t[%d] = {" % index)
+        w("\t\t.TimeoutTicks = %dU, .MsgCycleTicks = %dU, .MsgCycleOffsetTicks = %dU, .MsgReducedTicks = %dU,"
+          % (t("TimeoutTime"), t("MsgCycleTime"), t("MsgCycleOffset"), t("MsgReducedTime")))
+        w("\t\t.ImmediateNmCycleTicks = %dU, .RepeatMessageTicks = %dU, .WaitBusSleepTicks = %dU, .RemoteSleepIndTicks = %dU,"
+          % (t("ImmediateNmCycleTime"), t("RepeatMessageTime"), t("WaitBusSleepTime"), t("RemoteSleepIndTime")))
+        w("\t\t.TxPduId = %d, .TxSduLength = %d, .RxSduLength = %d,"
+          % (channel.get("TxPduId", index), channel["_length"], channel["_length"]))
+        w("\t\t.PduCbvPosition = %s, .PduNidPosition = %s, .UserDataOffset = %d, .UserDataLength = %d, .RxPduCount = %d,"
+          % (PDU_BYTE_ENUM[channel["_cbv"]], PDU_BYTE_ENUM[channel["_nid"]], channel["_offset"],
+             channel["_length"] - channel["_offset"], channel["_rx_count"]))
+        w("\t\t.ImmediateNmTransmissions = %d, .NodeId = %d, .NodeIdEnabled = %s, .NodeDetectionEnabled = %s,"
+          % (channel.get("ImmediateNmTransmissions", 0), channel.get("NodeId", 0), c_bool(channel.get("NodeIdEnabled")),
+             c_bool(channel.get("NodeDetectionEnabled"))))
+        w("\t\t.ActiveWakeupBitEnabled = %s, .BusLoadReductionActive = %s, .PnHandleMultipleNetworkRequests = %s"
+          % (c_bool(channel.get("ActiveWakeupBitEnabled")), c_bool(channel.get("BusLoadReductionActive")),
+             c_bool(channel.get("PnHandleMultipleNetworkRequests"))))
+        w("\t},")
+    w("};")
+    w("")
+
+    w("static const CanNm_ChannelPduType CanNm_ChannelPduCfg[%d] = {" % len(channels))
+    for index in range(len(channels)):
+        w("\t{ &CanNm_TxPduInfo_%d, &CanNm_TxPduInfo_%d, CanNm_RxPduRefs_%d }," % (index, index, index))
+    w("};")
+    w("")
+
+    pn = desc.get("PnInfo")
+    if pn is not None:
+        mask = pn["FilterMask"]
+        w("static const CanNm_PnFilterMaskByte CanNm_PnFilterMaskBytes[%d] = {" % len(mask))
+        for index, value in enumerate(mask):
+            w("\t{ %d, 0x%02X }," % (index, value))
+        w("};")
+        w("")
+        w("static const CanNm_PnInfo CanNm_PnInfoCfg = { %d, %d, CanNm_PnFilterMaskBytes };" % (len(mask), pn.get("Offset", 0)))
+        w("")
+
+    w("const CanNm_ConfigType CanNm_Config = {")
+    for key in GLOBAL_FLAGS:
+        w("\t.%-28s= %s," % (key, c_bool(desc.get(key))))
+    w("\t.%-28s= %s," % ("MainFunctionPeriod", c_float(period)))
+    w("\t.%-28s= %s," % ("PnResetTime", c_float(desc.get("PnResetTime", 0))))
+    w("\t.%-28s= %s," % ("PnInfo", "&CanNm_PnInfoCfg" if pn is not None else "NULL"))
+    w("\t.%-28s= { %s }," % ("ChannelConfig", ", ".join("&CanNm_Channel_%d" % i for i in range(len(channels)))))
+    w("\t.%-28s= CanNm_ChannelHotCfg," % "ChannelHot")
+    w("\t.%-28s= CanNm_ChannelPduCfg," % "ChannelPdu")
+    w("\t.%-28s= %d" % ("ChannelCount", len(channels)))
+    w("};")
+    return "\n".join(out) + "\n"
+
+
+BLOB_MAGIC = 0x424D4E43
+BLOB_VERSION = 1
+BLOB_HEADER = struct.Struct("<IHHIIHHIII")
+BLOB_GLOBAL = struct.Struct("<ff16B")
+BLOB_CHANNEL_HOT = struct.Struct("<8I3H7B5Bxx")
+
+
+def emit_blob(desc, period, channels):
+    """Layout of CanNm_BlobHeaderType, CanNm_BlobGlobalType and CanNm_ChannelHotType[] from CanNm_Blob.h."""
+    body = BLOB_GLOBAL.pack(period, float(desc.get("PnResetTime", 0)), *[bool(desc.get(key)) for key in GLOBAL_FLAGS])
+    for index, channel in enumerate(channels):
+        t = lambda key: to_ticks(channel.get(key, 0), period)
+        body += BLOB_CHANNEL_HOT.pack(
+            t("TimeoutTime"), t("MsgCycleTime"), t("MsgCycleOffset"), t("MsgReducedTime"),
+            t("ImmediateNmCycleTime"), t("RepeatMessageTime"), t("WaitBusSleepTime"), t("RemoteSleepIndTime"),
+            channel.get("TxPduId", index), channel["_length"], channel["_length"],
+            channel["_cbv"], channel["_nid"], channel["_offset"], channel["_length"] - channel["_offset"],
+            channel["_rx_count"], channel.get("ImmediateNmTransmissions", 0), channel.get("NodeId", 0),
+            bool(channel.get("NodeIdEnabled")), bool(channel.get("NodeDetectionEnabled")),
+            bool(channel.get("ActiveWakeupBitEnabled")), bool(channel.get("BusLoadReductionActive")),
+            bool(channel.get("PnHandleMultipleNetworkRequests")))
+    header_size = BLOB_HEADER.size
+    header = BLOB_HEADER.pack(BLOB_MAGIC, BLOB_VERSION, header_size, header_size + len(body),
+                              zlib.crc32(body) & 0xFFFFFFFF, len(channels), BLOB_CHANNEL_HOT.size,
+                              header_size, header_size + BLOB_GLOBAL.size, 0)
+    return header + body
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write("usage: %s <description.json> <output directory>\n" % argv[0])
+        return 2
+    try:
+        desc, period, channels = load(argv[1])
+        header = emit_header(desc, period, channels, argv[1])
+        source = emit_source(desc, period, channels, argv[1])
+        blob = emit_blob(desc, period, channels)
+    except (ConfigError, KeyError, ValueError) as error:
+        sys.stderr.write("%s: %s\n" % (argv[1], error))
+        return 1
+    os.makedirs(argv[2], exist_ok=True)
+    with open(os.path.join(argv[2], "CanNm_GenCfg.h"), "w") as f:
+        f.write(header)
+    with open(os.path.join(argv[2], "CanNm_PBcfg.c"), "w") as f:
+        f.write(source)
+    with open(os.path.join(argv[2], "CanNm_Cfg.bin"), "wb") as f:
+        f.write(blob)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
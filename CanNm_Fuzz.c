@@ -0,0 +1,785 @@
+/** ==================================================================================================================*\
+  @file CanNm_Fuzz.c
+
+  @brief Can Network Management Module - fuzzing harness
+
+  Runs CanNm on the inputs of a coverage guided fuzzer. An input is decoded into
+  - a configuration: the global switches, the channel count and per channel the CBV and NID positions, PDU length,
+    number of Rx PDUs, node identifier, feature flags and timers in main function ticks, and a second configuration
+    of the same channel count for CanNm_SwitchConfig,
+  - a sequence of steps until the input ends: CanNm_RxIndication with a frame of 0 to 64 bytes, the API functions on
+    one channel, CanNm_TxConfirmation, CanNm_TriggerTransmit with a buffer of 0 to 64 bytes, CanNm_SwitchConfig,
+    CanNm_DeInit, main function ticks, idle periods passed with CanNm_SkipTicks, and the result of CanIf_Transmit.
+  Bytes read past the end of the input are 0, so every input is valid. After every step the harness checks that
+  - each channel is in a state of its mode, and that the last state change notification and mode indication agree,
+  - CanNm_TicksToNextEvent is at least 1, and CANNM_TICKS_INFINITE once every channel is in bus sleep and no
+    configuration switch is pending,
+  - CanNm_GetPduData, CanNm_GetNodeIdentifier and CanNm_GetUserData return the last frame received, cut or padded
+    with zeros to the configured length,
+  - CanNm_SetUserData leaves the CBV and NID bytes of the Tx PDU alone,
+  - CanNm_DeInit either leaves all channels running or puts all of them to NM_STATE_UNINIT,
+  - the received frame counter of CanNm_GetStatistics counts every frame, when CANNM_STATISTICS_ENABLED is set,
+  and in the callouts that state change notifications chain, that CanIf_Transmit is not called in passive mode
+  except through CanNm_Transmit, and that transmitted NM PDUs have the configured length and node identifier.
+  A violated invariant prints the step and aborts, which the fuzzers report as a crash. The PDU buffers of the
+  configuration, frames and trigger transmit buffers are allocated with their exact length, so AddressSanitizer
+  catches accesses beyond them.
+
+  The instance is re-initialized in place for every input, only the PDU buffers are allocated again, so a run takes
+  microseconds.
+  libFuzzer and AFL++ use LLVMFuzzerTestOneInput:
+
+      clang -g -O1 -fsanitize=fuzzer,address,undefined -DUNIT_TEST -DCANNM_FUZZ_NO_MAIN -DCANNM_CHANNEL_COUNT=3 \
+          -o CanNm_Fuzz CanNm_Fuzz.c CanNm.c
+      ./CanNm_Fuzz -max_len=1024 corpus
+      afl-clang-fast -O2 -fsanitize=fuzzer -DUNIT_TEST -DCANNM_FUZZ_NO_MAIN -DCANNM_CHANNEL_COUNT=3 \
+          -o CanNm_Fuzz CanNm_Fuzz.c CanNm.c
+      afl-fuzz -i corpus -o findings -- ./CanNm_Fuzz
+
+  Without CANNM_FUZZ_NO_MAIN the harness has its own main: given files it runs each of them, e.g. a crash found by a
+  fuzzer or a corpus as regression test, without it runs random inputs and prints the executions per second. A random
+  input that violates an invariant is written to crash-fuzz.bin first.
+
+      gcc -O2 -DUNIT_TEST -DCANNM_CHANNEL_COUNT=3 -o CanNm_Fuzz CanNm_Fuzz.c CanNm.c
+      ./CanNm_Fuzz [-n inputs=1000000] [-s seed=1] [file]...
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CanNm.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_FUZZ_SDU_SIZE							64U			//Longest frame, a CAN FD payload
+#define CANNM_FUZZ_RX_PDUS							((CANNM_RXPDU_MAX_COUNT < 2) ? CANNM_RXPDU_MAX_COUNT : 2)
+#define CANNM_FUZZ_MAX_INPUT						512U		//Longest random input of the standalone main
+#define CANNM_FUZZ_CRASH_FILE						"crash-fuzz.bin"
+#define CANNM_FUZZ_ALL_CHANNELS						0xFFFFU		//dataChannel of CanNm_Fuzz_Check
+#define CANNM_FUZZ_NO_CHANNEL						0xFFFEU
+
+/* Steps, the operation byte is the step plus CANNM_FUZZ_OP_COUNT times the channel */
+#define CANNM_FUZZ_OP_RX_INDICATION					0U
+#define CANNM_FUZZ_OP_MAIN_FUNCTION					1U
+#define CANNM_FUZZ_OP_SKIP_TICKS					2U
+#define CANNM_FUZZ_OP_NETWORK_REQUEST				3U
+#define CANNM_FUZZ_OP_NETWORK_RELEASE				4U
+#define CANNM_FUZZ_OP_PASSIVE_START_UP				5U
+#define CANNM_FUZZ_OP_DISABLE_COMMUNICATION			6U
+#define CANNM_FUZZ_OP_ENABLE_COMMUNICATION			7U
+#define CANNM_FUZZ_OP_REPEAT_MESSAGE_REQUEST		8U
+#define CANNM_FUZZ_OP_BUS_SYNCHRONIZATION			9U
+#define CANNM_FUZZ_OP_SLEEP_READY_BIT				10U
+#define CANNM_FUZZ_OP_SET_USER_DATA					11U
+#define CANNM_FUZZ_OP_TX_CONFIRMATION				12U
+#define CANNM_FUZZ_OP_TRIGGER_TRANSMIT				13U
+#define CANNM_FUZZ_OP_TRANSMIT						14U
+#define CANNM_FUZZ_OP_CONFIRM_PN_AVAILABILITY		15U
+#define CANNM_FUZZ_OP_SWITCH_CONFIG					16U
+#define CANNM_FUZZ_OP_DEINIT						17U
+#define CANNM_FUZZ_OP_CANIF_RESULT					18U
+#define CANNM_FUZZ_OP_REMOTE_SLEEP_INDICATION		19U
+#define CANNM_FUZZ_OP_COUNT							20U
+
+#define CANNM_FUZZ_CHECK(Fuzz, condition) \
+	do { if (!(condition)) { CanNm_Fuzz_Fail((Fuzz), #condition, __LINE__); } } while (0)
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+/* Input bytes, 0 past the end */
+typedef struct {
+	const uint8*				Data;
+	size_t						Size;
+	size_t						Offset;
+} CanNm_Fuzz_InputType;
+
+/* One configuration with its PDU buffers */
+typedef struct {
+	CanNm_ConfigType			Config;
+	CanNm_ChannelType			Channel[CANNM_CHANNEL_COUNT];
+	CanNm_TxPdu					TxPdu[CANNM_CHANNEL_COUNT];
+	CanNm_UserDataTxPdu			UserDataTxPdu[CANNM_CHANNEL_COUNT];
+	CanNm_RxPdu					RxPdu[CANNM_CHANNEL_COUNT][CANNM_FUZZ_RX_PDUS];
+	PduInfoType					TxPduInfo[CANNM_CHANNEL_COUNT];
+	PduInfoType					RxPduInfo[CANNM_CHANNEL_COUNT][CANNM_FUZZ_RX_PDUS];
+	uint8*						TxSdu[CANNM_CHANNEL_COUNT];			//Allocated with the PDU length
+	uint8*						RxSdu[CANNM_CHANNEL_COUNT][CANNM_FUZZ_RX_PDUS];
+} CanNm_Fuzz_ConfigSetType;
+
+/* Harness state, the expected behaviour of every channel is shadowed from the callouts and steps */
+typedef struct {
+	CanNm_InstanceType			Instance;
+	CanNm_Fuzz_ConfigSetType	Set[2];
+	const CanNm_ConfigType*		ConfigPtr;				//Configuration the shadows below belong to
+	uint16						ChannelCount;
+	Std_ReturnType				CanIfResult;
+	boolean						InTransmitApi;			//CanIf_Transmit through CanNm_Transmit
+	uint32						Step;
+	uint8						Op;
+	uint16						OpChannel;
+	Nm_StateType				NotifiedState[CANNM_CHANNEL_COUNT];
+	Nm_ModeType					IndicatedMode[CANNM_CHANNEL_COUNT];
+	boolean						RemoteSleep[CANNM_CHANNEL_COUNT];
+	boolean						Received[CANNM_CHANNEL_COUNT];
+	uint8						RxFrame[CANNM_CHANNEL_COUNT][CANNM_FUZZ_SDU_SIZE];	//Padded with zeros
+	uint32						RxCount[CANNM_CHANNEL_COUNT];
+	const uint8*				InputData;				//Saved to CANNM_FUZZ_CRASH_FILE on a violation, if set
+	size_t						InputSize;
+} CanNm_Fuzz_Type;
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static uint8 CanNm_Fuzz_Byte( CanNm_Fuzz_InputType* Input );
+static uint8* CanNm_Fuzz_Alloc( uint32 length );
+static void CanNm_Fuzz_Configure( CanNm_Fuzz_InputType* Input, CanNm_Fuzz_ConfigSetType* Set, uint8 globals0,
+									uint8 globals1, uint16 channelCount );
+static void CanNm_Fuzz_Reset( CanNm_Fuzz_Type* Fuzz );
+static void CanNm_Fuzz_Run( CanNm_Fuzz_Type* Fuzz, CanNm_Fuzz_InputType* Input );
+static void CanNm_Fuzz_Step( CanNm_Fuzz_Type* Fuzz, CanNm_Fuzz_InputType* Input, uint8 op, uint16 channel );
+static void CanNm_Fuzz_Check( CanNm_Fuzz_Type* Fuzz, uint16 dataChannel );
+static void CanNm_Fuzz_Fail( const CanNm_Fuzz_Type* Fuzz, const char* condition, int line );
+
+/* Callouts */
+static Std_ReturnType CanNm_Fuzz_Transmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+											const PduInfoType* PduInfoPtr );
+static void CanNm_Fuzz_BusSleepMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Fuzz_NetworkMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Fuzz_PrepareBusSleepMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Fuzz_RemoteSleepInd( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Fuzz_RemoteSleepCancellation( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Fuzz_Indication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Fuzz_StateChangeNotification( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+												Nm_StateType nmPreviousState, Nm_StateType nmCurrentState );
+static void CanNm_Fuzz_PduIndication( CanNm_InstanceType* Instance, PduIdType RxPduId,
+										const PduInfoType* PduInfoPtr );
+
+/*====================================================================================================================*\
+    Local variables (static)
+\*====================================================================================================================*/
+static const CanNm_CallbacksType CanNm_Fuzz_Callbacks = {
+	.CanIfTransmit = CanNm_Fuzz_Transmit,
+	.BusSleepMode = CanNm_Fuzz_BusSleepMode,
+	.NetworkMode = CanNm_Fuzz_NetworkMode,
+	.NetworkStartIndication = CanNm_Fuzz_Indication,
+	.PduRxIndication = CanNm_Fuzz_Indication,
+	.PrepareBusSleepMode = CanNm_Fuzz_PrepareBusSleepMode,
+	.RemoteSleepCancellation = CanNm_Fuzz_RemoteSleepCancellation,
+	.RemoteSleepInd = CanNm_Fuzz_RemoteSleepInd,
+	.StateChangeNotification = CanNm_Fuzz_StateChangeNotification,
+	.TxTimeoutException = CanNm_Fuzz_Indication,
+	.PduRRxIndication = CanNm_Fuzz_PduIndication
+};
+
+static CanNm_Fuzz_Type CanNm_Fuzz;
+static void* CanNm_Fuzz_Arena;
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief LLVMFuzzerTestOneInput
+ *
+ * Entry point of libFuzzer and AFL++: run one input, a violated invariant aborts.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	CanNm_Fuzz_InputType Input = { data, size, 0 };
+	uint8 globals0 = CanNm_Fuzz_Byte(&Input);
+	uint8 globals1 = CanNm_Fuzz_Byte(&Input);
+	uint16 channelCount = 1 + (globals1 >> 5) % CANNM_CHANNEL_COUNT;
+	uint32 arenaSize = CanNm_ChannelArenaSize(CANNM_CHANNEL_COUNT);
+
+	if (CanNm_Fuzz_Arena == NULL && (CanNm_Fuzz_Arena = malloc(arenaSize)) == NULL) {
+		return 0;
+	}
+	CanNm_Fuzz_Configure(&Input, &CanNm_Fuzz.Set[0], globals0, globals1, channelCount);
+	CanNm_Fuzz_Configure(&Input, &CanNm_Fuzz.Set[1], globals0, globals1, channelCount);
+	CanNm_Fuzz.Instance.Callbacks = &CanNm_Fuzz_Callbacks;
+	CanNm_Fuzz.Instance.Context = &CanNm_Fuzz;
+	CanNm_Fuzz.ChannelCount = channelCount;
+	CanNm_Fuzz.CanIfResult = E_OK;
+	CanNm_Fuzz.Step = 0;
+	if (CanNm_InstanceInit(&CanNm_Fuzz.Instance, &CanNm_Fuzz.Set[0].Config, CanNm_Fuzz_Arena, arenaSize) != E_OK) {
+		return 0;
+	}
+	CanNm_Fuzz_Reset(&CanNm_Fuzz);
+	CanNm_Fuzz_Check(&CanNm_Fuzz, CANNM_FUZZ_ALL_CHANNELS);
+	CanNm_Fuzz_Run(&CanNm_Fuzz, &Input);
+	return 0;
+}
+
+#ifndef CANNM_FUZZ_NO_MAIN
+int main(int argc, char** argv)
+{
+	uint64 count = 1000000;
+	uint64 seed = 1;
+	int arg = 1;
+
+	for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+		if (argv[arg][1] == 'n') {
+			count = strtoull(argv[arg + 1], NULL, 0);
+		}
+		else if (argv[arg][1] == 's') {
+			seed = strtoull(argv[arg + 1], NULL, 0);
+		}
+		else {
+			fprintf(stderr, "usage: %s [-n inputs] [-s seed] [file]...\n", argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (arg < argc) {
+		for (; arg < argc; arg++) {
+			FILE* File = fopen(argv[arg], "rb");
+			static uint8 data[1 << 20];
+			size_t size;
+
+			if (File == NULL) {
+				fprintf(stderr, "cannot open %s\n", argv[arg]);
+				return EXIT_FAILURE;
+			}
+			size = fread(data, 1, sizeof(data), File);
+			fclose(File);
+			LLVMFuzzerTestOneInput(data, size);
+			printf("%s: %zu bytes, %u steps, ok\n", argv[arg], size, CanNm_Fuzz.Step);
+		}
+		return EXIT_SUCCESS;
+	}
+
+	/* Random inputs, xorshift64 */
+	static uint8 data[CANNM_FUZZ_MAX_INPUT];
+	uint64 state = (seed != 0) ? seed : 1;
+	uint64 steps = 0;
+	struct timespec Start, End;
+
+	clock_gettime(CLOCK_MONOTONIC, &Start);
+	for (uint64 run = 0; run < count; run++) {
+		size_t size;
+
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		size = 1 + state % CANNM_FUZZ_MAX_INPUT;
+		for (size_t index = 0; index < size; index += 8) {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			memcpy(&data[index], &state, (size - index < 8) ? size - index : 8);
+		}
+		CanNm_Fuzz.InputData = data;
+		CanNm_Fuzz.InputSize = size;
+		LLVMFuzzerTestOneInput(data, size);
+		steps += CanNm_Fuzz.Step;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &End);
+
+	float64 seconds = (float64)(End.tv_sec - Start.tv_sec) + (float64)(End.tv_nsec - Start.tv_nsec) / 1e9;
+	printf("%llu inputs, %llu steps in %.2f s: %.0f execs/s, %.0f steps/s\n", (unsigned long long)count,
+		(unsigned long long)steps, seconds, (float64)count / seconds, (float64)steps / seconds);
+	return EXIT_SUCCESS;
+}
+#endif
+
+/*====================================================================================================================*\
+    Local functions code
+\*====================================================================================================================*/
+
+static uint8 CanNm_Fuzz_Byte( CanNm_Fuzz_InputType* Input )
+{
+	return (Input->Offset < Input->Size) ? Input->Data[Input->Offset++] : 0;
+}
+
+/* Zeroed block of exactly length bytes, so AddressSanitizer reports any access beyond it */
+static uint8* CanNm_Fuzz_Alloc( uint32 length )
+{
+	uint8* block = calloc((length != 0) ? length : 1, 1);
+
+	if (block == NULL) {
+		abort();
+	}
+	return block;
+}
+
+/** @brief CanNm_Fuzz_Configure
+ *
+ * Decode the channels of one configuration, 8 bytes per channel, timers in main function ticks. CBV and NID never
+ * share a byte, PDUs are at least 2 bytes long so both fit. The PDU buffers of the previous input are freed.
+ */
+static void CanNm_Fuzz_Configure( CanNm_Fuzz_InputType* Input, CanNm_Fuzz_ConfigSetType* Set, uint8 globals0,
+									uint8 globals1, uint16 channelCount )
+{
+	static const CanNm_PduBytePositionType Position[4] = {
+		CANNM_PDU_BYTE_0, CANNM_PDU_BYTE_1, CANNM_PDU_OFF, CANNM_PDU_OFF
+	};
+	CanNm_ConfigType* Config = &Set->Config;
+
+	for (uint16 channel = 0; channel < CANNM_CHANNEL_COUNT; channel++) {
+		free(Set->TxSdu[channel]);
+		for (uint8 rx = 0; rx < CANNM_FUZZ_RX_PDUS; rx++) {
+			free(Set->RxSdu[channel][rx]);
+		}
+	}
+	memset(Set, 0, sizeof(CanNm_Fuzz_ConfigSetType));
+	Config->PassiveModeEnabled = (globals0 >> 0) & 1;
+	Config->ImmediateRestartEnabled = (globals0 >> 1) & 1;
+	Config->RemoteSleepIndEnabled = (globals0 >> 2) & 1;
+	Config->UserDataEnabled = (globals0 >> 3) & 1;
+	Config->ComUserDataSupport = (globals0 >> 4) & 1;
+	Config->GlobalPnSupport = (globals0 >> 5) & 1;
+	Config->CoordinationSyncSupport = (globals0 >> 6) & 1;
+	Config->BusLoadReductionEnabled = (globals0 >> 7) & 1;
+	Config->PduRxIndicationEnabled = (globals1 >> 0) & 1;
+	Config->StateChangeIndEnabled = (globals1 >> 1) & 1;
+	Config->ImmediateTxConfEnabled = (globals1 >> 2) & 1;
+	Config->BusSynchronizationEnabled = (globals1 >> 3) & 1;
+	Config->ComControlEnabled = (globals1 >> 4) & 1;
+	Config->MainFunctionPeriod = 1.0;
+#if (CANNM_CONFIG_VARIANT == CANNM_VARIANT_PRE_COMPILE)
+	/* The module uses the switches of CanNm_Cfg.h, the checks must see the same */
+	Config->PassiveModeEnabled = (CANNM_PASSIVE_MODE_ENABLED == STD_ON);
+	Config->ImmediateRestartEnabled = (CANNM_IMMEDIATE_RESTART_ENABLED == STD_ON);
+	Config->RemoteSleepIndEnabled = (CANNM_REMOTE_SLEEP_IND_ENABLED == STD_ON);
+	Config->UserDataEnabled = (CANNM_USER_DATA_ENABLED == STD_ON);
+	Config->ComUserDataSupport = (CANNM_COM_USER_DATA_SUPPORT == STD_ON);
+	Config->GlobalPnSupport = (CANNM_GLOBAL_PN_SUPPORT == STD_ON);
+	Config->CoordinationSyncSupport = (CANNM_COORDINATION_SYNC_SUPPORT == STD_ON);
+	Config->PduRxIndicationEnabled = (CANNM_PDU_RX_INDICATION_ENABLED == STD_ON);
+	Config->StateChangeIndEnabled = (CANNM_STATE_CHANGE_IND_ENABLED == STD_ON);
+	Config->MainFunctionPeriod = CANNM_MAIN_FUNCTION_PERIOD;
+#endif
+	Config->ChannelCount = channelCount;
+
+	for (uint16 channel = 0; channel < channelCount; channel++) {
+		CanNm_ChannelType* Channel = &Set->Channel[channel];
+		uint8 layout = CanNm_Fuzz_Byte(Input);
+		uint8 pdu = CanNm_Fuzz_Byte(Input);
+		uint8 cycle = CanNm_Fuzz_Byte(Input);
+		uint8 timeout = CanNm_Fuzz_Byte(Input);
+		uint8 repeat = CanNm_Fuzz_Byte(Input);
+		uint8 sleep = CanNm_Fuzz_Byte(Input);
+		uint8 reduced = CanNm_Fuzz_Byte(Input);
+		PduLengthType sduLength = 2 + pdu % 7;
+		uint8 rxPduCount = 1 + ((pdu >> 3) & 1) % CANNM_FUZZ_RX_PDUS;
+		float32 period = Config->MainFunctionPeriod;
+
+		Channel->PduCbvPosition = Position[layout & 3];
+		Channel->PduNidPosition = Position[(layout >> 2) & 3];
+		if (Channel->PduNidPosition != CANNM_PDU_OFF && Channel->PduNidPosition == Channel->PduCbvPosition) {
+			Channel->PduNidPosition = (Channel->PduCbvPosition == CANNM_PDU_BYTE_0) ? CANNM_PDU_BYTE_1 : CANNM_PDU_BYTE_0;
+		}
+		Channel->NodeDetectionEnabled = (layout >> 4) & 1;
+		Channel->NodeIdEnabled = (layout >> 5) & 1;
+		Channel->ActiveWakeupBitEnabled = (layout >> 6) & 1;
+		Channel->BusLoadReductionActive = (layout >> 7) & 1;
+		Channel->RepeatMsgIndEnabled = (pdu >> 4) & 1;
+		Channel->PnEnabled = (pdu >> 5) & 1;
+		Channel->PnHandleMultipleNetworkRequests = (pdu >> 6) & 1;
+		Channel->NodeId = CanNm_Fuzz_Byte(Input);
+		Channel->MsgCycleTime = period * (1 + cycle % 16);
+		Channel->MsgCycleOffset = period * ((cycle >> 4) % (1 + cycle % 16));
+		Channel->TimeoutTime = period * (1 + timeout % 32);
+		Channel->RepeatMessageTime = period * (repeat % 32);
+		Channel->ImmediateNmTransmissions = repeat >> 5;
+		Channel->WaitBusSleepTime = period * (1 + sleep % 32);
+		Channel->ImmediateNmCycleTime = period * (1 + (sleep >> 5));
+		Channel->MsgReducedTime = period * (1 + reduced % 16);
+		Channel->RemoteSleepIndTime = period * (1 + (reduced >> 4));
+
+		Set->TxSdu[channel] = CanNm_Fuzz_Alloc(sduLength);
+		Set->TxPduInfo[channel].SduDataPtr = Set->TxSdu[channel];
+		Set->TxPduInfo[channel].SduLength = sduLength;
+		Set->TxPdu[channel].TxConfirmationPduId = channel;
+		Set->TxPdu[channel].TxPduRef = &Set->TxPduInfo[channel];
+		Set->UserDataTxPdu[channel].TxUserDataPduId = channel;
+		Set->UserDataTxPdu[channel].TxUserDataPduRef = &Set->TxPduInfo[channel];
+		Channel->TxPdu = &Set->TxPdu[channel];
+		Channel->UserDataTxPdu = &Set->UserDataTxPdu[channel];
+		for (uint8 rx = 0; rx < rxPduCount; rx++) {
+			Set->RxSdu[channel][rx] = CanNm_Fuzz_Alloc(sduLength);
+			Set->RxPduInfo[channel][rx].SduDataPtr = Set->RxSdu[channel][rx];
+			Set->RxPduInfo[channel][rx].SduLength = sduLength;
+			Set->RxPdu[channel][rx].RxPduId = channel;
+			Set->RxPdu[channel][rx].RxPduRef = &Set->RxPduInfo[channel][rx];
+			Channel->RxPdu[rx] = &Set->RxPdu[channel][rx];
+		}
+		Config->ChannelConfig[channel] = Channel;
+	}
+}
+
+/** @brief CanNm_Fuzz_Reset
+ *
+ * Shadows of a freshly initialized instance.
+ */
+static void CanNm_Fuzz_Reset( CanNm_Fuzz_Type* Fuzz )
+{
+	Fuzz->ConfigPtr = Fuzz->Instance.ConfigPtr;
+	Fuzz->InTransmitApi = FALSE;
+	for (uint16 channel = 0; channel < Fuzz->ChannelCount; channel++) {
+		Fuzz->NotifiedState[channel] = NM_STATE_BUS_SLEEP;
+		Fuzz->IndicatedMode[channel] = NM_MODE_BUS_SLEEP;
+		Fuzz->RemoteSleep[channel] = FALSE;
+		Fuzz->Received[channel] = FALSE;
+		Fuzz->RxCount[channel] = 0;
+	}
+}
+
+static void CanNm_Fuzz_Run( CanNm_Fuzz_Type* Fuzz, CanNm_Fuzz_InputType* Input )
+{
+	while (Input->Offset < Input->Size) {
+		uint8 op = CanNm_Fuzz_Byte(Input);
+
+		Fuzz->Step++;
+		Fuzz->Op = op % CANNM_FUZZ_OP_COUNT;
+		Fuzz->OpChannel = (op / CANNM_FUZZ_OP_COUNT) % Fuzz->ChannelCount;
+		CanNm_Fuzz_Step(Fuzz, Input, Fuzz->Op, Fuzz->OpChannel);
+		CanNm_Fuzz_Check(Fuzz, (Fuzz->Op == CANNM_FUZZ_OP_MAIN_FUNCTION || Fuzz->Op == CANNM_FUZZ_OP_SKIP_TICKS ||
+			Fuzz->Op == CANNM_FUZZ_OP_SWITCH_CONFIG || Fuzz->Op == CANNM_FUZZ_OP_DEINIT) ? CANNM_FUZZ_ALL_CHANNELS :
+			Fuzz->OpChannel);
+	}
+}
+
+/** @brief CanNm_Fuzz_Step
+ *
+ * Decode the arguments of one step and run it, checking what can only be checked right after the call.
+ */
+static void CanNm_Fuzz_Step( CanNm_Fuzz_Type* Fuzz, CanNm_Fuzz_InputType* Input, uint8 op, uint16 channel )
+{
+	CanNm_InstanceType* Instance = &Fuzz->Instance;
+	const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[channel];
+	PduInfoType PduInfo;
+	uint8 length;
+
+	switch (op) {
+	case CANNM_FUZZ_OP_RX_INDICATION:
+		length = CanNm_Fuzz_Byte(Input) % (CANNM_FUZZ_SDU_SIZE + 1);
+		PduInfo.SduLength = length;
+		PduInfo.SduDataPtr = malloc((length != 0) ? length : 1);
+		for (uint8 index = 0; index < length; index++) {
+			PduInfo.SduDataPtr[index] = CanNm_Fuzz_Byte(Input);
+		}
+		memcpy(Fuzz->RxFrame[channel], PduInfo.SduDataPtr, length);
+		memset(&Fuzz->RxFrame[channel][length], 0, CANNM_FUZZ_SDU_SIZE - length);
+		Fuzz->Received[channel] = TRUE;
+		Fuzz->RxCount[channel]++;
+		CanNm_InstanceRxIndication(Instance, channel, &PduInfo);
+		free(PduInfo.SduDataPtr);
+		break;
+	case CANNM_FUZZ_OP_MAIN_FUNCTION:
+		length = 1 + CanNm_Fuzz_Byte(Input) % 16;
+		for (uint8 tick = 0; tick < length; tick++) {
+			CanNm_InstanceMainFunction(Instance);
+			CanNm_Fuzz_Check(Fuzz, CANNM_FUZZ_NO_CHANNEL);
+		}
+		break;
+	case CANNM_FUZZ_OP_SKIP_TICKS: {
+		uint32 ticks = CanNm_Fuzz_Byte(Input);
+		uint32 next = CanNm_InstanceTicksToNextEvent(Instance);
+
+		if (ticks >= next) {
+			ticks = next - 1;
+		}
+		CanNm_InstanceSkipTicks(Instance, ticks);
+		break;
+	}
+	case CANNM_FUZZ_OP_NETWORK_REQUEST:
+		(void)CanNm_InstanceNetworkRequest(Instance, channel);
+		break;
+	case CANNM_FUZZ_OP_NETWORK_RELEASE:
+		(void)CanNm_InstanceNetworkRelease(Instance, channel);
+		break;
+	case CANNM_FUZZ_OP_PASSIVE_START_UP:
+		(void)CanNm_InstancePassiveStartUp(Instance, channel);
+		break;
+	case CANNM_FUZZ_OP_DISABLE_COMMUNICATION:
+		(void)CanNm_InstanceDisableCommunication(Instance, channel);
+		break;
+	case CANNM_FUZZ_OP_ENABLE_COMMUNICATION:
+		(void)CanNm_InstanceEnableCommunication(Instance, channel);
+		break;
+	case CANNM_FUZZ_OP_REPEAT_MESSAGE_REQUEST:
+		(void)CanNm_InstanceRepeatMessageRequest(Instance, channel);
+		break;
+	case CANNM_FUZZ_OP_BUS_SYNCHRONIZATION:
+		(void)CanNm_InstanceRequestBusSynchronization(Instance, channel);
+		break;
+	case CANNM_FUZZ_OP_SLEEP_READY_BIT:
+		(void)CanNm_InstanceSetSleepReadyBit(Instance, channel, CanNm_Fuzz_Byte(Input) & 1);
+		break;
+	case CANNM_FUZZ_OP_SET_USER_DATA: {
+		const PduInfoType* TxPduRef = Instance->ConfigPtr->ChannelConfig[channel]->TxPdu->TxPduRef;
+		uint8 userData[CANNM_FUZZ_SDU_SIZE];
+		uint8 before[CANNM_FUZZ_SDU_SIZE];
+
+		for (uint8 index = 0; index < ChannelHot->UserDataLength; index++) {
+			userData[index] = CanNm_Fuzz_Byte(Input);
+		}
+		memcpy(before, TxPduRef->SduDataPtr, TxPduRef->SduLength);
+		if (CanNm_InstanceSetUserData(Instance, channel, userData) == E_OK) {
+			CANNM_FUZZ_CHECK(Fuzz, memcmp(TxPduRef->SduDataPtr, before, ChannelHot->UserDataOffset) == 0);
+			CANNM_FUZZ_CHECK(Fuzz, memcmp(TxPduRef->SduDataPtr + ChannelHot->UserDataOffset, userData,
+				ChannelHot->UserDataLength) == 0);
+		}
+		else {
+			CANNM_FUZZ_CHECK(Fuzz, memcmp(TxPduRef->SduDataPtr, before, TxPduRef->SduLength) == 0);
+		}
+		break;
+	}
+	case CANNM_FUZZ_OP_TX_CONFIRMATION:
+		CanNm_InstanceTxConfirmation(Instance, channel, (CanNm_Fuzz_Byte(Input) & 1) ? E_NOT_OK : E_OK);
+		break;
+	case CANNM_FUZZ_OP_TRIGGER_TRANSMIT: {
+		const PduInfoType* TxPduRef = Instance->ConfigPtr->ChannelConfig[channel]->TxPdu->TxPduRef;
+		Std_ReturnType status;
+
+		length = CanNm_Fuzz_Byte(Input) % (CANNM_FUZZ_SDU_SIZE + 1);
+		PduInfo.SduLength = length;
+		PduInfo.SduDataPtr = malloc((length != 0) ? length : 1);
+		status = CanNm_InstanceTriggerTransmit(Instance, channel, &PduInfo);
+		if (status == E_OK) {
+			CANNM_FUZZ_CHECK(Fuzz, PduInfo.SduLength == TxPduRef->SduLength);
+			CANNM_FUZZ_CHECK(Fuzz, memcmp(PduInfo.SduDataPtr, TxPduRef->SduDataPtr, TxPduRef->SduLength) == 0);
+		}
+		else {
+			CANNM_FUZZ_CHECK(Fuzz, length < TxPduRef->SduLength && PduInfo.SduLength == length);
+		}
+		free(PduInfo.SduDataPtr);
+		break;
+	}
+	case CANNM_FUZZ_OP_TRANSMIT:
+		length = CanNm_Fuzz_Byte(Input) % (CANNM_FUZZ_SDU_SIZE + 1);
+		PduInfo.SduLength = length;
+		PduInfo.SduDataPtr = malloc((length != 0) ? length : 1);
+		for (uint8 index = 0; index < length; index++) {
+			PduInfo.SduDataPtr[index] = CanNm_Fuzz_Byte(Input);
+		}
+		Fuzz->InTransmitApi = TRUE;
+		(void)CanNm_InstanceTransmit(Instance, channel, &PduInfo);
+		Fuzz->InTransmitApi = FALSE;
+		free(PduInfo.SduDataPtr);
+		break;
+	case CANNM_FUZZ_OP_CONFIRM_PN_AVAILABILITY:
+		CanNm_InstanceConfirmPnAvailability(Instance, channel);
+		break;
+	case CANNM_FUZZ_OP_SWITCH_CONFIG:
+		(void)CanNm_InstanceSwitchConfig(Instance, &Fuzz->Set[CanNm_Fuzz_Byte(Input) & 1].Config);
+		break;
+	case CANNM_FUZZ_OP_DEINIT: {
+		Nm_StateType before[CANNM_CHANNEL_COUNT];
+		Nm_ModeType mode;
+
+		for (uint16 index = 0; index < Fuzz->ChannelCount; index++) {
+			(void)CanNm_InstanceGetState(Instance, index, &before[index], &mode);
+		}
+		CanNm_InstanceDeInit(Instance);
+		for (uint16 index = 0; index < Fuzz->ChannelCount; index++) {
+			Nm_StateType state;
+
+			(void)CanNm_InstanceGetState(Instance, index, &state, &mode);
+			CANNM_FUZZ_CHECK(Fuzz, (Instance->InitStatus == CANNM_UNINIT) ? (state == NM_STATE_UNINIT) :
+				(state == before[index]));
+		}
+		if (Instance->InitStatus == CANNM_UNINIT) {
+			const CanNm_ConfigType* ConfigPtr = Instance->ConfigPtr;
+
+			CANNM_FUZZ_CHECK(Fuzz, CanNm_InstanceInit(Instance, ConfigPtr, CanNm_Fuzz_Arena,
+				CanNm_ChannelArenaSize(CANNM_CHANNEL_COUNT)) == E_OK);
+			CanNm_Fuzz_Reset(Fuzz);
+		}
+		break;
+	}
+	case CANNM_FUZZ_OP_CANIF_RESULT:
+		Fuzz->CanIfResult = (CanNm_Fuzz_Byte(Input) & 1) ? E_NOT_OK : E_OK;
+		break;
+	case CANNM_FUZZ_OP_REMOTE_SLEEP_INDICATION: {
+		boolean remoteSleep = FALSE;
+
+		(void)CanNm_InstanceCheckRemoteSleepInd(Instance, channel, &remoteSleep);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+/** @brief CanNm_Fuzz_Check
+ *
+ * Invariants that hold between any two steps. The received data are compared on dataChannel only, the channel the
+ * step worked on, or on all channels after steps that work on all of them, to keep the check cheap.
+ */
+static void CanNm_Fuzz_Check( CanNm_Fuzz_Type* Fuzz, uint16 dataChannel )
+{
+	CanNm_InstanceType* Instance = &Fuzz->Instance;
+	const CanNm_ConfigType* ConfigPtr = Instance->ConfigPtr;
+	boolean allAsleep = TRUE;
+	uint32 next = CanNm_InstanceTicksToNextEvent(Instance);
+
+	if (ConfigPtr != Fuzz->ConfigPtr) {
+		for (uint16 channel = 0; channel < Fuzz->ChannelCount; channel++) {
+			Fuzz->Received[channel] = FALSE;						//Rebound to the Rx PDUs of the new configuration
+		}
+		Fuzz->ConfigPtr = ConfigPtr;
+	}
+
+	for (uint16 channel = 0; channel < Fuzz->ChannelCount; channel++) {
+		const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[channel];
+		Nm_StateType state;
+		Nm_ModeType mode;
+		uint8 pduData[CANNM_FUZZ_SDU_SIZE];
+		const uint8* expected = Fuzz->RxFrame[channel];
+		uint8 nodeId;
+
+		CANNM_FUZZ_CHECK(Fuzz, CanNm_InstanceGetState(Instance, channel, &state, &mode) == E_OK);
+		switch (state) {
+		case NM_STATE_BUS_SLEEP:
+			CANNM_FUZZ_CHECK(Fuzz, mode == NM_MODE_BUS_SLEEP);
+			break;
+		case NM_STATE_PREPARE_BUS_SLEEP:
+			CANNM_FUZZ_CHECK(Fuzz, mode == NM_MODE_PREPARE_BUS_SLEEP);
+			break;
+		case NM_STATE_READY_SLEEP:
+		case NM_STATE_NORMAL_OPERATION:
+		case NM_STATE_REPEAT_MESSAGE:
+			CANNM_FUZZ_CHECK(Fuzz, mode == NM_MODE_NETWORK);
+			break;
+		default:
+			CANNM_FUZZ_CHECK(Fuzz, state == NM_STATE_BUS_SLEEP);
+			break;
+		}
+		CANNM_FUZZ_CHECK(Fuzz, mode == Fuzz->IndicatedMode[channel]);
+		if (ConfigPtr->StateChangeIndEnabled) {
+			CANNM_FUZZ_CHECK(Fuzz, state == Fuzz->NotifiedState[channel]);
+		}
+		allAsleep = allAsleep && (state == NM_STATE_BUS_SLEEP);
+		if (dataChannel != CANNM_FUZZ_ALL_CHANNELS && dataChannel != channel) {
+			continue;
+		}
+
+		/* The last frame, cut or padded to the configured length */
+		if (CanNm_InstanceGetPduData(Instance, channel, pduData) == E_OK) {
+			CANNM_FUZZ_CHECK(Fuzz, Fuzz->Received[channel]);
+			CANNM_FUZZ_CHECK(Fuzz, memcmp(pduData, expected, ChannelHot->RxSduLength) == 0);
+		}
+		if (CanNm_InstanceGetUserData(Instance, channel, pduData) == E_OK) {
+			CANNM_FUZZ_CHECK(Fuzz, Fuzz->Received[channel]);
+			CANNM_FUZZ_CHECK(Fuzz, memcmp(pduData, expected + ChannelHot->UserDataOffset, ChannelHot->UserDataLength) == 0);
+		}
+		if (CanNm_InstanceGetNodeIdentifier(Instance, channel, &nodeId) == E_OK) {
+			CANNM_FUZZ_CHECK(Fuzz, Fuzz->Received[channel]);
+			CANNM_FUZZ_CHECK(Fuzz, nodeId == expected[ChannelHot->PduNidPosition]);
+		}
+		else {
+			CANNM_FUZZ_CHECK(Fuzz, !Fuzz->Received[channel] || ChannelHot->PduNidPosition == CANNM_PDU_OFF);
+		}
+
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+		CanNm_StatisticsType Statistics;
+
+		CANNM_FUZZ_CHECK(Fuzz, CanNm_InstanceGetStatistics(Instance, channel, &Statistics) == E_OK);
+		CANNM_FUZZ_CHECK(Fuzz, Statistics.RxFrames == Fuzz->RxCount[channel]);
+#endif
+	}
+
+	CANNM_FUZZ_CHECK(Fuzz, next >= 1);
+	if (allAsleep && Instance->PendingConfigPtr == NULL) {
+		CANNM_FUZZ_CHECK(Fuzz, next == CANNM_TICKS_INFINITE);
+	}
+}
+
+static void CanNm_Fuzz_Fail( const CanNm_Fuzz_Type* Fuzz, const char* condition, int line )
+{
+	fprintf(stderr, "CanNm_Fuzz.c:%d: invariant violated at step %u (op %u on channel %u): %s\n", line, Fuzz->Step,
+		Fuzz->Op, Fuzz->OpChannel, condition);
+	if (Fuzz->InputData != NULL) {
+		FILE* File = fopen(CANNM_FUZZ_CRASH_FILE, "wb");
+
+		if (File != NULL) {
+			fwrite(Fuzz->InputData, 1, Fuzz->InputSize, File);
+			fclose(File);
+			fprintf(stderr, "input written to %s\n", CANNM_FUZZ_CRASH_FILE);
+		}
+	}
+	abort();
+}
+
+/*====================================================================================================================*\
+    Callouts
+\*====================================================================================================================*/
+
+static Std_ReturnType CanNm_Fuzz_Transmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+											const PduInfoType* PduInfoPtr )
+{
+	CanNm_Fuzz_Type* Fuzz = (CanNm_Fuzz_Type*)Instance->Context;
+
+	if (!Fuzz->InTransmitApi) {
+		const CanNm_ChannelHotType* ChannelHot = &Instance->ChannelHotPtr[TxPduId];
+
+		CANNM_FUZZ_CHECK(Fuzz, TxPduId < Fuzz->ChannelCount);
+		CANNM_FUZZ_CHECK(Fuzz, !Instance->ConfigPtr->PassiveModeEnabled);
+		CANNM_FUZZ_CHECK(Fuzz, PduInfoPtr->SduLength == ChannelHot->TxSduLength);
+		if (ChannelHot->NodeIdEnabled && ChannelHot->PduNidPosition != CANNM_PDU_OFF) {
+			CANNM_FUZZ_CHECK(Fuzz, PduInfoPtr->SduDataPtr[ChannelHot->PduNidPosition] == ChannelHot->NodeId);
+		}
+	}
+	return Fuzz->CanIfResult;
+}
+
+static void CanNm_Fuzz_BusSleepMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	((CanNm_Fuzz_Type*)Instance->Context)->IndicatedMode[nmChannelHandle] = NM_MODE_BUS_SLEEP;
+}
+
+static void CanNm_Fuzz_NetworkMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	((CanNm_Fuzz_Type*)Instance->Context)->IndicatedMode[nmChannelHandle] = NM_MODE_NETWORK;
+}
+
+static void CanNm_Fuzz_PrepareBusSleepMode( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	((CanNm_Fuzz_Type*)Instance->Context)->IndicatedMode[nmChannelHandle] = NM_MODE_PREPARE_BUS_SLEEP;
+}
+
+static void CanNm_Fuzz_RemoteSleepInd( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	((CanNm_Fuzz_Type*)Instance->Context)->RemoteSleep[nmChannelHandle] = TRUE;
+}
+
+static void CanNm_Fuzz_RemoteSleepCancellation( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	CanNm_Fuzz_Type* Fuzz = (CanNm_Fuzz_Type*)Instance->Context;
+
+	CANNM_FUZZ_CHECK(Fuzz, Fuzz->RemoteSleep[nmChannelHandle]);
+	Fuzz->RemoteSleep[nmChannelHandle] = FALSE;
+}
+
+static void CanNm_Fuzz_Indication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	CanNm_Fuzz_Type* Fuzz = (CanNm_Fuzz_Type*)Instance->Context;
+
+	CANNM_FUZZ_CHECK(Fuzz, nmChannelHandle < Fuzz->ChannelCount);
+}
+
+static void CanNm_Fuzz_StateChangeNotification( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+												Nm_StateType nmPreviousState, Nm_StateType nmCurrentState )
+{
+	CanNm_Fuzz_Type* Fuzz = (CanNm_Fuzz_Type*)Instance->Context;
+
+	CANNM_FUZZ_CHECK(Fuzz, nmPreviousState == Fuzz->NotifiedState[nmChannelHandle]);
+	Fuzz->NotifiedState[nmChannelHandle] = nmCurrentState;
+}
+
+static void CanNm_Fuzz_PduIndication( CanNm_InstanceType* Instance, PduIdType RxPduId,
+										const PduInfoType* PduInfoPtr )
+{
+	CanNm_Fuzz_Type* Fuzz = (CanNm_Fuzz_Type*)Instance->Context;
+
+	CANNM_FUZZ_CHECK(Fuzz, RxPduId < Fuzz->ChannelCount && PduInfoPtr != NULL);
+}
@@ -0,0 +1,558 @@
+/** ==================================================================================================================*\
+  @file CanNm_Metrics.c
+
+  @brief Can Network Management Module - Prometheus metrics exporter
+
+  Exporter described in CanNm_Metrics.h. The thread formats a snapshot, writes it to the file if there is one and
+  then serves socket connections until the next period, so a scrape always gets a complete snapshot without ever
+  touching the instances itself. Linux host only.
+
+      gcc -O2 -c CanNm_Metrics.c
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include "CanNm_Metrics.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_METRICS_DEFAULT_PERIOD_MS				1000U
+#define CANNM_METRICS_IO_TIMEOUT_MS					1000U		//Per connection, a stuck client delays the next snapshot
+#define CANNM_METRICS_REQUEST_SIZE					4096U
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+/* Text under construction, Length keeps counting beyond Size like snprintf */
+typedef struct {
+	char*						Text;
+	uint32						Size;
+	uint32						Length;
+} CanNm_Metrics_WriterType;
+
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+typedef struct {
+	const char*					Name;
+	const char*					Help;
+	uint32						Offset;					//Of the counter in CanNm_StatisticsType
+} CanNm_Metrics_CounterType;
+#endif
+
+/*====================================================================================================================*\
+    Local data
+\*====================================================================================================================*/
+static const char* const CanNm_Metrics_StateNames[CANNM_STATE_COUNT] = {
+	"uninit", "bus_sleep", "prepare_bus_sleep", "ready_sleep", "normal_operation", "repeat_message", "synchronize"
+};
+
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+static const CanNm_Metrics_CounterType CanNm_Metrics_Counters[] = {
+	{ "cannm_rx_frames_total", "NM PDUs received.", offsetof(CanNm_StatisticsType, RxFrames) },
+	{ "cannm_tx_attempts_total", "NM PDUs passed to CanIf_Transmit.", offsetof(CanNm_StatisticsType, TxAttempts) },
+	{ "cannm_tx_failures_total", "NM PDUs rejected by CanIf_Transmit or negatively confirmed.",
+		offsetof(CanNm_StatisticsType, TxFailures) },
+	{ "cannm_tx_confirmations_total", "NM PDUs positively confirmed.", offsetof(CanNm_StatisticsType, TxConfirmations) },
+	{ "cannm_tx_timeouts_total", "Nm_TxTimeoutException calls.", offsetof(CanNm_StatisticsType, TxTimeouts) }
+};
+#endif
+
+#if (CANNM_TIMING_ENABLED == STD_ON)
+static const char* const CanNm_Metrics_FunctionNames[CANNM_TIMING_FUNCTION_COUNT] = {
+	"main_function", "rx_indication", "tx_confirmation", "trigger_transmit"
+};
+#endif
+
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+static const char* const CanNm_Metrics_MilestoneNames[CANNM_WAKEUP_MILESTONE_COUNT] = {
+	"first_transmit", "first_confirmation", "normal_operation"
+};
+#endif
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static void* CanNm_Metrics_Thread( void* Arg );
+static Std_ReturnType CanNm_Metrics_Snapshot( CanNm_MetricsType* Metrics );
+static Std_ReturnType CanNm_Metrics_WriteFile( const CanNm_MetricsType* Metrics );
+static boolean CanNm_Metrics_SocketStale( const struct sockaddr_un* Address );
+static Std_ReturnType CanNm_Metrics_Wait( CanNm_MetricsType* Metrics );
+static void CanNm_Metrics_Serve( const CanNm_MetricsType* Metrics, int connection );
+static Std_ReturnType CanNm_Metrics_WriteAll( int fd, const char* data, uint32 length );
+static uint64 CanNm_Metrics_NowMs( void );
+static void CanNm_Metrics_Printf( CanNm_Metrics_WriterType* Writer, const char* format, ... );
+static void CanNm_Metrics_Family( CanNm_Metrics_WriterType* Writer, const char* name, const char* type,
+									const char* help );
+#if (CANNM_TIMING_ENABLED == STD_ON) || (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+static void CanNm_Metrics_Summary( CanNm_Metrics_WriterType* Writer, const char* name, const char* labels,
+									const CanNm_TimingType* Timing );
+#endif
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief CanNm_MetricsStart
+ *
+ * Create the socket or write the file once, then start the exporter thread. E_NOT_OK if any of it fails, nothing is
+ * left open then.
+ */
+Std_ReturnType CanNm_MetricsStart(CanNm_MetricsType* Metrics)
+{
+	size_t prefixLength = strlen(CANNM_METRICS_SOCKET_PREFIX);
+
+	if (Metrics == NULL || Metrics->Instances == NULL || Metrics->Path == NULL) {
+		return E_NOT_OK;
+	}
+	Metrics->PeriodMs = (Metrics->PeriodMs == 0) ? CANNM_METRICS_DEFAULT_PERIOD_MS : Metrics->PeriodMs;
+	Metrics->Running = FALSE;
+	Metrics->Listen = -1;
+	Metrics->Bound = FALSE;
+	Metrics->Text = NULL;
+	Metrics->TextLength = 0;
+	Metrics->TextSize = 0;
+	if (pipe(Metrics->Wake) != 0) {
+		return E_NOT_OK;
+	}
+	fcntl(Metrics->Wake[0], F_SETFD, FD_CLOEXEC);
+	fcntl(Metrics->Wake[1], F_SETFD, FD_CLOEXEC);
+
+	if (strncmp(Metrics->Path, CANNM_METRICS_SOCKET_PREFIX, prefixLength) == 0) {
+		struct sockaddr_un Address = { .sun_family = AF_UNIX };
+		const char* socketPath = Metrics->Path + prefixLength;
+		struct stat Stat;
+
+		Metrics->Listen = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		if (Metrics->Listen < 0 || strlen(socketPath) >= sizeof(Address.sun_path)) {
+			CanNm_MetricsStop(Metrics);
+			return E_NOT_OK;
+		}
+		strcpy(Address.sun_path, socketPath);
+		if (lstat(socketPath, &Stat) == 0 && S_ISSOCK(Stat.st_mode) && CanNm_Metrics_SocketStale(&Address)) {
+			unlink(socketPath);									//Left over by a previous run
+		}
+		if (bind(Metrics->Listen, (const struct sockaddr*)&Address, sizeof(Address)) != 0) {
+			CanNm_MetricsStop(Metrics);							//Any other file or a live socket is kept
+			return E_NOT_OK;
+		}
+		Metrics->Bound = TRUE;
+		if (listen(Metrics->Listen, 8) != 0 || CanNm_Metrics_Snapshot(Metrics) != E_OK) {
+			CanNm_MetricsStop(Metrics);
+			return E_NOT_OK;
+		}
+	}
+	else if (CanNm_Metrics_Snapshot(Metrics) != E_OK || CanNm_Metrics_WriteFile(Metrics) != E_OK) {
+		CanNm_MetricsStop(Metrics);
+		return E_NOT_OK;
+	}
+	else {
+		Metrics->Bound = TRUE;
+	}
+
+	if (pthread_create(&Metrics->Thread, NULL, CanNm_Metrics_Thread, Metrics) != 0) {
+		CanNm_MetricsStop(Metrics);
+		return E_NOT_OK;
+	}
+	Metrics->Running = TRUE;
+	return E_OK;
+}
+
+/** @brief CanNm_MetricsStop
+ *
+ * Stop the thread and remove the socket or file, so no stale values are scraped afterwards. Only a path the exporter
+ * created itself is removed.
+ */
+void CanNm_MetricsStop(CanNm_MetricsType* Metrics)
+{
+	size_t prefixLength = strlen(CANNM_METRICS_SOCKET_PREFIX);
+
+	if (Metrics->Running) {
+		(void)write(Metrics->Wake[1], "", 1);
+		pthread_join(Metrics->Thread, NULL);
+		Metrics->Running = FALSE;
+	}
+	close(Metrics->Wake[0]);
+	close(Metrics->Wake[1]);
+	if (Metrics->Listen >= 0) {
+		close(Metrics->Listen);
+		Metrics->Listen = -1;
+	}
+	if (Metrics->Bound) {
+		unlink((strncmp(Metrics->Path, CANNM_METRICS_SOCKET_PREFIX, prefixLength) == 0) ?
+			Metrics->Path + prefixLength : Metrics->Path);
+		Metrics->Bound = FALSE;
+	}
+	free(Metrics->Text);
+	Metrics->Text = NULL;
+}
+
+/** @brief CanNm_MetricsFormat
+ *
+ * Write the metrics of instanceCount instances to text, always terminated if textSize > 0. Returns the length of the
+ * complete text without the terminator; if that is not below textSize, the text was cut.
+ */
+uint32 CanNm_MetricsFormat(CanNm_InstanceType* const* Instances, uint32 instanceCount, char* text, uint32 textSize)
+{
+	CanNm_Metrics_WriterType Writer = { .Text = text, .Size = textSize, .Length = 0 };
+
+	if (textSize > 0) {
+		text[0] = '\0';
+	}
+
+	CanNm_Metrics_Family(&Writer, "cannm_initialized", "gauge", "1 if the instance is initialized.");
+	for (uint32 index = 0; index < instanceCount; index++) {
+		CanNm_Metrics_Printf(&Writer, "cannm_initialized{cannm_instance=\"%u\"} %u\n", index,
+			(Instances[index]->InitStatus == CANNM_INIT) ? 1U : 0U);
+	}
+
+	CanNm_Metrics_Family(&Writer, "cannm_state", "gauge", "1 for the current Nm_StateType of the channel.");
+	for (uint32 index = 0; index < instanceCount; index++) {
+		CanNm_InstanceType* Instance = Instances[index];
+
+		for (uint16 channel = 0; channel < Instance->ChannelCount && Instance->InitStatus == CANNM_INIT; channel++) {
+			Nm_StateType nmState;
+			Nm_ModeType nmMode;
+
+			CanNm_InstanceGetState(Instance, channel, &nmState, &nmMode);
+			for (uint32 state = 0; state < CANNM_STATE_COUNT; state++) {
+				CanNm_Metrics_Printf(&Writer, "cannm_state{cannm_instance=\"%u\",channel=\"%u\",state=\"%s\"} %u\n",
+					index, channel, CanNm_Metrics_StateNames[state], (nmState == state) ? 1U : 0U);
+			}
+		}
+	}
+
+#if (CANNM_STATISTICS_ENABLED == STD_ON)
+	for (uint32 counter = 0; counter < sizeof(CanNm_Metrics_Counters) / sizeof(CanNm_Metrics_Counters[0]); counter++) {
+		CanNm_Metrics_Family(&Writer, CanNm_Metrics_Counters[counter].Name, "counter", CanNm_Metrics_Counters[counter].Help);
+		for (uint32 index = 0; index < instanceCount; index++) {
+			CanNm_StatisticsType Statistics;
+
+			for (uint16 channel = 0; channel < Instances[index]->ChannelCount; channel++) {
+				if (CanNm_InstanceGetStatistics(Instances[index], channel, &Statistics) == E_OK) {
+					uint32 value;
+
+					memcpy(&value, (const uint8*)&Statistics + CanNm_Metrics_Counters[counter].Offset, sizeof(uint32));
+					CanNm_Metrics_Printf(&Writer, "%s{cannm_instance=\"%u\",channel=\"%u\"} %u\n",
+						CanNm_Metrics_Counters[counter].Name, index, channel, value);
+				}
+			}
+		}
+	}
+
+	/* Only transitions seen, the full matrix would be 49 series per channel */
+	CanNm_Metrics_Family(&Writer, "cannm_state_transitions_total", "counter", "State changes by previous and new state.");
+	for (uint32 index = 0; index < instanceCount; index++) {
+		CanNm_StatisticsType Statistics;
+
+		for (uint16 channel = 0; channel < Instances[index]->ChannelCount; channel++) {
+			if (CanNm_InstanceGetStatistics(Instances[index], channel, &Statistics) != E_OK) {
+				continue;
+			}
+			for (uint32 from = 0; from < CANNM_STATE_COUNT; from++) {
+				for (uint32 to = 0; to < CANNM_STATE_COUNT; to++) {
+					if (Statistics.Transitions[from][to] != 0) {
+						CanNm_Metrics_Printf(&Writer, "cannm_state_transitions_total"
+							"{cannm_instance=\"%u\",channel=\"%u\",from=\"%s\",to=\"%s\"} %u\n", index, channel,
+							CanNm_Metrics_StateNames[from], CanNm_Metrics_StateNames[to], Statistics.Transitions[from][to]);
+					}
+				}
+			}
+		}
+	}
+#endif
+
+#if (CANNM_BUS_LOAD_ENABLED == STD_ON)
+	CanNm_Metrics_Family(&Writer, "cannm_bus_load_frames_per_second", "gauge", "Averaged NM frame rate.");
+	for (uint32 index = 0; index < instanceCount; index++) {
+		CanNm_BusLoadType BusLoad;
+
+		for (uint16 channel = 0; channel < Instances[index]->ChannelCount; channel++) {
+			if (CanNm_InstanceGetBusLoad(Instances[index], channel, &BusLoad) == E_OK) {
+				CanNm_Metrics_Printf(&Writer,
+					"cannm_bus_load_frames_per_second{cannm_instance=\"%u\",channel=\"%u\",direction=\"rx\"} %.3f\n"
+					"cannm_bus_load_frames_per_second{cannm_instance=\"%u\",channel=\"%u\",direction=\"tx\"} %.3f\n",
+					index, channel, BusLoad.RxFramesPerSecond, index, channel, BusLoad.TxFramesPerSecond);
+			}
+		}
+	}
+	CanNm_Metrics_Family(&Writer, "cannm_bus_load_bits_per_second", "gauge", "Averaged NM bit rate.");
+	for (uint32 index = 0; index < instanceCount; index++) {
+		CanNm_BusLoadType BusLoad;
+
+		for (uint16 channel = 0; channel < Instances[index]->ChannelCount; channel++) {
+			if (CanNm_InstanceGetBusLoad(Instances[index], channel, &BusLoad) == E_OK) {
+				CanNm_Metrics_Printf(&Writer,
+					"cannm_bus_load_bits_per_second{cannm_instance=\"%u\",channel=\"%u\",direction=\"rx\"} %.3f\n"
+					"cannm_bus_load_bits_per_second{cannm_instance=\"%u\",channel=\"%u\",direction=\"tx\"} %.3f\n",
+					index, channel, BusLoad.RxBitsPerSecond, index, channel, BusLoad.TxBitsPerSecond);
+			}
+		}
+	}
+#endif
+
+#if (CANNM_TIMING_ENABLED == STD_ON)
+	CanNm_Metrics_Family(&Writer, "cannm_call_cycles", "summary",
+		"Execution time of the CanNm functions in CANNM_TIMING_CYCLES.");
+	for (uint32 index = 0; index < instanceCount; index++) {
+		for (uint32 function = 0; function < CANNM_TIMING_FUNCTION_COUNT && Instances[index]->InitStatus == CANNM_INIT;
+				function++) {
+			CanNm_TimingType Timing;
+			char labels[64];
+
+			memcpy(&Timing, &Instances[index]->Timing[function], sizeof(CanNm_TimingType));
+			snprintf(labels, sizeof(labels), "cannm_instance=\"%u\",function=\"%s\"", index,
+				CanNm_Metrics_FunctionNames[function]);
+			CanNm_Metrics_Summary(&Writer, "cannm_call_cycles", labels, &Timing);
+		}
+	}
+#endif
+
+#if (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+	CanNm_Metrics_Family(&Writer, "cannm_wakeup_latency", "summary",
+		"Time from a waking CanNm_NetworkRequest to a milestone in CANNM_WAKEUP_CLOCK units.");
+	for (uint32 index = 0; index < instanceCount; index++) {
+		for (uint16 channel = 0; channel < Instances[index]->ChannelCount; channel++) {
+			CanNm_WakeupLatencyType Latency;
+
+			if (CanNm_InstanceGetWakeupLatency(Instances[index], channel, &Latency) != E_OK) {
+				continue;
+			}
+			for (uint32 milestone = 0; milestone < CANNM_WAKEUP_MILESTONE_COUNT; milestone++) {
+				char labels[96];
+
+				snprintf(labels, sizeof(labels), "cannm_instance=\"%u\",channel=\"%u\",milestone=\"%s\"", index,
+					channel, CanNm_Metrics_MilestoneNames[milestone]);
+				CanNm_Metrics_Summary(&Writer, "cannm_wakeup_latency", labels, &Latency.Milestones[milestone]);
+			}
+		}
+	}
+#endif
+
+	return Writer.Length;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+static void* CanNm_Metrics_Thread( void* Arg )
+{
+	CanNm_MetricsType* Metrics = Arg;
+
+	while (CanNm_Metrics_Wait(Metrics) == E_OK) {
+		if (CanNm_Metrics_Snapshot(Metrics) == E_OK && Metrics->Listen < 0) {
+			(void)CanNm_Metrics_WriteFile(Metrics);				//Retried with the next snapshot
+		}
+	}
+	return NULL;
+}
+
+/** @brief CanNm_Metrics_Snapshot
+ *
+ * Format all instances into Text, growing it as needed.
+ */
+static Std_ReturnType CanNm_Metrics_Snapshot( CanNm_MetricsType* Metrics )
+{
+	uint32 length = CanNm_MetricsFormat(Metrics->Instances, Metrics->InstanceCount, Metrics->Text, Metrics->TextSize);
+
+	if (length >= Metrics->TextSize) {
+		uint32 size = length + length / 4U + 1U;			//Room for counters growing a digit
+		char* Text = realloc(Metrics->Text, size);
+
+		if (Text == NULL) {
+			return E_NOT_OK;
+		}
+		Metrics->Text = Text;
+		Metrics->TextSize = size;
+		length = CanNm_MetricsFormat(Metrics->Instances, Metrics->InstanceCount, Metrics->Text, Metrics->TextSize);
+		length = (length < size) ? length : size - 1U;
+	}
+	Metrics->TextLength = length;
+	return E_OK;
+}
+
+/** @brief CanNm_Metrics_WriteFile
+ *
+ * Replace the file by the snapshot, readers see either the old or the new one completely.
+ */
+static Std_ReturnType CanNm_Metrics_WriteFile( const CanNm_MetricsType* Metrics )
+{
+	char temporary[4096];
+	int fd;
+
+	if (snprintf(temporary, sizeof(temporary), "%s.tmp", Metrics->Path) >= (int)sizeof(temporary)) {
+		return E_NOT_OK;
+	}
+	fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		return E_NOT_OK;
+	}
+	if (CanNm_Metrics_WriteAll(fd, Metrics->Text, Metrics->TextLength) != E_OK) {
+		close(fd);
+		unlink(temporary);
+		return E_NOT_OK;
+	}
+	close(fd);
+	return (rename(temporary, Metrics->Path) == 0) ? E_OK : E_NOT_OK;
+}
+
+/** @brief CanNm_Metrics_SocketStale
+ *
+ * TRUE if nothing listens on the socket any more, e.g. after a crash of the exporter that bound it. A socket another
+ * running exporter serves is not stale.
+ */
+static boolean CanNm_Metrics_SocketStale( const struct sockaddr_un* Address )
+{
+	int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	boolean stale;
+
+	if (probe < 0) {
+		return FALSE;
+	}
+	stale = (connect(probe, (const struct sockaddr*)Address, sizeof(*Address)) != 0 && errno == ECONNREFUSED);
+	close(probe);
+	return stale;
+}
+
+/** @brief CanNm_Metrics_Wait
+ *
+ * Serve connections until the next snapshot is due. E_NOT_OK when the exporter is stopped.
+ */
+static Std_ReturnType CanNm_Metrics_Wait( CanNm_MetricsType* Metrics )
+{
+	uint64 due = CanNm_Metrics_NowMs() + Metrics->PeriodMs;
+
+	for (;;) {
+		struct pollfd Fds[2] = {
+			{ .fd = Metrics->Wake[0], .events = POLLIN },
+			{ .fd = Metrics->Listen, .events = POLLIN }			//Ignored by poll for a file, Listen is -1
+		};
+		uint64 now = CanNm_Metrics_NowMs();
+
+		if (now >= due) {
+			return E_OK;
+		}
+		if (poll(Fds, 2, (int)(due - now)) < 0 && errno != EINTR) {
+			return E_NOT_OK;
+		}
+		if (Fds[0].revents != 0) {
+			return E_NOT_OK;
+		}
+		if (Fds[1].revents & POLLIN) {
+			int connection = accept(Metrics->Listen, NULL, NULL);
+
+			if (connection >= 0) {
+				fcntl(connection, F_SETFD, FD_CLOEXEC);
+				CanNm_Metrics_Serve(Metrics, connection);
+				close(connection);
+			}
+		}
+	}
+}
+
+/** @brief CanNm_Metrics_Serve
+ *
+ * Read the request header, whatever it asks for, and answer with the snapshot.
+ */
+static void CanNm_Metrics_Serve( const CanNm_MetricsType* Metrics, int connection )
+{
+	struct timeval Timeout = { .tv_sec = CANNM_METRICS_IO_TIMEOUT_MS / 1000U,
+								.tv_usec = (CANNM_METRICS_IO_TIMEOUT_MS % 1000U) * 1000U };
+	char request[CANNM_METRICS_REQUEST_SIZE + 1];
+	uint32 received = 0;
+	char header[128];
+
+	setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+	setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &Timeout, sizeof(Timeout));
+	while (received < CANNM_METRICS_REQUEST_SIZE) {
+		ssize_t count = recv(connection, request + received, CANNM_METRICS_REQUEST_SIZE - received, 0);
+
+		if (count <= 0) {
+			break;
+		}
+		received += (uint32)count;
+		request[received] = '\0';
+		if (strstr(request, "\r\n\r\n") != NULL || strstr(request, "\n\n") != NULL) {
+			break;
+		}
+	}
+
+	int length = snprintf(header, sizeof(header), "HTTP/1.0 200 OK\r\n"
+		"Content-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: %u\r\n\r\n", Metrics->TextLength);
+	if (CanNm_Metrics_WriteAll(connection, header, (uint32)length) == E_OK) {
+		(void)CanNm_Metrics_WriteAll(connection, Metrics->Text, Metrics->TextLength);
+	}
+}
+
+static Std_ReturnType CanNm_Metrics_WriteAll( int fd, const char* data, uint32 length )
+{
+	while (length > 0) {
+		ssize_t count = write(fd, data, length);
+
+		if (count < 0 && errno == EINTR) {
+			continue;
+		}
+		if (count <= 0) {
+			return E_NOT_OK;
+		}
+		data += count;
+		length -= (uint32)count;
+	}
+	return E_OK;
+}
+
+static uint64 CanNm_Metrics_NowMs( void )
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return (uint64)Now.tv_sec * 1000U + (uint64)Now.tv_nsec / 1000000U;
+}
+
+static void CanNm_Metrics_Printf( CanNm_Metrics_WriterType* Writer, const char* format, ... )
+{
+	uint32 room = (Writer->Length < Writer->Size) ? Writer->Size - Writer->Length : 0;
+	va_list Args;
+
+	va_start(Args, format);
+	int length = vsnprintf((room > 0) ? Writer->Text + Writer->Length : NULL, room, format, Args);
+	va_end(Args);
+	Writer->Length += (length > 0) ? (uint32)length : 0;
+}
+
+static void CanNm_Metrics_Family( CanNm_Metrics_WriterType* Writer, const char* name, const char* type,
+									const char* help )
+{
+	CanNm_Metrics_Printf(Writer, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+#if (CANNM_TIMING_ENABLED == STD_ON) || (CANNM_WAKEUP_LATENCY_ENABLED == STD_ON)
+/* Quantiles are bucket upper bounds as in CanNm_TimingSummary */
+static void CanNm_Metrics_Summary( CanNm_Metrics_WriterType* Writer, const char* name, const char* labels,
+									const CanNm_TimingType* Timing )
+{
+	CanNm_TimingSummaryType Summary;
+
+	CanNm_TimingSummary(Timing, &Summary);
+	CanNm_Metrics_Printf(Writer, "%s{%s,quantile=\"0.5\"} %llu\n%s{%s,quantile=\"0.99\"} %llu\n"
+		"%s_sum{%s} %llu\n%s_count{%s} %u\n",
+		name, labels, (unsigned long long)Summary.P50, name, labels, (unsigned long long)Summary.P99,
+		name, labels, (unsigned long long)Timing->Sum, name, labels, Timing->Count);
+}
+#endif
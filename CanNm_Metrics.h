@@ -0,0 +1,63 @@
+#ifndef CANNM_METRICS_H
+#define CANNM_METRICS_H
+
+/**===================================================================================================================*\
+  @file CanNm_Metrics.h
+
+  @brief Can Network Management Module - Prometheus metrics exporter
+
+  Exports the states of all channels of one or more instances and, as far as they are enabled in CanNm_Cfg.h, the
+  statistics counters, bus load estimates, execution time and wake-up latency histograms in the Prometheus text
+  exposition format. A background thread takes a snapshot every PeriodMs through the CanNm_InstanceGet* functions,
+  which only read, so the main function and the indications never wait for it. Each value is read whole, but a
+  snapshot taken while a CanNm call runs may mix counts from before and after it.
+
+  With a Path like "/run/cannm/cannm.prom" the snapshot replaces the file atomically (written next to it and
+  renamed), as the node_exporter textfile collector expects. With "unix:/run/cannm.sock" the thread listens on that
+  Unix domain socket and answers every connection with the latest snapshot as an HTTP/1.0 response, e.g. for
+  curl --unix-socket /run/cannm.sock http://localhost/metrics. Nothing listens on the network. Linux host only.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <pthread.h>
+
+#include "CanNm.h"
+
+/*====================================================================================================================*\
+    Global macros
+\*====================================================================================================================*/
+#define CANNM_METRICS_SOCKET_PREFIX					"unix:"
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+/** @brief CanNm_MetricsType
+ *
+ * One exporter. The caller fills Instances to PeriodMs and keeps the instances alive until CanNm_MetricsStop, the
+ * remaining fields belong to the exporter thread. Instances are labelled cannm_instance="<index>".
+ */
+typedef struct {
+	CanNm_InstanceType* const*	Instances;
+	uint32						InstanceCount;
+	const char*					Path;					//File, or CANNM_METRICS_SOCKET_PREFIX and socket path
+	uint32						PeriodMs;				//Snapshot period, 0 for 1000
+	pthread_t					Thread;
+	boolean						Running;
+	int							Listen;					//Socket, -1 for a file
+	boolean						Bound;					//Path created by this exporter, removed on stop
+	int							Wake[2];				//Pipe to stop the thread
+	char*						Text;					//Latest snapshot
+	uint32						TextLength;
+	uint32						TextSize;
+} CanNm_MetricsType;
+
+/*====================================================================================================================*\
+    Global functions declarations
+\*====================================================================================================================*/
+Std_ReturnType CanNm_MetricsStart(CanNm_MetricsType* Metrics);
+void CanNm_MetricsStop(CanNm_MetricsType* Metrics);
+uint32 CanNm_MetricsFormat(CanNm_InstanceType* const* Instances, uint32 instanceCount, char* text, uint32 textSize);
+
+#endif /* CANNM_METRICS_H */
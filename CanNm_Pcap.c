@@ -0,0 +1,83 @@
+/** ==================================================================================================================*\
+  @file CanNm_Pcap.c
+
+  @brief Can Network Management Module - NM PDU capture ring
+
+  Ring set up and the consumer side of the capture ring, see CanNm_Pcap.h. Recording itself is CanNm_PcapRecord,
+  inlined into CanNm.c.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include "CanNm_Pcap.h"
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief CanNm_PcapInit
+ *
+ * Set up an empty ring over capacity frames, a power of two, timestamped with CANNM_PCAP_TIMESTAMP.
+ */
+Std_ReturnType CanNm_PcapInit(CanNm_PcapRingType* Ring, CanNm_PcapFrameType* frames, uint32 capacity)
+{
+	if (Ring == NULL || frames == NULL || CanNm_RingInit(&Ring->Slots, capacity) != E_OK) {
+		return E_NOT_OK;
+	}
+	for (uint32 index = 0; index < capacity; index++) {
+		atomic_init(&frames[index].Sequence, 0);
+	}
+	Ring->Frames = frames;
+	Ring->Clock = NULL;
+	Ring->ClockContext = NULL;
+	return E_OK;
+}
+
+/** @brief CanNm_PcapRead
+ *
+ * Copy up to maxCount frames recorded since *tail, oldest first, advance *tail past them and return their number.
+ * Frames overwritten before they were read are skipped and added to *lost. Reading stops at a frame that is still
+ * being written, it is returned by the next call. One consumer per ring, 0 as the first *tail.
+ */
+uint32 CanNm_PcapRead(const CanNm_PcapRingType* Ring, uint64* tail, CanNm_PcapFrameType* frames, uint32 maxCount,
+						uint32* lost)
+{
+	uint64 head = CanNm_RingHead(&Ring->Slots);
+	uint64 index = *tail;
+	uint32 copied = 0;
+
+	if (head - index > (uint64)Ring->Slots.Mask + 1) {
+		*lost += (uint32)(head - index - (Ring->Slots.Mask + 1));
+		index = head - (Ring->Slots.Mask + 1);
+	}
+	for (; index != head && copied < maxCount; index++) {
+		CanNm_PcapFrameType* Frame = &Ring->Frames[index & Ring->Slots.Mask];
+		uint64 sequence = CanNm_RingReadBegin(&Frame->Sequence);
+		CanNm_PcapFrameType* Copy = &frames[copied];
+
+		if (sequence < index + 1) {
+			break;												//Reserved, not yet written
+		}
+		if (sequence != index + 1) {
+			(*lost)++;											//Overwritten by a newer frame
+			continue;
+		}
+		Copy->Timestamp = Frame->Timestamp;
+		Copy->Channel = Frame->Channel;
+		Copy->Point = Frame->Point;
+		Copy->Drop = Frame->Drop;
+		Copy->Flags = Frame->Flags;
+		Copy->Nid = Frame->Nid;
+		Copy->Length = (Frame->Length > CANNM_PCAP_DATA_SIZE) ? CANNM_PCAP_DATA_SIZE : Frame->Length;
+		memcpy(Copy->Data, Frame->Data, Copy->Length);
+		if (!CanNm_RingReadEnd(&Frame->Sequence, sequence)) {
+			(*lost)++;
+			continue;
+		}
+		atomic_init(&Copy->Sequence, sequence);
+		copied++;
+	}
+	*tail = index;
+	return copied;
+}
@@ -0,0 +1,136 @@
+#ifndef CANNM_PCAP_H
+#define CANNM_PCAP_H
+
+/**===================================================================================================================*\
+  @file CanNm_Pcap.h
+
+  @brief Can Network Management Module - NM PDU capture ring
+
+  With CANNM_PCAP_ENABLED set to STD_ON, CanNm copies every NM PDU it receives in CanNm_RxIndication, passes to
+  CanIf_Transmit or hands out in CanNm_TriggerTransmit into the capture ring set in CanNm_InstanceType::PcapRing.
+  PDUs the module drops are captured as well, marked with the reason: transmissions suppressed while communication is
+  disabled, PDUs rejected by CanIf_Transmit and CanNm_TriggerTransmit calls with a too short buffer. Like the trace
+  ring of CanNm_Trace.h, a capture ring serves one core and shares its slot protocol, CanNm_Ring.h, so recording is
+  a timestamp read and a copy of the PDU, and a full ring overwrites its oldest frames.
+
+  CanNm_PcapRead hands the complete frames to a consumer in order, e.g. to the writer of CanNm_PcapWriter.h, which
+  turns them into a pcapng file for Wireshark on a background thread.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <string.h>
+
+#include "Std_Types.h"
+#include "CanNm_Ring.h"
+#if defined(__unix__)
+#include <time.h>
+#endif
+
+/*====================================================================================================================*\
+    Global macros
+\*====================================================================================================================*/
+/* Tap points of CanNm_PcapFrameType::Point */
+#define CANNM_PCAP_RX_INDICATION					0U		//Received, CanNm_RxIndication
+#define CANNM_PCAP_TRANSMIT							1U		//Sent, CanIf_Transmit
+#define CANNM_PCAP_TRIGGER_TRANSMIT					2U		//Sent, CanNm_TriggerTransmit
+
+/* Drop reasons of CanNm_PcapFrameType::Drop */
+#define CANNM_PCAP_DROP_NONE						0U
+#define CANNM_PCAP_DROP_TX_DISABLED					1U		//Not passed to CanIf_Transmit, communication disabled
+#define CANNM_PCAP_DROP_CANIF_REJECTED				2U		//CanIf_Transmit returned E_NOT_OK
+#define CANNM_PCAP_DROP_BUFFER_TOO_SMALL			3U		//CanNm_TriggerTransmit left the buffer unchanged
+
+/* Flags of CanNm_PcapFrameType::Flags */
+#define CANNM_PCAP_NID_VALID						0x01U	//Nid holds the source node identifier of the PDU
+
+/* Longest PDU kept, the payload of a CAN FD frame; longer PDUs are cut */
+#define CANNM_PCAP_DATA_SIZE						64U
+
+/* Timestamp of frames of rings without Clock in ns since the epoch, as shown by Wireshark. Defaults to the real time
+ * clock on POSIX hosts, can be defined to e.g. a synchronized ECU time. */
+#ifndef CANNM_PCAP_TIMESTAMP
+#if defined(__unix__)
+#define CANNM_PCAP_TIMESTAMP()						CanNm_PcapRealTime()
+#else
+#define CANNM_PCAP_TIMESTAMP()						((uint64)0)
+#endif
+#endif
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+/** @brief CanNm_PcapFrameType
+ *
+ * One captured PDU. Sequence is the sequence number of its slot, see CanNm_RingSequenceType.
+ */
+typedef struct {
+	uint64						Timestamp;				//ns
+	CanNm_RingSequenceType		Sequence;
+	uint16						Channel;
+	uint8						Point;					//CANNM_PCAP_RX_INDICATION ...
+	uint8						Drop;					//CANNM_PCAP_DROP_*
+	uint8						Flags;					//CANNM_PCAP_NID_VALID
+	uint8						Nid;
+	uint8						Length;
+	uint8						Data[CANNM_PCAP_DATA_SIZE];
+} CanNm_PcapFrameType;
+
+/** @brief CanNm_PcapRingType
+ *
+ * Ring of Capacity frames, a power of two. Clock, if not NULL, replaces CANNM_PCAP_TIMESTAMP, e.g. with the time of a
+ * simulation, and returns ns.
+ */
+typedef struct {
+	CanNm_RingType				Slots;
+	CanNm_PcapFrameType*		Frames;
+	uint64						(*Clock)(void* ClockContext);
+	void*						ClockContext;
+} CanNm_PcapRingType;
+
+/*====================================================================================================================*\
+    Global functions declarations
+\*====================================================================================================================*/
+Std_ReturnType CanNm_PcapInit(CanNm_PcapRingType* Ring, CanNm_PcapFrameType* frames, uint32 capacity);
+uint32 CanNm_PcapRead(const CanNm_PcapRingType* Ring, uint64* tail, CanNm_PcapFrameType* frames, uint32 maxCount,
+						uint32* lost);
+
+/*====================================================================================================================*\
+    Global inline functions and function macros code
+\*====================================================================================================================*/
+
+#if defined(__unix__)
+static inline uint64 CanNm_PcapRealTime(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_REALTIME, &Now);
+	return (uint64)Now.tv_sec * 1000000000U + (uint64)Now.tv_nsec;
+}
+#endif
+
+/** @brief CanNm_PcapRecord
+ *
+ * Append one PDU. A concurrent CanNm_PcapRead waits for it until it is complete.
+ */
+static inline void CanNm_PcapRecord(CanNm_PcapRingType* Ring, uint16 channel, uint8 point, uint8 drop, uint8 flags,
+									uint8 nid, const uint8* data, uint32 length)
+{
+	uint64 index = CanNm_RingReserve(&Ring->Slots);
+	CanNm_PcapFrameType* Frame = &Ring->Frames[index & Ring->Slots.Mask];
+
+	length = (length > CANNM_PCAP_DATA_SIZE) ? CANNM_PCAP_DATA_SIZE : length;
+	CanNm_RingOpen(&Frame->Sequence);
+	Frame->Timestamp = (Ring->Clock != NULL) ? Ring->Clock(Ring->ClockContext) : CANNM_PCAP_TIMESTAMP();
+	Frame->Channel = channel;
+	Frame->Point = point;
+	Frame->Drop = drop;
+	Frame->Flags = flags;
+	Frame->Nid = nid;
+	Frame->Length = (uint8)length;
+	memcpy(Frame->Data, data, length);
+	CanNm_RingPublish(&Frame->Sequence, index);
+}
+
+#endif /* CANNM_PCAP_H */
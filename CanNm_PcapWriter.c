@@ -0,0 +1,312 @@
+/** ==================================================================================================================*\
+  @file CanNm_PcapWriter.c
+
+  @brief Can Network Management Module - pcapng writer of the NM PDU capture ring
+
+  Writer described in CanNm_PcapWriter.h. The file starts with a section header and one interface description per
+  channel, then the thread appends an enhanced packet block per frame and flushes once per period. Linux host only.
+
+      gcc -O2 -c CanNm_Pcap.c CanNm_PcapWriter.c
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "CanNm_PcapWriter.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_PCAPWRITER_DEFAULT_PERIOD_MS			100U
+#define CANNM_PCAPWRITER_BUFFER_SIZE				65536U
+#define CANNM_PCAPWRITER_BATCH						64U			//Frames per CanNm_PcapRead
+
+/* pcapng blocks, options and link type */
+#define CANNM_PCAPWRITER_SECTION_HEADER				0x0A0D0D0AUL
+#define CANNM_PCAPWRITER_INTERFACE_DESCRIPTION		0x00000001UL
+#define CANNM_PCAPWRITER_ENHANCED_PACKET			0x00000006UL
+#define CANNM_PCAPWRITER_BYTE_ORDER_MAGIC			0x1A2B3C4DUL
+#define CANNM_PCAPWRITER_OPT_COMMENT				1U
+#define CANNM_PCAPWRITER_IF_NAME					2U
+#define CANNM_PCAPWRITER_IF_TSRESOL					9U
+#define CANNM_PCAPWRITER_EPB_FLAGS					2U
+#define CANNM_PCAPWRITER_EPB_INBOUND				0x00000001UL
+#define CANNM_PCAPWRITER_EPB_OUTBOUND				0x00000002UL
+#define CANNM_PCAPWRITER_LINKTYPE_CAN_SOCKETCAN		227U
+
+/* SocketCAN frame header */
+#define CANNM_PCAPWRITER_CAN_SFF_MASK				0x000007FFUL
+#define CANNM_PCAPWRITER_CAN_EFF_FLAG				0x80000000UL
+#define CANNM_PCAPWRITER_CANFD_FDF					0x04U
+#define CANNM_PCAPWRITER_CAN_MAX_DLEN				8U
+
+/* Longest block: header, SocketCAN frame, flags, comment, end of options and trailing length */
+#define CANNM_PCAPWRITER_BLOCK_SIZE					256U
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+/* Block under construction */
+typedef struct {
+	uint8						Data[CANNM_PCAPWRITER_BLOCK_SIZE];
+	uint32						Length;
+} CanNm_PcapWriter_BlockType;
+
+/*====================================================================================================================*\
+    Local data
+\*====================================================================================================================*/
+static const char* const CanNm_PcapWriter_PointNames[] = {
+	"CanNm_RxIndication", "CanIf_Transmit", "CanNm_TriggerTransmit"
+};
+
+static const char* const CanNm_PcapWriter_DropReasons[] = {
+	"", " dropped, communication disabled", " dropped, rejected by CanIf", " dropped, buffer too small"
+};
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static void* CanNm_PcapWriter_Thread( void* Arg );
+static void CanNm_PcapWriter_Drain( CanNm_PcapWriterType* Writer );
+static Std_ReturnType CanNm_PcapWriter_Header( CanNm_PcapWriterType* Writer );
+static void CanNm_PcapWriter_Frame( CanNm_PcapWriterType* Writer, const CanNm_PcapFrameType* Frame );
+static void CanNm_PcapWriter_Open( CanNm_PcapWriter_BlockType* Block, uint32 type );
+static void CanNm_PcapWriter_Put( CanNm_PcapWriter_BlockType* Block, const void* data, uint32 length );
+static void CanNm_PcapWriter_Put32( CanNm_PcapWriter_BlockType* Block, uint32 value );
+static void CanNm_PcapWriter_Option( CanNm_PcapWriter_BlockType* Block, uint16 code, const void* value,
+									uint16 length );
+static void CanNm_PcapWriter_Close( FILE* File, CanNm_PcapWriter_BlockType* Block );
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief CanNm_PcapWriterStart
+ *
+ * Create the file, write its header and start the writer thread. E_NOT_OK if any of it fails, nothing is left open
+ * then. Frames recorded before the start are written as far as the ring still holds them.
+ */
+Std_ReturnType CanNm_PcapWriterStart(CanNm_PcapWriterType* Writer)
+{
+	int fd;
+
+	if (Writer == NULL || Writer->Ring == NULL || Writer->Path == NULL || Writer->ChannelCount == 0) {
+		return E_NOT_OK;
+	}
+	Writer->PeriodMs = (Writer->PeriodMs == 0) ? CANNM_PCAPWRITER_DEFAULT_PERIOD_MS : Writer->PeriodMs;
+	Writer->Running = FALSE;
+	Writer->Tail = 0;
+	Writer->Written = 0;
+	Writer->Lost = 0;
+
+	fd = open(Writer->Path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		return E_NOT_OK;
+	}
+	Writer->File = fdopen(fd, "wb");
+	if (Writer->File == NULL) {
+		close(fd);
+		return E_NOT_OK;
+	}
+	setvbuf(Writer->File, NULL, _IOFBF, CANNM_PCAPWRITER_BUFFER_SIZE);
+	if (CanNm_PcapWriter_Header(Writer) != E_OK || pipe(Writer->Wake) != 0) {
+		fclose(Writer->File);
+		Writer->File = NULL;
+		return E_NOT_OK;
+	}
+	fcntl(Writer->Wake[0], F_SETFD, FD_CLOEXEC);
+	fcntl(Writer->Wake[1], F_SETFD, FD_CLOEXEC);
+
+	if (pthread_create(&Writer->Thread, NULL, CanNm_PcapWriter_Thread, Writer) != 0) {
+		(void)CanNm_PcapWriterStop(Writer);
+		return E_NOT_OK;
+	}
+	Writer->Running = TRUE;
+	return E_OK;
+}
+
+/** @brief CanNm_PcapWriterStop
+ *
+ * Stop the thread, write the frames still in the ring and close the file. E_NOT_OK if writing the file failed at
+ * any time, the file may then be incomplete.
+ */
+Std_ReturnType CanNm_PcapWriterStop(CanNm_PcapWriterType* Writer)
+{
+	Std_ReturnType status = E_OK;
+
+	if (Writer->Running) {
+		(void)write(Writer->Wake[1], "", 1);
+		pthread_join(Writer->Thread, NULL);
+		Writer->Running = FALSE;
+	}
+	close(Writer->Wake[0]);
+	close(Writer->Wake[1]);
+	if (Writer->File != NULL) {
+		CanNm_PcapWriter_Drain(Writer);
+		status = (ferror(Writer->File) == 0) ? E_OK : E_NOT_OK;
+		status = (fclose(Writer->File) == 0) ? status : E_NOT_OK;
+		Writer->File = NULL;
+	}
+	return status;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+static void* CanNm_PcapWriter_Thread( void* Arg )
+{
+	CanNm_PcapWriterType* Writer = Arg;
+	struct pollfd Wake = { .fd = Writer->Wake[0], .events = POLLIN };
+
+	for (;;) {
+		int ready = poll(&Wake, 1, (int)Writer->PeriodMs);
+
+		if ((ready < 0 && errno != EINTR) || ready > 0) {
+			return NULL;
+		}
+		CanNm_PcapWriter_Drain(Writer);
+		fflush(Writer->File);
+	}
+}
+
+/** @brief CanNm_PcapWriter_Drain
+ *
+ * Write all complete frames of the ring into the stdio buffer.
+ */
+static void CanNm_PcapWriter_Drain( CanNm_PcapWriterType* Writer )
+{
+	CanNm_PcapFrameType Frames[CANNM_PCAPWRITER_BATCH];
+	uint32 count;
+
+	do {
+		count = CanNm_PcapRead(Writer->Ring, &Writer->Tail, Frames, CANNM_PCAPWRITER_BATCH, &Writer->Lost);
+		for (uint32 index = 0; index < count; index++) {
+			if (Frames[index].Channel < Writer->ChannelCount) {
+				CanNm_PcapWriter_Frame(Writer, &Frames[index]);
+				Writer->Written++;
+			}
+			else {
+				Writer->Lost++;
+			}
+		}
+	} while (count == CANNM_PCAPWRITER_BATCH);
+}
+
+/** @brief CanNm_PcapWriter_Header
+ *
+ * Section header of unknown length and one interface per channel with ns timestamps.
+ */
+static Std_ReturnType CanNm_PcapWriter_Header( CanNm_PcapWriterType* Writer )
+{
+	CanNm_PcapWriter_BlockType Block;
+	const uint16 linkType[2] = { CANNM_PCAPWRITER_LINKTYPE_CAN_SOCKETCAN, 0U };	//Link type and reserved
+	const uint8 tsresol = 9U;
+
+	CanNm_PcapWriter_Open(&Block, CANNM_PCAPWRITER_SECTION_HEADER);
+	CanNm_PcapWriter_Put32(&Block, CANNM_PCAPWRITER_BYTE_ORDER_MAGIC);
+	CanNm_PcapWriter_Put32(&Block, 1U);									//Version 1.0
+	CanNm_PcapWriter_Put32(&Block, 0xFFFFFFFFUL);						//Section length unknown
+	CanNm_PcapWriter_Put32(&Block, 0xFFFFFFFFUL);
+	CanNm_PcapWriter_Close(Writer->File, &Block);
+
+	for (uint16 channel = 0; channel < Writer->ChannelCount; channel++) {
+		char name[16];
+		int length = snprintf(name, sizeof(name), "cannm%u", channel);
+
+		CanNm_PcapWriter_Open(&Block, CANNM_PCAPWRITER_INTERFACE_DESCRIPTION);
+		CanNm_PcapWriter_Put(&Block, linkType, sizeof(linkType));
+		CanNm_PcapWriter_Put32(&Block, 0U);									//No snap length
+		CanNm_PcapWriter_Option(&Block, CANNM_PCAPWRITER_IF_NAME, name, (uint16)length);
+		CanNm_PcapWriter_Option(&Block, CANNM_PCAPWRITER_IF_TSRESOL, &tsresol, 1U);
+		CanNm_PcapWriter_Put32(&Block, 0U);									//End of options
+		CanNm_PcapWriter_Close(Writer->File, &Block);
+	}
+	return (fflush(Writer->File) == 0) ? E_OK : E_NOT_OK;
+}
+
+/** @brief CanNm_PcapWriter_Frame
+ *
+ * Enhanced packet block of one frame: SocketCAN header and payload, direction and the comment.
+ */
+static void CanNm_PcapWriter_Frame( CanNm_PcapWriterType* Writer, const CanNm_PcapFrameType* Frame )
+{
+	CanNm_PcapWriter_BlockType Block;
+	uint32 canId = (Writer->CanIdBase != NULL) ? Writer->CanIdBase[Frame->Channel] : CANNM_PCAP_CAN_ID_BASE;
+	uint8 header[8] = { 0 };
+	uint32 direction = (Frame->Point == CANNM_PCAP_RX_INDICATION) ? CANNM_PCAPWRITER_EPB_INBOUND :
+						CANNM_PCAPWRITER_EPB_OUTBOUND;
+	char comment[64];
+	int length;
+
+	canId += ((Frame->Flags & CANNM_PCAP_NID_VALID) != 0) ? Frame->Nid : 0U;
+	canId |= (canId > CANNM_PCAPWRITER_CAN_SFF_MASK) ? CANNM_PCAPWRITER_CAN_EFF_FLAG : 0U;
+	header[0] = (uint8)(canId >> 24);										//Big endian
+	header[1] = (uint8)(canId >> 16);
+	header[2] = (uint8)(canId >> 8);
+	header[3] = (uint8)canId;
+	header[4] = Frame->Length;
+	header[5] = (Frame->Length > CANNM_PCAPWRITER_CAN_MAX_DLEN) ? CANNM_PCAPWRITER_CANFD_FDF : 0U;
+	length = snprintf(comment, sizeof(comment), "%s%s",
+		CanNm_PcapWriter_PointNames[(Frame->Point < 3U) ? Frame->Point : 0U],
+		CanNm_PcapWriter_DropReasons[(Frame->Drop < 4U) ? Frame->Drop : 0U]);
+
+	CanNm_PcapWriter_Open(&Block, CANNM_PCAPWRITER_ENHANCED_PACKET);
+	CanNm_PcapWriter_Put32(&Block, Frame->Channel);						//Interface
+	CanNm_PcapWriter_Put32(&Block, (uint32)(Frame->Timestamp >> 32));
+	CanNm_PcapWriter_Put32(&Block, (uint32)Frame->Timestamp);
+	CanNm_PcapWriter_Put32(&Block, sizeof(header) + Frame->Length);		//Captured and original length
+	CanNm_PcapWriter_Put32(&Block, sizeof(header) + Frame->Length);
+	CanNm_PcapWriter_Put(&Block, header, sizeof(header));
+	CanNm_PcapWriter_Put(&Block, Frame->Data, Frame->Length);
+	CanNm_PcapWriter_Put(&Block, "\0\0\0", (4U - Block.Length % 4U) % 4U);
+	CanNm_PcapWriter_Option(&Block, CANNM_PCAPWRITER_EPB_FLAGS, &direction, sizeof(direction));
+	CanNm_PcapWriter_Option(&Block, CANNM_PCAPWRITER_OPT_COMMENT, comment, (uint16)length);
+	CanNm_PcapWriter_Put32(&Block, 0U);										//End of options
+	CanNm_PcapWriter_Close(Writer->File, &Block);
+}
+
+/* Block type and room for the total length, filled in by CanNm_PcapWriter_Close */
+static void CanNm_PcapWriter_Open( CanNm_PcapWriter_BlockType* Block, uint32 type )
+{
+	Block->Length = 0;
+	CanNm_PcapWriter_Put32(Block, type);
+	CanNm_PcapWriter_Put32(Block, 0U);
+}
+
+static void CanNm_PcapWriter_Put( CanNm_PcapWriter_BlockType* Block, const void* data, uint32 length )
+{
+	memcpy(&Block->Data[Block->Length], data, length);
+	Block->Length += length;
+}
+
+/* Host byte order, announced by the byte order magic of the section header */
+static void CanNm_PcapWriter_Put32( CanNm_PcapWriter_BlockType* Block, uint32 value )
+{
+	CanNm_PcapWriter_Put(Block, &value, sizeof(value));
+}
+
+static void CanNm_PcapWriter_Option( CanNm_PcapWriter_BlockType* Block, uint16 code, const void* value,
+									uint16 length )
+{
+	CanNm_PcapWriter_Put(Block, &code, sizeof(code));
+	CanNm_PcapWriter_Put(Block, &length, sizeof(length));
+	CanNm_PcapWriter_Put(Block, value, length);
+	CanNm_PcapWriter_Put(Block, "\0\0\0", (4U - length % 4U) % 4U);
+}
+
+/* Trailing total length, which is also patched into the header */
+static void CanNm_PcapWriter_Close( FILE* File, CanNm_PcapWriter_BlockType* Block )
+{
+	uint32 total = Block->Length + 4U;
+
+	memcpy(&Block->Data[4], &total, sizeof(total));
+	CanNm_PcapWriter_Put32(Block, total);
+	(void)fwrite(Block->Data, 1, Block->Length, File);
+}
@@ -0,0 +1,65 @@
+#ifndef CANNM_PCAPWRITER_H
+#define CANNM_PCAPWRITER_H
+
+/**===================================================================================================================*\
+  @file CanNm_PcapWriter.h
+
+  @brief Can Network Management Module - pcapng writer of the NM PDU capture ring
+
+  Drains a capture ring of CanNm_Pcap.h into a pcapng file every PeriodMs on a background thread, through a large
+  stdio buffer, so CanNm itself only ever appends to the ring. Every channel is an interface named "cannm<channel>"
+  of link type LINKTYPE_CAN_SOCKETCAN, which Wireshark decodes with its CAN dissectors. A frame is flagged inbound or
+  outbound and carries a comment with its tap point and, for the PDUs CanNm dropped, the reason, e.g.
+  "CanIf_Transmit dropped, rejected by CanIf", so frame.comment contains "dropped" shows them all.
+
+  The CAN identifier of a frame is the base identifier of its channel plus the NID byte of the PDU, the usual
+  AUTOSAR NM identifier range; PDUs without NID get the base. Identifiers above 0x7FF are written as extended
+  identifiers, PDUs longer than 8 bytes as CAN FD frames. Linux host only.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <pthread.h>
+#include <stdio.h>
+
+#include "CanNm_Pcap.h"
+
+/*====================================================================================================================*\
+    Global macros
+\*====================================================================================================================*/
+/* Base CAN identifier of the channels without CanIdBase entry */
+#ifndef CANNM_PCAP_CAN_ID_BASE
+#define CANNM_PCAP_CAN_ID_BASE						0x500U
+#endif
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+/** @brief CanNm_PcapWriterType
+ *
+ * One writer. The caller fills Ring to PeriodMs and keeps the ring alive until CanNm_PcapWriterStop, the remaining
+ * fields belong to the writer thread. Frames of channels from ChannelCount on have no interface and count as lost.
+ */
+typedef struct {
+	CanNm_PcapRingType*			Ring;
+	const char*					Path;
+	uint16						ChannelCount;			//Interfaces written
+	const uint32*				CanIdBase;				//Per channel, NULL for CANNM_PCAP_CAN_ID_BASE on all
+	uint32						PeriodMs;				//Flush period, 0 for 100
+	pthread_t					Thread;
+	boolean						Running;
+	FILE*						File;
+	int							Wake[2];				//Pipe to stop the thread
+	uint64						Tail;					//Next frame of the ring to write
+	uint32						Written;				//Frames written
+	uint32						Lost;					//Frames overwritten before they were written
+} CanNm_PcapWriterType;
+
+/*====================================================================================================================*\
+    Global functions declarations
+\*====================================================================================================================*/
+Std_ReturnType CanNm_PcapWriterStart(CanNm_PcapWriterType* Writer);
+Std_ReturnType CanNm_PcapWriterStop(CanNm_PcapWriterType* Writer);
+
+#endif /* CANNM_PCAPWRITER_H */
@@ -0,0 +1,791 @@
+/** ==================================================================================================================*\
+  @file CanNm_Replay.c
+
+  @brief Can Network Management Module - bus log replay
+
+  Feeds the NM frames of a recorded bus log into CanNm, configured from a CanNm_Cfg.bin image (CanNm_Blob.h), and
+  prints the resulting state timeline, one line per state change:
+
+      <seconds since the first frame> ch <channel> <previous state> -> <new state>
+
+  Logs are candump -l files ("(1436509052.249713) can0 51B#1122334455667788", CAN FD "##") or Vector ASC files
+  (classic CAN lines, "base hex|dec", "timestamps absolute|relative"); the format is detected per line. A map
+  "[bus:]id[-id]=channel" routes CAN IDs of the candump interface or ASC channel bus, or of all buses, to the
+  RxPduId of a channel; without one, 0x500-0x5FF of any bus go to channel 0. A map "-t" marks the own NM frames of
+  the ECU instead: they are not received, but confirm its pending transmission, so lost frames show as Tx timeouts.
+  Without "-t" every transmission is confirmed right away. A CanNm_NetworkStartIndication is answered with
+  CanNm_PassiveStartUp as ComM would, outside passive mode, where CanNm_PassiveStartUp is rejected, with a
+  CanNm_NetworkRequest and CanNm_NetworkRelease, which wake the channel into the same states. "-R
+  time:channel:request|release" adds network requests of the application at log times.
+
+  The main function runs at the configured period on the log clock, event driven as in CanNm_SimAdvance, so idle
+  periods cost nothing and a 10 hour log replays in about the time it takes to parse it. "-r" paces the replay to
+  the recorded timestamps instead. After the last frame the replay continues until all timers have stopped, at
+  most CANNM_REPLAY_DRAIN_TIME. With "-e expected.txt" the timeline is compared with an expected one of the same
+  format, times may differ by the tolerance "-T" in ms (default one main function period); the differences are
+  printed and the exit status is EXIT_FAILURE if there are any. Host only.
+
+      gcc -O2 -DUNIT_TEST -o CanNm_Replay CanNm_Replay.c CanNm_Blob.c CanNm_Trace.c CanNm.c -lm
+      ./CanNm_Replay -c CanNm_Cfg.bin [-m map]... [-t map]... [-R request]... [-r] [-e expected] [-T ms] [-o out] log
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CanNm_Blob.h"
+#include "CanNm_Trace.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_REPLAY_MAX_MAPS						64U
+#define CANNM_REPLAY_MAX_REQUESTS					256U
+#define CANNM_REPLAY_MAX_SDU_LENGTH					64U
+#define CANNM_REPLAY_MAX_DIFFS						20U			//Printed, all are counted
+#define CANNM_REPLAY_DRAIN_TIME						3600.0		//s
+#define CANNM_REPLAY_DEFAULT_FIRST_ID				0x500U
+#define CANNM_REPLAY_DEFAULT_LAST_ID				0x5FFU
+#define CANNM_REPLAY_LINE_LENGTH					1024U
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+/* CAN IDs First to Last of Bus ("" for all) to a channel */
+typedef struct {
+	char						Bus[16];
+	uint32						First;
+	uint32						Last;
+	uint16						Channel;
+	boolean						Own;					//Own NM frames of the ECU, "-t"
+} CanNm_Replay_MapType;
+
+typedef struct {
+	float64						Time;
+	uint16						Channel;
+	boolean						Request;				//CanNm_NetworkRequest, else CanNm_NetworkRelease
+} CanNm_Replay_RequestType;
+
+typedef struct {
+	float64						Time;
+	uint16						Channel;
+	uint8						From;
+	uint8						To;
+} CanNm_Replay_TransitionType;
+
+typedef struct {
+	float64						Time;					//s since the first frame
+	char						Bus[16];
+	uint32						CanId;
+	uint8						Length;
+	uint8						Data[CANNM_REPLAY_MAX_SDU_LENGTH];
+} CanNm_Replay_FrameType;
+
+typedef struct {
+	FILE*						File;
+	boolean						Started;				//Start is set
+	float64						Start;					//Log time of the first frame
+	boolean						AscDecimal;
+	boolean						AscRelative;
+	float64						AscLast;				//Absolute time of the previous ASC line
+	uint64						LineNumber;
+} CanNm_Replay_LogType;
+
+typedef struct {
+	CanNm_Replay_MapType		Maps[CANNM_REPLAY_MAX_MAPS];
+	uint32						MapCount;
+	boolean						OwnMapped;				//Any "-t" map, transmissions wait for the log
+	CanNm_Replay_RequestType	Requests[CANNM_REPLAY_MAX_REQUESTS];
+	uint32						RequestCount;
+	uint32						NextRequest;
+	uint64						PeriodUs;				//Main function period
+	uint64						Tick;					//Main functions since the first frame
+	float64						Now;					//s since the first frame
+	uint16						ChannelCount;
+	boolean*					StartPending;			//NetworkStartIndication to answer, per channel
+	boolean*					TxPending;				//Transmission not confirmed yet, per channel
+	CanNm_Replay_TransitionType* Timeline;
+	uint32						TimelineLength;
+	uint32						TimelineSize;
+	boolean						Realtime;
+	struct timespec				WallStart;
+	uint64						FrameCount;
+	uint64						UnmappedCount;
+	uint64						TxCount;
+	uint64						OwnCount;
+} CanNm_Replay_Type;
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static Std_ReturnType CanNm_Replay_ParseMap( const char* text, boolean own, CanNm_Replay_Type* Replay );
+static Std_ReturnType CanNm_Replay_ParseRequest( const char* text, CanNm_Replay_Type* Replay );
+static boolean CanNm_Replay_Next( CanNm_Replay_LogType* Log, CanNm_Replay_FrameType* Frame );
+static boolean CanNm_Replay_ParseCandump( const char* line, float64* time, CanNm_Replay_FrameType* Frame );
+static boolean CanNm_Replay_ParseAsc( CanNm_Replay_LogType* Log, char* line, float64* time,
+										CanNm_Replay_FrameType* Frame );
+static void CanNm_Replay_AdvanceTo( CanNm_Replay_Type* Replay, float64 time );
+static void CanNm_Replay_RunTo( CanNm_Replay_Type* Replay, uint64 tick );
+static void CanNm_Replay_Deliver( CanNm_Replay_Type* Replay, const CanNm_Replay_FrameType* Frame );
+static void CanNm_Replay_Settle( CanNm_Replay_Type* Replay );
+static void CanNm_Replay_Pace( const CanNm_Replay_Type* Replay, float64 time );
+static uint64 CanNm_Replay_Tick( const CanNm_Replay_Type* Replay, float64 time );
+static void CanNm_Replay_Write( const CanNm_Replay_Type* Replay, FILE* Out );
+static uint32 CanNm_Replay_Diff( const CanNm_Replay_Type* Replay, const char* path, float64 tolerance );
+static Std_ReturnType CanNm_Replay_Load( const char* path, CanNm_Replay_TransitionType** Timeline, uint32* length );
+static sint32 CanNm_Replay_Channel( const CanNm_InstanceType* Instance, PduIdType TxPduId );
+
+/* Callouts */
+static Std_ReturnType CanNm_Replay_Transmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+											const PduInfoType* PduInfoPtr );
+static void CanNm_Replay_Indication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Replay_NetworkStartIndication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Replay_StateChangeNotification( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+													Nm_StateType nmPreviousState, Nm_StateType nmCurrentState );
+static void CanNm_Replay_PduIndication( CanNm_InstanceType* Instance, PduIdType RxPduId,
+										const PduInfoType* PduInfoPtr );
+
+/*====================================================================================================================*\
+    Local variables (static)
+\*====================================================================================================================*/
+/* Callouts of the replayed ECU, only transmissions, wake-ups and state changes matter */
+static const CanNm_CallbacksType CanNm_Replay_Callbacks = {
+	.CanIfTransmit = CanNm_Replay_Transmit,
+	.BusSleepMode = CanNm_Replay_Indication,
+	.NetworkMode = CanNm_Replay_Indication,
+	.NetworkStartIndication = CanNm_Replay_NetworkStartIndication,
+	.PduRxIndication = CanNm_Replay_Indication,
+	.PrepareBusSleepMode = CanNm_Replay_Indication,
+	.RemoteSleepCancellation = CanNm_Replay_Indication,
+	.RemoteSleepInd = CanNm_Replay_Indication,
+	.StateChangeNotification = CanNm_Replay_StateChangeNotification,
+	.TxTimeoutException = CanNm_Replay_Indication,
+	.PduRRxIndication = CanNm_Replay_PduIndication
+};
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+int main(int argc, char** argv)
+{
+	static CanNm_Replay_Type Replay;
+	static CanNm_BlobType Blob;
+	CanNm_Replay_LogType Log = { 0 };
+	CanNm_Replay_FrameType Frame;
+	const char* configPath = NULL;
+	const char* expectedPath = NULL;
+	const char* outPath = NULL;
+	float64 tolerance = -1.0;
+	int arg = 1;
+
+	for (; arg + 1 < argc && argv[arg][0] == '-'; arg++) {
+		char option = argv[arg][1];
+		const char* value = "";
+		Std_ReturnType status = E_OK;
+
+		if (option == 'r') {
+			Replay.Realtime = TRUE;										//The only option without value
+			continue;
+		}
+		value = argv[++arg];
+		switch (option) {
+		case 'c': configPath = value; break;
+		case 'm': status = CanNm_Replay_ParseMap(value, FALSE, &Replay); break;
+		case 't': status = CanNm_Replay_ParseMap(value, TRUE, &Replay); break;
+		case 'R': status = CanNm_Replay_ParseRequest(value, &Replay); break;
+		case 'e': expectedPath = value; break;
+		case 'T': tolerance = atof(value) / 1000.0; break;
+		case 'o': outPath = value; break;
+		default: status = E_NOT_OK; break;
+		}
+		if (status != E_OK) {
+			fprintf(stderr, "invalid option -%c %s\n", option, value);
+			return EXIT_FAILURE;
+		}
+	}
+	if (configPath == NULL || arg + 1 != argc) {
+		fprintf(stderr, "usage: %s -c CanNm_Cfg.bin [-m [bus:]id[-id]=channel]... [-t [bus:]id[-id]=channel]...\n"
+			"       [-R seconds:channel:request|release]... [-r] [-e expected] [-T ms] [-o timeline] <log>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if (Replay.MapCount == 0 || (Replay.OwnMapped && Replay.MapCount == 1 && Replay.Maps[0].Own)) {
+		Replay.Maps[Replay.MapCount++] = (CanNm_Replay_MapType){ "", CANNM_REPLAY_DEFAULT_FIRST_ID,
+																	CANNM_REPLAY_DEFAULT_LAST_ID, 0, FALSE };
+	}
+
+	/* The ECU, with state change notifications on whatever the image says, since they make the timeline */
+	if (CanNm_BlobOpen(&Blob, configPath) != E_OK) {
+		fprintf(stderr, "%s: not a valid CanNm configuration image\n", configPath);
+		return EXIT_FAILURE;
+	}
+	uint8* ram = aligned_alloc(CANNM_ARENA_ALIGN,
+								(CanNm_BlobRamSize(&Blob) + CANNM_ARENA_ALIGN) & ~(CANNM_ARENA_ALIGN - 1));
+	Blob.Config.StateChangeIndEnabled = TRUE;
+	Replay.ChannelCount = Blob.Config.ChannelCount;
+	Replay.PeriodUs = (uint64)llround(1e6 * Blob.Config.MainFunctionPeriod / CANNM_BUS_LOAD_TIME_UNITS_PER_SECOND);
+	Replay.StartPending = calloc(Replay.ChannelCount, sizeof(boolean));
+	Replay.TxPending = calloc(Replay.ChannelCount, sizeof(boolean));
+	CanNm_Internal.Callbacks = &CanNm_Replay_Callbacks;
+	CanNm_Internal.Context = &Replay;
+	if (ram == NULL || Replay.StartPending == NULL || Replay.TxPending == NULL || Replay.PeriodUs == 0 ||
+		CanNm_BlobInit(&Blob, ram, CanNm_BlobRamSize(&Blob)) != E_OK) {
+		fprintf(stderr, "%s: cannot initialize CanNm\n", configPath);
+		return EXIT_FAILURE;
+	}
+	for (uint32 map = 0; map < Replay.MapCount; map++) {
+		if (Replay.Maps[map].Channel >= Replay.ChannelCount) {
+			fprintf(stderr, "map to channel %u, the configuration has %u\n", Replay.Maps[map].Channel,
+				Replay.ChannelCount);
+			return EXIT_FAILURE;
+		}
+	}
+	for (uint32 request = 0; request < Replay.RequestCount; request++) {
+		if (Replay.Requests[request].Channel >= Replay.ChannelCount) {
+			fprintf(stderr, "request on channel %u, the configuration has %u\n", Replay.Requests[request].Channel,
+				Replay.ChannelCount);
+			return EXIT_FAILURE;
+		}
+	}
+	tolerance = (tolerance < 0.0) ? (float64)Replay.PeriodUs / 1e6 : tolerance;
+
+	Log.File = fopen(argv[arg], "r");
+	if (Log.File == NULL) {
+		perror(argv[arg]);
+		return EXIT_FAILURE;
+	}
+
+	struct timespec Begin, End;
+	clock_gettime(CLOCK_MONOTONIC, &Begin);
+	Replay.WallStart = Begin;
+	while (CanNm_Replay_Next(&Log, &Frame)) {
+		CanNm_Replay_AdvanceTo(&Replay, Frame.Time);
+		CanNm_Replay_Deliver(&Replay, &Frame);
+	}
+	fclose(Log.File);
+	float64 logTime = Replay.Now;
+	if (Replay.RequestCount > 0) {
+		CanNm_Replay_AdvanceTo(&Replay, Replay.Requests[Replay.RequestCount - 1].Time);
+	}
+	float64 drainEnd = Replay.Now + CANNM_REPLAY_DRAIN_TIME;
+	while (CanNm_TicksToNextEvent() != CANNM_TICKS_INFINITE && Replay.Now < drainEnd) {
+		CanNm_Replay_RunTo(&Replay, Replay.Tick + CanNm_TicksToNextEvent());
+	}
+	clock_gettime(CLOCK_MONOTONIC, &End);
+
+	FILE* Out = (outPath != NULL) ? fopen(outPath, "w") : stdout;
+	if (Out == NULL) {
+		perror(outPath);
+		return EXIT_FAILURE;
+	}
+	CanNm_Replay_Write(&Replay, Out);
+	if (Out != stdout) {
+		fclose(Out);
+	}
+
+	float64 wall = (float64)(End.tv_sec - Begin.tv_sec) + (float64)(End.tv_nsec - Begin.tv_nsec) * 1e-9;
+	fprintf(stderr, "%llu NM frames (%llu own), %llu other frames, %llu transmitted, %u state changes, "
+		"%.1f s of log in %.3f s (%.0fx)\n", (unsigned long long)Replay.FrameCount, (unsigned long long)Replay.OwnCount,
+		(unsigned long long)Replay.UnmappedCount, (unsigned long long)Replay.TxCount, Replay.TimelineLength, logTime,
+		wall, (wall > 0.0) ? logTime / wall : 0.0);
+
+	if (expectedPath != NULL) {
+		uint32 differences = CanNm_Replay_Diff(&Replay, expectedPath, tolerance);
+
+		fprintf(stderr, "%u differences to %s\n", differences, expectedPath);
+		return (differences == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+/** @brief CanNm_Replay_ParseMap
+ *
+ * "[bus:]id[-id]=channel", IDs in hex.
+ */
+static Std_ReturnType CanNm_Replay_ParseMap( const char* text, boolean own, CanNm_Replay_Type* Replay )
+{
+	CanNm_Replay_MapType* Map = &Replay->Maps[Replay->MapCount];
+	const char* colon = strchr(text, ':');
+	char* end;
+
+	if (Replay->MapCount >= CANNM_REPLAY_MAX_MAPS) {
+		return E_NOT_OK;
+	}
+	memset(Map, 0, sizeof(CanNm_Replay_MapType));
+	if (colon != NULL) {
+		if ((size_t)(colon - text) >= sizeof(Map->Bus)) {
+			return E_NOT_OK;
+		}
+		memcpy(Map->Bus, text, (size_t)(colon - text));
+		text = colon + 1;
+	}
+	Map->First = (uint32)strtoul(text, &end, 16);
+	Map->Last = (*end == '-') ? (uint32)strtoul(end + 1, &end, 16) : Map->First;
+	if (end == text || *end != '=' || Map->Last < Map->First) {
+		return E_NOT_OK;
+	}
+	Map->Channel = (uint16)strtoul(end + 1, &end, 0);
+	Map->Own = own;
+	Replay->OwnMapped |= own;
+	Replay->MapCount++;
+	return (*end == '\0') ? E_OK : E_NOT_OK;
+}
+
+/** @brief CanNm_Replay_ParseRequest
+ *
+ * "seconds:channel:request|release", in the order of time.
+ */
+static Std_ReturnType CanNm_Replay_ParseRequest( const char* text, CanNm_Replay_Type* Replay )
+{
+	CanNm_Replay_RequestType* Request = &Replay->Requests[Replay->RequestCount];
+	char action[16];
+	unsigned int channel;
+
+	if (Replay->RequestCount >= CANNM_REPLAY_MAX_REQUESTS ||
+		sscanf(text, "%lf:%u:%15s", &Request->Time, &channel, action) != 3 ||
+		(strcmp(action, "request") != 0 && strcmp(action, "release") != 0) ||
+		(Replay->RequestCount > 0 && Request->Time < Replay->Requests[Replay->RequestCount - 1].Time)) {
+		return E_NOT_OK;
+	}
+	Request->Channel = (uint16)channel;
+	Request->Request = (strcmp(action, "request") == 0);
+	Replay->RequestCount++;
+	return E_OK;
+}
+
+/** @brief CanNm_Replay_Next
+ *
+ * Next classic or FD data frame of the log, FALSE at its end.
+ */
+static boolean CanNm_Replay_Next( CanNm_Replay_LogType* Log, CanNm_Replay_FrameType* Frame )
+{
+	char line[CANNM_REPLAY_LINE_LENGTH];
+
+	while (fgets(line, sizeof(line), Log->File) != NULL) {
+		float64 time;
+		boolean found;
+
+		Log->LineNumber++;
+		memset(Frame, 0, sizeof(CanNm_Replay_FrameType));
+		if (line[0] == '(') {
+			found = CanNm_Replay_ParseCandump(line, &time, Frame);
+		}
+		else {
+			found = CanNm_Replay_ParseAsc(Log, line, &time, Frame);
+		}
+		if (found) {
+			if (!Log->Started) {
+				Log->Start = time;
+				Log->Started = TRUE;
+			}
+			Frame->Time = time - Log->Start;
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/** @brief CanNm_Replay_ParseCandump
+ *
+ * "(time) bus id#data" or "(time) bus id##<flags>data", remote frames are skipped.
+ */
+static boolean CanNm_Replay_ParseCandump( const char* line, float64* time, CanNm_Replay_FrameType* Frame )
+{
+	char frame[CANNM_REPLAY_LINE_LENGTH];
+	char* end;
+
+	if (sscanf(line, "(%lf) %15s %1000s", time, Frame->Bus, frame) != 3) {
+		return FALSE;
+	}
+	Frame->CanId = (uint32)strtoul(frame, &end, 16);
+	if (end == frame || *end != '#' || end[1] == 'R') {
+		return FALSE;
+	}
+	end += (end[1] == '#') ? 3 : 1;									//Skip the FD flags nibble
+	while (end[0] != '\0' && end[1] != '\0' && Frame->Length < CANNM_REPLAY_MAX_SDU_LENGTH) {
+		char byte[3] = { end[0], end[1], '\0' };
+		char* byteEnd;
+
+		if (end[0] == '.') {
+			end++;
+			continue;
+		}
+		Frame->Data[Frame->Length++] = (uint8)strtoul(byte, &byteEnd, 16);
+		if (byteEnd != byte + 2) {
+			Frame->Length--;
+			break;
+		}
+		end += 2;
+	}
+	return TRUE;
+}
+
+/** @brief CanNm_Replay_ParseAsc
+ *
+ * "time channel id[x] Rx|Tx d dlc bytes...", header lines set the number base and time stamp mode.
+ */
+static boolean CanNm_Replay_ParseAsc( CanNm_Replay_LogType* Log, char* line, float64* time,
+										CanNm_Replay_FrameType* Frame )
+{
+	char* token[6 + 8];
+	uint32 count = 0;
+	char* end;
+
+	if (strncmp(line, "base ", 5) == 0) {
+		Log->AscDecimal = (strncmp(line + 5, "dec", 3) == 0);
+		Log->AscRelative = (strstr(line, "relative") != NULL);
+		return FALSE;
+	}
+	for (char* next = strtok(line, " \t\r\n"); next != NULL && count < 14; next = strtok(NULL, " \t\r\n")) {
+		token[count++] = next;
+	}
+	if (count < 6) {
+		return FALSE;
+	}
+	*time = strtod(token[0], &end);
+	if (end == token[0] || *end != '\0') {
+		return FALSE;
+	}
+	*time += Log->AscRelative ? Log->AscLast : 0.0;
+	Log->AscLast = *time;
+
+	/* Classic data frames only, CANFD lines and error or statistic events are skipped */
+	uint32 length = (uint32)strtoul(token[5], &end, 16);
+	if (strspn(token[1], "0123456789") != strlen(token[1]) || (strcmp(token[3], "Rx") != 0 &&
+		strcmp(token[3], "Tx") != 0) || strcmp(token[4], "d") != 0 || *end != '\0' || length > 8 ||
+		count < 6 + length) {
+		return FALSE;
+	}
+	snprintf(Frame->Bus, sizeof(Frame->Bus), "%s", token[1]);
+	Frame->CanId = (uint32)strtoul(token[2], &end, Log->AscDecimal ? 10 : 16);
+	if (end == token[2] || (*end != '\0' && *end != 'x')) {
+		return FALSE;
+	}
+	for (uint32 index = 0; index < length; index++) {
+		Frame->Data[index] = (uint8)strtoul(token[6 + index], NULL, Log->AscDecimal ? 10 : 16);
+	}
+	Frame->Length = (uint8)length;
+	return TRUE;
+}
+
+/** @brief CanNm_Replay_AdvanceTo
+ *
+ * Run all main functions and network requests due up to time.
+ */
+static void CanNm_Replay_AdvanceTo( CanNm_Replay_Type* Replay, float64 time )
+{
+	while (Replay->NextRequest < Replay->RequestCount && Replay->Requests[Replay->NextRequest].Time <= time) {
+		const CanNm_Replay_RequestType* Request = &Replay->Requests[Replay->NextRequest++];
+
+		CanNm_Replay_RunTo(Replay, CanNm_Replay_Tick(Replay, Request->Time));
+		Replay->Now = (Request->Time > Replay->Now) ? Request->Time : Replay->Now;
+		CanNm_Replay_Pace(Replay, Replay->Now);
+		(void)(Request->Request ? CanNm_NetworkRequest(Request->Channel) : CanNm_NetworkRelease(Request->Channel));
+		CanNm_Replay_Settle(Replay);
+	}
+	CanNm_Replay_RunTo(Replay, CanNm_Replay_Tick(Replay, time));
+	Replay->Now = (time > Replay->Now) ? time : Replay->Now;
+}
+
+/** @brief CanNm_Replay_RunTo
+ *
+ * Main functions up to and including tick, idle periods skipped.
+ */
+static void CanNm_Replay_RunTo( CanNm_Replay_Type* Replay, uint64 tick )
+{
+	while (Replay->Tick < tick) {
+		uint32 next = CanNm_TicksToNextEvent();
+		uint64 skip = ((uint64)next - 1 < tick - Replay->Tick) ? (uint64)next - 1 : tick - Replay->Tick;
+
+		if (skip > 0) {
+			CanNm_SkipTicks((uint32)skip);
+			Replay->Tick += skip;
+		}
+		else {
+			Replay->Tick++;
+			Replay->Now = (float64)(Replay->Tick * Replay->PeriodUs) / 1e6;
+			CanNm_Replay_Pace(Replay, Replay->Now);
+			CanNm_MainFunction();
+			CanNm_Replay_Settle(Replay);
+		}
+	}
+}
+
+/** @brief CanNm_Replay_Deliver
+ *
+ * Receive a mapped frame or confirm the own transmission it carries.
+ */
+static void CanNm_Replay_Deliver( CanNm_Replay_Type* Replay, const CanNm_Replay_FrameType* Frame )
+{
+	const CanNm_Replay_MapType* Map = NULL;
+
+	for (uint32 index = 0; index < Replay->MapCount && Map == NULL; index++) {
+		const CanNm_Replay_MapType* Candidate = &Replay->Maps[index];
+
+		if (Frame->CanId >= Candidate->First && Frame->CanId <= Candidate->Last &&
+			(Candidate->Bus[0] == '\0' || strcmp(Candidate->Bus, Frame->Bus) == 0)) {
+			Map = Candidate;
+		}
+	}
+	if (Map == NULL) {
+		Replay->UnmappedCount++;
+		return;
+	}
+
+	CanNm_Replay_Pace(Replay, Frame->Time);
+	Replay->FrameCount++;
+	if (Map->Own) {
+		Replay->OwnCount++;
+		if (Replay->TxPending[Map->Channel]) {
+			Replay->TxPending[Map->Channel] = FALSE;
+			CanNm_TxConfirmation(Map->Channel, E_OK);
+		}
+	}
+	else {
+		PduInfoType PduInfo = { .SduDataPtr = (uint8*)Frame->Data, .SduLength = Frame->Length };
+
+		CanNm_RxIndication(Map->Channel, &PduInfo);
+	}
+	CanNm_Replay_Settle(Replay);
+}
+
+/** @brief CanNm_Replay_Settle
+ *
+ * Answer what the last CanNm call indicated, outside of its callouts: wake-ups and, without own frames in the log,
+ * the confirmation of every transmission.
+ */
+static void CanNm_Replay_Settle( CanNm_Replay_Type* Replay )
+{
+	boolean again = TRUE;
+
+	while (again) {
+		again = FALSE;
+		for (uint16 channel = 0; channel < Replay->ChannelCount; channel++) {
+			if (Replay->StartPending[channel]) {
+				Replay->StartPending[channel] = FALSE;
+				if (CanNm_PassiveStartUp(channel) != E_OK) {
+					(void)CanNm_NetworkRequest(channel);					//Same states outside passive mode
+					(void)CanNm_NetworkRelease(channel);
+				}
+				again = TRUE;
+			}
+			if (Replay->TxPending[channel] && !Replay->OwnMapped) {
+				Replay->TxPending[channel] = FALSE;
+				CanNm_TxConfirmation(channel, E_OK);
+				again = TRUE;
+			}
+		}
+	}
+}
+
+/** @brief CanNm_Replay_Pace
+ *
+ * With "-r", wait until time has passed since the start of the replay.
+ */
+static void CanNm_Replay_Pace( const CanNm_Replay_Type* Replay, float64 time )
+{
+	struct timespec Due = Replay->WallStart;
+
+	if (!Replay->Realtime) {
+		return;
+	}
+	Due.tv_sec += (time_t)time;
+	Due.tv_nsec += (long)((time - floor(time)) * 1e9);
+	if (Due.tv_nsec >= 1000000000L) {
+		Due.tv_sec++;
+		Due.tv_nsec -= 1000000000L;
+	}
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Due, NULL) == EINTR) {
+	}
+}
+
+/* Last main function due at time, in whole microseconds so that period multiples are exact */
+static uint64 CanNm_Replay_Tick( const CanNm_Replay_Type* Replay, float64 time )
+{
+	return (uint64)llround(time * 1e6) / Replay->PeriodUs;
+}
+
+static void CanNm_Replay_Write( const CanNm_Replay_Type* Replay, FILE* Out )
+{
+	for (uint32 index = 0; index < Replay->TimelineLength; index++) {
+		const CanNm_Replay_TransitionType* Transition = &Replay->Timeline[index];
+
+		fprintf(Out, "%.6f ch %u %s -> %s\n", Transition->Time, Transition->Channel,
+			CanNm_TraceStateName(Transition->From), CanNm_TraceStateName(Transition->To));
+	}
+}
+
+/** @brief CanNm_Replay_Diff
+ *
+ * Merge the timeline with the expected one in time order. Entries of the same channel and states whose times differ
+ * by at most tolerance match, the others are printed, "-" expected only, "+" replayed only. Returns their number.
+ */
+static uint32 CanNm_Replay_Diff( const CanNm_Replay_Type* Replay, const char* path, float64 tolerance )
+{
+	CanNm_Replay_TransitionType* Expected = NULL;
+	uint32 expectedCount = 0;
+	uint32 differences = 0;
+	uint32 actual = 0;
+	uint32 expected = 0;
+
+	if (CanNm_Replay_Load(path, &Expected, &expectedCount) != E_OK) {
+		return 1;
+	}
+	while (actual < Replay->TimelineLength || expected < expectedCount) {
+		const CanNm_Replay_TransitionType* Actual = (actual < Replay->TimelineLength) ? &Replay->Timeline[actual] : NULL;
+		const CanNm_Replay_TransitionType* Wanted = (expected < expectedCount) ? &Expected[expected] : NULL;
+		const CanNm_Replay_TransitionType* Extra;
+		char sign;
+
+		if (Actual != NULL && Wanted != NULL && fabs(Actual->Time - Wanted->Time) <= tolerance &&
+			Actual->Channel == Wanted->Channel && Actual->From == Wanted->From && Actual->To == Wanted->To) {
+			actual++;
+			expected++;
+			continue;
+		}
+		if (Wanted == NULL || (Actual != NULL && Actual->Time <= Wanted->Time)) {
+			Extra = Actual;
+			sign = '+';
+			actual++;
+		}
+		else {
+			Extra = Wanted;
+			sign = '-';
+			expected++;
+		}
+		if (differences++ < CANNM_REPLAY_MAX_DIFFS) {
+			printf("%c %.6f ch %u %s -> %s\n", sign, Extra->Time, Extra->Channel, CanNm_TraceStateName(Extra->From),
+				CanNm_TraceStateName(Extra->To));
+		}
+	}
+	free(Expected);
+	return differences;
+}
+
+/** @brief CanNm_Replay_Load
+ *
+ * Read a timeline in the output format, other lines are ignored.
+ */
+static Std_ReturnType CanNm_Replay_Load( const char* path, CanNm_Replay_TransitionType** Timeline, uint32* length )
+{
+	FILE* File = fopen(path, "r");
+	char line[CANNM_REPLAY_LINE_LENGTH];
+	uint32 size = 0;
+
+	if (File == NULL) {
+		perror(path);
+		return E_NOT_OK;
+	}
+	while (fgets(line, sizeof(line), File) != NULL) {
+		CanNm_Replay_TransitionType Transition = { .From = CANNM_STATE_COUNT, .To = CANNM_STATE_COUNT };
+		char from[32], to[32];
+		unsigned int channel;
+
+		if (sscanf(line, "%lf ch %u %31s -> %31s", &Transition.Time, &channel, from, to) != 4) {
+			continue;
+		}
+		for (uint8 state = 0; state < CANNM_STATE_COUNT; state++) {
+			Transition.From = (strcmp(from, CanNm_TraceStateName(state)) == 0) ? state : Transition.From;
+			Transition.To = (strcmp(to, CanNm_TraceStateName(state)) == 0) ? state : Transition.To;
+		}
+		Transition.Channel = (uint16)channel;
+		if (*length == size) {
+			CanNm_Replay_TransitionType* Grown;
+
+			size = (size > 0) ? 2 * size : 1024U;
+			Grown = realloc(*Timeline, size * sizeof(CanNm_Replay_TransitionType));
+			if (Grown == NULL) {
+				fclose(File);
+				return E_NOT_OK;
+			}
+			*Timeline = Grown;
+		}
+		(*Timeline)[(*length)++] = Transition;
+	}
+	fclose(File);
+	return E_OK;
+}
+
+/* Channel of the CanIf TxPduId CanNm transmits with, -1 if none. The PDU ids CanNm receives from CanIf, in
+ * CanNm_RxIndication and CanNm_TxConfirmation, are the channel itself. */
+static sint32 CanNm_Replay_Channel( const CanNm_InstanceType* Instance, PduIdType TxPduId )
+{
+	for (uint16 channel = 0; channel < Instance->ChannelCount; channel++) {
+		if (Instance->ChannelHotPtr[channel].TxPduId == TxPduId) {
+			return channel;
+		}
+	}
+	return -1;
+}
+
+/********************/
+/* Callouts         */
+/********************/
+static Std_ReturnType CanNm_Replay_Transmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+											const PduInfoType* PduInfoPtr )
+{
+	CanNm_Replay_Type* Replay = Instance->Context;
+	sint32 channel = CanNm_Replay_Channel(Instance, TxPduId);
+
+	(void)PduInfoPtr;
+	if (channel < 0 || Replay->TxPending[channel]) {
+		return E_NOT_OK;												//Previous frame still in the controller
+	}
+	Replay->TxPending[channel] = TRUE;
+	Replay->TxCount++;
+	return E_OK;
+}
+
+static void CanNm_Replay_Indication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	(void)nmChannelHandle;
+}
+
+static void CanNm_Replay_NetworkStartIndication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	CanNm_Replay_Type* Replay = Instance->Context;
+
+	Replay->StartPending[nmChannelHandle] = TRUE;
+}
+
+static void CanNm_Replay_StateChangeNotification( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+													Nm_StateType nmPreviousState, Nm_StateType nmCurrentState )
+{
+	CanNm_Replay_Type* Replay = Instance->Context;
+
+	if (nmPreviousState == nmCurrentState) {
+		return;
+	}
+	if (Replay->TimelineLength == Replay->TimelineSize) {
+		uint32 size = (Replay->TimelineSize > 0) ? 2 * Replay->TimelineSize : 1024U;
+		CanNm_Replay_TransitionType* Timeline = realloc(Replay->Timeline, size * sizeof(CanNm_Replay_TransitionType));
+
+		if (Timeline == NULL) {
+			return;
+		}
+		Replay->Timeline = Timeline;
+		Replay->TimelineSize = size;
+	}
+	Replay->Timeline[Replay->TimelineLength++] = (CanNm_Replay_TransitionType){
+		Replay->Now, nmChannelHandle, (uint8)nmPreviousState, (uint8)nmCurrentState
+	};
+}
+
+static void CanNm_Replay_PduIndication( CanNm_InstanceType* Instance, PduIdType RxPduId,
+										const PduInfoType* PduInfoPtr )
+{
+	(void)Instance;
+	(void)RxPduId;
+	(void)PduInfoPtr;
+}
@@ -0,0 +1,116 @@
+#ifndef CANNM_RING_H
+#define CANNM_RING_H
+
+/**===================================================================================================================*\
+  @file CanNm_Ring.h
+
+  @brief Can Network Management Module - lock-free record ring
+
+  Slot index and sequence numbers of the trace ring of CanNm_Trace.h and the capture ring of CanNm_Pcap.h, which
+  differ in their records only. A writer reserves the slot of index Head & Mask with one atomic increment of Head,
+  sets the sequence number of the slot to 0, writes the record and publishes it with sequence number index + 1.
+  Writers never wait, so interrupts may preempt a recording and a full ring overwrites its oldest records. A reader
+  takes a record only if its sequence number is index + 1 both before and after the copy. Head and the sequence
+  numbers are 64 bit and do not wrap during the life time of a ring.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdatomic.h>
+
+#include "Std_Types.h"
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+/** @brief CanNm_RingSequenceType
+ *
+ * Sequence number of a slot, the index of its record plus 1, 0 while the record is written.
+ */
+typedef _Atomic uint64 CanNm_RingSequenceType;
+
+/** @brief CanNm_RingType
+ *
+ * Slot index of a ring of Mask + 1 records.
+ */
+typedef struct {
+	_Atomic uint64				Head;					//Records reserved so far
+	uint32						Mask;					//Capacity - 1
+} CanNm_RingType;
+
+/*====================================================================================================================*\
+    Global inline functions and function macros code
+\*====================================================================================================================*/
+
+/** @brief CanNm_RingInit
+ *
+ * Set up an empty ring of capacity slots, a power of two. The sequence numbers of the slots are set by the caller.
+ */
+static inline Std_ReturnType CanNm_RingInit(CanNm_RingType* Ring, uint32 capacity)
+{
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+		return E_NOT_OK;
+	}
+	atomic_init(&Ring->Head, 0);
+	Ring->Mask = capacity - 1;
+	return E_OK;
+}
+
+/** @brief CanNm_RingReserve
+ *
+ * Reserve the next slot and return its index.
+ */
+static inline uint64 CanNm_RingReserve(CanNm_RingType* Ring)
+{
+	return atomic_fetch_add_explicit(&Ring->Head, 1, memory_order_relaxed);
+}
+
+/** @brief CanNm_RingOpen
+ *
+ * Mark a reserved slot as being written, before the first store to its record.
+ */
+static inline void CanNm_RingOpen(CanNm_RingSequenceType* Sequence)
+{
+	atomic_store_explicit(Sequence, 0, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+}
+
+/** @brief CanNm_RingPublish
+ *
+ * Publish the record of slot index after its last store.
+ */
+static inline void CanNm_RingPublish(CanNm_RingSequenceType* Sequence, uint64 index)
+{
+	atomic_store_explicit(Sequence, index + 1, memory_order_release);
+}
+
+/** @brief CanNm_RingHead
+ *
+ * Number of slots reserved so far.
+ */
+static inline uint64 CanNm_RingHead(const CanNm_RingType* Ring)
+{
+	return atomic_load_explicit(&((CanNm_RingType*)Ring)->Head, memory_order_acquire);
+}
+
+/** @brief CanNm_RingReadBegin
+ *
+ * Sequence number of a slot before its record is copied.
+ */
+static inline uint64 CanNm_RingReadBegin(const CanNm_RingSequenceType* Sequence)
+{
+	return atomic_load_explicit((CanNm_RingSequenceType*)Sequence, memory_order_acquire);
+}
+
+/** @brief CanNm_RingReadEnd
+ *
+ * TRUE if the slot still holds the record of sequence number sequence after the copy, i.e. the copy is consistent.
+ */
+static inline boolean CanNm_RingReadEnd(const CanNm_RingSequenceType* Sequence, uint64 sequence)
+{
+	atomic_thread_fence(memory_order_acquire);
+	return (atomic_load_explicit((CanNm_RingSequenceType*)Sequence, memory_order_relaxed) == sequence) ? TRUE : FALSE;
+}
+
+#endif /* CANNM_RING_H */
@@ -0,0 +1,629 @@
+/** ==================================================================================================================*\
+  @file CanNm_Sim.c
+
+  @brief Can Network Management Module - virtual CAN bus simulator
+
+  Nodes, arbitration and virtual clock of the simulator described in CanNm_Sim.h. Host only.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "CanNm_Sim.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_SIM_ALIGN(size)						\
+	(((size) + CANNM_ARENA_ALIGN - 1) & ~(uintptr_t)(CANNM_ARENA_ALIGN - 1))
+#define CANNM_SIM_QUEUE_FRAMES_PER_NODE				4U
+#define CANNM_SIM_NS_PER_TIME_UNIT					1000000.0	//Configuration times are in ms
+#define CANNM_SIM_MAX_FRAME_BITS					(64U * 8U + 64U)
+#define CANNM_SIM_CLASSIC_TAIL_BITS					13U			//CRC delimiter, ACK, ACK delimiter, EOF, IFS
+#define CANNM_SIM_FD_TAIL_BITS						13U
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static uint8 CanNm_Sim_RxPduCount( const CanNm_ChannelType* ChannelConf );
+static uint32 CanNm_Sim_NodeRamSize( const CanNm_ChannelType* ChannelConf );
+static Std_ReturnType CanNm_Sim_Transmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+ 											const PduInfoType* PduInfoPtr );
+static void CanNm_Sim_StateChangeNotification( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 												Nm_StateType nmPreviousState, Nm_StateType nmCurrentState );
+static void CanNm_Sim_Indication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle );
+static void CanNm_Sim_PduIndication( CanNm_InstanceType* Instance, PduIdType PduId, const PduInfoType* PduInfoPtr );
+static void CanNm_Sim_Complete( CanNm_SimType* Sim, const CanNm_SimFrameType* Frame );
+static void CanNm_Sim_BusRun( CanNm_SimType* Sim, uint64 until );
+static uint32 CanNm_Sim_Arbitrate( const CanNm_SimType* Sim, uint64 time );
+static uint64 CanNm_Sim_BackgroundStart( const CanNm_SimType* Sim, uint64 time, uint32 canId );
+static uint64 CanNm_Sim_FrameTime( const CanNm_SimType* Sim, const CanNm_SimFrameType* Frame );
+static uint64 CanNm_Sim_Hash( uint64 seed, uint64 value );
+static uint16 CanNm_Sim_PutBits( uint8* bits, uint16 position, uint32 value, uint8 count );
+static uint16 CanNm_Sim_StuffBits( const uint8* bits, uint16 count, uint16 stuffedBefore, uint16* stuffedAt );
+
+/*====================================================================================================================*\
+    Local variables (static)
+\*====================================================================================================================*/
+/* Callouts of every node, the Nm and PduR indications are not modelled */
+static const CanNm_CallbacksType CanNm_Sim_Callbacks = {
+	.CanIfTransmit = CanNm_Sim_Transmit,
+	.BusSleepMode = CanNm_Sim_Indication,
+	.NetworkMode = CanNm_Sim_Indication,
+	.NetworkStartIndication = CanNm_Sim_Indication,
+	.PduRxIndication = CanNm_Sim_Indication,
+	.PrepareBusSleepMode = CanNm_Sim_Indication,
+	.RemoteSleepCancellation = CanNm_Sim_Indication,
+	.RemoteSleepInd = CanNm_Sim_Indication,
+	.StateChangeNotification = CanNm_Sim_StateChangeNotification,
+	.TxTimeoutException = CanNm_Sim_Indication,
+	.PduRRxIndication = CanNm_Sim_PduIndication
+};
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief CanNm_SimRamSize
+ *
+ * Size of the memory CanNm_SimInit needs for nodeCount nodes of the template NodeConfig, 0 if the template cannot be
+ * simulated.
+ */
+uint32 CanNm_SimRamSize(const CanNm_ConfigType* NodeConfig, uint16 nodeCount)
+{
+	const CanNm_ChannelType* ChannelConf = (NodeConfig != NULL) ? NodeConfig->ChannelConfig[0] : NULL;
+
+	if (ChannelConf == NULL || ChannelConf->TxPdu == NULL || ChannelConf->UserDataTxPdu == NULL ||
+		CanNm_Sim_RxPduCount(ChannelConf) == 0 || nodeCount == 0 ||
+		ChannelConf->TxPdu->TxPduRef->SduLength > CANNM_SIM_MAX_SDU_LENGTH ||
+		ChannelConf->RxPdu[0]->RxPduRef->SduLength > CANNM_SIM_MAX_SDU_LENGTH) {
+		return 0;
+	}
+	return CANNM_SIM_ALIGN(nodeCount * sizeof(CanNm_SimNodeType)) +
+		nodeCount * CanNm_Sim_NodeRamSize(ChannelConf) +
+		CANNM_SIM_ALIGN(nodeCount * CANNM_SIM_QUEUE_FRAMES_PER_NODE * sizeof(CanNm_SimFrameType));
+}
+
+/** @brief CanNm_SimInit
+ *
+ * Lay out nodeCount nodes of the template NodeConfig in ram and initialize them in Bus-Sleep Mode at tick 0.
+ * ram must be aligned to CANNM_ARENA_ALIGN and at least CanNm_SimRamSize bytes long.
+ */
+Std_ReturnType CanNm_SimInit(CanNm_SimType* Sim, const CanNm_ConfigType* NodeConfig, uint16 nodeCount,
+ 								uint32 canIdBase, uint8* ram, uint32 ramSize)
+{
+	uint32 size = CanNm_SimRamSize(NodeConfig, nodeCount);
+
+	if (Sim == NULL || size == 0 || ram == NULL || ((uintptr_t)ram % CANNM_ARENA_ALIGN) != 0 || ramSize < size) {
+		return E_NOT_OK;
+	}
+
+	const CanNm_ChannelType* ChannelConf = NodeConfig->ChannelConfig[0];
+	uint8 rxPduCount = CanNm_Sim_RxPduCount(ChannelConf);
+	uint8 txSduLength = ChannelConf->TxPdu->TxPduRef->SduLength;
+	uint8 rxSduLength = ChannelConf->RxPdu[0]->RxPduRef->SduLength;
+	uint32 arenaSize = CanNm_ChannelArenaSize(1);
+
+	memset(Sim, 0, sizeof(CanNm_SimType));
+	memset(ram, 0, size);
+	Sim->Nodes = (CanNm_SimNodeType*)ram;
+	Sim->NodeCount = nodeCount;
+	Sim->Period = NodeConfig->MainFunctionPeriod;
+	ram += CANNM_SIM_ALIGN(nodeCount * sizeof(CanNm_SimNodeType));
+
+	for (uint16 index = 0; index < nodeCount; index++) {
+		CanNm_SimNodeType* Node = &Sim->Nodes[index];
+		uint8* arena = ram;
+		PduInfoType* RxPduInfo = (PduInfoType*)(ram + CANNM_SIM_ALIGN(arenaSize));
+		CanNm_RxPdu* RxPdu = (CanNm_RxPdu*)(RxPduInfo + rxPduCount);
+		uint8* Sdu = (uint8*)CANNM_SIM_ALIGN((uintptr_t)(RxPdu + rxPduCount));
+
+		Node->Sim = Sim;
+		Node->Index = index;
+		Node->State = NM_STATE_BUS_SLEEP;
+
+		Node->TxPduInfo.SduDataPtr = Sdu;
+		Node->TxPduInfo.SduLength = txSduLength;
+		Sdu += txSduLength;
+		Node->TxPdu = *ChannelConf->TxPdu;
+		Node->TxPdu.TxConfirmationPduId = 0;
+		Node->TxPdu.TxPduRef = &Node->TxPduInfo;
+		Node->UserDataTxPdu = *ChannelConf->UserDataTxPdu;
+		Node->UserDataTxPdu.TxUserDataPduRef = &Node->TxPduInfo;
+
+		Node->Channel = *ChannelConf;
+		Node->Channel.NodeId = (uint8)(ChannelConf->NodeId + index);
+		Node->Channel.TxPdu = &Node->TxPdu;
+		Node->Channel.UserDataTxPdu = &Node->UserDataTxPdu;
+		for (uint8 rx = 0; rx < rxPduCount; rx++) {
+			RxPduInfo[rx].SduDataPtr = Sdu;
+			RxPduInfo[rx].SduLength = rxSduLength;
+			RxPdu[rx].RxPduId = 0;
+			RxPdu[rx].RxPduRef = &RxPduInfo[rx];
+			Node->Channel.RxPdu[rx] = &RxPdu[rx];
+			Sdu += rxSduLength;
+		}
+		Node->CanId = canIdBase + Node->Channel.NodeId;
+
+		/* One channel per node, timing derived by the instance. State changes are always notified to the bus. */
+		Node->Config = *NodeConfig;
+		memset((void*)Node->Config.ChannelConfig, 0, sizeof(Node->Config.ChannelConfig));
+		Node->Config.ChannelConfig[0] = &Node->Channel;
+		Node->Config.ChannelHot = NULL;
+		Node->Config.ChannelPdu = NULL;
+		Node->Config.ChannelCount = 1;
+		Node->Config.StateChangeIndEnabled = TRUE;
+
+		Node->Instance.Callbacks = &CanNm_Sim_Callbacks;
+		Node->Instance.Context = Node;
+		if (CanNm_InstanceInit(&Node->Instance, &Node->Config, arena, arenaSize) != E_OK) {
+			return E_NOT_OK;
+		}
+		ram += CanNm_Sim_NodeRamSize(ChannelConf);
+	}
+
+	Sim->Queue = (CanNm_SimFrameType*)ram;
+	Sim->QueueSize = nodeCount * CANNM_SIM_QUEUE_FRAMES_PER_NODE;
+	return E_OK;
+}
+
+/** @brief CanNm_SimSetBus
+ *
+ * Switch the bus to the bit-timing model Bus, or back to frames without bus time for Bitrate 0. Call it between
+ * steps with no frame queued. The configuration times are taken as ms.
+ */
+Std_ReturnType CanNm_SimSetBus(CanNm_SimType* Sim, const CanNm_SimBusType* Bus)
+{
+	if (Sim == NULL || Bus == NULL || Sim->QueueLength > 0 || Sim->BusBusy ||
+		(Bus->DataBitrate != 0 && Bus->DataBitrate < Bus->Bitrate) || Bus->BackgroundLoad < 0.0 ||
+		Bus->BackgroundLoad >= 1.0 || Bus->BackgroundLength > 8) {
+		return E_NOT_OK;
+	}
+
+	Sim->Bus = *Bus;
+	Sim->BusFreeTime = Sim->Now;
+	Sim->BackgroundThreshold = 0;
+	Sim->BackgroundSlotTime = 0;
+	if (Bus->Bitrate != 0 && Bus->BackgroundLoad > 0.0) {
+		static const uint8 payload[8] = { 0xA5, 0xA5, 0xA5, 0xA5, 0xA5, 0xA5, 0xA5, 0xA5 };
+		uint32 bits = CanNm_SimFrameBits(Bus->BackgroundCanId, payload, Bus->BackgroundLength, FALSE, NULL);
+
+		Sim->BackgroundSlotTime = ((uint64)bits * 1000000000ULL + Bus->Bitrate - 1) / Bus->Bitrate;
+		Sim->BackgroundThreshold = (uint32)(Bus->BackgroundLoad * 4294967296.0);
+	}
+	return E_OK;
+}
+
+/** @brief CanNm_SimFrameBits
+ *
+ * Bits of a data frame with 11 bit identifier from SOF to the end of the interframe space, stuff bits included.
+ * Classic frames carry up to 8 bytes. CAN FD frames are padded with 0x00 to the next valid length, the bits from the
+ * bit rate switch to the end of the CRC field are also returned in dataPhaseBits (may be NULL).
+ */
+uint32 CanNm_SimFrameBits(uint32 canId, const uint8* data, uint8 length, boolean fd, uint32* dataPhaseBits)
+{
+	static const uint8 fdLength[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+	uint8 bits[CANNM_SIM_MAX_FRAME_BITS];
+	uint16 count = 0;
+	uint8 dlc = 0;
+	uint32 total;
+
+	fd = fd || (length > 8);
+	length = (length > 64) ? 64 : length;
+	while (fdLength[dlc] < length) {
+		dlc++;
+	}
+	if (!fd) {
+		dlc = length;
+	}
+
+	count = CanNm_Sim_PutBits(bits, count, 0, 1);							//SOF
+	count = CanNm_Sim_PutBits(bits, count, canId & 0x7FFU, 11);
+	if (!fd) {
+		count = CanNm_Sim_PutBits(bits, count, 0, 3);						//RTR, IDE, r0
+	}
+	else {
+		count = CanNm_Sim_PutBits(bits, count, 0x0AU, 6);					//RRS, IDE, FDF, res, BRS, ESI
+	}
+	uint16 dataPhaseStart = count - 1;										//ESI, after the bit rate switch
+	count = CanNm_Sim_PutBits(bits, count, dlc, 4);
+	for (uint8 index = 0; index < (fd ? fdLength[dlc] : length); index++) {
+		count = CanNm_Sim_PutBits(bits, count, (index < length) ? data[index] : 0x00U, 8);
+	}
+
+	if (!fd) {
+		/* CRC-15 over SOF to data, stuffing covers SOF to CRC */
+		uint16 crc = 0;
+		for (uint16 bit = 0; bit < count; bit++) {
+			boolean next = bits[bit] ^ ((crc >> 14) & 1U);
+			crc = (uint16)((crc << 1) & 0x7FFFU);
+			crc ^= next ? 0x4599U : 0;
+		}
+		count = CanNm_Sim_PutBits(bits, count, crc, 15);
+		total = count + CanNm_Sim_StuffBits(bits, count, 0, NULL) + CANNM_SIM_CLASSIC_TAIL_BITS;
+		if (dataPhaseBits != NULL) {
+			*dataPhaseBits = 0;
+		}
+	}
+	else {
+		/* Dynamic stuffing up to the data, then stuff count, CRC-17/21 and fixed stuff bits every 4 bits */
+		uint16 stuffedArbitration = 0;
+		uint16 stuffed = CanNm_Sim_StuffBits(bits, count, dataPhaseStart, &stuffedArbitration);
+		uint16 crcField = 4 + ((fdLength[dlc] <= 16) ? 17 : 21);
+		uint16 fixed = 1 + crcField / 4;
+		uint16 dataPhase = (count - dataPhaseStart) + (stuffed - stuffedArbitration) + crcField + fixed;
+
+		total = count + stuffed + crcField + fixed + CANNM_SIM_FD_TAIL_BITS;
+		if (dataPhaseBits != NULL) {
+			*dataPhaseBits = dataPhase;
+		}
+	}
+	return total;
+}
+
+/** @brief CanNm_SimDeliver
+ *
+ * Deliver the queued frames in arbitration order. Each frame goes to CanNm_RxIndication of all other nodes, then to
+ * CanNm_TxConfirmation of its sender. Frames queued meanwhile take part in the next arbitration.
+ */
+void CanNm_SimDeliver(CanNm_SimType* Sim)
+{
+	while (Sim->QueueLength > 0) {
+		uint32 winner = 0;
+		for (uint32 index = 1; index < Sim->QueueLength; index++) {
+			if (Sim->Queue[index].CanId < Sim->Queue[winner].CanId) {
+				winner = index;
+			}
+		}
+
+		CanNm_SimFrameType Frame = Sim->Queue[winner];
+
+		Sim->QueueLength--;
+		memmove(&Sim->Queue[winner], &Sim->Queue[winner + 1], (Sim->QueueLength - winner) * sizeof(CanNm_SimFrameType));
+		CanNm_Sim_Complete(Sim, &Frame);
+	}
+}
+
+/** @brief CanNm_SimStep
+ *
+ * Advance the virtual clock by one MainFunctionPeriod: deliver what the API calls since the last step queued, run the
+ * main function of every node and deliver what it sent. With the bit-timing model the bus instead runs up to the
+ * start of the period and carries the frames sent in it over the following periods.
+ */
+void CanNm_SimStep(CanNm_SimType* Sim)
+{
+	uint64 periodTime = (uint64)(Sim->Period * CANNM_SIM_NS_PER_TIME_UNIT);
+
+	if (Sim->Bus.Bitrate == 0) {
+		CanNm_SimDeliver(Sim);
+	}
+	else {
+		CanNm_Sim_BusRun(Sim, Sim->Tick * periodTime);
+	}
+	Sim->Now = Sim->Tick * periodTime;
+	for (uint16 node = 0; node < Sim->NodeCount; node++) {
+		CanNm_InstanceMainFunction(&Sim->Nodes[node].Instance);
+	}
+	if (Sim->Bus.Bitrate == 0) {
+		CanNm_SimDeliver(Sim);
+	}
+	Sim->Tick++;
+	Sim->Now = Sim->Tick * periodTime;
+}
+
+/** @brief CanNm_SimRun
+ *
+ * Advance the virtual clock by ticks main function periods.
+ */
+void CanNm_SimRun(CanNm_SimType* Sim, uint64 ticks)
+{
+	for (uint64 tick = 0; tick < ticks; tick++) {
+		CanNm_SimStep(Sim);
+	}
+}
+
+/** @brief CanNm_SimAdvance
+ *
+ * Same as CanNm_SimRun with a discrete-event clock: the bus jumps over the main function periods in which no node
+ * has a timer expiring and runs only the periods that can change state, so idle and sleeping clusters cost nothing.
+ * Frames, callbacks and their ticks are identical to CanNm_SimRun.
+ */
+void CanNm_SimAdvance(CanNm_SimType* Sim, uint64 ticks)
+{
+	uint64 end = Sim->Tick + ticks;
+
+	while (Sim->Tick < end) {
+		uint32 next = CANNM_TICKS_INFINITE;
+
+		if (Sim->Bus.Bitrate == 0) {
+			CanNm_SimDeliver(Sim);
+		}
+		else if (Sim->QueueLength > 0 || Sim->BusBusy) {
+			next = 1;										//Frames on the bus are events of the next period
+		}
+		for (uint16 node = 0; node < Sim->NodeCount; node++) {
+			uint32 nodeNext = CanNm_InstanceTicksToNextEvent(&Sim->Nodes[node].Instance);
+			next = (nodeNext < next) ? nodeNext : next;
+		}
+
+		uint64 skip = ((uint64)next - 1 < end - Sim->Tick) ? (uint64)next - 1 : end - Sim->Tick;
+		if (skip > 0) {
+			for (uint16 node = 0; node < Sim->NodeCount; node++) {
+				CanNm_InstanceSkipTicks(&Sim->Nodes[node].Instance, (uint32)skip);
+			}
+			Sim->Tick += skip;
+			Sim->SkippedCount += skip;
+			Sim->Now = Sim->Tick * (uint64)(Sim->Period * CANNM_SIM_NS_PER_TIME_UNIT);
+		}
+		else {
+			CanNm_SimStep(Sim);
+		}
+	}
+}
+
+/** @brief CanNm_SimCountState
+ *
+ * Number of nodes in nmState.
+ */
+uint16 CanNm_SimCountState(const CanNm_SimType* Sim, Nm_StateType nmState)
+{
+	uint16 count = 0;
+
+	for (uint16 node = 0; node < Sim->NodeCount; node++) {
+		count += (Sim->Nodes[node].State == nmState) ? 1 : 0;
+	}
+	return count;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+static uint8 CanNm_Sim_RxPduCount( const CanNm_ChannelType* ChannelConf )
+{
+	uint8 rxPduCount = 0;
+
+	while (rxPduCount < CANNM_RXPDU_MAX_COUNT && ChannelConf->RxPdu[rxPduCount] != NULL) {
+		rxPduCount++;
+	}
+	return rxPduCount;
+}
+
+/** @brief CanNm_Sim_NodeRamSize
+ *
+ * Channel arena, RX PDUs and SDU buffers of one node.
+ */
+static uint32 CanNm_Sim_NodeRamSize( const CanNm_ChannelType* ChannelConf )
+{
+	uint8 rxPduCount = CanNm_Sim_RxPduCount(ChannelConf);
+	uint32 size = CANNM_SIM_ALIGN(CanNm_ChannelArenaSize(1));
+
+	size += CANNM_SIM_ALIGN(rxPduCount * (sizeof(PduInfoType) + sizeof(CanNm_RxPdu)));
+	size += CANNM_SIM_ALIGN(ChannelConf->TxPdu->TxPduRef->SduLength +
+							rxPduCount * ChannelConf->RxPdu[0]->RxPduRef->SduLength);
+	return size;
+}
+
+/** @brief CanNm_Sim_Transmit
+ *
+ * CanIf_Transmit of a node: copy the PDU into the arbitration queue.
+ */
+static Std_ReturnType CanNm_Sim_Transmit( CanNm_InstanceType* Instance, PduIdType TxPduId,
+ 											const PduInfoType* PduInfoPtr )
+{
+	CanNm_SimNodeType* Node = (CanNm_SimNodeType*)Instance->Context;
+	CanNm_SimType* Sim = Node->Sim;
+
+	(void)TxPduId;
+	if (Sim->QueueLength >= Sim->QueueSize) {
+		Sim->DroppedCount++;
+		return E_NOT_OK;
+	}
+
+	CanNm_SimFrameType* Frame = &Sim->Queue[Sim->QueueLength++];
+	Frame->CanId = Node->CanId;
+	Frame->Node = Node->Index;
+	Frame->Length = (PduInfoPtr->SduLength < CANNM_SIM_MAX_SDU_LENGTH) ? PduInfoPtr->SduLength : CANNM_SIM_MAX_SDU_LENGTH;
+	memcpy(Frame->Data, PduInfoPtr->SduDataPtr, Frame->Length);
+	Frame->QueueTime = Sim->Now;
+	Frame->StartTime = Sim->Now;
+	Frame->EndTime = Sim->Now;
+	return E_OK;
+}
+
+static void CanNm_Sim_StateChangeNotification( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle,
+ 												Nm_StateType nmPreviousState, Nm_StateType nmCurrentState )
+{
+	CanNm_SimNodeType* Node = (CanNm_SimNodeType*)Instance->Context;
+
+	(void)nmChannelHandle;
+	Node->State = nmCurrentState;
+	if (Node->Sim->StateObserver != NULL) {
+		Node->Sim->StateObserver(Node->Sim, Node->Index, nmPreviousState, nmCurrentState);
+	}
+}
+
+static void CanNm_Sim_Indication( CanNm_InstanceType* Instance, NetworkHandleType nmChannelHandle )
+{
+	(void)Instance;
+	(void)nmChannelHandle;
+}
+
+static void CanNm_Sim_PduIndication( CanNm_InstanceType* Instance, PduIdType PduId, const PduInfoType* PduInfoPtr )
+{
+	(void)Instance;
+	(void)PduId;
+	(void)PduInfoPtr;
+}
+
+/** @brief CanNm_Sim_Complete
+ *
+ * End of frame: CanNm_RxIndication on all other nodes, then CanNm_TxConfirmation on the sender.
+ */
+static void CanNm_Sim_Complete( CanNm_SimType* Sim, const CanNm_SimFrameType* Frame )
+{
+	PduInfoType PduInfo = { .SduDataPtr = (uint8*)Frame->Data, .SduLength = Frame->Length };
+	uint64 latency = Frame->EndTime - Frame->QueueTime;
+
+	for (uint16 node = 0; node < Sim->NodeCount; node++) {
+		if (node != Frame->Node) {
+			CanNm_InstanceRxIndication(&Sim->Nodes[node].Instance, 0, &PduInfo);
+		}
+	}
+	CanNm_InstanceTxConfirmation(&Sim->Nodes[Frame->Node].Instance, 0, E_OK);
+	Sim->FrameCount++;
+	Sim->LatencySum += latency;
+	Sim->LatencyMax = (latency > Sim->LatencyMax) ? latency : Sim->LatencyMax;
+	if (Sim->FrameObserver != NULL) {
+		Sim->FrameObserver(Sim, Frame);
+	}
+}
+
+/** @brief CanNm_Sim_BusRun
+ *
+ * Carry the queued frames of the bit-timing model one after another and complete those that end by until. A frame
+ * starts when the bus is free of NM PDUs and background traffic, the lowest CAN ID of the frames queued by then wins.
+ */
+static void CanNm_Sim_BusRun( CanNm_SimType* Sim, uint64 until )
+{
+	for (;;) {
+		if (Sim->BusBusy) {
+			if (Sim->InFlight.EndTime > until) {
+				break;
+			}
+			CanNm_SimFrameType Frame = Sim->InFlight;
+			Sim->BusBusy = FALSE;
+			Sim->BusFreeTime = Frame.EndTime;
+			Sim->Now = Frame.EndTime;
+			CanNm_Sim_Complete(Sim, &Frame);
+		}
+		if (Sim->QueueLength == 0) {
+			break;
+		}
+
+		/* Earliest start, then wait for background frames, which may let later frames join the arbitration */
+		uint64 start = Sim->Queue[0].QueueTime;
+		for (uint32 index = 1; index < Sim->QueueLength; index++) {
+			start = (Sim->Queue[index].QueueTime < start) ? Sim->Queue[index].QueueTime : start;
+		}
+		start = (Sim->BusFreeTime > start) ? Sim->BusFreeTime : start;
+		uint32 winner = CanNm_Sim_Arbitrate(Sim, start);
+		uint64 free = CanNm_Sim_BackgroundStart(Sim, start, Sim->Queue[winner].CanId);
+		while (free != start) {
+			start = free;
+			winner = CanNm_Sim_Arbitrate(Sim, start);
+			free = CanNm_Sim_BackgroundStart(Sim, start, Sim->Queue[winner].CanId);
+		}
+		if (start > until) {
+			break;
+		}
+
+		Sim->InFlight = Sim->Queue[winner];
+		Sim->QueueLength--;
+		memmove(&Sim->Queue[winner], &Sim->Queue[winner + 1], (Sim->QueueLength - winner) * sizeof(CanNm_SimFrameType));
+		Sim->InFlight.StartTime = start;
+		Sim->InFlight.EndTime = start + CanNm_Sim_FrameTime(Sim, &Sim->InFlight);
+		Sim->NmBusTime += Sim->InFlight.EndTime - start;
+		Sim->BusBusy = TRUE;
+	}
+	Sim->Now = until;
+}
+
+/** @brief CanNm_Sim_Arbitrate
+ *
+ * Queue index of the lowest CAN ID queued by time, the first one for equal IDs.
+ */
+static uint32 CanNm_Sim_Arbitrate( const CanNm_SimType* Sim, uint64 time )
+{
+	uint32 winner = Sim->QueueLength;
+
+	for (uint32 index = 0; index < Sim->QueueLength; index++) {
+		if (Sim->Queue[index].QueueTime <= time &&
+			(winner == Sim->QueueLength || Sim->Queue[index].CanId < Sim->Queue[winner].CanId)) {
+			winner = index;
+		}
+	}
+	return winner;
+}
+
+/** @brief CanNm_Sim_BackgroundStart
+ *
+ * First time from time on at which a frame with canId gets the bus past the background traffic.
+ */
+static uint64 CanNm_Sim_BackgroundStart( const CanNm_SimType* Sim, uint64 time, uint32 canId )
+{
+	while (Sim->BackgroundThreshold != 0) {
+		uint64 slot = time / Sim->BackgroundSlotTime;
+
+		if ((uint32)CanNm_Sim_Hash(Sim->Bus.Seed, slot) >= Sim->BackgroundThreshold ||
+			(time == slot * Sim->BackgroundSlotTime && canId < Sim->Bus.BackgroundCanId)) {
+			break;
+		}
+		time = (slot + 1) * Sim->BackgroundSlotTime;
+	}
+	return time;
+}
+
+static uint64 CanNm_Sim_FrameTime( const CanNm_SimType* Sim, const CanNm_SimFrameType* Frame )
+{
+	uint32 dataPhaseBits = 0;
+	uint32 bits = CanNm_SimFrameBits(Frame->CanId, Frame->Data, Frame->Length, Sim->Bus.Fd, &dataPhaseBits);
+	uint32 dataBitrate = Sim->Bus.DataBitrate;
+
+	if (dataBitrate == 0) {
+		dataBitrate = Sim->Bus.Bitrate;
+	}
+	return ((uint64)(bits - dataPhaseBits) * 1000000000ULL + Sim->Bus.Bitrate - 1) / Sim->Bus.Bitrate +
+		((uint64)dataPhaseBits * 1000000000ULL + dataBitrate - 1) / dataBitrate;
+}
+
+/** @brief CanNm_Sim_Hash
+ *
+ * SplitMix64 finalizer of seed and value, the background pattern as a pure function of the slot.
+ */
+static uint64 CanNm_Sim_Hash( uint64 seed, uint64 value )
+{
+	uint64 z = seed + 0x9E3779B97F4A7C15ULL * (value + 1);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static uint16 CanNm_Sim_PutBits( uint8* bits, uint16 position, uint32 value, uint8 count )
+{
+	for (uint8 bit = count; bit > 0; bit--) {
+		bits[position++] = (uint8)((value >> (bit - 1)) & 1U);
+	}
+	return position;
+}
+
+/** @brief CanNm_Sim_StuffBits
+ *
+ * Stuff bits inserted into bits, a complement after every 5 equal bits counting stuff bits. stuffedAt (may be NULL)
+ * receives the number inserted before bit position stuffedBefore.
+ */
+static uint16 CanNm_Sim_StuffBits( const uint8* bits, uint16 count, uint16 stuffedBefore, uint16* stuffedAt )
+{
+	uint16 stuffed = 0;
+	uint8 run = 0;
+	uint8 last = 2;
+
+	for (uint16 bit = 0; bit < count; bit++) {
+		if (bit == stuffedBefore && stuffedAt != NULL) {
+			*stuffedAt = stuffed;
+		}
+		run = (bits[bit] == last) ? run + 1 : 1;
+		last = bits[bit];
+		if (run == 5) {
+			stuffed++;
+			last = !last;
+			run = 1;
+		}
+	}
+	return stuffed;
+}
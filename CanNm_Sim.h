@@ -0,0 +1,132 @@
+#ifndef CANNM_SIM_H
+#define CANNM_SIM_H
+
+/**===================================================================================================================*\
+  @file CanNm_Sim.h
+
+  @brief Can Network Management Module - virtual CAN bus simulator
+
+  Wires N CanNm instances, one channel each, to one virtual bus. A node's CanIf_Transmit queues the NM PDU on the
+  bus, the bus delivers queued frames in arbitration order (lowest CAN ID first) to CanNm_RxIndication of every other
+  node and confirms them to the sender with CanNm_TxConfirmation. A shared virtual clock drives CanNm_MainFunction of
+  all nodes once per MainFunctionPeriod, so a cluster runs as fast as the host allows. CanNm_SimAdvance runs the same
+  clock event driven and jumps over periods in which no timer expires. Host only.
+
+  By default frames take no bus time. CanNm_SimSetBus switches to a bit-timing model: frames are serialized at the
+  configured bitrate with their exact length including stuff bits, classic or CAN FD with bit rate switch, compete
+  in arbitration with queued frames and with background traffic, and CanNm_RxIndication/CanNm_TxConfirmation arrive
+  at the end of the frame. Frames sent in one main function period are then received in a later one.
+
+  Every node is a copy of one template configuration with its own PDU buffers. Node n gets the NodeId of the template
+  plus n and sends with CAN ID CanIdBase plus its NodeId.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include "CanNm.h"
+
+/*====================================================================================================================*\
+    Global macros
+\*====================================================================================================================*/
+#define CANNM_SIM_MAX_SDU_LENGTH					64U
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+typedef struct CanNm_Sim CanNm_SimType;
+
+/** @brief CanNm_SimFrameType
+ *
+ * NM PDU on the virtual bus.
+ */
+typedef struct {
+	uint32						CanId;
+	uint16						Node;					//Sender
+	uint8						Length;
+	uint8						Data[CANNM_SIM_MAX_SDU_LENGTH];
+	uint64						QueueTime;				//ns of bus time, CanIf_Transmit
+	uint64						StartTime;				//ns, won arbitration
+	uint64						EndTime;				//ns, CanNm_RxIndication and CanNm_TxConfirmation
+} CanNm_SimFrameType;
+
+/** @brief CanNm_SimBusType
+ *
+ * Bit-timing model of the bus, see CanNm_SimSetBus. Background traffic is a pattern of frames in fixed slots of one
+ * background frame time, each slot taken with probability BackgroundLoad. A slot frame keeps the bus until its end,
+ * but loses a slot start to a waiting NM PDU with a lower CAN ID. Background frames overlapped by an NM PDU are dropped
+ * and not retried, so the pattern does not depend on the NM traffic.
+ */
+typedef struct {
+	uint32						Bitrate;				//Nominal bit/s, 0 for frames without bus time
+	uint32						DataBitrate;			//Data phase bit/s of CAN FD frames with bit rate switch, 0 for none
+	boolean						Fd;						//Send NM PDUs as CAN FD frames, longer PDUs always are
+	float32						BackgroundLoad;			//Share of bus time taken by other traffic, below 1
+	uint32						BackgroundCanId;
+	uint8						BackgroundLength;		//Classic CAN payload bytes
+	uint64						Seed;					//Background pattern
+} CanNm_SimBusType;
+
+/** @brief CanNm_SimNodeType
+ *
+ * One ECU on the bus: a CanNm instance with its own copy of the template configuration.
+ */
+typedef struct {
+	CanNm_InstanceType			Instance;
+	CanNm_SimType*				Sim;
+	uint16						Index;
+	uint32						CanId;
+	Nm_StateType				State;					//Last state notified by the instance
+	CanNm_ConfigType			Config;
+	CanNm_ChannelType			Channel;
+	CanNm_TxPdu					TxPdu;
+	CanNm_UserDataTxPdu			UserDataTxPdu;
+	PduInfoType					TxPduInfo;
+} CanNm_SimNodeType;
+
+/** @brief CanNm_SimType
+ *
+ * Bus, clock and nodes. The observers and Context are optional and set by the caller after CanNm_SimInit.
+ */
+struct CanNm_Sim {
+	CanNm_SimNodeType*			Nodes;
+	uint16						NodeCount;
+	float32						Period;					//MainFunctionPeriod of the template
+	uint64						Tick;					//Main function periods since CanNm_SimInit
+	uint64						SkippedCount;			//Periods jumped over by CanNm_SimAdvance
+	CanNm_SimFrameType*			Queue;					//Frames waiting for arbitration
+	uint32						QueueLength;
+	uint32						QueueSize;
+	uint64						FrameCount;				//Frames delivered
+	uint64						DroppedCount;			//Frames refused because the queue was full
+	CanNm_SimBusType			Bus;
+	uint64						Now;					//ns of bus time
+	uint64						BusFreeTime;			//ns, end of the last NM PDU
+	boolean						BusBusy;
+	CanNm_SimFrameType			InFlight;
+	uint64						BackgroundSlotTime;		//ns
+	uint32						BackgroundThreshold;	//Slots with a hash below carry a background frame
+	uint64						NmBusTime;				//ns the bus carried NM PDUs
+	uint64						LatencySum;				//ns from CanIf_Transmit to CanNm_TxConfirmation
+	uint64						LatencyMax;
+	void						(*FrameObserver)(CanNm_SimType* Sim, const CanNm_SimFrameType* Frame);
+	void						(*StateObserver)(CanNm_SimType* Sim, uint16 node, Nm_StateType nmPreviousState,
+ 													Nm_StateType nmCurrentState);
+	void*						Context;
+};
+
+/*====================================================================================================================*\
+    Global functions declarations
+\*====================================================================================================================*/
+uint32 CanNm_SimRamSize(const CanNm_ConfigType* NodeConfig, uint16 nodeCount);
+Std_ReturnType CanNm_SimInit(CanNm_SimType* Sim, const CanNm_ConfigType* NodeConfig, uint16 nodeCount,
+ 								uint32 canIdBase, uint8* ram, uint32 ramSize);
+Std_ReturnType CanNm_SimSetBus(CanNm_SimType* Sim, const CanNm_SimBusType* Bus);
+uint32 CanNm_SimFrameBits(uint32 canId, const uint8* data, uint8 length, boolean fd, uint32* dataPhaseBits);
+void CanNm_SimDeliver(CanNm_SimType* Sim);
+void CanNm_SimStep(CanNm_SimType* Sim);
+void CanNm_SimRun(CanNm_SimType* Sim, uint64 ticks);
+void CanNm_SimAdvance(CanNm_SimType* Sim, uint64 ticks);
+uint16 CanNm_SimCountState(const CanNm_SimType* Sim, Nm_StateType nmState);
+
+#endif /* CANNM_SIM_H */
@@ -0,0 +1,372 @@
+/** ==================================================================================================================*\
+  @file CanNm_SimMain.c
+
+  @brief Can Network Management Module - virtual CAN bus simulator program
+
+  Runs independent clusters of N nodes of the built-in "Body" channel for a number of hours of bus time and prints
+  frame, drop and state counts with the achieved speed-up over real time. Every node requests the network in the first
+  second of each 10 minute drive cycle and releases it in the first second of the second half, at times drawn from the
+  run's seed. The clock is event driven (CanNm_SimAdvance) unless "tick" is given. Runs are spread over a thread pool
+  (0 threads for one per CPU) and the printed checksum over all frames depends on the seed only. A bitrate in bit/s
+  switches to the bit-timing model with the given share of background traffic at higher priority, and the frame
+  latency from CanIf_Transmit to CanNm_TxConfirmation is printed. The surrounding stack is the unit test mocks:
+
+      gcc -O2 -DUNIT_TEST -pthread -o CanNm_Sim CanNm_SimMain.c CanNm_Sim.c CanNm_SimPool.c CanNm.c
+      ./CanNm_Sim [nodes=100] [hours=1] [event|tick] [runs=1] [threads=0] [seed=1] [bitrate=0] [load=0] [trace]
+
+  Built with -DCANNM_TRACE_ENABLED=STD_ON and CanNm_Trace.c, a trace file name records the last
+  CANNM_SIM_MAIN_TRACE_EVENTS events of every node of the first run, timestamped with the bus time, and writes them
+  as one CanNm_TraceDump per node, with the node index as core, for CanNm_TraceExport -l node.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CanNm_Sim.h"
+#include "CanNm_SimPool.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_SIM_MAIN_CAN_ID_BASE					0x500U
+#define CANNM_SIM_MAIN_DRIVE_CYCLE					600000.0	//ms
+#define CANNM_SIM_MAIN_MAX_NODES					200U		//NodeId 17 + n must fit into a byte
+#define CANNM_SIM_MAIN_JITTER						1000.0		//ms
+#define CANNM_SIM_MAIN_BACKGROUND_CAN_ID			0x100U
+#define CANNM_SIM_MAIN_TRACE_EVENTS					65536U		//Per node, a power of two
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+
+/* Arguments shared by all runs */
+typedef struct {
+	uint16						NodeCount;
+	uint64						Ticks;
+	boolean						TickStepping;
+	CanNm_SimBusType			Bus;
+	const char*					TracePath;				//NULL for no trace
+	struct CanNm_SimMain_Result* Results;
+} CanNm_SimMain_RunsType;
+
+/* Result slot of one run */
+typedef struct CanNm_SimMain_Result {
+	uint64						FrameCount;
+	uint64						DroppedCount;
+	uint64						SkippedCount;
+	uint64						Checksum;				//FNV-1a over tick, CAN ID and payload of all frames
+	uint64						LatencySum;				//ns
+	uint64						LatencyMax;
+	uint16						StateCount[NM_STATE_SYNCHRONIZE + 1];
+	Std_ReturnType				Status;
+} CanNm_SimMain_ResultType;
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static void CanNm_SimMain_Run( void* Context, uint32 index, uint64 seed );
+static void CanNm_SimMain_Checksum( CanNm_SimType* Sim, const CanNm_SimFrameType* Frame );
+static void CanNm_SimMain_Advance( CanNm_SimType* Sim, boolean tickStepping, uint64 ticks );
+#if (CANNM_TRACE_ENABLED == STD_ON)
+static CanNm_TraceRingType* CanNm_SimMain_TraceAttach( CanNm_SimType* Sim );
+static Std_ReturnType CanNm_SimMain_TraceWrite( const CanNm_SimType* Sim, const CanNm_TraceRingType* Rings,
+												const char* path );
+static uint64 CanNm_SimMain_TraceClock( void* ClockContext );
+#endif
+
+/*====================================================================================================================*\
+    Local variables (static)
+\*====================================================================================================================*/
+static uint8 CanNm_SimMain_TxSdu[8];
+static uint8 CanNm_SimMain_RxSdu[8];
+
+static const PduInfoType CanNm_SimMain_TxPduInfo = { .SduDataPtr = CanNm_SimMain_TxSdu, .SduLength = 8 };
+static const PduInfoType CanNm_SimMain_RxPduInfo = { .SduDataPtr = CanNm_SimMain_RxSdu, .SduLength = 8 };
+static const CanNm_TxPdu CanNm_SimMain_TxPdu = { .TxConfirmationPduId = 0, .TxPduRef = &CanNm_SimMain_TxPduInfo };
+static const CanNm_UserDataTxPdu CanNm_SimMain_UserDataTxPdu = {
+	.TxUserDataPduId = 0,
+	.TxUserDataPduRef = &CanNm_SimMain_TxPduInfo
+};
+static const CanNm_RxPdu CanNm_SimMain_RxPdu = { .RxPduId = 0, .RxPduRef = &CanNm_SimMain_RxPduInfo };
+
+/* "Body" channel of CanNm_Cfg.json, times in ms */
+static const CanNm_ChannelType CanNm_SimMain_Channel = {
+	.ActiveWakeupBitEnabled		= TRUE,
+	.ImmediateNmCycleTime		= 20,
+	.ImmediateNmTransmissions	= 3,
+	.MsgCycleOffset				= 10,
+	.MsgCycleTime				= 1000,
+	.NodeDetectionEnabled		= TRUE,
+	.NodeId						= 17,
+	.NodeIdEnabled				= TRUE,
+	.PduCbvPosition				= CANNM_PDU_BYTE_1,
+	.PduNidPosition				= CANNM_PDU_BYTE_0,
+	.RemoteSleepIndTime			= 3000,
+	.RepeatMessageTime			= 1500,
+	.TimeoutTime				= 2000,
+	.TxPdu						= &CanNm_SimMain_TxPdu,
+	.UserDataTxPdu				= &CanNm_SimMain_UserDataTxPdu,
+	.WaitBusSleepTime			= 2000,
+	.RxPdu						= { &CanNm_SimMain_RxPdu, &CanNm_SimMain_RxPdu }
+};
+
+static const CanNm_ConfigType CanNm_SimMain_Config = {
+	.ChannelConfig			= { &CanNm_SimMain_Channel },
+	.MainFunctionPeriod		= 10.0,
+	.RemoteSleepIndEnabled	= TRUE,
+	.StateChangeIndEnabled	= TRUE,
+	.UserDataEnabled		= TRUE
+};
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+int main(int argc, char** argv)
+{
+	CanNm_SimMain_RunsType Runs = {
+		.NodeCount = (argc > 1) ? (uint16)atoi(argv[1]) : 100,
+		.TickStepping = (argc > 3) && (strcmp(argv[3], "tick") == 0)
+	};
+	float64 hours = (argc > 2) ? atof(argv[2]) : 1.0;
+	uint32 runCount = (argc > 4) ? (uint32)atoi(argv[4]) : 1;
+	uint32 threadCount = (argc > 5) ? (uint32)atoi(argv[5]) : 0;
+	uint64 seed = (argc > 6) ? strtoull(argv[6], NULL, 0) : 1;
+
+	Runs.Bus.Bitrate = (argc > 7) ? (uint32)atoi(argv[7]) : 0;
+	Runs.Bus.BackgroundLoad = (argc > 8) ? (float32)atof(argv[8]) : 0.0f;
+	Runs.Bus.BackgroundCanId = CANNM_SIM_MAIN_BACKGROUND_CAN_ID;
+	Runs.Bus.BackgroundLength = 8;
+	Runs.Bus.Seed = seed;
+	Runs.TracePath = (argc > 9) ? argv[9] : NULL;
+
+	if (Runs.NodeCount == 0 || Runs.NodeCount > CANNM_SIM_MAIN_MAX_NODES || hours <= 0.0 || runCount == 0) {
+		fprintf(stderr, "usage: %s [nodes 1..%u] [hours] [event|tick] [runs] [threads] [seed] [bitrate] [load] [trace]\n",
+			argv[0], CANNM_SIM_MAIN_MAX_NODES);
+		return EXIT_FAILURE;
+	}
+#if (CANNM_TRACE_ENABLED == STD_OFF)
+	if (Runs.TracePath != NULL) {
+		fprintf(stderr, "trace needs a build with -DCANNM_TRACE_ENABLED=STD_ON\n");
+		return EXIT_FAILURE;
+	}
+#endif
+	Runs.Ticks = (uint64)(hours * 3600000.0 / CanNm_SimMain_Config.MainFunctionPeriod);
+	Runs.Results = calloc(runCount, sizeof(CanNm_SimMain_ResultType));
+	if (Runs.Results == NULL) {
+		return EXIT_FAILURE;
+	}
+	threadCount = (threadCount == 0) ? CanNm_SimPoolThreadCount() : threadCount;
+
+	struct timespec start, stop;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	CanNm_SimPoolRun(threadCount, runCount, CanNm_SimMain_Run, &Runs, seed);
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+
+	/* Merge in run order */
+	CanNm_SimMain_ResultType Total = { .Checksum = 0xCBF29CE484222325ULL, .Status = E_OK };
+	for (uint32 run = 0; run < runCount; run++) {
+		CanNm_SimMain_ResultType* Result = &Runs.Results[run];
+		Total.FrameCount += Result->FrameCount;
+		Total.DroppedCount += Result->DroppedCount;
+		Total.SkippedCount += Result->SkippedCount;
+		Total.Checksum = (Total.Checksum ^ Result->Checksum) * 0x100000001B3ULL;
+		Total.LatencySum += Result->LatencySum;
+		Total.LatencyMax = (Result->LatencyMax > Total.LatencyMax) ? Result->LatencyMax : Total.LatencyMax;
+		for (uint8 state = 0; state <= NM_STATE_SYNCHRONIZE; state++) {
+			Total.StateCount[state] += Result->StateCount[state];
+		}
+		Total.Status |= Result->Status;
+	}
+	free(Runs.Results);
+	if (Total.Status != E_OK) {
+		fprintf(stderr, "CanNm_SimInit or CanNm_SimSetBus failed\n");
+		return EXIT_FAILURE;
+	}
+
+	float64 wall = (float64)(stop.tv_sec - start.tv_sec) + (float64)(stop.tv_nsec - start.tv_nsec) * 1e-9;
+	printf("runs %u, threads %u, nodes %u, bus time %.2f h, %llu ticks, %llu skipped\n", runCount, threadCount,
+		Runs.NodeCount, hours, (unsigned long long)Runs.Ticks * runCount, (unsigned long long)Total.SkippedCount);
+	printf("frames %llu, dropped %llu, checksum %016llx\n", (unsigned long long)Total.FrameCount,
+		(unsigned long long)Total.DroppedCount, (unsigned long long)Total.Checksum);
+	printf("bus sleep %u, prepare bus sleep %u, repeat message %u, normal operation %u, ready sleep %u\n",
+		Total.StateCount[NM_STATE_BUS_SLEEP], Total.StateCount[NM_STATE_PREPARE_BUS_SLEEP],
+		Total.StateCount[NM_STATE_REPEAT_MESSAGE], Total.StateCount[NM_STATE_NORMAL_OPERATION],
+		Total.StateCount[NM_STATE_READY_SLEEP]);
+	if (Runs.Bus.Bitrate != 0) {
+		printf("bitrate %u, background load %.2f, latency mean %.1f us, max %.1f us\n", Runs.Bus.Bitrate,
+			Runs.Bus.BackgroundLoad, (Total.FrameCount > 0) ? Total.LatencySum / 1000.0 / Total.FrameCount : 0.0,
+			Total.LatencyMax / 1000.0);
+	}
+	printf("wall %.3f s, %.0fx real time\n", wall, hours * 3600.0 * runCount / wall);
+	return EXIT_SUCCESS;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+/** @brief CanNm_SimMain_Run
+ *
+ * One cluster on its own bus, a job of CanNm_SimPoolRun.
+ */
+static void CanNm_SimMain_Run( void* Context, uint32 index, uint64 seed )
+{
+	CanNm_SimMain_RunsType* Runs = (CanNm_SimMain_RunsType*)Context;
+	CanNm_SimMain_ResultType* Result = &Runs->Results[index];
+	uint32 ramSize = CanNm_SimRamSize(&CanNm_SimMain_Config, Runs->NodeCount);
+	void* ram = malloc(ramSize);
+	CanNm_SimType Sim;
+
+	Result->Checksum = 0xCBF29CE484222325ULL;
+	if (ram == NULL || CanNm_SimInit(&Sim, &CanNm_SimMain_Config, Runs->NodeCount, CANNM_SIM_MAIN_CAN_ID_BASE, ram,
+										ramSize) != E_OK || CanNm_SimSetBus(&Sim, &Runs->Bus) != E_OK) {
+		Result->Status = E_NOT_OK;
+		free(ram);
+		return;
+	}
+	Sim.FrameObserver = CanNm_SimMain_Checksum;
+	Sim.Context = Result;
+#if (CANNM_TRACE_ENABLED == STD_ON)
+	CanNm_TraceRingType* Rings = (index == 0 && Runs->TracePath != NULL) ? CanNm_SimMain_TraceAttach(&Sim) : NULL;
+#endif
+
+	uint64 cycleTicks = (uint64)(CANNM_SIM_MAIN_DRIVE_CYCLE / Sim.Period);
+	uint64 jitterTicks = (uint64)(CANNM_SIM_MAIN_JITTER / Sim.Period);
+	uint16* due = malloc(Runs->NodeCount * sizeof(uint16));
+	uint64 random = seed;
+
+	while (due != NULL && Sim.Tick < Runs->Ticks) {
+		uint64 phase = Sim.Tick % cycleTicks;
+		boolean request = (phase < cycleTicks / 2);
+
+		/* Draw the request or release tick of every node within the jitter window, then step through the window */
+		for (uint16 node = 0; node < Runs->NodeCount; node++) {
+			due[node] = (uint16)(CanNm_SimRandom(&random) % jitterTicks);
+		}
+		for (uint64 tick = 0; tick < jitterTicks && Sim.Tick < Runs->Ticks; tick++) {
+			for (uint16 node = 0; node < Runs->NodeCount; node++) {
+				if (due[node] == tick && request) {
+					CanNm_InstanceNetworkRequest(&Sim.Nodes[node].Instance, 0);
+				}
+				else if (due[node] == tick) {
+					CanNm_InstanceNetworkRelease(&Sim.Nodes[node].Instance, 0);
+				}
+			}
+			CanNm_SimMain_Advance(&Sim, Runs->TickStepping, 1);
+		}
+
+		uint64 run = (request ? cycleTicks / 2 : cycleTicks) - phase - jitterTicks;
+		run = (run < Runs->Ticks - Sim.Tick) ? run : Runs->Ticks - Sim.Tick;
+		CanNm_SimMain_Advance(&Sim, Runs->TickStepping, run);
+	}
+
+	Result->FrameCount = Sim.FrameCount;
+	Result->DroppedCount = Sim.DroppedCount;
+	Result->SkippedCount = Sim.SkippedCount;
+	Result->LatencySum = Sim.LatencySum;
+	Result->LatencyMax = Sim.LatencyMax;
+	for (uint8 state = 0; state <= NM_STATE_SYNCHRONIZE; state++) {
+		Result->StateCount[state] = CanNm_SimCountState(&Sim, (Nm_StateType)state);
+	}
+	Result->Status = (due != NULL) ? E_OK : E_NOT_OK;
+#if (CANNM_TRACE_ENABLED == STD_ON)
+	if (index == 0 && Runs->TracePath != NULL) {
+		Result->Status |= CanNm_SimMain_TraceWrite(&Sim, Rings, Runs->TracePath);
+	}
+#endif
+	free(due);
+	free(ram);
+}
+
+static void CanNm_SimMain_Advance( CanNm_SimType* Sim, boolean tickStepping, uint64 ticks )
+{
+	if (tickStepping) {
+		CanNm_SimRun(Sim, ticks);
+	}
+	else {
+		CanNm_SimAdvance(Sim, ticks);
+	}
+}
+
+#if (CANNM_TRACE_ENABLED == STD_ON)
+/** @brief CanNm_SimMain_TraceAttach
+ *
+ * Give every node a ring on the bus clock. Returns the rings, NULL if out of memory.
+ */
+static CanNm_TraceRingType* CanNm_SimMain_TraceAttach( CanNm_SimType* Sim )
+{
+	CanNm_TraceRingType* Rings = calloc(Sim->NodeCount, sizeof(CanNm_TraceRingType));
+	CanNm_TraceEventType* Events = malloc((size_t)Sim->NodeCount * CANNM_SIM_MAIN_TRACE_EVENTS *
+											sizeof(CanNm_TraceEventType));
+
+	if (Rings == NULL || Events == NULL) {
+		free(Rings);
+		free(Events);
+		return NULL;
+	}
+	for (uint16 node = 0; node < Sim->NodeCount; node++) {
+		CanNm_TraceInit(&Rings[node], &Events[(size_t)node * CANNM_SIM_MAIN_TRACE_EVENTS], CANNM_SIM_MAIN_TRACE_EVENTS,
+			node);
+		Rings[node].Clock = CanNm_SimMain_TraceClock;
+		Rings[node].ClockContext = Sim;
+		Rings[node].ClockHz = 1000000000U;
+		Sim->Nodes[node].Instance.TraceRing = &Rings[node];
+	}
+	return Rings;
+}
+
+/** @brief CanNm_SimMain_TraceWrite
+ *
+ * Write the dumps of all nodes to path and release the rings.
+ */
+static Std_ReturnType CanNm_SimMain_TraceWrite( const CanNm_SimType* Sim, const CanNm_TraceRingType* Rings,
+												const char* path )
+{
+	uint32 bufferSize = sizeof(CanNm_TraceDumpHeaderType) + CANNM_SIM_MAIN_TRACE_EVENTS * sizeof(CanNm_TraceEventType);
+	void* buffer = malloc(bufferSize);
+	FILE* File = (Rings != NULL && buffer != NULL) ? fopen(path, "wb") : NULL;
+	Std_ReturnType status = (File != NULL) ? E_OK : E_NOT_OK;
+
+	for (uint16 node = 0; File != NULL && node < Sim->NodeCount; node++) {
+		uint32 length = CanNm_TraceDump(&Rings[node], buffer, bufferSize);
+
+		status |= (fwrite(buffer, 1, length, File) == length) ? E_OK : E_NOT_OK;
+	}
+	if (File != NULL && fclose(File) != 0) {
+		status = E_NOT_OK;
+	}
+	if (status != E_OK) {
+		perror(path);
+	}
+	if (Rings != NULL) {
+		free(Rings[0].Events);
+		free((void*)Rings);
+	}
+	free(buffer);
+	return status;
+}
+
+static uint64 CanNm_SimMain_TraceClock( void* ClockContext )
+{
+	return ((const CanNm_SimType*)ClockContext)->Now;
+}
+#endif
+
+static void CanNm_SimMain_Checksum( CanNm_SimType* Sim, const CanNm_SimFrameType* Frame )
+{
+	CanNm_SimMain_ResultType* Result = (CanNm_SimMain_ResultType*)Sim->Context;
+	uint64 hash = Result->Checksum;
+
+	hash = (hash ^ Sim->Tick) * 0x100000001B3ULL;
+	hash = (hash ^ Frame->CanId) * 0x100000001B3ULL;
+	for (uint8 index = 0; index < Frame->Length; index++) {
+		hash = (hash ^ Frame->Data[index]) * 0x100000001B3ULL;
+	}
+	Result->Checksum = hash;
+}
@@ -0,0 +1,207 @@
+/** ==================================================================================================================*\
+  @file CanNm_SimPool.c
+
+  @brief Can Network Management Module - parallel simulation runs
+
+  Work-stealing pool described in CanNm_SimPool.h. Each worker owns a contiguous range of job indices packed into
+  one atomic word (begin in the low, end in the high half). The owner takes jobs from the front, an idle worker steals
+  the back half of a victim's range. Jobs only ever move between ranges, so a worker may stop once one sweep over all
+  ranges finds them empty. Host (POSIX) only.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "CanNm_SimPool.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_SIMPOOL_MAX_THREADS					256U
+#define CANNM_SIMPOOL_RANGE(begin, end)				((uint64)(begin) | ((uint64)(end) << 32))
+#define CANNM_SIMPOOL_BEGIN(range)					((uint32)(range))
+#define CANNM_SIMPOOL_END(range)					((uint32)((range) >> 32))
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+typedef struct CanNm_SimPool CanNm_SimPoolType;
+
+typedef struct {
+	_Alignas(64) _Atomic uint64	Range;					//Own a cache line, ranges are hammered by CAS
+	CanNm_SimPoolType*			Pool;
+	uint32						Index;
+	pthread_t					Thread;
+} CanNm_SimPoolWorkerType;
+
+struct CanNm_SimPool {
+	CanNm_SimPoolWorkerType*	Workers;
+	uint32						WorkerCount;
+	CanNm_SimJobType			Job;
+	void*						Context;
+	uint64						Seed;
+};
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static void* CanNm_SimPool_Worker( void* Arg );
+static boolean CanNm_SimPool_Take( CanNm_SimPoolWorkerType* Worker, uint32* index );
+static boolean CanNm_SimPool_Steal( CanNm_SimPoolWorkerType* Worker );
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief CanNm_SimPoolRun
+ *
+ * Run Job for every index below jobCount on threadCount threads (0 for one per online CPU) and return when all jobs
+ * are done. The calling thread is worker 0.
+ */
+Std_ReturnType CanNm_SimPoolRun(uint32 threadCount, uint32 jobCount, CanNm_SimJobType Job, void* Context, uint64 seed)
+{
+	CanNm_SimPoolType Pool = { .Job = Job, .Context = Context, .Seed = seed };
+
+	if (Job == NULL) {
+		return E_NOT_OK;
+	}
+	threadCount = (threadCount == 0) ? CanNm_SimPoolThreadCount() : threadCount;
+	threadCount = (threadCount > CANNM_SIMPOOL_MAX_THREADS) ? CANNM_SIMPOOL_MAX_THREADS : threadCount;
+	threadCount = (threadCount > jobCount) ? jobCount : threadCount;
+	if (threadCount == 0) {
+		return E_OK;
+	}
+
+	Pool.Workers = aligned_alloc(64, threadCount * sizeof(CanNm_SimPoolWorkerType));
+	if (Pool.Workers == NULL) {
+		return E_NOT_OK;
+	}
+	Pool.WorkerCount = threadCount;
+	for (uint32 index = 0; index < threadCount; index++) {
+		CanNm_SimPoolWorkerType* Worker = &Pool.Workers[index];
+		uint32 begin = (uint32)(((uint64)jobCount * index) / threadCount);
+		uint32 end = (uint32)(((uint64)jobCount * (index + 1)) / threadCount);
+
+		atomic_init(&Worker->Range, CANNM_SIMPOOL_RANGE(begin, end));
+		Worker->Pool = &Pool;
+		Worker->Index = index;
+	}
+
+	/* Jobs of workers that fail to start are stolen by the others */
+	uint32 started = 1;
+	while (started < threadCount &&
+			pthread_create(&Pool.Workers[started].Thread, NULL, CanNm_SimPool_Worker, &Pool.Workers[started]) == 0) {
+		started++;
+	}
+	CanNm_SimPool_Worker(&Pool.Workers[0]);
+	for (uint32 index = 1; index < started; index++) {
+		pthread_join(Pool.Workers[index].Thread, NULL);
+	}
+	free(Pool.Workers);
+	return E_OK;
+}
+
+/** @brief CanNm_SimPoolThreadCount
+ *
+ * Number of online CPUs, at least 1.
+ */
+uint32 CanNm_SimPoolThreadCount(void)
+{
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return (count > 0) ? (uint32)count : 1;
+}
+
+/** @brief CanNm_SimPoolSeed
+ *
+ * Seed of job index, a SplitMix64 step of the pool seed. Independent of thread count and schedule.
+ */
+uint64 CanNm_SimPoolSeed(uint64 seed, uint32 index)
+{
+	uint64 z = seed + 0x9E3779B97F4A7C15ULL * ((uint64)index + 1);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/** @brief CanNm_SimRandom
+ *
+ * Next 32 bit number of the job local generator State (xorshift64*), State must not be 0.
+ */
+uint32 CanNm_SimRandom(uint64* State)
+{
+	*State ^= *State >> 12;
+	*State ^= *State << 25;
+	*State ^= *State >> 27;
+	return (uint32)((*State * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+static void* CanNm_SimPool_Worker( void* Arg )
+{
+	CanNm_SimPoolWorkerType* Worker = (CanNm_SimPoolWorkerType*)Arg;
+	CanNm_SimPoolType* Pool = Worker->Pool;
+	uint32 index;
+
+	do {
+		while (CanNm_SimPool_Take(Worker, &index)) {
+			uint64 seed = CanNm_SimPoolSeed(Pool->Seed, index);
+			Pool->Job(Pool->Context, index, (seed != 0) ? seed : 1);
+		}
+	} while (CanNm_SimPool_Steal(Worker));
+	return NULL;
+}
+
+/** @brief CanNm_SimPool_Take
+ *
+ * Take the first job of the own range.
+ */
+static boolean CanNm_SimPool_Take( CanNm_SimPoolWorkerType* Worker, uint32* index )
+{
+	uint64 range = atomic_load(&Worker->Range);
+
+	while (CANNM_SIMPOOL_BEGIN(range) < CANNM_SIMPOOL_END(range)) {
+		if (atomic_compare_exchange_weak(&Worker->Range, &range,
+											CANNM_SIMPOOL_RANGE(CANNM_SIMPOOL_BEGIN(range) + 1, CANNM_SIMPOOL_END(range)))) {
+			*index = CANNM_SIMPOOL_BEGIN(range);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/** @brief CanNm_SimPool_Steal
+ *
+ * Move the back half of the first non empty range of another worker into the own, empty range. FALSE once all
+ * ranges are empty.
+ */
+static boolean CanNm_SimPool_Steal( CanNm_SimPoolWorkerType* Worker )
+{
+	CanNm_SimPoolType* Pool = Worker->Pool;
+
+	for (uint32 offset = 1; offset < Pool->WorkerCount; offset++) {
+		CanNm_SimPoolWorkerType* Victim = &Pool->Workers[(Worker->Index + offset) % Pool->WorkerCount];
+		uint64 range = atomic_load(&Victim->Range);
+
+		while (CANNM_SIMPOOL_BEGIN(range) < CANNM_SIMPOOL_END(range)) {
+			uint32 begin = CANNM_SIMPOOL_BEGIN(range);
+			uint32 end = CANNM_SIMPOOL_END(range);
+			uint32 split = end - (end - begin + 1) / 2;
+
+			if (atomic_compare_exchange_weak(&Victim->Range, &range, CANNM_SIMPOOL_RANGE(begin, split))) {
+				atomic_store(&Worker->Range, CANNM_SIMPOOL_RANGE(split, end));
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
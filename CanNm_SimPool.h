@@ -0,0 +1,38 @@
+#ifndef CANNM_SIMPOOL_H
+#define CANNM_SIMPOOL_H
+
+/**===================================================================================================================*\
+  @file CanNm_SimPool.h
+
+  @brief Can Network Management Module - parallel simulation runs
+
+  Runs independent simulation jobs, typically one CanNm_Sim bus or one sweep candidate each, on a work-stealing pool
+  of POSIX threads. Every job gets its index and a seed derived from the pool seed and the index only, and writes its
+  result to its own slot, so merging the slots in index order gives the same bits for any thread count and schedule.
+  The nodes of one bus stay on one thread and are synchronised by the bus clock. Host only.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include "Std_Types.h"
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+
+/** @brief CanNm_SimJobType
+ *
+ * One job of CanNm_SimPoolRun. Must only write state owned by job index.
+ */
+typedef void (*CanNm_SimJobType)(void* Context, uint32 index, uint64 seed);
+
+/*====================================================================================================================*\
+    Global functions declarations
+\*====================================================================================================================*/
+Std_ReturnType CanNm_SimPoolRun(uint32 threadCount, uint32 jobCount, CanNm_SimJobType Job, void* Context, uint64 seed);
+uint32 CanNm_SimPoolThreadCount(void);
+uint64 CanNm_SimPoolSeed(uint64 seed, uint32 index);
+uint32 CanNm_SimRandom(uint64* State);
+
+#endif /* CANNM_SIMPOOL_H */
@@ -0,0 +1,364 @@
+/** ==================================================================================================================*\
+  @file CanNm_Sweep.c
+
+  @brief Can Network Management Module - NM timing parameter sweep
+
+  Simulates a cluster for every combination of MsgCycleTime, MsgCycleOffset, ImmediateNmTransmissions,
+  ImmediateNmCycleTime and MsgReducedTime of the grid below and prints the Pareto front of
+  - NM bus load: NM frame bits over bus bit time while the cluster is awake,
+  - wake-up latency: first network request until every node is in NM_STATE_NORMAL_OPERATION,
+  - sleep time: last network release until every node is in NM_STATE_BUS_SLEEP,
+  each the mean over a number of wake/sleep cycles. Node 0 wakes the bus, every other node requests the network on
+  the first NM PDU it receives. After the awake time all nodes release within one second. The release times come
+  from the seed and are the same for all candidates. MsgCycleOffset is applied as a step: node n uses n times it
+  modulo MsgCycleTime. MsgReducedTime is the value of node 0, node n of N uses MsgReducedTime plus n/N of the gap to
+  MsgCycleTime, so that the nodes with bus load reduction keep distinct reduced cycles as AUTOSAR requires. The
+  surrounding stack is the unit test mocks:
+
+      gcc -O2 -DUNIT_TEST -pthread -o CanNm_Sweep CanNm_Sweep.c CanNm_Sim.c CanNm_SimPool.c CanNm.c
+      ./CanNm_Sweep [nodes=32] [cycles=4] [threads=0] [seed=1] [all]
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CanNm_Sim.h"
+#include "CanNm_SimPool.h"
+
+/*====================================================================================================================*\
+    Local macros
+\*====================================================================================================================*/
+#define CANNM_SWEEP_CAN_ID_BASE						0x500U
+#define CANNM_SWEEP_MAX_NODES						200U
+#define CANNM_SWEEP_BITRATE							500000.0	//bit/s
+#define CANNM_SWEEP_AWAKE_TIME						30000.0		//ms from wake-up to the first release
+#define CANNM_SWEEP_RELEASE_JITTER					1000.0		//ms
+#define CANNM_SWEEP_SLEEP_LIMIT						60000.0		//ms after the releases before a cycle is abandoned
+
+#define CANNM_SWEEP_COUNT(array)					(sizeof(array) / sizeof((array)[0]))
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+
+/* Candidate timing, times in ms */
+typedef struct {
+	float32						MsgCycleTime;
+	float32						MsgCycleOffset;
+	uint8						ImmediateNmTransmissions;
+	float32						ImmediateNmCycleTime;
+	float32						MsgReducedTime;			//0 for no bus load reduction
+} CanNm_Sweep_CandidateType;
+
+/* Result slot of one candidate */
+typedef struct {
+	CanNm_Sweep_CandidateType	Candidate;
+	float64						BusLoad;				//%
+	float64						WakeLatency;			//ms
+	float64						SleepTime;				//ms
+	boolean						Failed;					//Did not wake or sleep completely in some cycle
+	boolean						Pareto;
+} CanNm_Sweep_ResultType;
+
+/* Arguments shared by all candidates */
+typedef struct {
+	uint16						NodeCount;
+	uint16						CycleCount;
+	uint64						Seed;
+	CanNm_Sweep_ResultType*		Results;
+} CanNm_Sweep_RunsType;
+
+/* Bus observer state of one candidate run */
+typedef struct {
+	boolean*					Requested;
+	uint64						Bits;
+	uint64						FullTick;				//Tick all nodes reached Normal Operation, 0 while pending
+} CanNm_Sweep_BusType;
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static void CanNm_Sweep_Run( void* Context, uint32 index, uint64 seed );
+static void CanNm_Sweep_Frame( CanNm_SimType* Sim, const CanNm_SimFrameType* Frame );
+static void CanNm_Sweep_State( CanNm_SimType* Sim, uint16 node, Nm_StateType nmPreviousState,
+ 								Nm_StateType nmCurrentState );
+static void CanNm_Sweep_Candidate( uint32 index, CanNm_Sweep_CandidateType* Candidate );
+static uint32 CanNm_Sweep_CandidateCount( void );
+static boolean CanNm_Sweep_Dominates( const CanNm_Sweep_ResultType* A, const CanNm_Sweep_ResultType* B );
+
+/*====================================================================================================================*\
+    Local variables (static)
+\*====================================================================================================================*/
+
+/* Sweep grid, times in ms */
+static const float32 CanNm_Sweep_MsgCycleTime[] = { 500, 1000, 2000 };
+static const float32 CanNm_Sweep_MsgCycleOffset[] = { 0, 10, 50 };
+static const uint8 CanNm_Sweep_ImmediateNmTransmissions[] = { 0, 1, 3, 5 };
+static const float32 CanNm_Sweep_ImmediateNmCycleTime[] = { 10, 20, 50 };
+static const float32 CanNm_Sweep_MsgReducedRatio[] = { 0, 0.5 };		//MsgReducedTime over MsgCycleTime
+
+static uint8 CanNm_Sweep_TxSdu[8];
+static uint8 CanNm_Sweep_RxSdu[8];
+
+static const PduInfoType CanNm_Sweep_TxPduInfo = { .SduDataPtr = CanNm_Sweep_TxSdu, .SduLength = 8 };
+static const PduInfoType CanNm_Sweep_RxPduInfo = { .SduDataPtr = CanNm_Sweep_RxSdu, .SduLength = 8 };
+static const CanNm_TxPdu CanNm_Sweep_TxPdu = { .TxConfirmationPduId = 0, .TxPduRef = &CanNm_Sweep_TxPduInfo };
+static const CanNm_UserDataTxPdu CanNm_Sweep_UserDataTxPdu = {
+	.TxUserDataPduId = 0,
+	.TxUserDataPduRef = &CanNm_Sweep_TxPduInfo
+};
+static const CanNm_RxPdu CanNm_Sweep_RxPdu = { .RxPduId = 0, .RxPduRef = &CanNm_Sweep_RxPduInfo };
+
+/* "Body" channel of CanNm_Cfg.json, the swept parameters are set per candidate */
+static const CanNm_ChannelType CanNm_Sweep_Channel = {
+	.ActiveWakeupBitEnabled		= TRUE,
+	.NodeDetectionEnabled		= TRUE,
+	.NodeId						= 17,
+	.NodeIdEnabled				= TRUE,
+	.PduCbvPosition				= CANNM_PDU_BYTE_1,
+	.PduNidPosition				= CANNM_PDU_BYTE_0,
+	.RemoteSleepIndTime			= 3000,
+	.RepeatMessageTime			= 1500,
+	.TxPdu						= &CanNm_Sweep_TxPdu,
+	.UserDataTxPdu				= &CanNm_Sweep_UserDataTxPdu,
+	.WaitBusSleepTime			= 2000,
+	.RxPdu						= { &CanNm_Sweep_RxPdu }
+};
+
+static const CanNm_ConfigType CanNm_Sweep_Config = {
+	.BusLoadReductionEnabled	= TRUE,
+	.MainFunctionPeriod			= 10.0,
+	.StateChangeIndEnabled		= TRUE
+};
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+int main(int argc, char** argv)
+{
+	CanNm_Sweep_RunsType Runs = {
+		.NodeCount = (argc > 1) ? (uint16)atoi(argv[1]) : 32,
+		.CycleCount = (argc > 2) ? (uint16)atoi(argv[2]) : 4,
+		.Seed = (argc > 4) ? strtoull(argv[4], NULL, 0) : 1
+	};
+	uint32 threadCount = (argc > 3) ? (uint32)atoi(argv[3]) : 0;
+	boolean all = (argc > 5) && (strcmp(argv[5], "all") == 0);
+	uint32 candidateCount = CanNm_Sweep_CandidateCount();
+
+	if (Runs.NodeCount < 2 || Runs.NodeCount > CANNM_SWEEP_MAX_NODES || Runs.CycleCount == 0) {
+		fprintf(stderr, "usage: %s [nodes 2..%u] [cycles] [threads] [seed] [all]\n", argv[0], CANNM_SWEEP_MAX_NODES);
+		return EXIT_FAILURE;
+	}
+	Runs.Results = calloc(candidateCount, sizeof(CanNm_Sweep_ResultType));
+	if (Runs.Results == NULL || CanNm_SimPoolRun(threadCount, candidateCount, CanNm_Sweep_Run, &Runs, Runs.Seed) != E_OK) {
+		return EXIT_FAILURE;
+	}
+
+	/* Pareto front over the candidates that woke and slept in every cycle, minimizing all three objectives */
+	uint32 frontCount = 0;
+	for (uint32 index = 0; index < candidateCount; index++) {
+		CanNm_Sweep_ResultType* Result = &Runs.Results[index];
+		Result->Pareto = !Result->Failed;
+		for (uint32 other = 0; other < candidateCount && Result->Pareto; other++) {
+			if (!Runs.Results[other].Failed && CanNm_Sweep_Dominates(&Runs.Results[other], Result)) {
+				Result->Pareto = FALSE;
+			}
+		}
+		frontCount += Result->Pareto ? 1 : 0;
+	}
+
+	printf("# %u candidates, %u on the Pareto front, %u nodes, %u cycles, seed %llu\n", candidateCount, frontCount,
+		Runs.NodeCount, Runs.CycleCount, (unsigned long long)Runs.Seed);
+	printf("MsgCycleTime,MsgCycleOffset,ImmediateNmTransmissions,ImmediateNmCycleTime,MsgReducedTime,"
+		"BusLoad%%,WakeLatencyMs,SleepTimeMs,Pareto\n");
+	for (uint32 index = 0; index < candidateCount; index++) {
+		const CanNm_Sweep_ResultType* Result = &Runs.Results[index];
+		if (all || Result->Pareto) {
+			printf("%.0f,%.0f,%u,%.0f,%.0f,%.3f,%.1f,%.1f,%s\n", Result->Candidate.MsgCycleTime,
+				Result->Candidate.MsgCycleOffset, Result->Candidate.ImmediateNmTransmissions,
+				Result->Candidate.ImmediateNmCycleTime, Result->Candidate.MsgReducedTime, Result->BusLoad,
+				Result->WakeLatency, Result->SleepTime, Result->Failed ? "failed" : (Result->Pareto ? "yes" : "no"));
+		}
+	}
+	free(Runs.Results);
+	return EXIT_SUCCESS;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+/** @brief CanNm_Sweep_Run
+ *
+ * Wake/sleep cycles of one candidate, a job of CanNm_SimPoolRun.
+ */
+static void CanNm_Sweep_Run( void* Context, uint32 index, uint64 seed )
+{
+	CanNm_Sweep_RunsType* Runs = (CanNm_Sweep_RunsType*)Context;
+	CanNm_Sweep_ResultType* Result = &Runs->Results[index];
+	CanNm_Sweep_CandidateType* Candidate = &Result->Candidate;
+	CanNm_ChannelType channel = CanNm_Sweep_Channel;
+	CanNm_ConfigType config = CanNm_Sweep_Config;
+	CanNm_SimType Sim;
+	CanNm_Sweep_BusType Bus = { 0 };
+	uint64 random = (Runs->Seed != 0) ? Runs->Seed : 1;	//Common random numbers for all candidates
+
+	(void)seed;											//Not the per job seed, see random
+	CanNm_Sweep_Candidate(index, Candidate);
+	channel.MsgCycleTime = Candidate->MsgCycleTime;
+	channel.ImmediateNmTransmissions = Candidate->ImmediateNmTransmissions;
+	channel.ImmediateNmCycleTime = Candidate->ImmediateNmCycleTime;
+	channel.MsgReducedTime = Candidate->MsgReducedTime;
+	channel.BusLoadReductionActive = (Candidate->MsgReducedTime > 0);
+	channel.TimeoutTime = 2 * Candidate->MsgCycleTime;
+	config.ChannelConfig[0] = &channel;
+
+	uint32 ramSize = CanNm_SimRamSize(&config, Runs->NodeCount);
+	void* ram = malloc(ramSize);
+	Bus.Requested = calloc(Runs->NodeCount, sizeof(boolean));
+	if (ram == NULL || Bus.Requested == NULL ||
+		CanNm_SimInit(&Sim, &config, Runs->NodeCount, CANNM_SWEEP_CAN_ID_BASE, ram, ramSize) != E_OK) {
+		Result->Failed = TRUE;
+		free(Bus.Requested);
+		free(ram);
+		return;
+	}
+	for (uint16 node = 0; node < Runs->NodeCount; node++) {
+		CanNm_SimNodeType* Node = &Sim.Nodes[node];
+		uint32 offsetTicks = (uint32)(Candidate->MsgCycleOffset / config.MainFunctionPeriod) * node;
+		uint32 cycleTicks = (uint32)(Candidate->MsgCycleTime / config.MainFunctionPeriod);
+		Node->Channel.MsgCycleOffset = (float32)(offsetTicks % cycleTicks) * config.MainFunctionPeriod;
+		if (channel.BusLoadReductionActive) {
+			Node->Channel.MsgReducedTime += (Candidate->MsgCycleTime - Candidate->MsgReducedTime) * node / Runs->NodeCount;
+		}
+		CanNm_InstanceSwitchConfig(&Node->Instance, &Node->Config);
+	}
+	Sim.FrameObserver = CanNm_Sweep_Frame;
+	Sim.StateObserver = CanNm_Sweep_State;
+	Sim.Context = &Bus;
+
+	uint64 awakeTicks = (uint64)(CANNM_SWEEP_AWAKE_TIME / Sim.Period);
+	uint64 jitterTicks = (uint64)(CANNM_SWEEP_RELEASE_JITTER / Sim.Period);
+	uint64 limitTicks = (uint64)(CANNM_SWEEP_SLEEP_LIMIT / Sim.Period);
+	uint64 busBits = 0, wakeTicks = 0, sleepTicks = 0;
+	float64 busTime = 0;
+
+	CanNm_SimAdvance(&Sim, 1);
+	for (uint16 cycle = 0; cycle < Runs->CycleCount && !Result->Failed; cycle++) {
+		uint64 start = Sim.Tick;
+
+		/* Wake-up by node 0, the others follow on the first NM PDU */
+		memset(Bus.Requested, 0, Runs->NodeCount * sizeof(boolean));
+		Bus.Bits = 0;
+		Bus.FullTick = 0;
+		Bus.Requested[0] = TRUE;
+		CanNm_InstanceNetworkRequest(&Sim.Nodes[0].Instance, 0);
+		CanNm_SimAdvance(&Sim, awakeTicks);
+		Result->Failed |= (Bus.FullTick == 0);
+		wakeTicks += Bus.FullTick - start;
+
+		/* Release within the jitter window and wait for the common bus sleep */
+		uint64 last = 0;
+		for (uint16 node = 0; node < Runs->NodeCount; node++) {
+			uint64 due = CanNm_SimRandom(&random) % jitterTicks;
+			Bus.Requested[node] = (boolean)(due + 1);
+			last = (due > last) ? due : last;
+		}
+		for (uint64 tick = 0; tick <= last; tick++) {
+			for (uint16 node = 0; node < Runs->NodeCount; node++) {
+				if (Bus.Requested[node] == tick + 1) {
+					CanNm_InstanceNetworkRelease(&Sim.Nodes[node].Instance, 0);
+				}
+			}
+			CanNm_SimAdvance(&Sim, 1);
+		}
+		for (uint16 node = 0; node < Runs->NodeCount; node++) {
+			Bus.Requested[node] = TRUE;				//No wake-up on the remaining frames
+		}
+		uint64 released = Sim.Tick - 1;
+		while (CanNm_SimCountState(&Sim, NM_STATE_BUS_SLEEP) < Runs->NodeCount && Sim.Tick - released < limitTicks) {
+			CanNm_SimAdvance(&Sim, 1);
+		}
+		Result->Failed |= (CanNm_SimCountState(&Sim, NM_STATE_BUS_SLEEP) < Runs->NodeCount);
+		sleepTicks += Sim.Tick - released;
+		busBits += Bus.Bits;
+		busTime += (float64)(Sim.Tick - start) * Sim.Period / 1000.0;
+		CanNm_SimAdvance(&Sim, awakeTicks);			//Parked
+	}
+
+	Result->BusLoad = 100.0 * (float64)busBits / (CANNM_SWEEP_BITRATE * busTime);
+	Result->WakeLatency = (float64)wakeTicks * Sim.Period / Runs->CycleCount;
+	Result->SleepTime = (float64)sleepTicks * Sim.Period / Runs->CycleCount;
+	free(Bus.Requested);
+	free(ram);
+}
+
+/** @brief CanNm_Sweep_Frame
+ *
+ * Counts the bits of the frame on a classic CAN bus and wakes the nodes that have not requested the network yet.
+ */
+static void CanNm_Sweep_Frame( CanNm_SimType* Sim, const CanNm_SimFrameType* Frame )
+{
+	CanNm_Sweep_BusType* Bus = (CanNm_Sweep_BusType*)Sim->Context;
+
+	Bus->Bits += CanNm_SimFrameBits(Frame->CanId, Frame->Data, Frame->Length, FALSE, NULL);
+	for (uint16 node = 0; node < Sim->NodeCount; node++) {
+		if (!Bus->Requested[node]) {
+			Bus->Requested[node] = TRUE;
+			CanNm_InstanceNetworkRequest(&Sim->Nodes[node].Instance, 0);
+		}
+	}
+}
+
+static void CanNm_Sweep_State( CanNm_SimType* Sim, uint16 node, Nm_StateType nmPreviousState,
+ 								Nm_StateType nmCurrentState )
+{
+	CanNm_Sweep_BusType* Bus = (CanNm_Sweep_BusType*)Sim->Context;
+
+	(void)node;
+	(void)nmPreviousState;
+	if (nmCurrentState == NM_STATE_NORMAL_OPERATION && Bus->FullTick == 0 &&
+		CanNm_SimCountState(Sim, NM_STATE_NORMAL_OPERATION) == Sim->NodeCount) {
+		Bus->FullTick = Sim->Tick;
+	}
+}
+
+/** @brief CanNm_Sweep_Candidate
+ *
+ * Grid point index, the last parameter varies fastest.
+ */
+static void CanNm_Sweep_Candidate( uint32 index, CanNm_Sweep_CandidateType* Candidate )
+{
+	uint32 ratio = index % CANNM_SWEEP_COUNT(CanNm_Sweep_MsgReducedRatio);
+	index /= CANNM_SWEEP_COUNT(CanNm_Sweep_MsgReducedRatio);
+	Candidate->ImmediateNmCycleTime = CanNm_Sweep_ImmediateNmCycleTime[index % CANNM_SWEEP_COUNT(CanNm_Sweep_ImmediateNmCycleTime)];
+	index /= CANNM_SWEEP_COUNT(CanNm_Sweep_ImmediateNmCycleTime);
+	Candidate->ImmediateNmTransmissions = CanNm_Sweep_ImmediateNmTransmissions[index % CANNM_SWEEP_COUNT(CanNm_Sweep_ImmediateNmTransmissions)];
+	index /= CANNM_SWEEP_COUNT(CanNm_Sweep_ImmediateNmTransmissions);
+	Candidate->MsgCycleOffset = CanNm_Sweep_MsgCycleOffset[index % CANNM_SWEEP_COUNT(CanNm_Sweep_MsgCycleOffset)];
+	index /= CANNM_SWEEP_COUNT(CanNm_Sweep_MsgCycleOffset);
+	Candidate->MsgCycleTime = CanNm_Sweep_MsgCycleTime[index];
+	Candidate->MsgReducedTime = Candidate->MsgCycleTime * CanNm_Sweep_MsgReducedRatio[ratio];
+}
+
+static uint32 CanNm_Sweep_CandidateCount( void )
+{
+	return CANNM_SWEEP_COUNT(CanNm_Sweep_MsgCycleTime) * CANNM_SWEEP_COUNT(CanNm_Sweep_MsgCycleOffset) *
+		CANNM_SWEEP_COUNT(CanNm_Sweep_ImmediateNmTransmissions) * CANNM_SWEEP_COUNT(CanNm_Sweep_ImmediateNmCycleTime) *
+		CANNM_SWEEP_COUNT(CanNm_Sweep_MsgReducedRatio);
+}
+
+/** @brief CanNm_Sweep_Dominates
+ *
+ * A is no worse than B in every objective and better in at least one.
+ */
+static boolean CanNm_Sweep_Dominates( const CanNm_Sweep_ResultType* A, const CanNm_Sweep_ResultType* B )
+{
+	return (A->BusLoad <= B->BusLoad && A->WakeLatency <= B->WakeLatency && A->SleepTime <= B->SleepTime) &&
+		(A->BusLoad < B->BusLoad || A->WakeLatency < B->WakeLatency || A->SleepTime < B->SleepTime);
+}
@@ -0,0 +1,68 @@
+/** ==================================================================================================================*\
+  @file CanNm_Timing.c
+
+  @brief Can Network Management Module - execution time and wake-up latency histograms
+
+  Percentiles and summaries of the histograms, see CanNm_Timing.h. Recording itself is CanNm_TimingRecord, inlined
+  into CanNm.c.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include "CanNm_Timing.h"
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief CanNm_TimingSummary
+ *
+ * Count, mean, p50, p99 and maximum of a histogram, all 0 for an empty one.
+ */
+void CanNm_TimingSummary(const CanNm_TimingType* Timing, CanNm_TimingSummaryType* Summary)
+{
+	Summary->Count = Timing->Count;
+	Summary->Mean = (Timing->Count > 0) ? Timing->Sum / Timing->Count : 0;
+	Summary->P50 = CanNm_TimingPercentile(Timing, 500);
+	Summary->P99 = CanNm_TimingPercentile(Timing, 990);
+	Summary->Max = Timing->Max;
+}
+
+/** @brief CanNm_TimingPercentile
+ *
+ * Smallest bucket limit that at least permille / 1000 of the calls did not exceed, capped at the maximum.
+ */
+uint64 CanNm_TimingPercentile(const CanNm_TimingType* Timing, uint32 permille)
+{
+	uint64 rank = ((uint64)Timing->Count * permille + 999U) / 1000U;
+	uint64 seen = 0;
+
+	rank = (rank > 0) ? rank : 1;
+	for (uint32 bucket = 0; bucket < CANNM_TIMING_BUCKETS; bucket++) {
+		seen += Timing->Buckets[bucket];
+		if (seen >= rank) {
+			uint64 limit = CanNm_TimingBucketLimit(bucket);
+			return (limit < Timing->Max) ? limit : Timing->Max;
+		}
+	}
+	return Timing->Max;
+}
+
+/** @brief CanNm_TimingBucketLimit
+ *
+ * Largest duration counted into a bucket.
+ */
+uint64 CanNm_TimingBucketLimit(uint32 bucket)
+{
+	if (bucket < CANNM_TIMING_SUB_BUCKETS) {
+		return bucket;
+	}
+	if (bucket >= CANNM_TIMING_BUCKETS - 1U) {
+		return ~(uint64)0;
+	}
+
+	uint32 exponent = bucket / CANNM_TIMING_SUB_BUCKETS + 2U;
+	uint64 mantissa = CANNM_TIMING_SUB_BUCKETS + bucket % CANNM_TIMING_SUB_BUCKETS;
+	return ((mantissa + 1U) << (exponent - 3U)) - 1U;
+}
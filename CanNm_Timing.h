@@ -0,0 +1,158 @@
+#ifndef CANNM_TIMING_H
+#define CANNM_TIMING_H
+
+/**===================================================================================================================*\
+  @file CanNm_Timing.h
+
+  @brief Can Network Management Module - execution time and wake-up latency histograms
+
+  With CANNM_TIMING_ENABLED set to STD_ON, every call of CanNm_MainFunction, CanNm_RxIndication,
+  CanNm_TxConfirmation and CanNm_TriggerTransmit, or their instance variants, is timed with CANNM_TIMING_CYCLES and
+  counted into a log-bucketed histogram of its instance. Callouts made during a call, e.g. the notifications of
+  several timers expiring in the same main function, are part of its time. Values below 8 cycles get a bucket each,
+  larger values 8 buckets per power of two, so a bucket is at most 12.5 % wide, and the exact maximum is kept beside.
+  Recording is a counter read, a bit scan and four stores.
+
+  With CANNM_WAKEUP_LATENCY_ENABLED set to STD_ON, every channel keeps the same kind of histograms of its wake-ups:
+  the time from a CanNm_NetworkRequest in Bus-Sleep or Prepare Bus-Sleep Mode to the first CanIf_Transmit call, to
+  the first positive CanNm_TxConfirmation and to the arrival in Normal Operation State, in units of
+  CANNM_WAKEUP_CLOCK. A milestone not reached before the channel leaves Repeat Message State towards sleep is not
+  counted.
+
+  CanNm_TimingSummary reduces a histogram to count, mean, p50, p99 and maximum. A percentile is the upper bound of
+  the bucket it falls into, capped at the maximum, i.e. never below the true value.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include "Std_Types.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*====================================================================================================================*\
+    Global macros
+\*====================================================================================================================*/
+/* Timed functions, index of CanNm_InstanceType::Timing */
+#define CANNM_TIMING_MAIN_FUNCTION					0U
+#define CANNM_TIMING_RX_INDICATION					1U
+#define CANNM_TIMING_TX_CONFIRMATION				2U
+#define CANNM_TIMING_TRIGGER_TRANSMIT				3U
+#define CANNM_TIMING_FUNCTION_COUNT					4U
+
+/* Wake-up milestones, index of CanNm_WakeupLatencyType::Milestones */
+#define CANNM_WAKEUP_FIRST_TRANSMIT					0U
+#define CANNM_WAKEUP_FIRST_CONFIRMATION				1U
+#define CANNM_WAKEUP_NORMAL_OPERATION				2U
+#define CANNM_WAKEUP_MILESTONE_COUNT				3U
+
+/* 8 exact buckets, then 8 per power of two up to 2^32 cycles; longer calls count into the last bucket */
+#define CANNM_TIMING_SUB_BUCKETS					8U
+#define CANNM_TIMING_BUCKETS						240U
+
+/* Cycle counter of the histograms. Defaults to the time stamp counter on x86 and the virtual counter on AArch64, can
+ * be defined to e.g. a DWT_CYCCNT read on Cortex-M or a free running timer. */
+#ifndef CANNM_TIMING_CYCLES
+#if defined(__x86_64__) || defined(__i386__)
+#define CANNM_TIMING_CYCLES()						((uint64)__rdtsc())
+#elif defined(__aarch64__)
+#define CANNM_TIMING_CYCLES()						CanNm_TimingVirtualCount()
+#else
+#define CANNM_TIMING_CYCLES()						((uint64)0)
+#endif
+#endif
+
+/* Clock of the wake-up latencies. Defaults to units of 1024 cycles of CANNM_TIMING_CYCLES, so 2^32 units span more
+ * than 20 minutes at a few GHz, can be defined to e.g. a microsecond timer. */
+#ifndef CANNM_WAKEUP_CLOCK
+#define CANNM_WAKEUP_CLOCK()						(CANNM_TIMING_CYCLES() >> 10)
+#endif
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+
+/** @brief CanNm_TimingType
+ *
+ * Histogram of one function or wake-up milestone since initialization or the last reset.
+ */
+typedef struct {
+	uint32						Count;
+	uint64						Sum;					//Cycles or CANNM_WAKEUP_CLOCK units
+	uint64						Max;
+	uint32						Buckets[CANNM_TIMING_BUCKETS];
+} CanNm_TimingType;
+
+/** @brief CanNm_TimingSummaryType
+ *
+ * Reduced histogram, all values in the unit of the histogram.
+ */
+typedef struct {
+	uint32						Count;
+	uint64						Mean;
+	uint64						P50;
+	uint64						P99;
+	uint64						Max;
+} CanNm_TimingSummaryType;
+
+/** @brief CanNm_WakeupLatencyType
+ *
+ * Wake-up latency histograms of one channel, indexed by CANNM_WAKEUP_*, in units of CANNM_WAKEUP_CLOCK.
+ */
+typedef struct {
+	CanNm_TimingType			Milestones[CANNM_WAKEUP_MILESTONE_COUNT];
+} CanNm_WakeupLatencyType;
+
+/*====================================================================================================================*\
+    Global functions declarations
+\*====================================================================================================================*/
+void CanNm_TimingSummary(const CanNm_TimingType* Timing, CanNm_TimingSummaryType* Summary);
+uint64 CanNm_TimingPercentile(const CanNm_TimingType* Timing, uint32 permille);
+uint64 CanNm_TimingBucketLimit(uint32 bucket);
+
+/*====================================================================================================================*\
+    Global inline functions and function macros code
+\*====================================================================================================================*/
+
+/** @brief CanNm_TimingBucket
+ *
+ * Histogram bucket of a duration.
+ */
+static inline uint32 CanNm_TimingBucket(uint64 cycles)
+{
+	if (cycles < CANNM_TIMING_SUB_BUCKETS) {
+		return (uint32)cycles;
+	}
+	if (cycles > 0xFFFFFFFFULL) {
+		return CANNM_TIMING_BUCKETS - 1U;
+	}
+
+	uint32 value = (uint32)cycles;
+	uint32 exponent = 31U - (uint32)__builtin_clz(value);
+	return (exponent - 2U) * CANNM_TIMING_SUB_BUCKETS + ((value >> (exponent - 3U)) & (CANNM_TIMING_SUB_BUCKETS - 1U));
+}
+
+/** @brief CanNm_TimingRecord
+ *
+ * Count one call of the given duration. Not atomic: calls of the same function on two cores at once may lose a count.
+ */
+static inline void CanNm_TimingRecord(CanNm_TimingType* Timing, uint64 cycles)
+{
+	Timing->Count++;
+	Timing->Sum += cycles;
+	Timing->Max = (cycles > Timing->Max) ? cycles : Timing->Max;
+	Timing->Buckets[CanNm_TimingBucket(cycles)]++;
+}
+
+#if defined(__aarch64__)
+static inline uint64 CanNm_TimingVirtualCount(void)
+{
+	uint64 count;
+
+	__asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(count));
+	return count;
+}
+#endif
+
+#endif /* CANNM_TIMING_H */
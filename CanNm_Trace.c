@@ -0,0 +1,181 @@
+/** ==================================================================================================================*\
+  @file CanNm_Trace.c
+
+  @brief Can Network Management Module - binary event trace
+
+  Ring set up, consistent copies of live rings, dumps and the text form of events, see CanNm_Trace.h. Recording
+  itself is CanNm_TraceRecord, inlined into CanNm.c.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdio.h>
+#include <string.h>
+
+#include "CanNm_Trace.h"
+#include "NmStack_Types.h"
+
+/*====================================================================================================================*\
+    Local variables (static)
+\*====================================================================================================================*/
+static const char* const CanNm_Trace_StateNames[] = {
+	"UNINIT", "BUS_SLEEP", "PREPARE_BUS_SLEEP", "READY_SLEEP", "NORMAL_OPERATION", "REPEAT_MESSAGE", "SYNCHRONIZE"
+};
+
+static const char* const CanNm_Trace_TimerNames[] = {
+	"Timeout", "MessageCycle", "RepeatMessage", "WaitBusSleep", "RemoteSleepInd"
+};
+
+static const char* const CanNm_Trace_CalloutNames[] = {
+	"NetworkStartIndication", "RemoteSleepInd", "RemoteSleepCancellation", "TxTimeoutException"
+};
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static const char* CanNm_Trace_Name( const char* const* names, uint32 count, uint32 index );
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+/** @brief CanNm_TraceInit
+ *
+ * Set up an empty ring over capacity events, a power of two, timestamped with CANNM_TRACE_TIMESTAMP.
+ */
+Std_ReturnType CanNm_TraceInit(CanNm_TraceRingType* Ring, CanNm_TraceEventType* events, uint32 capacity, uint16 core)
+{
+	if (Ring == NULL || events == NULL || CanNm_RingInit(&Ring->Slots, capacity) != E_OK) {
+		return E_NOT_OK;
+	}
+	for (uint32 index = 0; index < capacity; index++) {
+		atomic_init(&events[index].Sequence, 0);
+	}
+	Ring->Events = events;
+	Ring->Clock = NULL;
+	Ring->ClockContext = NULL;
+	Ring->ClockHz = 0;
+	Ring->Core = core;
+	return E_OK;
+}
+
+/** @brief CanNm_TraceSnapshot
+ *
+ * Copy up to maxCount of the newest complete events, oldest first, and return their number. Events that are being
+ * written or get overwritten during the copy are left out, so the ring may keep recording on other cores.
+ */
+uint32 CanNm_TraceSnapshot(const CanNm_TraceRingType* Ring, CanNm_TraceEventType* events, uint32 maxCount)
+{
+	uint64 head = CanNm_RingHead(&Ring->Slots);
+	uint32 count = (head > (uint64)Ring->Slots.Mask + 1) ? Ring->Slots.Mask + 1 : (uint32)head;
+	uint32 copied = 0;
+
+	count = (count > maxCount) ? maxCount : count;
+	for (uint64 index = head - count; index != head; index++) {
+		CanNm_TraceEventType* Event = &Ring->Events[index & Ring->Slots.Mask];
+		uint64 sequence = CanNm_RingReadBegin(&Event->Sequence);
+
+		if (sequence != index + 1) {
+			continue;
+		}
+		events[copied].Timestamp = Event->Timestamp;
+		events[copied].Channel = Event->Channel;
+		events[copied].Type = Event->Type;
+		events[copied].Arg8 = Event->Arg8;
+		events[copied].Arg32 = Event->Arg32;
+		if (CanNm_RingReadEnd(&Event->Sequence, sequence)) {
+			atomic_init(&events[copied].Sequence, sequence);
+			copied++;
+		}
+	}
+	return copied;
+}
+
+/** @brief CanNm_TraceDump
+ *
+ * Write a CanNm_TraceDumpHeaderType and a snapshot of the ring into buffer, e.g. to store it in non-volatile memory
+ * after a failed shutdown. Returns the bytes written, 0 if the buffer cannot hold the header.
+ */
+uint32 CanNm_TraceDump(const CanNm_TraceRingType* Ring, void* buffer, uint32 bufferSize)
+{
+	CanNm_TraceDumpHeaderType* Header = (CanNm_TraceDumpHeaderType*)buffer;
+
+	if (Ring == NULL || buffer == NULL || bufferSize < sizeof(CanNm_TraceDumpHeaderType)) {
+		return 0;
+	}
+	memset(Header, 0, sizeof(CanNm_TraceDumpHeaderType));
+	Header->Magic = CANNM_TRACE_DUMP_MAGIC;
+	Header->Version = CANNM_TRACE_DUMP_VERSION;
+	Header->Core = Ring->Core;
+	Header->EventSize = sizeof(CanNm_TraceEventType);
+	Header->Head = CanNm_RingHead(&Ring->Slots);
+	Header->ClockHz = Ring->ClockHz;
+	Header->Count = CanNm_TraceSnapshot(Ring, (CanNm_TraceEventType*)&Header[1],
+										(bufferSize - sizeof(CanNm_TraceDumpHeaderType)) / sizeof(CanNm_TraceEventType));
+	return sizeof(CanNm_TraceDumpHeaderType) + Header->Count * sizeof(CanNm_TraceEventType);
+}
+
+/** @brief CanNm_TraceFormat
+ *
+ * Text of one event without timestamp, e.g. "ch 2 RX nid 0x11 cbv 0x01 pdu 2". Returns the length like snprintf.
+ */
+uint32 CanNm_TraceFormat(const CanNm_TraceEventType* Event, char* text, uint32 textSize)
+{
+	int length;
+
+	switch (Event->Type) {
+	case CANNM_TRACE_STATE:
+		length = snprintf(text, textSize, "ch %u STATE %s -> %s", Event->Channel,
+			CanNm_Trace_Name(CanNm_Trace_StateNames, 7, Event->Arg8 >> 4),
+			CanNm_Trace_Name(CanNm_Trace_StateNames, 7, Event->Arg8 & 0x0F));
+		break;
+	case CANNM_TRACE_TIMER_START:
+	case CANNM_TRACE_TIMER_STOP:
+		length = snprintf(text, textSize, "ch %u TIMER %s %s %u", Event->Channel,
+			CanNm_Trace_Name(CanNm_Trace_TimerNames, 5, Event->Arg8),
+			(Event->Type == CANNM_TRACE_TIMER_START) ? "start" : "stop left", Event->Arg32);
+		break;
+	case CANNM_TRACE_TIMER_EXPIRED:
+		length = snprintf(text, textSize, "ch %u TIMER %s expired", Event->Channel,
+			CanNm_Trace_Name(CanNm_Trace_TimerNames, 5, Event->Arg8));
+		break;
+	case CANNM_TRACE_RX:
+		length = snprintf(text, textSize, "ch %u RX nid %s0x%02X cbv %s0x%02X pdu %u", Event->Channel,
+			(Event->Arg32 & (CANNM_TRACE_RX_NID_VALID << 8)) ? "" : "-", Event->Arg32 & 0xFF,
+			(Event->Arg32 & (CANNM_TRACE_RX_CBV_VALID << 8)) ? "" : "-", Event->Arg8, Event->Arg32 >> 16);
+		break;
+	case CANNM_TRACE_TX:
+		length = snprintf(text, textSize, "ch %u TX %s %s", Event->Channel,
+			(Event->Arg8 == CANNM_TRACE_TX_TRANSMIT) ? "transmit" : "confirmation",
+			(Event->Arg32 == E_OK) ? "E_OK" : "E_NOT_OK");
+		break;
+	case CANNM_TRACE_CALLOUT:
+		length = snprintf(text, textSize, "ch %u CALLOUT %s", Event->Channel,
+			CanNm_Trace_Name(CanNm_Trace_CalloutNames, 4, Event->Arg8));
+		break;
+	default:
+		length = snprintf(text, textSize, "ch %u type %u 0x%02X 0x%08X", Event->Channel, Event->Type, Event->Arg8,
+			Event->Arg32);
+		break;
+	}
+	return (length > 0) ? (uint32)length : 0;
+}
+
+/** @brief CanNm_TraceStateName
+ *
+ * Name of an Nm_StateType as in CANNM_TRACE_STATE events, e.g. "REPEAT_MESSAGE", "?" if out of range.
+ */
+const char* CanNm_TraceStateName(uint8 state)
+{
+	return CanNm_Trace_Name(CanNm_Trace_StateNames, 7, state);
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+static const char* CanNm_Trace_Name( const char* const* names, uint32 count, uint32 index )
+{
+	return (index < count) ? names[index] : "?";
+}
@@ -0,0 +1,155 @@
+#ifndef CANNM_TRACE_H
+#define CANNM_TRACE_H
+
+/**===================================================================================================================*\
+  @file CanNm_Trace.h
+
+  @brief Can Network Management Module - binary event trace
+
+  With CANNM_TRACE_ENABLED set to STD_ON, CanNm records state transitions, timer start, stop and expiry, received
+  NM PDUs with NID and CBV, transmit results and the remote sleep and timeout callouts into the trace ring set in
+  CanNm_InstanceType::TraceRing. A ring is meant for one core: all instances running there may share it, and
+  interrupts that call CanNm_RxIndication or CanNm_TxConfirmation may preempt a recording, see CanNm_Ring.h for the
+  slot protocol. A record is a few stores and one timestamp read, and a full ring overwrites its oldest events, so
+  tracing can stay enabled in production.
+
+  CanNm_TraceSnapshot copies the valid events of a live ring, CanNm_TraceDump serializes a ring into the format
+  read by CanNm_TraceDecode, which prints the events of one or more rings, merged by timestamp, as text, and by
+  CanNm_TraceExport, which converts them into a Chrome trace for timeline viewers.
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include "Std_Types.h"
+#include "CanNm_Ring.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*====================================================================================================================*\
+    Global macros
+\*====================================================================================================================*/
+/* Event types */
+#define CANNM_TRACE_STATE							1U		//Arg8: previous state << 4 | new state
+#define CANNM_TRACE_TIMER_START						2U		//Arg8: timer, Arg32: main function ticks
+#define CANNM_TRACE_TIMER_STOP						3U		//Arg8: timer, Arg32: ticks left
+#define CANNM_TRACE_TIMER_EXPIRED					4U		//Arg8: timer
+#define CANNM_TRACE_RX								5U		//Arg8: CBV, Arg32: NID | flags << 8 | RxPduId << 16
+#define CANNM_TRACE_TX								6U		//Arg8: CANNM_TRACE_TX_*, Arg32: Std_ReturnType
+#define CANNM_TRACE_CALLOUT							7U		//Arg8: CANNM_TRACE_CALLOUT_*
+
+/* Timers of CANNM_TRACE_TIMER_* */
+#define CANNM_TRACE_TIMER_TIMEOUT					0U
+#define CANNM_TRACE_TIMER_MESSAGE_CYCLE				1U
+#define CANNM_TRACE_TIMER_REPEAT_MESSAGE			2U
+#define CANNM_TRACE_TIMER_WAIT_BUS_SLEEP			3U
+#define CANNM_TRACE_TIMER_REMOTE_SLEEP_IND			4U
+
+/* Flags of CANNM_TRACE_RX */
+#define CANNM_TRACE_RX_NID_VALID					0x01U
+#define CANNM_TRACE_RX_CBV_VALID					0x02U
+
+/* Kinds of CANNM_TRACE_TX */
+#define CANNM_TRACE_TX_TRANSMIT						0U		//Return value of CanIf_Transmit
+#define CANNM_TRACE_TX_CONFIRMATION					1U		//Result of CanNm_TxConfirmation
+
+/* Callouts of CANNM_TRACE_CALLOUT */
+#define CANNM_TRACE_CALLOUT_NETWORK_START			0U
+#define CANNM_TRACE_CALLOUT_REMOTE_SLEEP_IND		1U
+#define CANNM_TRACE_CALLOUT_REMOTE_SLEEP_CANCEL		2U
+#define CANNM_TRACE_CALLOUT_TX_TIMEOUT				3U
+
+/* Dump format of CanNm_TraceDump */
+#define CANNM_TRACE_DUMP_MAGIC						0x544D4E43UL	//"CNMT"
+#define CANNM_TRACE_DUMP_VERSION					2U
+
+/* Timestamp of events of rings without Clock. Defaults to the time stamp counter on x86, can be defined to e.g. a
+ * free running hardware timer read. */
+#ifndef CANNM_TRACE_TIMESTAMP
+#if defined(__x86_64__) || defined(__i386__)
+#define CANNM_TRACE_TIMESTAMP()						((uint64)__rdtsc())
+#else
+#define CANNM_TRACE_TIMESTAMP()						((uint64)0)
+#endif
+#endif
+
+/*====================================================================================================================*\
+    Global types
+\*====================================================================================================================*/
+typedef struct CanNm_TraceRing CanNm_TraceRingType;
+
+/** @brief CanNm_TraceEventType
+ *
+ * One record. Sequence is the sequence number of its slot, see CanNm_RingSequenceType.
+ */
+typedef struct {
+	uint64						Timestamp;
+	CanNm_RingSequenceType		Sequence;
+	uint16						Channel;
+	uint8						Type;
+	uint8						Arg8;
+	uint32						Arg32;
+} CanNm_TraceEventType;
+
+/** @brief CanNm_TraceRingType
+ *
+ * Ring of Capacity events, a power of two. Clock, if not NULL, replaces CANNM_TRACE_TIMESTAMP, e.g. with the time of
+ * a simulation. ClockHz is the rate of the timestamps, 0 if unknown, and only used by the decoder.
+ */
+struct CanNm_TraceRing {
+	CanNm_RingType				Slots;
+	CanNm_TraceEventType*		Events;
+	uint64						(*Clock)(void* ClockContext);
+	void*						ClockContext;
+	uint64						ClockHz;
+	uint16						Core;
+};
+
+/** @brief CanNm_TraceDumpHeaderType
+ *
+ * Header of CanNm_TraceDump, followed by Count events, oldest first, of the host byte order.
+ */
+typedef struct {
+	uint32						Magic;
+	uint16						Version;
+	uint16						Core;
+	uint32						EventSize;
+	uint32						Count;
+	uint32						Reserved;
+	uint64						Head;
+	uint64						ClockHz;
+} CanNm_TraceDumpHeaderType;
+
+/*====================================================================================================================*\
+    Global functions declarations
+\*====================================================================================================================*/
+Std_ReturnType CanNm_TraceInit(CanNm_TraceRingType* Ring, CanNm_TraceEventType* events, uint32 capacity, uint16 core);
+uint32 CanNm_TraceSnapshot(const CanNm_TraceRingType* Ring, CanNm_TraceEventType* events, uint32 maxCount);
+uint32 CanNm_TraceDump(const CanNm_TraceRingType* Ring, void* buffer, uint32 bufferSize);
+uint32 CanNm_TraceFormat(const CanNm_TraceEventType* Event, char* text, uint32 textSize);
+const char* CanNm_TraceStateName(uint8 state);
+
+/*====================================================================================================================*\
+    Global inline functions and function macros code
+\*====================================================================================================================*/
+
+/** @brief CanNm_TraceRecord
+ *
+ * Append one event. A concurrent CanNm_TraceSnapshot skips it until it is complete.
+ */
+static inline void CanNm_TraceRecord(CanNm_TraceRingType* Ring, uint16 channel, uint8 type, uint8 arg8, uint32 arg32)
+{
+	uint64 index = CanNm_RingReserve(&Ring->Slots);
+	CanNm_TraceEventType* Event = &Ring->Events[index & Ring->Slots.Mask];
+
+	CanNm_RingOpen(&Event->Sequence);
+	Event->Timestamp = (Ring->Clock != NULL) ? Ring->Clock(Ring->ClockContext) : CANNM_TRACE_TIMESTAMP();
+	Event->Channel = channel;
+	Event->Type = type;
+	Event->Arg8 = arg8;
+	Event->Arg32 = arg32;
+	CanNm_RingPublish(&Event->Sequence, index);
+}
+
+#endif /* CANNM_TRACE_H */
@@ -0,0 +1,128 @@
+/** ==================================================================================================================*\
+  @file CanNm_TraceDecode.c
+
+  @brief Can Network Management Module - trace dump decoder
+
+  Prints the events of one or more CanNm_TraceDump files, e.g. one per core, as text merged by timestamp. Events of
+  equal timestamp keep the order of the files and of their rings. Times are seconds since the first event if the
+  dumps carry the clock rate, raw timestamp ticks otherwise. Host only.
+
+      gcc -O2 -o CanNm_TraceDecode CanNm_TraceDecode.c CanNm_Trace.c
+      ./CanNm_TraceDecode core0.bin [core1.bin ...]
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CanNm_Trace.h"
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+typedef struct {
+	CanNm_TraceDumpHeaderType	Header;
+	CanNm_TraceEventType*		Events;
+	uint32						Next;
+} CanNm_TraceDecode_DumpType;
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static Std_ReturnType CanNm_TraceDecode_Load( const char* path, CanNm_TraceDecode_DumpType* Dump );
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+int main(int argc, char** argv)
+{
+	CanNm_TraceDecode_DumpType* Dumps;
+	uint32 dumpCount = (argc > 1) ? (uint32)(argc - 1) : 0;
+	boolean first = TRUE;
+	uint64 start = 0;
+	uint64 clockHz = 0;
+
+	if (dumpCount == 0) {
+		fprintf(stderr, "usage: %s <dump> [dump ...]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	Dumps = calloc(dumpCount, sizeof(CanNm_TraceDecode_DumpType));
+	if (Dumps == NULL) {
+		return EXIT_FAILURE;
+	}
+	for (uint32 index = 0; index < dumpCount; index++) {
+		CanNm_TraceDumpHeaderType* Header = &Dumps[index].Header;
+
+		if (CanNm_TraceDecode_Load(argv[index + 1], &Dumps[index]) != E_OK) {
+			return EXIT_FAILURE;
+		}
+		printf("# core %u: %u events, %llu recorded, %llu overwritten\n", Header->Core, Header->Count,
+			(unsigned long long)Header->Head, (unsigned long long)(Header->Head - Header->Count));
+		clockHz = (index == 0 || clockHz == Header->ClockHz) ? Header->ClockHz : 0;
+	}
+
+	for (;;) {
+		CanNm_TraceDecode_DumpType* Next = NULL;
+		char text[128];
+
+		for (uint32 index = 0; index < dumpCount; index++) {
+			CanNm_TraceDecode_DumpType* Dump = &Dumps[index];
+
+			if (Dump->Next < Dump->Header.Count && (Next == NULL ||
+				Dump->Events[Dump->Next].Timestamp < Next->Events[Next->Next].Timestamp)) {
+				Next = Dump;
+			}
+		}
+		if (Next == NULL) {
+			break;
+		}
+
+		const CanNm_TraceEventType* Event = &Next->Events[Next->Next++];
+		if (first) {
+			start = Event->Timestamp;
+			first = FALSE;
+		}
+		CanNm_TraceFormat(Event, text, sizeof(text));
+		if (clockHz != 0) {
+			printf("%14.9f core %u %s\n", (float64)(Event->Timestamp - start) / (float64)clockHz, Next->Header.Core,
+				text);
+		}
+		else {
+			printf("%14llu core %u %s\n", (unsigned long long)(Event->Timestamp - start), Next->Header.Core, text);
+		}
+	}
+	return EXIT_SUCCESS;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+static Std_ReturnType CanNm_TraceDecode_Load( const char* path, CanNm_TraceDecode_DumpType* Dump )
+{
+	FILE* File = fopen(path, "rb");
+	CanNm_TraceDumpHeaderType* Header = &Dump->Header;
+
+	if (File == NULL) {
+		perror(path);
+		return E_NOT_OK;
+	}
+	if (fread(Header, sizeof(CanNm_TraceDumpHeaderType), 1, File) != 1 || Header->Magic != CANNM_TRACE_DUMP_MAGIC ||
+		Header->Version != CANNM_TRACE_DUMP_VERSION || Header->EventSize != sizeof(CanNm_TraceEventType)) {
+		fprintf(stderr, "%s: not a CanNm trace dump of this host\n", path);
+		fclose(File);
+		return E_NOT_OK;
+	}
+	Dump->Events = malloc((Header->Count > 0 ? Header->Count : 1) * sizeof(CanNm_TraceEventType));
+	if (Dump->Events == NULL || fread(Dump->Events, sizeof(CanNm_TraceEventType), Header->Count, File) != Header->Count) {
+		fprintf(stderr, "%s: truncated\n", path);
+		fclose(File);
+		return E_NOT_OK;
+	}
+	fclose(File);
+	return E_OK;
+}
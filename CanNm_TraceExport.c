@@ -0,0 +1,277 @@
+/** ==================================================================================================================*\
+  @file CanNm_TraceExport.c
+
+  @brief Can Network Management Module - trace dump to Chrome trace converter
+
+  Converts CanNm_TraceDump files into the Chrome trace event JSON format, which chrome://tracing and the Perfetto UI
+  (ui.perfetto.dev) load directly. A file may hold several dumps back to back, e.g. one per node of a CanNm_Sim run.
+  Every dump becomes a process named after its core, every channel a thread track on which the Nm_StateType is a
+  sequence of slices, one per state visit, which self transitions do not split. Received NM PDUs, transmit results,
+  timer expiries and the callouts are instant events on the same track, named by their CanNm_TraceFormat text. Timer
+  starts and stops are left out, they would bury the track.
+
+  The first slice of a channel begins with the oldest event of its dump, in the previous state of the first
+  transition, the last one ends with the newest event. Times are microseconds since the oldest event of all dumps if
+  the dumps carry the clock rate, raw timestamp ticks otherwise. Host only.
+
+      gcc -O2 -o CanNm_TraceExport CanNm_TraceExport.c CanNm_Trace.c
+      ./CanNm_TraceExport [-l label] <dump> [dump ...] > trace.json
+\*====================================================================================================================*/
+
+/*====================================================================================================================*\
+    Include headers
+\*====================================================================================================================*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CanNm_Trace.h"
+
+/*====================================================================================================================*\
+    Local types
+\*====================================================================================================================*/
+typedef struct {
+	CanNm_TraceDumpHeaderType	Header;
+	CanNm_TraceEventType*		Events;
+} CanNm_TraceExport_DumpType;
+
+/* State slice in progress of one channel */
+typedef struct {
+	uint64						Since;
+	uint8						State;
+	boolean						Known;					//Since and State are valid
+	boolean						Named;					//Track name written
+} CanNm_TraceExport_TrackType;
+
+typedef struct {
+	FILE*						Out;
+	uint64						Start;					//Oldest timestamp of all dumps
+	boolean						First;					//No event written yet
+} CanNm_TraceExport_WriterType;
+
+/*====================================================================================================================*\
+    Local functions declarations
+\*====================================================================================================================*/
+static Std_ReturnType CanNm_TraceExport_Load( const char* path, CanNm_TraceExport_DumpType** Dumps, uint32* dumpCount );
+static void CanNm_TraceExport_Dump( CanNm_TraceExport_WriterType* Writer, const CanNm_TraceExport_DumpType* Dump,
+									const char* label );
+static void CanNm_TraceExport_Slice( CanNm_TraceExport_WriterType* Writer, const CanNm_TraceExport_DumpType* Dump,
+									uint16 channel, uint8 state, uint64 begin, uint64 end );
+static void CanNm_TraceExport_Begin( CanNm_TraceExport_WriterType* Writer );
+static float64 CanNm_TraceExport_Time( const CanNm_TraceExport_WriterType* Writer,
+									const CanNm_TraceExport_DumpType* Dump, uint64 timestamp );
+
+/*====================================================================================================================*\
+    Global functions code
+\*====================================================================================================================*/
+
+int main(int argc, char** argv)
+{
+	CanNm_TraceExport_DumpType* Dumps = NULL;
+	CanNm_TraceExport_WriterType Writer = { .Out = stdout, .First = TRUE };
+	uint32 dumpCount = 0;
+	const char* label = "core";
+	int arg = 1;
+
+	if (argc > 2 && strcmp(argv[1], "-l") == 0) {
+		label = argv[2];
+		arg = 3;
+	}
+	if (arg >= argc) {
+		fprintf(stderr, "usage: %s [-l label] <dump> [dump ...]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	for (; arg < argc; arg++) {
+		if (CanNm_TraceExport_Load(argv[arg], &Dumps, &dumpCount) != E_OK) {
+			return EXIT_FAILURE;
+		}
+	}
+
+	boolean any = FALSE;
+	for (uint32 index = 0; index < dumpCount; index++) {
+		if (Dumps[index].Header.Count > 0 && (!any || Dumps[index].Events[0].Timestamp < Writer.Start)) {
+			Writer.Start = Dumps[index].Events[0].Timestamp;
+			any = TRUE;
+		}
+		if (Dumps[index].Header.ClockHz == 0) {
+			fprintf(stderr, "core %u: no clock rate, times are timestamp ticks\n", Dumps[index].Header.Core);
+		}
+	}
+
+	fprintf(Writer.Out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+	for (uint32 index = 0; index < dumpCount; index++) {
+		CanNm_TraceExport_Dump(&Writer, &Dumps[index], label);
+	}
+	fprintf(Writer.Out, "\n]}\n");
+	return (fflush(Writer.Out) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*====================================================================================================================*\
+    Local functions (static) code
+\*====================================================================================================================*/
+
+/** @brief CanNm_TraceExport_Load
+ *
+ * Append all dumps of a file to Dumps.
+ */
+static Std_ReturnType CanNm_TraceExport_Load( const char* path, CanNm_TraceExport_DumpType** Dumps, uint32* dumpCount )
+{
+	FILE* File = fopen(path, "rb");
+	CanNm_TraceDumpHeaderType Header;
+	uint32 found = 0;
+
+	if (File == NULL) {
+		perror(path);
+		return E_NOT_OK;
+	}
+	while (fread(&Header, sizeof(CanNm_TraceDumpHeaderType), 1, File) == 1) {
+		CanNm_TraceExport_DumpType* Grown;
+		CanNm_TraceEventType* Events;
+
+		if (Header.Magic != CANNM_TRACE_DUMP_MAGIC || Header.Version != CANNM_TRACE_DUMP_VERSION ||
+			Header.EventSize != sizeof(CanNm_TraceEventType)) {
+			fprintf(stderr, "%s: not a CanNm trace dump of this host\n", path);
+			fclose(File);
+			return E_NOT_OK;
+		}
+		Events = malloc((Header.Count > 0 ? Header.Count : 1) * sizeof(CanNm_TraceEventType));
+		if (Events == NULL || fread(Events, sizeof(CanNm_TraceEventType), Header.Count, File) != Header.Count) {
+			fprintf(stderr, "%s: truncated\n", path);
+			fclose(File);
+			return E_NOT_OK;
+		}
+		Grown = realloc(*Dumps, (*dumpCount + 1) * sizeof(CanNm_TraceExport_DumpType));
+		if (Grown == NULL) {
+			fclose(File);
+			return E_NOT_OK;
+		}
+		*Dumps = Grown;
+		Grown[*dumpCount].Header = Header;
+		Grown[*dumpCount].Events = Events;
+		(*dumpCount)++;
+		found++;
+	}
+	fclose(File);
+	if (found == 0) {
+		fprintf(stderr, "%s: not a CanNm trace dump of this host\n", path);
+		return E_NOT_OK;
+	}
+	return E_OK;
+}
+
+/** @brief CanNm_TraceExport_Dump
+ *
+ * Track names, state slices and instant events of one dump.
+ */
+static void CanNm_TraceExport_Dump( CanNm_TraceExport_WriterType* Writer, const CanNm_TraceExport_DumpType* Dump,
+									const char* label )
+{
+	const CanNm_TraceDumpHeaderType* Header = &Dump->Header;
+	CanNm_TraceExport_TrackType* Tracks;
+	uint32 channelCount = 0;
+
+	if (Header->Count == 0) {
+		return;
+	}
+	for (uint32 index = 0; index < Header->Count; index++) {
+		channelCount = (Dump->Events[index].Channel >= channelCount) ? Dump->Events[index].Channel + 1U : channelCount;
+	}
+	Tracks = calloc(channelCount, sizeof(CanNm_TraceExport_TrackType));
+	if (Tracks == NULL) {
+		return;
+	}
+
+	CanNm_TraceExport_Begin(Writer);
+	fprintf(Writer->Out, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"%s %u\"}}",
+		Header->Core, label, Header->Core);
+	for (uint32 index = 0; index < Header->Count; index++) {
+		const CanNm_TraceEventType* Event = &Dump->Events[index];
+		CanNm_TraceExport_TrackType* Track = &Tracks[Event->Channel];
+		const char* category;
+		char text[128];
+
+		if (!Track->Named) {
+			CanNm_TraceExport_Begin(Writer);
+			fprintf(Writer->Out,
+				"{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"channel %u\"}}",
+				Header->Core, Event->Channel, Event->Channel);
+			Track->Named = TRUE;
+		}
+		switch (Event->Type) {
+		case CANNM_TRACE_STATE:
+			if (Track->Known && Track->State == (Event->Arg8 & 0x0F)) {
+				continue;											//Self transitions keep the slice
+			}
+			if (Track->Known) {
+				CanNm_TraceExport_Slice(Writer, Dump, Event->Channel, Track->State, Track->Since, Event->Timestamp);
+			}
+			else if (Event->Timestamp > Dump->Events[0].Timestamp) {
+				CanNm_TraceExport_Slice(Writer, Dump, Event->Channel, Event->Arg8 >> 4, Dump->Events[0].Timestamp,
+					Event->Timestamp);
+			}
+			Track->State = Event->Arg8 & 0x0F;
+			Track->Since = Event->Timestamp;
+			Track->Known = TRUE;
+			continue;
+		case CANNM_TRACE_RX:
+			category = "rx";
+			break;
+		case CANNM_TRACE_TX:
+			category = "tx";
+			break;
+		case CANNM_TRACE_TIMER_EXPIRED:
+			category = "timer";
+			break;
+		case CANNM_TRACE_CALLOUT:
+			category = "callout";
+			break;
+		default:
+			continue;
+		}
+
+		/* Name is the event text without the "ch <n> " prefix */
+		CanNm_TraceFormat(Event, text, sizeof(text));
+		const char* name = strchr(text + 3, ' ');
+		name = (name != NULL) ? name + 1 : text;
+		CanNm_TraceExport_Begin(Writer);
+		fprintf(Writer->Out, "{\"ph\":\"i\",\"s\":\"t\",\"cat\":\"%s\",\"name\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f}",
+			category, name, Header->Core, Event->Channel, CanNm_TraceExport_Time(Writer, Dump, Event->Timestamp));
+	}
+
+	/* Channels with a transition end in their last state with the newest event */
+	uint64 end = Dump->Events[Header->Count - 1].Timestamp;
+	for (uint32 channel = 0; channel < channelCount; channel++) {
+		if (Tracks[channel].Known) {
+			CanNm_TraceExport_Slice(Writer, Dump, (uint16)channel, Tracks[channel].State, Tracks[channel].Since, end);
+		}
+	}
+	free(Tracks);
+}
+
+/** @brief CanNm_TraceExport_Slice
+ *
+ * Complete event of one state visit from begin to end.
+ */
+static void CanNm_TraceExport_Slice( CanNm_TraceExport_WriterType* Writer, const CanNm_TraceExport_DumpType* Dump,
+									uint16 channel, uint8 state, uint64 begin, uint64 end )
+{
+	float64 ts = CanNm_TraceExport_Time(Writer, Dump, begin);
+
+	CanNm_TraceExport_Begin(Writer);
+	fprintf(Writer->Out, "{\"ph\":\"X\",\"cat\":\"state\",\"name\":\"%s\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+		CanNm_TraceStateName(state), Dump->Header.Core, channel, ts, CanNm_TraceExport_Time(Writer, Dump, end) - ts);
+}
+
+static void CanNm_TraceExport_Begin( CanNm_TraceExport_WriterType* Writer )
+{
+	fprintf(Writer->Out, Writer->First ? "\n" : ",\n");
+	Writer->First = FALSE;
+}
+
+static float64 CanNm_TraceExport_Time( const CanNm_TraceExport_WriterType* Writer,
+									const CanNm_TraceExport_DumpType* Dump, uint64 timestamp )
+{
+	float64 ticks = (float64)(timestamp - Writer->Start);
+
+	return (Dump->Header.ClockHz != 0) ? ticks * 1e6 / (float64)Dump->Header.ClockHz : ticks;
+}
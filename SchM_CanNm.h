@@ -3,4 +3,17 @@
 
 void CanNm_MainFunction(void);
 
+/* Exclusive area around the pending configuration of CanNm_SwitchConfig. The RTE of an ECU generates these from its
+ * OS resources, this host version is a spin lock shared by all instances. */
+#ifndef SchM_Enter_CanNm_CANNM_EXCLUSIVE_AREA_0
+#include <stdatomic.h>
+
+static atomic_flag SchM_CanNm_ExclusiveArea0 = ATOMIC_FLAG_INIT;
+
+#define SchM_Enter_CanNm_CANNM_EXCLUSIVE_AREA_0()	\
+	while (atomic_flag_test_and_set_explicit(&SchM_CanNm_ExclusiveArea0, memory_order_acquire)) {}
+#define SchM_Exit_CanNm_CANNM_EXCLUSIVE_AREA_0()	\
+	atomic_flag_clear_explicit(&SchM_CanNm_ExclusiveArea0, memory_order_release)
+#endif
+
 #endif /* SCHM_CANNM_H */
@@ -2,17 +2,38 @@
   @file UT_CanNm.c
 
   @brief Unit tests for Can Network Management Module
+
+  Built with -DCANNM_CONFIG_VARIANT=CANNM_VARIANT_PRE_COMPILE the tests run against the pre-compile variant; tests
+  which change global switches at run time are then left out.
 \*====================================================================================================================*/
 #define UNIT_TEST
+#define CANNM_STATISTICS_ENABLED STD_ON
+#define CANNM_TRACE_ENABLED STD_ON
+#define CANNM_TIMING_ENABLED STD_ON
+#define CANNM_TIMING_CYCLES() Test_TimingCycles()
+#define CANNM_WAKEUP_LATENCY_ENABLED STD_ON
+#define CANNM_WAKEUP_CLOCK() Test_WakeupTime
+#define CANNM_BUS_LOAD_ENABLED STD_ON
+#define CANNM_PCAP_ENABLED STD_ON
 
 /*====================================================================================================================*\
     Include headers
 \*====================================================================================================================*/
 #include "Std_Types.h"
+uint64 Test_TimingCycles(void);
+static uint64 Test_WakeupTime;
 #include "acutest.h"
 #include "fff.h"
 #include "CanNm.h"
 #include "CanNm.c"
+#include "CanNm_Blob.c"
+#include "CanNm_Sim.c"
+#include "CanNm_SimPool.c"
+#include "CanNm_Trace.c"
+#include "CanNm_Timing.c"
+#include "CanNm_Metrics.c"
+#include "CanNm_Pcap.c"
+#include "CanNm_PcapWriter.c"
 
 /*====================================================================================================================*\
     Local macros
@@ -185,7 +206,7 @@ void Test_Of_CanNm_Init(void)
 	TEST_CHECK(CanNm_Internal.Channels[0].State == NM_STATE_BUS_SLEEP);
 	TEST_CHECK(CanNm_Internal.Channels[0].Requested == FALSE);
 	TEST_CHECK(CanNm_Internal.Channels[0].Mode == NM_MODE_BUS_SLEEP);
-	TEST_CHECK(CanNm_ConfigPtr == &canNmConfig);
+	TEST_CHECK(CanNm_Internal.ConfigPtr == &canNmConfig);
 
 	if (canNmConfig.GlobalPnSupport) {
         /* Check initialization for GlobalPnSupport */
@@ -195,8 +216,8 @@ void Test_Of_CanNm_Init(void)
 	TEST_CHECK(CanNm_Internal.Channels[0].MessageCycleTimer.State == CANNM_TIMER_STOPPED);
 
 	/* Check initialization of user data to 0xFF */
-	uint8* destUserData = CanNm_Internal_GetUserDataPtr(canNmChannel, canNmChannel->TxPdu->TxPduRef->SduDataPtr);
-	uint8 userDataLength = CanNm_Internal_GetUserDataLength(canNmChannel);
+	uint8* destUserData = CanNm_Internal_GetUserDataPtr(&CanNm_ChannelHot[0], canNmChannel->TxPdu->TxPduRef->SduDataPtr);
+	uint8 userDataLength = CanNm_Internal_GetUserDataLength(&CanNm_ChannelHot[0]);
 	for (uint8* ptr = destUserData; ptr < (destUserData + userDataLength); ptr++) {
 		TEST_CHECK(*destUserData == 0xFF);
 	}
@@ -206,6 +227,547 @@ void Test_Of_CanNm_Init(void)
 
 }
 
+/**
+ * @brief Hot channel block test
+ *
+ * Function testing the per channel parameters derived by CanNm_Init
+*/
+void Test_Of_CanNm_ChannelHotInit(void)
+{
+	CanNm_ChannelHotType* ChannelHot = &CanNm_ChannelHot[0];
+
+	/* Check that times are converted to main function ticks */
+	CanNm_Init(&canNmConfig);
+	TEST_CHECK(ChannelHot->TimeoutTicks == 100);
+	TEST_CHECK(ChannelHot->MsgCycleTicks == 500);
+	TEST_CHECK(ChannelHot->RemoteSleepIndTicks == 2000);
+
+	/* Check that the user data layout and RX ring length are precomputed */
+	TEST_CHECK(ChannelHot->UserDataOffset == 2);
+	TEST_CHECK(ChannelHot->UserDataLength == CANNM_SDU_LENGTH - 2);
+	TEST_CHECK(ChannelHot->RxPduCount == 7);
+	TEST_CHECK(ChannelHot->TxSduLength == CANNM_SDU_LENGTH);
+
+	/* Check that user data start behind the last control byte, never on a control byte */
+	canNmChannel[0].PduCbvPosition = CANNM_PDU_OFF;
+	canNmChannel[0].PduNidPosition = CANNM_PDU_BYTE_1;
+	canNmConfig.UserDataEnabled = TRUE;
+	CanNm_Init(&canNmConfig);
+	TEST_CHECK(ChannelHot->UserDataOffset == 2);
+	TEST_CHECK(ChannelHot->UserDataLength == CANNM_SDU_LENGTH - 2);
+	uint8 userData[CANNM_SDU_LENGTH - 2] = {0xEE, 0xEE, 0xEE, 0xEE, 0xEE, 0xEE};
+	TEST_CHECK(CanNm_SetUserData(nmChannelHandle, userData) == E_OK);
+	TEST_CHECK(TestTxMessageSdu[CANNM_PDU_BYTE_1] == ChannelHot->NodeId);
+	canNmChannel[0].PduCbvPosition = CANNM_PDU_BYTE_0;
+	canNmChannel[0].PduNidPosition = CANNM_PDU_OFF;
+	CanNm_Init(&canNmConfig);
+	TEST_CHECK(ChannelHot->UserDataOffset == 1);
+	canNmChannel[0].PduCbvPosition = CANNM_PDU_OFF;
+	CanNm_Init(&canNmConfig);
+	TEST_CHECK(ChannelHot->UserDataOffset == 0);
+	canNmChannel[0].PduCbvPosition = CANNM_PDU_BYTE_1;
+	canNmChannel[0].PduNidPosition = CANNM_PDU_BYTE_0;
+	canNmConfig.UserDataEnabled = FALSE;
+
+	/* Check that ticks are rounded up for a non integer ratio */
+	canNmConfig.MainFunctionPeriod = 3.0;
+	CanNm_Init(&canNmConfig);
+	TEST_CHECK(ChannelHot->TimeoutTicks == 34);
+	canNmConfig.MainFunctionPeriod = 1.0;
+	CanNm_DeInit();
+
+	/* Check that a precomputed hot table is used in place */
+	static CanNm_ChannelHotType channelHotCfg[CANNM_CHANNEL_COUNT];
+	channelHotCfg[0].TimeoutTicks = 42;
+	channelHotCfg[0].RxPduCount = 1;
+	canNmConfig.ChannelHot = channelHotCfg;
+	CanNm_Init(&canNmConfig);
+	TEST_CHECK(CanNm_Internal.ChannelHotPtr == channelHotCfg);
+	TEST_CHECK(CanNm_Internal.ChannelHotPtr[0].TimeoutTicks == 42);
+	canNmConfig.ChannelHot = NULL;
+	CanNm_DeInit();
+}
+
+/**
+ * @brief Binary configuration test
+ *
+ * Function testing validation and in place use of a configuration image (CanNm_Blob.h)
+*/
+void Test_Of_CanNm_Blob(void)
+{
+	static uint32 image[64];
+	static uint64 ram[1024];
+	static CanNm_BlobType blob;
+	CanNm_BlobHeaderType* Header = (CanNm_BlobHeaderType*)image;
+	CanNm_BlobGlobalType* Global = (CanNm_BlobGlobalType*)(Header + 1);
+	CanNm_ChannelHotType* ChannelHot = (CanNm_ChannelHotType*)(Global + 1);
+	uint32 size = sizeof(*Header) + sizeof(*Global) + sizeof(*ChannelHot);
+
+	/* Build an image from the test channel */
+	CanNm_Init(&canNmConfig);
+	*ChannelHot = CanNm_ChannelHot[0];
+	CanNm_DeInit();
+	Global->MainFunctionPeriod = 1.0;
+	Global->UserDataEnabled = TRUE;
+	*Header = (CanNm_BlobHeaderType){ CANNM_BLOB_MAGIC, CANNM_BLOB_VERSION, sizeof(*Header), size, 0, 1,
+										sizeof(*ChannelHot), sizeof(*Header), sizeof(*Header) + sizeof(*Global), 0 };
+	Header->Crc = CanNm_Blob_Crc32((uint8*)Global, size - sizeof(*Header));
+
+	/* Check that the channel records are used in place */
+	TEST_CHECK(CanNm_BlobBind(&blob, (uint8*)image, size) == E_OK);
+	TEST_CHECK(blob.Config.ChannelHot == ChannelHot);
+	TEST_CHECK(blob.Config.UserDataEnabled == TRUE);
+	TEST_CHECK(CanNm_BlobRamSize(&blob) <= sizeof(ram));
+	TEST_CHECK(CanNm_BlobInit(&blob, (uint8*)ram, sizeof(ram)) == E_OK);
+	TEST_CHECK(CanNm_Internal.ChannelHotPtr == ChannelHot);
+	TEST_CHECK(CanNm_Internal.Channels[0].TxPduRef->SduDataPtr[CANNM_PDU_BYTE_1] == 0x00);
+	TEST_CHECK(CanNm_Internal.Channels[0].TxPduRef->SduLength == CANNM_SDU_LENGTH);
+	CanNm_DeInit();
+
+	/* Check that corrupted or inconsistent images are rejected */
+	TEST_CHECK(CanNm_BlobCheck((uint8*)image, size - 1) == E_NOT_OK);
+	ChannelHot->RxPduCount = 0;
+	TEST_CHECK(CanNm_BlobCheck((uint8*)image, size) == E_NOT_OK);
+	Header->Crc = CanNm_Blob_Crc32((uint8*)Global, size - sizeof(*Header));
+	TEST_CHECK(CanNm_BlobCheck((uint8*)image, size) == E_NOT_OK);
+	Header->Version++;
+	TEST_CHECK(CanNm_BlobCheck((uint8*)image, size) == E_NOT_OK);
+}
+
+/**
+ * @brief Configuration switch test
+ *
+ * Function testing CanNm_SwitchConfig on an awake channel
+*/
+void Test_Of_CanNm_SwitchConfig(void)
+{
+	static CanNm_ChannelType channelDiag;
+	static CanNm_ConfigType configDiag;
+	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	uint8 userData[CANNM_SDU_LENGTH - 2] = {10, 11, 12, 13, 14, 15};
+
+	channelDiag = canNmChannel[0];
+	channelDiag.MsgCycleTime = 50;
+	configDiag = canNmConfig;
+	configDiag.UserDataEnabled = TRUE;
+	configDiag.ChannelConfig[0] = &channelDiag;
+
+	/* Check that the switch is refused before initialization */
+	CanNm_DeInit();
+	TEST_CHECK(CanNm_SwitchConfig(&configDiag) == E_NOT_OK);
+
+	CanNm_Init(&canNmConfig);
+	CanNm_NetworkRequest(nmChannelHandle);
+	ChannelInternal->State = NM_STATE_NORMAL_OPERATION;
+	CanNm_Internal_TimerStart(&ChannelInternal->MessageCycleTimer, 500);
+	canNmConfig.UserDataEnabled = TRUE;
+	CanNm_SetUserData(nmChannelHandle, userData);
+	canNmConfig.UserDataEnabled = FALSE;
+	TestTxMessageSdu[CANNM_PDU_BYTE_1] = 0x10;
+
+	/* Check that nothing changes before the main function boundary */
+	TEST_CHECK(CanNm_SwitchConfig(&configDiag) == E_OK);
+	TEST_CHECK(CanNm_Internal.ConfigPtr == &canNmConfig);
+	TEST_CHECK(CanNm_Internal.ChannelHotPtr[0].MsgCycleTicks == 500);
+
+	/* Check that timing is re-derived while the channel state, CBV and user data are kept */
+	CanNm_MainFunction();
+	TEST_CHECK(CanNm_Internal.ConfigPtr == &configDiag);
+	TEST_CHECK(CanNm_Internal.ChannelHotPtr == CanNm_ChannelHotSwap);
+	TEST_CHECK(CanNm_Internal.ChannelHotPtr[0].MsgCycleTicks == 50);
+	TEST_CHECK(ChannelInternal->Mode == NM_MODE_NETWORK);
+	TEST_CHECK(ChannelInternal->State == NM_STATE_NORMAL_OPERATION);
+	TEST_CHECK(ChannelInternal->MessageCycleTimer.TimeLeft == 49);
+	TEST_CHECK(TestTxMessageSdu[CANNM_PDU_BYTE_1] == 0x10);
+	TEST_CHECK(memcmp(&TestTxMessageSdu[2], userData, sizeof(userData)) == 0);
+
+	/* Check that switching back uses the first bank again */
+	CanNm_SwitchConfig(&canNmConfig);
+	CanNm_MainFunction();
+	TEST_CHECK(CanNm_Internal.ChannelHotPtr == CanNm_ChannelHot);
+	TEST_CHECK(CanNm_Internal.ChannelHotPtr[0].MsgCycleTicks == 500);
+	TEST_CHECK(ChannelInternal->State == NM_STATE_NORMAL_OPERATION);
+}
+
+/**
+ * @brief Channel arena test
+ *
+ * Function testing CanNm_InitArena with more channels than CANNM_CHANNEL_COUNT
+*/
+void Test_Of_CanNm_InitArena(void)
+{
+	enum { ARENA_CHANNEL_COUNT = 300 };
+	static CanNm_ChannelHotType channelHot[ARENA_CHANNEL_COUNT];
+	static CanNm_ChannelPduType channelPdu[ARENA_CHANNEL_COUNT];
+	static uint64 arena[ARENA_CHANNEL_COUNT * 512];
+	static CanNm_ConfigType config;
+	uint32 arenaSize = CanNm_ChannelArenaSize(ARENA_CHANNEL_COUNT);
+
+	CanNm_Init(&canNmConfig);
+	for (uint16 channel = 0; channel < ARENA_CHANNEL_COUNT; channel++) {
+		channelHot[channel] = CanNm_ChannelHot[0];
+		channelPdu[channel] = (CanNm_ChannelPduType){ &canNmTxPduInfo, &canNmTxPduInfo, canNmChannel[0].RxPdu };
+	}
+	config = canNmConfig;
+	config.ChannelHot = channelHot;
+	config.ChannelPdu = channelPdu;
+	config.ChannelCount = ARENA_CHANNEL_COUNT;
+
+	/* Check that incomplete configurations and short arenas are rejected */
+	TEST_CHECK(arenaSize <= sizeof(arena));
+	TEST_CHECK(CanNm_InitArena(&canNmConfig, arena, sizeof(arena)) == E_NOT_OK);
+	TEST_CHECK(CanNm_InitArena(&config, arena, arenaSize - 1) == E_NOT_OK);
+	TEST_CHECK(CanNm_InitArena(&config, (uint8*)arena + sizeof(uint32), arenaSize) == E_NOT_OK);
+
+	/* Check that every channel of the arena is initialized and handled */
+	TEST_CHECK(CanNm_InitArena(&config, arena, arenaSize) == E_OK);
+	TEST_CHECK(CanNm_Internal.Channels == (CanNm_Internal_ChannelType*)arena);
+	TEST_CHECK((uintptr_t)CanNm_Internal.ChannelHotBank[0] % CANNM_ARENA_ALIGN == 0);
+	TEST_CHECK((uintptr_t)CanNm_Internal.ChannelHotBank[1] % CANNM_ARENA_ALIGN == 0);
+	TEST_CHECK(CanNm_Internal.ChannelCount == ARENA_CHANNEL_COUNT);
+	TEST_CHECK(CanNm_Internal.Channels[ARENA_CHANNEL_COUNT - 1].State == NM_STATE_BUS_SLEEP);
+	CanNm_RxIndication(ARENA_CHANNEL_COUNT - 1, &canNmRxPduInfo);
+	TEST_CHECK(CanNm_Internal.Channels[ARENA_CHANNEL_COUNT - 1].Channel == ARENA_CHANNEL_COUNT - 1);
+	CanNm_Internal_TimerStart(&CanNm_Internal.Channels[ARENA_CHANNEL_COUNT - 1].RepeatMessageTimer, 1);
+	CanNm_Internal.Channels[ARENA_CHANNEL_COUNT - 1].Mode = NM_MODE_NETWORK;
+	CanNm_Internal.Channels[ARENA_CHANNEL_COUNT - 1].State = NM_STATE_REPEAT_MESSAGE;
+	CanNm_MainFunction();
+	TEST_CHECK(CanNm_Internal.Channels[ARENA_CHANNEL_COUNT - 1].State == NM_STATE_READY_SLEEP);
+
+	/* Check that CanNm_Init goes back to the static storage */
+	CanNm_Init(&canNmConfig);
+	TEST_CHECK(CanNm_Internal.Channels == CanNm_ChannelStorage);
+	TEST_CHECK(CanNm_Internal.ChannelCount == CANNM_CHANNEL_COUNT);
+
+	/* Check that channels without Rx PDU are rejected */
+	static CanNm_ChannelType channelNoRx;
+	static CanNm_ConfigType configNoRx;
+	channelNoRx = canNmChannel[0];
+	memset(channelNoRx.RxPdu, 0, sizeof(channelNoRx.RxPdu));
+	configNoRx = canNmConfig;
+	configNoRx.ChannelConfig[0] = &channelNoRx;
+	TEST_CHECK(CanNm_SwitchConfig(&configNoRx) == E_NOT_OK);
+	CanNm_DeInit();
+	CanNm_Init(&configNoRx);
+	TEST_CHECK(CanNm_Internal.InitStatus == CANNM_UNINIT);
+	channelHot[ARENA_CHANNEL_COUNT - 1].RxPduCount = 0;
+	TEST_CHECK(CanNm_InitArena(&config, arena, arenaSize) == E_NOT_OK);
+}
+
+/**
+ * @brief Multi-instance test
+ *
+ * Function testing two independent instances with their own callbacks
+*/
+static uint32 InstanceTxCount[2];
+
+static Std_ReturnType Test_InstanceTransmit(CanNm_InstanceType* Instance, PduIdType TxPduId, const PduInfoType* PduInfoPtr)
+{
+	(void)TxPduId;
+	(void)PduInfoPtr;
+	InstanceTxCount[*(uint8*)Instance->Context]++;
+	return E_OK;
+}
+
+void Test_Of_CanNm_Instance(void)
+{
+	static CanNm_CallbacksType callbacks;
+	static CanNm_InstanceType instance[2];
+	static uint64 arena[2][512];
+	static uint8 instanceId[2] = {0, 1};
+	Nm_StateType state;
+	Nm_ModeType mode;
+
+	callbacks = CanNm_Internal_Callouts;
+	callbacks.CanIfTransmit = Test_InstanceTransmit;
+	for (uint8 i = 0; i < 2; i++) {
+		instance[i].Callbacks = &callbacks;
+		instance[i].Context = &instanceId[i];
+	}
+	InstanceTxCount[0] = 0;
+	InstanceTxCount[1] = 0;
+	CanIf_Transmit_reset();
+	CanNm_Init(&canNmConfig);
+
+	/* Check that short arenas are rejected */
+	TEST_CHECK(CanNm_InstanceInit(&instance[0], &canNmConfig, arena[0], CanNm_ChannelArenaSize(1) - 1) == E_NOT_OK);
+	TEST_CHECK(CanNm_InstanceInit(&instance[0], &canNmConfig, arena[0], sizeof(arena[0])) == E_OK);
+	TEST_CHECK(CanNm_InstanceInit(&instance[1], &canNmConfig, arena[1], sizeof(arena[1])) == E_OK);
+	TEST_CHECK(instance[0].ChannelHotPtr[0].MsgCycleTicks == 500);
+
+	/* Check that a request on one instance leaves the other and the default instance asleep */
+	CanNm_InstanceNetworkRequest(&instance[0], nmChannelHandle);
+	for (uint16 tick = 0; tick < 10; tick++) {
+		CanNm_InstanceMainFunction(&instance[0]);
+		CanNm_InstanceMainFunction(&instance[1]);
+	}
+	CanNm_InstanceGetState(&instance[0], nmChannelHandle, &state, &mode);
+	TEST_CHECK(state == NM_STATE_REPEAT_MESSAGE);
+	CanNm_InstanceGetState(&instance[1], nmChannelHandle, &state, &mode);
+	TEST_CHECK(state == NM_STATE_BUS_SLEEP);
+	CanNm_GetState(nmChannelHandle, &state, &mode);
+	TEST_CHECK(state == NM_STATE_BUS_SLEEP);
+
+	/* Check that frames go through the callbacks of the sending instance only */
+	TEST_CHECK(InstanceTxCount[0] == 1);
+	TEST_CHECK(InstanceTxCount[1] == 0);
+	TEST_CHECK(CanIf_Transmit_mock.call_count == 0);
+}
+
+/**
+ * @brief Simulator test
+ *
+ * Function testing a cluster of nodes on the virtual bus
+*/
+static uint64 SimLastTick;
+static uint32 SimLastCanId;
+static boolean SimOrderOk;
+
+static void Test_SimFrameObserver(CanNm_SimType* Sim, const CanNm_SimFrameType* Frame)
+{
+	if (Sim->Tick == SimLastTick && Frame->CanId < SimLastCanId) {
+		SimOrderOk = FALSE;
+	}
+	SimLastTick = Sim->Tick;
+	SimLastCanId = Frame->CanId;
+}
+
+void Test_Of_CanNm_Sim(void)
+{
+	static CanNm_ChannelType channel;
+	static CanNm_ConfigType config;
+	static CanNm_SimType sim;
+	static uint64 ram[8192];
+
+	channel = canNmChannel[0];
+	channel.TimeoutTime = 1500;
+	config = canNmConfig;
+	config.ChannelConfig[0] = &channel;
+	SimLastTick = 0;
+	SimLastCanId = 0;
+	SimOrderOk = TRUE;
+	CanIf_Transmit_reset();
+
+	/* Check that short memory is rejected */
+	TEST_CHECK(CanNm_SimRamSize(&config, 3) <= sizeof(ram));
+	TEST_CHECK(CanNm_SimInit(&sim, &config, 3, 0x500, (uint8*)ram, CanNm_SimRamSize(&config, 3) - 1) == E_NOT_OK);
+	TEST_CHECK(CanNm_SimInit(&sim, &config, 3, 0x500, (uint8*)ram, sizeof(ram)) == E_OK);
+	TEST_CHECK(sim.Nodes[2].CanId == 0x502);
+	TEST_CHECK(CanNm_SimCountState(&sim, NM_STATE_BUS_SLEEP) == 3);
+	sim.FrameObserver = Test_SimFrameObserver;
+
+	/* Check that the requesting cluster reaches Normal Operation with frames in arbitration order */
+	for (uint16 node = 0; node < 3; node++) {
+		CanNm_InstanceNetworkRequest(&sim.Nodes[node].Instance, nmChannelHandle);
+	}
+	CanNm_SimRun(&sim, 3000);
+	TEST_CHECK(CanNm_SimCountState(&sim, NM_STATE_NORMAL_OPERATION) == 3);
+	TEST_CHECK(sim.FrameCount > 3);
+	TEST_CHECK(sim.DroppedCount == 0);
+	TEST_CHECK(SimOrderOk);
+
+	/* Check that the released cluster falls asleep together */
+	for (uint16 node = 0; node < 3; node++) {
+		CanNm_InstanceNetworkRelease(&sim.Nodes[node].Instance, nmChannelHandle);
+	}
+	CanNm_SimRun(&sim, 5000);
+	TEST_CHECK(CanNm_SimCountState(&sim, NM_STATE_BUS_SLEEP) == 3);
+	TEST_CHECK(CanIf_Transmit_mock.call_count == 0);
+}
+
+/**
+ * @brief Discrete-event clock test
+ *
+ * Function testing that CanNm_SimAdvance reproduces the frames and state changes of CanNm_SimRun
+*/
+typedef struct {
+	uint32 Length;
+	uint64 Event[256][3];
+} Test_SimTraceType;
+
+static void Test_SimTraceFrame(CanNm_SimType* Sim, const CanNm_SimFrameType* Frame)
+{
+	Test_SimTraceType* Trace = (Test_SimTraceType*)Sim->Context;
+
+	if (Trace->Length < 256) {
+		Trace->Event[Trace->Length][0] = Sim->Tick;
+		Trace->Event[Trace->Length][1] = Frame->CanId;
+		Trace->Event[Trace->Length++][2] = Frame->Data[1];
+	}
+}
+
+static void Test_SimTraceState(CanNm_SimType* Sim, uint16 node, Nm_StateType nmPreviousState, Nm_StateType nmCurrentState)
+{
+	Test_SimTraceType* Trace = (Test_SimTraceType*)Sim->Context;
+
+	(void)nmPreviousState;
+	if (Trace->Length < 256) {
+		Trace->Event[Trace->Length][0] = Sim->Tick;
+		Trace->Event[Trace->Length][1] = 0x10000 + node;
+		Trace->Event[Trace->Length++][2] = nmCurrentState;
+	}
+}
+
+void Test_Of_CanNm_SimAdvance(void)
+{
+	static CanNm_ChannelType channel;
+	static CanNm_ConfigType config;
+	static CanNm_SimType sim[2];
+	static uint64 ram[2][8192];
+	static Test_SimTraceType trace[2];
+
+	channel = canNmChannel[0];
+	channel.TimeoutTime = 1500;
+	channel.ImmediateNmTransmissions = 2;
+	channel.ImmediateNmCycleTime = 20;
+	config = canNmConfig;
+	config.ChannelConfig[0] = &channel;
+
+	for (uint8 i = 0; i < 2; i++) {
+		TEST_CHECK(CanNm_SimInit(&sim[i], &config, 3, 0x500, (uint8*)ram[i], sizeof(ram[i])) == E_OK);
+		trace[i].Length = 0;
+		sim[i].Context = &trace[i];
+		sim[i].FrameObserver = Test_SimTraceFrame;
+		sim[i].StateObserver = Test_SimTraceState;
+	}
+
+	/* Check that a wake-up, a release and a long sleep give the same trace with both clocks */
+	for (uint8 i = 0; i < 2; i++) {
+		CanNm_InstanceNetworkRequest(&sim[i].Nodes[0].Instance, nmChannelHandle);
+		CanNm_InstanceNetworkRequest(&sim[i].Nodes[2].Instance, nmChannelHandle);
+	}
+	CanNm_SimRun(&sim[0], 1777);
+	CanNm_SimAdvance(&sim[1], 1777);
+	TEST_CHECK(sim[1].Tick == 1777);
+	for (uint8 i = 0; i < 2; i++) {
+		CanNm_InstanceNetworkRelease(&sim[i].Nodes[0].Instance, nmChannelHandle);
+		CanNm_InstanceNetworkRelease(&sim[i].Nodes[2].Instance, nmChannelHandle);
+	}
+	CanNm_SimRun(&sim[0], 100000);
+	CanNm_SimAdvance(&sim[1], 100000);
+
+	TEST_CHECK(CanNm_SimCountState(&sim[1], NM_STATE_BUS_SLEEP) == 3);
+	TEST_CHECK(sim[1].Tick == sim[0].Tick);
+	TEST_CHECK(sim[1].FrameCount == sim[0].FrameCount);
+	TEST_CHECK(sim[1].SkippedCount > 90000);
+	TEST_CHECK(trace[0].Length > 10 && trace[0].Length < 256);
+	TEST_CHECK(trace[1].Length == trace[0].Length);
+	TEST_CHECK(memcmp(trace[0].Event, trace[1].Event, sizeof(trace[0].Event)) == 0);
+}
+
+/**
+ * @brief Simulation pool test
+ *
+ * Function testing that parallel runs are complete and reproducible for any thread count
+*/
+typedef struct {
+	uint32 Visits;
+	uint64 Result;
+} Test_SimPoolSlotType;
+
+static void Test_SimPoolJob(void* Context, uint32 index, uint64 seed)
+{
+	Test_SimPoolSlotType* Slot = &((Test_SimPoolSlotType*)Context)[index];
+	uint64 random = seed;
+
+	Slot->Visits++;
+	Slot->Result = 0;
+	for (uint32 i = 0; i < 1000 + index * 100; i++) {
+		Slot->Result += CanNm_SimRandom(&random);
+	}
+}
+
+void Test_Of_CanNm_SimPool(void)
+{
+	static Test_SimPoolSlotType slot[3][100];
+	uint32 threads[3] = {1, 4, 7};
+
+	for (uint8 i = 0; i < 3; i++) {
+		memset(slot[i], 0, sizeof(slot[i]));
+		TEST_CHECK(CanNm_SimPoolRun(threads[i], 100, Test_SimPoolJob, slot[i], 42) == E_OK);
+	}
+
+	/* Check that every job ran once and the results do not depend on the thread count */
+	for (uint32 index = 0; index < 100; index++) {
+		TEST_CHECK(slot[0][index].Visits == 1 && slot[1][index].Visits == 1 && slot[2][index].Visits == 1);
+	}
+	TEST_CHECK(memcmp(slot[0], slot[1], sizeof(slot[0])) == 0);
+	TEST_CHECK(memcmp(slot[0], slot[2], sizeof(slot[0])) == 0);
+	TEST_CHECK(slot[0][0].Result != slot[0][1].Result);
+	TEST_CHECK(CanNm_SimPoolRun(4, 0, Test_SimPoolJob, slot[0], 42) == E_OK);
+	TEST_CHECK(CanNm_SimPoolRun(4, 1, NULL, slot[0], 42) == E_NOT_OK);
+}
+
+/**
+ * @brief Bus timing test
+ *
+ * Function testing frame lengths, serialization and background load of the bit-timing model
+*/
+static uint64 SimBusEnd;
+static boolean SimBusOk;
+
+static void Test_SimBusFrame(CanNm_SimType* Sim, const CanNm_SimFrameType* Frame)
+{
+	uint32 bits = CanNm_SimFrameBits(Frame->CanId, Frame->Data, Frame->Length, FALSE, NULL);
+
+	if (Frame->StartTime < Frame->QueueTime || Frame->StartTime < SimBusEnd ||
+		Frame->EndTime - Frame->StartTime != bits * 2000ULL || Sim->Now != Frame->EndTime) {
+		SimBusOk = FALSE;
+	}
+	SimBusEnd = Frame->EndTime;
+}
+
+void Test_Of_CanNm_SimBus(void)
+{
+	static CanNm_ChannelType channel;
+	static CanNm_ConfigType config;
+	static CanNm_SimType sim[3];
+	static uint64 ram[3][8192];
+	uint8 zeros[64] = {0};
+	uint8 alternating[8] = {0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55, 0x55};
+	uint32 dataPhaseBits;
+	CanNm_SimBusType bus = { .Bitrate = 500000, .BackgroundCanId = 0x100, .BackgroundLength = 8, .Seed = 3 };
+
+	/* Check classic and CAN FD frame lengths */
+	TEST_CHECK(CanNm_SimFrameBits(0x500, alternating, 8, FALSE, NULL) >= 111);
+	TEST_CHECK(CanNm_SimFrameBits(0x500, zeros, 8, FALSE, NULL) > CanNm_SimFrameBits(0x500, alternating, 8, FALSE, NULL));
+	TEST_CHECK(CanNm_SimFrameBits(0x500, zeros, 8, FALSE, NULL) <= 135);
+	TEST_CHECK(CanNm_SimFrameBits(0x500, zeros, 64, FALSE, &dataPhaseBits) > 64 * 8);
+	TEST_CHECK(dataPhaseBits > 64 * 8 && dataPhaseBits < 64 * 8 + 150);
+
+	channel = canNmChannel[0];
+	channel.TimeoutTime = 1500;
+	config = canNmConfig;
+	config.ChannelConfig[0] = &channel;
+	for (uint8 i = 0; i < 3; i++) {
+		TEST_CHECK(CanNm_SimInit(&sim[i], &config, 3, 0x500, (uint8*)ram[i], sizeof(ram[i])) == E_OK);
+		bus.BackgroundLoad = (i == 2) ? 0.6 : 0.0;
+		TEST_CHECK(CanNm_SimSetBus(&sim[i], &bus) == E_OK);
+		for (uint16 node = 0; node < 3; node++) {
+			CanNm_InstanceNetworkRequest(&sim[i].Nodes[node].Instance, nmChannelHandle);
+		}
+	}
+	bus.BackgroundLoad = 1.0;
+	TEST_CHECK(CanNm_SimSetBus(&sim[0], &bus) == E_NOT_OK);
+
+	/* Check that frames are serialized at the bitrate and received after they were sent */
+	SimBusEnd = 0;
+	SimBusOk = TRUE;
+	sim[0].FrameObserver = Test_SimBusFrame;
+	CanNm_SimRun(&sim[0], 3000);
+	TEST_CHECK(SimBusOk);
+	TEST_CHECK(CanNm_SimCountState(&sim[0], NM_STATE_NORMAL_OPERATION) == 3);
+	TEST_CHECK(sim[0].LatencyMax > sim[0].InFlight.EndTime - sim[0].InFlight.StartTime);
+
+	/* Check that the event driven clock gives the same bus and that background load delays the frames */
+	CanNm_SimAdvance(&sim[1], 3000);
+	CanNm_SimAdvance(&sim[2], 3000);
+	TEST_CHECK(sim[1].FrameCount == sim[0].FrameCount);
+	TEST_CHECK(sim[1].LatencySum == sim[0].LatencySum);
+	TEST_CHECK(sim[1].NmBusTime == sim[0].NmBusTime);
+	TEST_CHECK(sim[2].LatencySum / sim[2].FrameCount > sim[0].LatencySum / sim[0].FrameCount);
+}
+
 void Test_Of_CanNm_DeInit(void)
 {
     CanNm_Init(&canNmConfig);
@@ -215,6 +777,29 @@ void Test_Of_CanNm_DeInit(void)
 	CanNm_DeInit();
 	TEST_CHECK(CanNm_Internal.Channels[0].State == NM_STATE_UNINIT);
 	TEST_CHECK(CanNm_Internal.InitStatus = CANNM_UNINIT);
+
+	/* Check that a channel still awake keeps all channels initialized */
+	static CanNm_ChannelHotType channelHot[2];
+	static CanNm_ChannelPduType channelPdu[2];
+	static CanNm_InstanceType instance;
+	static CanNm_ConfigType config;
+	static uint64 arena[1024];
+
+	CanNm_Init(&canNmConfig);
+	for (uint16 channel = 0; channel < 2; channel++) {
+		channelHot[channel] = CanNm_ChannelHot[0];
+		channelPdu[channel] = (CanNm_ChannelPduType){ &canNmTxPduInfo, &canNmTxPduInfo, canNmChannel[0].RxPdu };
+	}
+	config = canNmConfig;
+	config.ChannelHot = channelHot;
+	config.ChannelPdu = channelPdu;
+	config.ChannelCount = 2;
+	TEST_CHECK(CanNm_InstanceInit(&instance, &config, arena, sizeof(arena)) == E_OK);
+	CanNm_InstanceNetworkRequest(&instance, 1);
+	CanNm_InstanceDeInit(&instance);
+	TEST_CHECK(instance.InitStatus == CANNM_INIT);
+	TEST_CHECK(instance.Channels[0].State == NM_STATE_BUS_SLEEP);
+	TEST_CHECK(instance.Channels[1].State == NM_STATE_REPEAT_MESSAGE);
 }
 
 
@@ -235,6 +820,21 @@ void Test_Of_CanNm_PassiveStartUp(void)
 	status = CanNm_PassiveStartUp(nmChannelHandle);
 	TEST_CHECK(status == E_OK);
 
+	/* Check that a start-up in Prepare Bus Sleep Mode reports Prepare Bus Sleep State as the previous state */
+	canNmConfig.StateChangeIndEnabled = 1;
+	CanNm_Init(&canNmConfig);
+	CanNm_PassiveStartUp(nmChannelHandle);
+	for (uint16 tick = 0; tick < 3000 && CanNm_Internal.Channels[0].Mode != NM_MODE_PREPARE_BUS_SLEEP; tick++) {
+		CanNm_MainFunction();
+	}
+	TEST_CHECK(CanNm_Internal.Channels[0].Mode == NM_MODE_PREPARE_BUS_SLEEP);
+	Nm_StateChangeNotification_reset();
+	TEST_CHECK(CanNm_PassiveStartUp(nmChannelHandle) == E_OK);
+	TEST_CHECK(CanNm_Internal.Channels[0].State == NM_STATE_REPEAT_MESSAGE);
+	TEST_CHECK(Nm_StateChangeNotification_mock.call_count == 1);
+	TEST_CHECK(Nm_StateChangeNotification_mock.arg1_val == NM_STATE_PREPARE_BUS_SLEEP);
+	TEST_CHECK(Nm_StateChangeNotification_mock.arg2_val == NM_STATE_REPEAT_MESSAGE);
+	canNmConfig.StateChangeIndEnabled = 0;
 }
 
 void Test_Of_CanNm_NetworkRequest(void)
@@ -322,6 +922,46 @@ void Test_Of_CanNm_NetworkRelease(void)
 
 }
 
+/**
+ * @brief Ready Sleep State test
+ *
+ * Function testing that no PDU is scheduled after entering Ready Sleep State
+*/
+void Test_Of_CanNm_ReadySleep(void)
+{
+	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	uint32 calls;
+
+	/* Check the way from Normal Operation State */
+	CanNm_Init(&canNmConfig);
+	CanIf_Transmit_reset();
+	CanNm_NetworkRequest(nmChannelHandle);
+	for (uint16 tick = 0; tick < 3000 && ChannelInternal->State != NM_STATE_NORMAL_OPERATION; tick++) {
+		CanNm_MainFunction();
+	}
+	TEST_CHECK(ChannelInternal->MessageCycleTimer.State == CANNM_TIMER_STARTED);
+	CanNm_NetworkRelease(nmChannelHandle);
+	TEST_CHECK(ChannelInternal->State == NM_STATE_READY_SLEEP);
+	TEST_CHECK(ChannelInternal->MessageCycleTimer.State == CANNM_TIMER_STOPPED);
+
+	/* Check the way from Repeat Message State, no PDU is sent until Bus Sleep Mode */
+	CanNm_Init(&canNmConfig);
+	CanNm_NetworkRequest(nmChannelHandle);
+	CanNm_NetworkRelease(nmChannelHandle);
+	for (uint16 tick = 0; tick < 3000 && ChannelInternal->State != NM_STATE_READY_SLEEP; tick++) {
+		CanNm_MainFunction();
+	}
+	TEST_CHECK(ChannelInternal->State == NM_STATE_READY_SLEEP);
+	TEST_CHECK(ChannelInternal->MessageCycleTimer.State == CANNM_TIMER_STOPPED);
+	calls = CanIf_Transmit_mock.call_count;
+	for (uint16 tick = 0; tick < 3000; tick++) {
+		CanNm_MainFunction();
+	}
+	TEST_CHECK(ChannelInternal->Mode == NM_MODE_BUS_SLEEP);
+	TEST_CHECK(ChannelInternal->MessageCycleTimer.State == CANNM_TIMER_STOPPED);
+	TEST_CHECK(CanIf_Transmit_mock.call_count == calls);
+}
+
 void Test_Of_CanNm_DisableCommunication(void)
 {
 	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
@@ -489,7 +1129,7 @@ void Test_Of_CanNm_RepeatMessageRequest(void)
 	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
 	Std_ReturnType status;
 
-	canNmConfig.ChannelConfig[0]->NodeDetectionEnabled = 1;
+	canNmChannel[0].NodeDetectionEnabled = 1;
 	CanNm_Init(&canNmConfig);
 	ChannelInternal->State = NM_STATE_READY_SLEEP;
 	status = CanNm_RepeatMessageRequest(nmChannelHandle);
@@ -512,11 +1152,33 @@ void Test_Of_CanNm_GetPduData(void)
 	CanNm_DeInit();
 
 	// Check that GetPduData returns NM_E_NOT_OK before reception
-	canNmConfig.ChannelConfig[0]->NodeDetectionEnabled = 1;
+	canNmChannel[0].NodeDetectionEnabled = 1;
 	CanNm_Init(&canNmConfig);
 	ChannelInternal->RxLastPdu = 1;
 	status = CanNm_GetPduData(nmChannelHandle, &nmPduDataPtr);
 	TEST_CHECK(status == NM_E_OK);
+
+	/* Check that the last of two received PDUs is returned */
+	static uint8 rxSdu[2][CANNM_SDU_LENGTH];
+	static PduInfoType rxPduInfo[2] = { { rxSdu[0], CANNM_SDU_LENGTH }, { rxSdu[1], CANNM_SDU_LENGTH } };
+	static CanNm_RxPdu rxPdu[2] = { { 0, &rxPduInfo[0] }, { 0, &rxPduInfo[1] } };
+	static CanNm_ChannelType channel;
+	static CanNm_ConfigType config;
+	uint8 first[CANNM_SDU_LENGTH] = {0x11, 0, 1, 1, 1, 1, 1, 1};
+	uint8 last[CANNM_SDU_LENGTH] = {0x22, 0, 2, 2, 2, 2, 2, 2};
+	uint8 pduData[CANNM_SDU_LENGTH];
+
+	channel = canNmChannel[0];
+	memset(channel.RxPdu, 0, sizeof(channel.RxPdu));
+	channel.RxPdu[0] = &rxPdu[0];
+	channel.RxPdu[1] = &rxPdu[1];
+	config = canNmConfig;
+	config.ChannelConfig[0] = &channel;
+	CanNm_Init(&config);
+	CanNm_RxIndication(RxPduId, &(PduInfoType){ first, CANNM_SDU_LENGTH });
+	CanNm_RxIndication(RxPduId, &(PduInfoType){ last, CANNM_SDU_LENGTH });
+	TEST_CHECK(CanNm_GetPduData(nmChannelHandle, pduData) == E_OK);
+	TEST_CHECK(memcmp(pduData, last, CANNM_SDU_LENGTH) == 0);
 }
 
 void Test_Of_CanNm_GetState(void)
@@ -593,6 +1255,117 @@ void Test_Of_CanNm_TxConfirmation(void)
 	CanNm_Init(&canNmConfig);
 	CanNm_TxConfirmation(nmChannelHandle, status);
 
+	/* Check that a confirmation arriving in Bus Sleep Mode starts no timer */
+	TEST_CHECK(ChannelInternal->Mode == NM_MODE_BUS_SLEEP);
+	TEST_CHECK(ChannelInternal->TimeoutTimer.State == CANNM_TIMER_STOPPED);
+
+	/* Check that a confirmation in Network Mode restarts the NM-Timeout Timer */
+	CanNm_NetworkRequest(nmChannelHandle);
+	ChannelInternal->TimeoutTimer.TimeLeft = 1;
+	CanNm_TxConfirmation(nmChannelHandle, status);
+	TEST_CHECK(ChannelInternal->TimeoutTimer.State == CANNM_TIMER_STARTED);
+	TEST_CHECK(ChannelInternal->TimeoutTimer.TimeLeft == 100);
+}
+
+/**
+ * @brief Reception test
+ *
+ * Function testing CanNm_RxIndication with PDUs shorter and longer than configured
+*/
+void Test_Of_CanNm_RxIndication(void)
+{
+	static struct {
+		uint8 Sdu[CANNM_SDU_LENGTH];
+		uint8 Guard[4];
+	} rxBuffer;
+	static PduInfoType rxPduInfo = { rxBuffer.Sdu, CANNM_SDU_LENGTH };
+	static CanNm_RxPdu rxPdu = { 0, &rxPduInfo };
+	static CanNm_ChannelType channel;
+	static CanNm_ConfigType config;
+	uint8 longSdu[12] = {0x21, 0x01, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+	uint8 nodeId;
+
+	channel = canNmChannel[0];
+	memset(channel.RxPdu, 0, sizeof(channel.RxPdu));
+	channel.RxPdu[0] = &rxPdu;
+	config = canNmConfig;
+	config.ChannelConfig[0] = &channel;
+	CanNm_Init(&config);
+
+	/* Check that a longer PDU is cut to the configured length */
+	CanNm_RxIndication(RxPduId, &(PduInfoType){ longSdu, sizeof(longSdu) });
+	TEST_CHECK(memcmp(rxBuffer.Sdu, longSdu, CANNM_SDU_LENGTH) == 0);
+	TEST_CHECK(rxBuffer.Guard[0] == 0 && rxBuffer.Guard[3] == 0);
+
+	/* Check that a shorter PDU is padded with zeros, no byte of the previous PDU is kept */
+	CanNm_RxIndication(RxPduId, &(PduInfoType){ longSdu, 1 });
+	TEST_CHECK(rxBuffer.Sdu[0] == 0x21);
+	TEST_CHECK(rxBuffer.Sdu[1] == 0 && rxBuffer.Sdu[CANNM_SDU_LENGTH - 1] == 0);
+	TEST_CHECK(CanNm_GetNodeIdentifier(nmChannelHandle, &nodeId) == E_OK && nodeId == 0x21);
+}
+
+/**
+ * @brief Bus load reduction test
+ *
+ * Function testing the message cycle timer restart on reception with bus load reduction
+*/
+void Test_Of_CanNm_BusLoadReduction(void)
+{
+	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+
+	canNmChannel[0].BusLoadReductionActive = TRUE;
+	canNmChannel[0].MsgReducedTime = 300;
+	CanNm_Init(&canNmConfig);
+	CanNm_NetworkRequest(nmChannelHandle);
+	for (uint16 tick = 0; tick < 3000 && ChannelInternal->State != NM_STATE_NORMAL_OPERATION; tick++) {
+		CanNm_MainFunction();
+	}
+
+	/* Check that a reception in Normal Operation State restarts the timer with the reduced time */
+	TEST_CHECK(ChannelInternal->State == NM_STATE_NORMAL_OPERATION && ChannelInternal->BusLoadReduction);
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	TEST_CHECK(ChannelInternal->MessageCycleTimer.State == CANNM_TIMER_STARTED);
+	TEST_CHECK(ChannelInternal->MessageCycleTimer.TimeLeft == 300);
+
+	/* Check that a reception in Ready Sleep State starts no transmission */
+	CanNm_NetworkRelease(nmChannelHandle);
+	TEST_CHECK(ChannelInternal->State == NM_STATE_READY_SLEEP);
+	CanNm_Internal_TimerStop(&ChannelInternal->MessageCycleTimer);
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	TEST_CHECK(ChannelInternal->MessageCycleTimer.State == CANNM_TIMER_STOPPED);
+}
+
+/**
+ * @brief Control bit vector test
+ *
+ * Function testing that a channel without CBV writes no control bits
+*/
+void Test_Of_CanNm_CbvOff(void)
+{
+	static uint8 txBuffer[256];
+	static PduInfoType txPduInfo = { txBuffer, CANNM_SDU_LENGTH };
+	static CanNm_TxPdu txPdu = { 0, &txPduInfo };
+	static CanNm_ChannelType channel;
+	static CanNm_ConfigType config;
+
+	memset(txBuffer, 0xA5, sizeof(txBuffer));
+	channel = canNmChannel[0];
+	channel.PduCbvPosition = CANNM_PDU_OFF;
+	channel.TxPdu = &txPdu;
+	config = canNmConfig;
+	config.ChannelConfig[0] = &channel;
+	CanNm_Init(&config);
+
+	/* Active wake-up sets and leaving Repeat Message State clears CBV bits on channels with CBV */
+	CanNm_NetworkRequest(nmChannelHandle);
+	TEST_CHECK(txBuffer[CANNM_PDU_OFF] == 0xA5);
+	for (uint16 tick = 0; tick < 3000 && CanNm_Internal.Channels[0].State != NM_STATE_NORMAL_OPERATION; tick++) {
+		CanNm_MainFunction();
+	}
+	TEST_CHECK(CanNm_Internal.Channels[0].State == NM_STATE_NORMAL_OPERATION);
+	TEST_CHECK(CanNm_RepeatMessageRequest(nmChannelHandle) == E_NOT_OK);
+	TEST_CHECK(txBuffer[CANNM_PDU_OFF] == 0xA5);
+	TEST_CHECK(txBuffer[CANNM_SDU_LENGTH] == 0xA5);
 }
 
 void Test_Of_CanNm_ConfirmPnAvailability(void)
@@ -618,6 +1391,126 @@ void Test_Of_CanNm_TriggerTransmit(void)
 	TEST_CHECK(status == E_OK);
 }
 
+void Test_Of_CanNm_Statistics(void)
+{
+	CanNm_StatisticsType Statistics = {0};
+
+	CanNm_Init(&canNmConfig);
+	CanIf_Transmit_reset();
+	TEST_CHECK(CanNm_GetStatistics(nmChannelHandle, NULL) == E_NOT_OK);
+	TEST_CHECK(CanNm_GetStatistics(CANNM_CHANNEL_COUNT, &Statistics) == E_NOT_OK);
+
+	/* Repeat Message State, first frame after the cycle offset */
+	CanNm_NetworkRequest(nmChannelHandle);
+	for (uint8 tick = 0; tick < 10; tick++) {
+		CanNm_MainFunction();
+	}
+	CanNm_TxConfirmation(TxPduId, E_OK);
+	CanNm_TxConfirmation(TxPduId, E_NOT_OK);
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	CanIf_Transmit_mock.return_val = E_NOT_OK;
+	CanNm_RequestBusSynchronization(nmChannelHandle);
+	CanIf_Transmit_mock.return_val = E_OK;
+
+	TEST_CHECK(CanNm_GetStatistics(nmChannelHandle, &Statistics) == E_OK);
+	TEST_CHECK(Statistics.RxFrames == 2);
+	TEST_CHECK(Statistics.TxAttempts == CanIf_Transmit_mock.call_count);
+	TEST_CHECK(Statistics.TxAttempts == 2);
+	TEST_CHECK(Statistics.TxFailures == 2);
+	TEST_CHECK(Statistics.TxConfirmations == 1);
+	TEST_CHECK(Statistics.TxTimeouts == 0);
+	TEST_CHECK(Statistics.Transitions[NM_STATE_BUS_SLEEP][NM_STATE_REPEAT_MESSAGE] == 1);
+
+	/* No frames are confirmed any more, the NM-Timeout Timer expires in Repeat Message State */
+	for (uint16 tick = 0; tick < 150; tick++) {
+		CanNm_MainFunction();
+	}
+	CanNm_GetStatistics(nmChannelHandle, &Statistics);
+	TEST_CHECK(Statistics.TxTimeouts == 1);
+	TEST_CHECK(Statistics.TxAttempts == CanIf_Transmit_mock.call_count);
+
+	TEST_CHECK(CanNm_ResetStatistics(nmChannelHandle) == E_OK);
+	CanNm_GetStatistics(nmChannelHandle, &Statistics);
+	TEST_CHECK(Statistics.RxFrames == 0 && Statistics.TxAttempts == 0 && Statistics.TxTimeouts == 0);
+	TEST_CHECK(Statistics.Transitions[NM_STATE_BUS_SLEEP][NM_STATE_REPEAT_MESSAGE] == 0);
+}
+
+static uint64 Test_TraceClock(void* ClockContext)
+{
+	return ++*(uint64*)ClockContext;
+}
+
+void Test_Of_CanNm_Trace(void)
+{
+	static CanNm_TraceEventType ringEvents[16];
+	static CanNm_TraceEventType events[16];
+	static uint64 dump[(sizeof(CanNm_TraceDumpHeaderType) + sizeof(ringEvents)) / sizeof(uint64)];
+	static CanNm_TraceRingType ring;
+	uint64 clock = 0;
+	uint32 count;
+	char text[64];
+
+	TEST_CHECK(CanNm_TraceInit(&ring, ringEvents, 12, 0) == E_NOT_OK);
+	TEST_CHECK(CanNm_TraceInit(&ring, ringEvents, 16, 3) == E_OK);
+	ring.Clock = Test_TraceClock;
+	ring.ClockContext = &clock;
+	CanNm_Init(&canNmConfig);
+	CanNm_Internal.TraceRing = &ring;
+
+	/* Check the events of a network request: the timers of Repeat Message State, then the state change */
+	CanNm_NetworkRequest(nmChannelHandle);
+	count = CanNm_TraceSnapshot(&ring, events, 16);
+	TEST_CHECK(count == 4);
+	TEST_CHECK(events[0].Type == CANNM_TRACE_TIMER_START && events[0].Arg8 == CANNM_TRACE_TIMER_TIMEOUT);
+	TEST_CHECK(events[0].Arg32 == 100);
+	TEST_CHECK(events[3].Type == CANNM_TRACE_STATE);
+	TEST_CHECK(events[3].Arg8 == ((NM_STATE_BUS_SLEEP << 4) | NM_STATE_REPEAT_MESSAGE));
+	TEST_CHECK(events[0].Timestamp == 1 && events[3].Timestamp == 4);
+	CanNm_TraceFormat(&events[3], text, sizeof(text));
+	TEST_CHECK(strcmp(text, "ch 0 STATE BUS_SLEEP -> REPEAT_MESSAGE") == 0);
+	TEST_CHECK(strcmp(CanNm_TraceStateName(events[3].Arg8 & 0x0F), "REPEAT_MESSAGE") == 0);
+
+	/* Check that a received frame carries NID and CBV */
+	SduDataPtr[0] = 0x21;
+	SduDataPtr[1] = 0x01;
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	count = CanNm_TraceSnapshot(&ring, events, 16);
+	for (uint32 index = 0; index < count; index++) {
+		if (events[index].Type == CANNM_TRACE_RX) {
+			CanNm_TraceFormat(&events[index], text, sizeof(text));
+			TEST_CHECK(strcmp(text, "ch 0 RX nid 0x21 cbv 0x01 pdu 0") == 0);
+			TEST_MSG("%s", text);
+		}
+	}
+
+	/* Check that a full ring keeps the newest events in order and that a dump holds the same */
+	for (uint16 tick = 0; tick < 1000; tick++) {
+		CanNm_MainFunction();
+	}
+	count = CanNm_TraceSnapshot(&ring, events, 16);
+	TEST_CHECK(count == 16);
+	TEST_CHECK(events[15].Sequence == atomic_load(&ring.Slots.Head));
+	for (uint32 index = 1; index < count; index++) {
+		TEST_CHECK(events[index].Sequence == events[index - 1].Sequence + 1);
+		TEST_CHECK(events[index].Timestamp > events[index - 1].Timestamp);
+	}
+	TEST_CHECK(CanNm_TraceDump(&ring, dump, sizeof(dump)) == sizeof(dump));
+	TEST_CHECK(((CanNm_TraceDumpHeaderType*)dump)->Count == 16 && ((CanNm_TraceDumpHeaderType*)dump)->Core == 3);
+	TEST_CHECK(memcmp(&((CanNm_TraceDumpHeaderType*)dump)[1], events, sizeof(events)) == 0);
+
+	/* Check that a ring keeps its newest events across 2^32 recorded events */
+	atomic_store(&ring.Slots.Head, 0xFFFFFFF8ULL);
+	for (uint32 index = 0; index < 16; index++) {
+		CanNm_TraceRecord(&ring, 0, CANNM_TRACE_CALLOUT, CANNM_TRACE_CALLOUT_NETWORK_START, index);
+	}
+	count = CanNm_TraceSnapshot(&ring, events, 16);
+	TEST_CHECK(count == 16 && events[0].Arg32 == 0 && events[15].Arg32 == 15);
+	TEST_CHECK(events[7].Sequence == 0x100000000ULL && events[15].Sequence == 0x100000008ULL);
+
+	CanNm_Internal.TraceRing = NULL;
+}
+
 void Test_Of_State_Machine(void)
 {
 	Std_ReturnType status;
@@ -754,20 +1647,471 @@ void Test_Of_State_Machine(void)
 	TEST_CHECK(status == E_OK);
 
 }
+static uint64 Test_Cycles;
+static uint64 Test_CyclesPerRead;					//Duration of every timed call
+
+uint64 Test_TimingCycles(void)
+{
+	Test_Cycles += Test_CyclesPerRead;
+	return Test_Cycles;
+}
+
+void Test_Of_CanNm_Timing(void)
+{
+	CanNm_TimingSummaryType Summary = {0};
+	static const uint64 durations[] = { 0, 7, 8, 9, 15, 16, 17, 100, 1000, 65535, 1000000, 0xFFFFFFFFULL };
+	uint8 sdu[CANNM_SDU_LENGTH];
+	PduInfoType shortPdu = { .SduDataPtr = sdu, .SduLength = 1 };
+
+	/* Check that every duration lies in its bucket and bucket limits increase */
+	for (uint8 index = 0; index < sizeof(durations) / sizeof(durations[0]); index++) {
+		uint32 bucket = CanNm_TimingBucket(durations[index]);
+
+		TEST_CHECK(bucket < CANNM_TIMING_BUCKETS);
+		TEST_CHECK(CanNm_TimingBucketLimit(bucket) >= durations[index]);
+		TEST_CHECK(bucket == 0 || CanNm_TimingBucketLimit(bucket - 1) < durations[index]);
+		TEST_CHECK(durations[index] < 8 || bucket == CANNM_TIMING_BUCKETS - 1 ||
+			CanNm_TimingBucketLimit(bucket) - durations[index] < durations[index] / 8);
+		TEST_MSG("duration %llu bucket %u", (unsigned long long)durations[index], bucket);
+	}
+	TEST_CHECK(CanNm_TimingBucket(0x100000000ULL) == CANNM_TIMING_BUCKETS - 1);
+
+	CanNm_Init(&canNmConfig);
+	TEST_CHECK(CanNm_GetTiming(CANNM_TIMING_FUNCTION_COUNT, &Summary) == E_NOT_OK);
+	TEST_CHECK(CanNm_GetTiming(CANNM_TIMING_MAIN_FUNCTION, &Summary) == E_OK);
+	TEST_CHECK(Summary.Count == 0 && Summary.P99 == 0 && Summary.Max == 0);
+
+	/* 99 main functions of 10 cycles and one spike of 1000 */
+	Test_CyclesPerRead = 10;
+	for (uint8 tick = 0; tick < 99; tick++) {
+		CanNm_MainFunction();
+	}
+	Test_CyclesPerRead = 1000;
+	CanNm_MainFunction();
+	Test_CyclesPerRead = 5;
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	TEST_CHECK(CanNm_TriggerTransmit(TxPduId, &shortPdu) == E_NOT_OK);
+	Test_CyclesPerRead = 0;
+
+	CanNm_GetTiming(CANNM_TIMING_MAIN_FUNCTION, &Summary);
+	TEST_CHECK(Summary.Count == 100);
+	TEST_CHECK(Summary.P50 == 10 && Summary.P99 == 10);
+	TEST_CHECK(Summary.Max == 1000);
+	TEST_CHECK(Summary.Mean == (99 * 10 + 1000) / 100);
+	CanNm_GetTiming(CANNM_TIMING_RX_INDICATION, &Summary);
+	TEST_CHECK(Summary.Count == 1 && Summary.P50 == 5 && Summary.Max == 5);
+	CanNm_GetTiming(CANNM_TIMING_TRIGGER_TRANSMIT, &Summary);
+	TEST_CHECK(Summary.Count == 1);
+	CanNm_GetTiming(CANNM_TIMING_TX_CONFIRMATION, &Summary);
+	TEST_CHECK(Summary.Count == 0);
+
+	/* The spike is the p99 once it is more than 1 % of the calls */
+	CanNm_Internal.Timing[CANNM_TIMING_MAIN_FUNCTION].Buckets[CanNm_TimingBucket(1000)]++;
+	CanNm_Internal.Timing[CANNM_TIMING_MAIN_FUNCTION].Count++;
+	CanNm_GetTiming(CANNM_TIMING_MAIN_FUNCTION, &Summary);
+	TEST_CHECK(Summary.P99 == 1000);
+
+	CanNm_ResetTiming();
+	CanNm_GetTiming(CANNM_TIMING_MAIN_FUNCTION, &Summary);
+	TEST_CHECK(Summary.Count == 0 && Summary.Max == 0);
+}
+
+void Test_Of_CanNm_WakeupLatency(void)
+{
+	CanNm_WakeupLatencyType Latency = {0};
+	uint64 firstTransmit = 0;
+	uint64 firstConfirmation = 0;
+	uint64 normalOperation = 0;
+
+	CanNm_Init(&canNmConfig);
+	CanIf_Transmit_reset();
+	TEST_CHECK(CanNm_GetWakeupLatency(CANNM_CHANNEL_COUNT, &Latency) == E_NOT_OK);
+	TEST_CHECK(CanNm_GetWakeupLatency(nmChannelHandle, NULL) == E_NOT_OK);
+
+	/* Wake up at time 1000 with one time unit per main function, confirm the first frame one period after it */
+	Test_WakeupTime = 1000;
+	CanNm_NetworkRequest(nmChannelHandle);
+	for (uint16 tick = 0; tick < 1000 && normalOperation == 0; tick++) {
+		Test_WakeupTime++;
+		if (firstTransmit != 0 && firstConfirmation == 0) {
+			CanNm_TxConfirmation(TxPduId, E_OK);
+			firstConfirmation = Test_WakeupTime;
+		}
+		CanNm_MainFunction();
+		if (CanIf_Transmit_mock.call_count > 0 && firstTransmit == 0) {
+			firstTransmit = Test_WakeupTime;
+		}
+		CanNm_GetState(nmChannelHandle, &nmStatePtr, &nmModePtr);
+		normalOperation = (nmStatePtr == NM_STATE_NORMAL_OPERATION) ? Test_WakeupTime : 0;
+	}
+	CanNm_TxConfirmation(TxPduId, E_OK);
+
+	TEST_CHECK(firstTransmit != 0 && firstConfirmation != 0 && normalOperation != 0);
+	TEST_CHECK(CanNm_GetWakeupLatency(nmChannelHandle, &Latency) == E_OK);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_FIRST_TRANSMIT].Count == 1);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_FIRST_TRANSMIT].Max == firstTransmit - 1000);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_FIRST_CONFIRMATION].Count == 1);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_FIRST_CONFIRMATION].Max == firstConfirmation - 1000);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_NORMAL_OPERATION].Count == 1);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_NORMAL_OPERATION].Max == normalOperation - 1000);
+
+	/* A request in Normal Operation State is no wake-up */
+	CanNm_NetworkRequest(nmChannelHandle);
+	CanNm_GetWakeupLatency(nmChannelHandle, &Latency);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_NORMAL_OPERATION].Count == 1);
+
+	/* A wake-up released before Normal Operation State counts its frames only */
+	CanNm_Init(&canNmConfig);
+	CanIf_Transmit_reset();
+	CanNm_NetworkRequest(nmChannelHandle);
+	CanNm_NetworkRelease(nmChannelHandle);
+	for (uint16 tick = 0; tick < 1000; tick++) {
+		Test_WakeupTime++;
+		CanNm_MainFunction();
+	}
+	CanNm_GetWakeupLatency(nmChannelHandle, &Latency);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_FIRST_TRANSMIT].Count == 1);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_NORMAL_OPERATION].Count == 0);
+
+	TEST_CHECK(CanNm_ResetWakeupLatency(nmChannelHandle) == E_OK);
+	CanNm_GetWakeupLatency(nmChannelHandle, &Latency);
+	TEST_CHECK(Latency.Milestones[CANNM_WAKEUP_FIRST_TRANSMIT].Count == 0);
+}
+
+void Test_Of_CanNm_BusLoad(void)
+{
+	CanNm_BusLoadType BusLoad;
+
+	CanNm_Init(&canNmConfig);
+	CanIf_Transmit_reset();
+	TEST_CHECK(CanNm_GetBusLoad(CANNM_CHANNEL_COUNT, &BusLoad) == E_NOT_OK);
+	TEST_CHECK(CanNm_GetBusLoad(nmChannelHandle, NULL) == E_NOT_OK);
+	TEST_CHECK(CanNm_GetBusLoad(nmChannelHandle, &BusLoad) == E_OK);
+	TEST_CHECK(BusLoad.RxFramesPerSecond == 0.0F && BusLoad.TxBitsPerSecond == 0.0F);
+
+	/* One received and one confirmed frame every 10 ms for 2 s, 111 bits each */
+	CanNm_NetworkRequest(nmChannelHandle);
+	for (uint16 tick = 0; tick < 2000; tick++) {
+		if (tick % 10 == 0) {
+			CanNm_RxIndication(RxPduId, &PduInfoPtr);
+			CanNm_TxConfirmation(TxPduId, E_OK);
+		}
+		CanNm_MainFunction();
+	}
+	TEST_CHECK(CanNm_GetBusLoad(nmChannelHandle, &BusLoad) == E_OK);
+	TEST_CHECK(BusLoad.RxFramesPerSecond > 90.0F && BusLoad.RxFramesPerSecond < 110.0F);
+	TEST_CHECK(BusLoad.RxBitsPerSecond > 9990.0F && BusLoad.RxBitsPerSecond < 12210.0F);
+	TEST_CHECK(BusLoad.TxFramesPerSecond > 90.0F && BusLoad.TxFramesPerSecond < 110.0F);
+	TEST_CHECK(BusLoad.TxBitsPerSecond > 9990.0F && BusLoad.TxBitsPerSecond < 12210.0F);
+
+	/* Negative confirmations are no traffic, a silent bus decays */
+	for (uint16 tick = 0; tick < 200; tick++) {
+		CanNm_TxConfirmation(TxPduId, E_NOT_OK);
+		CanNm_MainFunction();
+	}
+	CanNm_GetBusLoad(nmChannelHandle, &BusLoad);
+	TEST_CHECK(BusLoad.TxFramesPerSecond < 30.0F);
+	CanNm_SkipTicks(2000);
+	CanNm_GetBusLoad(nmChannelHandle, &BusLoad);
+	TEST_CHECK(BusLoad.RxFramesPerSecond < 1.0F && BusLoad.TxBitsPerSecond < 1.0F);
+
+}
+
+/* Read a whole file as a terminated text, an empty text if it does not exist */
+static void Test_ReadText(const char* path, char* text, size_t size)
+{
+	FILE* File = fopen(path, "r");
+
+	text[0] = '\0';
+	if (File != NULL) {
+		text[fread(text, 1, size - 1, File)] = '\0';
+		fclose(File);
+	}
+}
+
+void Test_Of_CanNm_Metrics(void)
+{
+	CanNm_InstanceType* Instances[1] = { &CanNm_Internal };
+	char directory[] = "/tmp/UT_CanNm_metrics.XXXXXX";
+	char filePath[64];
+	char socketPath[64];
+	CanNm_MetricsType Metrics = { .Instances = Instances, .InstanceCount = 1, .Path = filePath, .PeriodMs = 10 };
+	struct sockaddr_un Address = { .sun_family = AF_UNIX };
+	static char text[65536];
+	uint32 length;
+
+	TEST_CHECK(mkdtemp(directory) != NULL);
+	snprintf(filePath, sizeof(filePath), "%s/metrics.prom", directory);
+	snprintf(socketPath, sizeof(socketPath), "unix:%s/metrics.sock", directory);
+	snprintf(Address.sun_path, sizeof(Address.sun_path), "%s/metrics.sock", directory);
+	CanNm_Init(&canNmConfig);
+	CanIf_Transmit_reset();
+	CanNm_NetworkRequest(nmChannelHandle);
+	for (uint8 tick = 0; tick < 10; tick++) {
+		CanNm_MainFunction();
+	}
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+
+	length = CanNm_MetricsFormat(Instances, 1, text, sizeof(text));
+	TEST_CHECK(length > 0 && length == strlen(text));
+	TEST_CHECK(strstr(text, "# TYPE cannm_state gauge\n") != NULL);
+	TEST_CHECK(strstr(text, "cannm_state{cannm_instance=\"0\",channel=\"0\",state=\"repeat_message\"} 1\n") != NULL);
+	TEST_CHECK(strstr(text, "cannm_state{cannm_instance=\"0\",channel=\"0\",state=\"bus_sleep\"} 0\n") != NULL);
+	TEST_CHECK(strstr(text, "cannm_rx_frames_total{cannm_instance=\"0\",channel=\"0\"} 1\n") != NULL);
+	TEST_CHECK(strstr(text, "from=\"bus_sleep\",to=\"repeat_message\"} 1\n") != NULL);
+	TEST_CHECK(strstr(text, "cannm_call_cycles_count{cannm_instance=\"0\",function=\"main_function\"} 10\n") != NULL);
+	TEST_CHECK(strstr(text, "cannm_wakeup_latency_count{cannm_instance=\"0\",channel=\"0\",milestone=\"first_transmit\"} 1\n")
+		!= NULL);
+	TEST_CHECK(strstr(text, "cannm_bus_load_frames_per_second{cannm_instance=\"0\",channel=\"0\",direction=\"rx\"}") != NULL);
+
+	/* A short buffer gets a terminated prefix and the full length */
+	TEST_CHECK(CanNm_MetricsFormat(Instances, 1, text, 64) == length && strlen(text) == 63);
+
+	/* File, replaced every period and removed on stop */
+	TEST_CHECK(CanNm_MetricsStart(&Metrics) == E_OK);
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	for (uint16 wait = 0; wait < 5000; wait++) {
+		Test_ReadText(Metrics.Path, text, sizeof(text));
+		if (strstr(text, "cannm_rx_frames_total{cannm_instance=\"0\",channel=\"0\"} 2\n") != NULL) {
+			break;
+		}
+		usleep(1000);
+	}
+	TEST_CHECK(strstr(text, "cannm_rx_frames_total{cannm_instance=\"0\",channel=\"0\"} 2\n") != NULL);
+	CanNm_MetricsStop(&Metrics);
+	TEST_CHECK(access(Metrics.Path, F_OK) != 0);
+
+	/* Unix domain socket, one HTTP response per connection */
+	Metrics.Path = socketPath;
+	TEST_CHECK(CanNm_MetricsStart(&Metrics) == E_OK);
+	int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	TEST_CHECK(connect(connection, (const struct sockaddr*)&Address, sizeof(Address)) == 0);
+	send(connection, "GET /metrics HTTP/1.0\r\n\r\n", 25, 0);
+	length = 0;
+	for (ssize_t count; (count = recv(connection, text + length, sizeof(text) - 1 - length, 0)) > 0;) {
+		length += (uint32)count;
+	}
+	text[length] = '\0';
+	close(connection);
+	TEST_CHECK(strncmp(text, "HTTP/1.0 200 OK\r\n", 17) == 0);
+	TEST_CHECK(strstr(text, "\r\n\r\n# HELP cannm_initialized") != NULL);
+	TEST_CHECK(strstr(text, "cannm_initialized{cannm_instance=\"0\"} 1\n") != NULL);
+	CanNm_MetricsStop(&Metrics);
+	TEST_CHECK(access(Address.sun_path, F_OK) != 0);
+
+	/* A file that is no socket is kept */
+	close(open(Address.sun_path, O_WRONLY | O_CREAT | O_TRUNC, 0644));
+	TEST_CHECK(CanNm_MetricsStart(&Metrics) == E_NOT_OK);
+	TEST_CHECK(access(Address.sun_path, F_OK) == 0);
+	unlink(Address.sun_path);
+
+	/* The socket of a running exporter is kept, the one of a crashed exporter is replaced */
+	CanNm_MetricsType Other = { .Instances = Instances, .InstanceCount = 1, .Path = Metrics.Path, .PeriodMs = 10 };
+	TEST_CHECK(CanNm_MetricsStart(&Metrics) == E_OK);
+	TEST_CHECK(CanNm_MetricsStart(&Other) == E_NOT_OK);
+	connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	TEST_CHECK(connect(connection, (const struct sockaddr*)&Address, sizeof(Address)) == 0);
+	close(connection);
+	CanNm_MetricsStop(&Metrics);
+	connection = socket(AF_UNIX, SOCK_STREAM, 0);
+	TEST_CHECK(bind(connection, (const struct sockaddr*)&Address, sizeof(Address)) == 0);
+	close(connection);
+	TEST_CHECK(CanNm_MetricsStart(&Other) == E_OK);
+	CanNm_MetricsStop(&Other);
+	TEST_CHECK(access(Address.sun_path, F_OK) != 0);
+	TEST_CHECK(rmdir(directory) == 0);
+}
+
+/* Binary search for a text, the pcapng blocks hold names and comments unterminated */
+static boolean Test_Contains(const uint8* data, uint32 size, const char* text)
+{
+	uint32 length = (uint32)strlen(text);
+
+	for (uint32 offset = 0; offset + length <= size; offset++) {
+		if (memcmp(&data[offset], text, length) == 0) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+void Test_Of_CanNm_Pcap(void)
+{
+	static CanNm_PcapFrameType ringFrames[16];
+	static CanNm_PcapFrameType frames[16];
+	static CanNm_PcapRingType ring;
+	static uint8 file[4096];
+	char path[] = "/tmp/UT_CanNm_pcapng.XXXXXX";
+	CanNm_PcapWriterType Writer = { .Ring = &ring, .Path = path, .ChannelCount = 1, .PeriodMs = 10 };
+	uint8 shortSdu[4];
+	PduInfoType ShortPduInfo = { .SduDataPtr = shortSdu, .SduLength = sizeof(shortSdu) };
+	uint64 clock = 0;
+	uint64 tail = 0;
+	uint32 lost = 0;
+	uint32 count;
+	uint32 calls;
+	uint8 nodeId;
+	struct stat Stat;
+
+	TEST_CHECK(CanNm_PcapInit(&ring, ringFrames, 12) == E_NOT_OK);
+	TEST_CHECK(CanNm_PcapInit(&ring, ringFrames, 16) == E_OK);
+	ring.Clock = Test_TraceClock;
+	ring.ClockContext = &clock;
+	CanNm_Init(&canNmConfig);
+	CanIf_Transmit_reset();
+	CanNm_Internal.PcapRing = &ring;
+	CanNm_GetLocalNodeIdentifier(nmChannelHandle, &nodeId);
+
+	/* A received PDU with its NID, then the first transmission of Repeat Message State */
+	SduDataPtr[0] = 0x21;
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	CanNm_NetworkRequest(nmChannelHandle);
+	for (uint16 tick = 0; tick < 1000 && CanIf_Transmit_mock.call_count == 0; tick++) {
+		CanNm_MainFunction();
+	}
+	count = CanNm_PcapRead(&ring, &tail, frames, 16, &lost);
+	TEST_CHECK(count == 2 && lost == 0 && tail == 2);
+	TEST_CHECK(frames[0].Point == CANNM_PCAP_RX_INDICATION && frames[0].Drop == CANNM_PCAP_DROP_NONE);
+	TEST_CHECK(frames[0].Flags == CANNM_PCAP_NID_VALID && frames[0].Nid == 0x21 && frames[0].Length == 8);
+	TEST_CHECK(memcmp(frames[0].Data, SduDataPtr, 8) == 0);
+	TEST_CHECK(frames[1].Point == CANNM_PCAP_TRANSMIT && frames[1].Drop == CANNM_PCAP_DROP_NONE);
+	TEST_CHECK(frames[1].Nid == nodeId && frames[1].Timestamp > frames[0].Timestamp);
+
+	/* Dropped PDUs: rejected by CanIf, too short a buffer for CanNm_TriggerTransmit, communication disabled */
+	CanIf_Transmit_mock.return_val = E_NOT_OK;
+	calls = CanIf_Transmit_mock.call_count;
+	for (uint16 tick = 0; tick < 1000 && CanIf_Transmit_mock.call_count == calls; tick++) {
+		CanNm_MainFunction();
+	}
+	CanIf_Transmit_mock.return_val = E_OK;
+	TEST_CHECK(CanNm_TriggerTransmit(TxPduId, &ShortPduInfo) == E_NOT_OK);
+	canNmConfig.CoordinationSyncSupport = TRUE;
+	TEST_CHECK(CanNm_DisableCommunication(nmChannelHandle) == E_OK);
+	TEST_CHECK(CanNm_SetSleepReadyBit(nmChannelHandle, TRUE) == E_OK);
+	canNmConfig.CoordinationSyncSupport = FALSE;
+	count = CanNm_PcapRead(&ring, &tail, frames, 16, &lost);
+	TEST_CHECK(count == 3 && lost == 0);
+	TEST_CHECK(frames[0].Point == CANNM_PCAP_TRANSMIT && frames[0].Drop == CANNM_PCAP_DROP_CANIF_REJECTED);
+	TEST_CHECK(frames[1].Point == CANNM_PCAP_TRIGGER_TRANSMIT && frames[1].Drop == CANNM_PCAP_DROP_BUFFER_TOO_SMALL);
+	TEST_CHECK(frames[2].Point == CANNM_PCAP_TRANSMIT && frames[2].Drop == CANNM_PCAP_DROP_TX_DISABLED);
+
+	/* CanNm_Transmit is captured on the channel of its PDU id, an unknown id is not captured */
+	canNmConfig.ComUserDataSupport = TRUE;
+	TEST_CHECK(CanNm_Transmit(TxPduId, &PduInfoPtr) == E_OK);
+	TEST_CHECK(CanNm_Transmit(TxPduId + 1000, &PduInfoPtr) == E_OK);
+	canNmConfig.ComUserDataSupport = FALSE;
+	count = CanNm_PcapRead(&ring, &tail, frames, 16, &lost);
+	TEST_CHECK(count == 1 && lost == 0);
+	TEST_CHECK(frames[0].Point == CANNM_PCAP_TRANSMIT && frames[0].Channel == nmChannelHandle);
+
+	/* A full ring loses the oldest frames, the reader learns how many */
+	for (uint8 index = 0; index < 20; index++) {
+		CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	}
+	count = CanNm_PcapRead(&ring, &tail, frames, 16, &lost);
+	TEST_CHECK(count == 16 && lost == 4);
+	TEST_CHECK(CanNm_PcapRead(&ring, &tail, frames, 16, &lost) == 0);
+
+	/* pcapng file: section header, one interface, then a block per frame, written by the thread and on stop */
+	int fd = mkstemp(path);
+	TEST_CHECK(fd >= 0);
+	close(fd);
+	TEST_CHECK(CanNm_PcapInit(&ring, ringFrames, 16) == E_OK);
+	TEST_CHECK(CanNm_PcapWriterStart(&Writer) == E_OK);
+	CanNm_RxIndication(RxPduId, &PduInfoPtr);
+	for (uint16 wait = 0; wait < 5000 && (stat(Writer.Path, &Stat) != 0 || Stat.st_size <= 28 + 48); wait++) {
+		usleep(1000);
+	}
+	TEST_CHECK(stat(Writer.Path, &Stat) == 0 && Stat.st_size > 28 + 48);
+	TEST_CHECK(CanNm_TriggerTransmit(TxPduId, &ShortPduInfo) == E_NOT_OK);
+	TEST_CHECK(CanNm_PcapWriterStop(&Writer) == E_OK);
+	TEST_CHECK(Writer.Written == 2 && Writer.Lost == 0);
+	CanNm_Internal.PcapRing = NULL;
+
+	FILE* File = fopen(Writer.Path, "rb");
+	TEST_CHECK(File != NULL);
+	if (File == NULL) {
+		unlink(Writer.Path);
+		return;
+	}
+	uint32 size = (uint32)fread(file, 1, sizeof(file), File);
+	uint32 blocks[4] = { 0 };
+	uint32 offset = 0;
+	fclose(File);
+	for (uint32 block = 0; offset + 12 <= size && block < 4; block++) {
+		uint32 length;
+
+		memcpy(&blocks[block], &file[offset], 4);
+		memcpy(&length, &file[offset + 4], 4);
+		TEST_CHECK(length % 4 == 0 && memcmp(&file[offset + length - 4], &length, 4) == 0);
+		if (blocks[block] == 6 && block == 2) {
+			TEST_CHECK(memcmp(&file[offset + 28], "\x00\x00\x05\x21\x08\x00\x00\x00", 8) == 0);
+			TEST_CHECK(memcmp(&file[offset + 36], SduDataPtr, 8) == 0);
+		}
+		offset += length;
+	}
+	TEST_CHECK(offset == size);
+	TEST_CHECK(blocks[0] == 0x0A0D0D0A && blocks[1] == 1 && blocks[2] == 6 && blocks[3] == 6);
+	TEST_CHECK(Test_Contains(file, size, "cannm0"));
+	TEST_CHECK(Test_Contains(file, size, "CanNm_TriggerTransmit dropped, buffer too small"));
+	unlink(Writer.Path);
+}
+
+#if (CANNM_CONFIG_VARIANT == CANNM_VARIANT_PRE_COMPILE)
+void Test_Of_CanNm_PreCompile(void)
+{
+	CanNm_Internal_ChannelType* ChannelInternal = &CanNm_Internal.Channels[nmChannelHandle];
+	uint8 userData[CANNM_SDU_LENGTH] = {0};
+
+	/* Check that the global switches come from CanNm_Cfg.h, not from the configuration */
+	canNmConfig.PassiveModeEnabled = TRUE;
+	canNmConfig.UserDataEnabled = TRUE;
+	canNmConfig.StateChangeIndEnabled = TRUE;
+	CanNm_Init(&canNmConfig);
+	Nm_StateChangeNotification_reset();
+	TEST_CHECK(CanNm_PassiveStartUp(nmChannelHandle) == E_NOT_OK);
+	TEST_CHECK(CanNm_NetworkRequest(nmChannelHandle) == E_OK);
+	TEST_CHECK(ChannelInternal->State == NM_STATE_REPEAT_MESSAGE);
+	TEST_CHECK(ChannelInternal->TxEnabled == TRUE);
+	TEST_CHECK(Nm_StateChangeNotification_mock.call_count == 0);
+	TEST_CHECK(CanNm_DisableCommunication(nmChannelHandle) == E_OK);
+	TEST_CHECK(CanNm_SetUserData(nmChannelHandle, userData) == E_NOT_OK);
+	canNmConfig.PassiveModeEnabled = FALSE;
+	canNmConfig.UserDataEnabled = FALSE;
+	canNmConfig.StateChangeIndEnabled = FALSE;
+}
+#endif
+
 /*
   Test list - write down here all functions which should be executed as tests.
 */
+#if (CANNM_CONFIG_VARIANT == CANNM_VARIANT_POST_BUILD)
+#define TEST_POST_BUILD(test)	{ #test, test },
+#else
+#define TEST_POST_BUILD(test)
+#endif
+
 TEST_LIST = {
   { "Test_Of_CanNm_Init", Test_Of_CanNm_Init },
+  TEST_POST_BUILD(Test_Of_CanNm_ChannelHotInit)
+  { "Test_Of_CanNm_Blob", Test_Of_CanNm_Blob },
+  TEST_POST_BUILD(Test_Of_CanNm_SwitchConfig)
+  { "Test_Of_CanNm_InitArena", Test_Of_CanNm_InitArena },
+  { "Test_Of_CanNm_Instance", Test_Of_CanNm_Instance },
+  TEST_POST_BUILD(Test_Of_CanNm_Sim)
+  { "Test_Of_CanNm_SimAdvance", Test_Of_CanNm_SimAdvance },
+  TEST_POST_BUILD(Test_Of_CanNm_SimBus)
+  { "Test_Of_CanNm_SimPool", Test_Of_CanNm_SimPool },
   { "Test_Of_CanNm_DeInit", Test_Of_CanNm_DeInit },
-  { "Test_Of_CanNm_PassiveStartUp", Test_Of_CanNm_PassiveStartUp },
+  TEST_POST_BUILD(Test_Of_CanNm_PassiveStartUp)
   { "Test_Of_CanNm_NetworkRequest", Test_Of_CanNm_NetworkRequest },
   { "Test_Of_CanNm_NetworkRelease", Test_Of_CanNm_NetworkRelease },
-  { "Test_Of_CanNm_DisableCommunication", Test_Of_CanNm_DisableCommunication },
+  { "Test_Of_CanNm_ReadySleep", Test_Of_CanNm_ReadySleep },
+  TEST_POST_BUILD(Test_Of_CanNm_DisableCommunication)
   { "Test_Of_CanNm_EnableCommunication", Test_Of_CanNm_EnableCommunication },
-  { "Test_Of_CanNm_SetUserData", Test_Of_CanNm_SetUserData },
-  { "Test_Of_CanNm_GetUserData", Test_Of_CanNm_GetUserData },
-  { "Test_Of_CanNm_Transmit", Test_Of_CanNm_Transmit },
+  TEST_POST_BUILD(Test_Of_CanNm_SetUserData)
+  TEST_POST_BUILD(Test_Of_CanNm_GetUserData)
+  TEST_POST_BUILD(Test_Of_CanNm_Transmit)
   { "Test_Of_CanNm_GetNodeIdentifier", Test_Of_CanNm_GetNodeIdentifier },
   { "Test_Of_CanNm_GetLocalNodeIdentifier", Test_Of_CanNm_GetLocalNodeIdentifier },
   { "Test_Of_CanNm_RepeatMessageRequest", Test_Of_CanNm_RepeatMessageRequest },
@@ -775,11 +2119,24 @@ TEST_LIST = {
   { "Test_Of_CanNm_GetState", Test_Of_CanNm_GetState },
   { "Test_Of_CanNm_RequestBusSynchronization", Test_Of_CanNm_RequestBusSynchronization },
   { "Test_Of_CanNm_CheckRemoteSleepInd", Test_Of_CanNm_CheckRemoteSleepInd },
-  { "Test_Of_CanNm_SetSleepReadyBit", Test_Of_CanNm_SetSleepReadyBit },
+  TEST_POST_BUILD(Test_Of_CanNm_SetSleepReadyBit)
   { "Test_Of_CanNm_TxConfirmation", Test_Of_CanNm_TxConfirmation },
+  { "Test_Of_CanNm_RxIndication", Test_Of_CanNm_RxIndication },
+  { "Test_Of_CanNm_BusLoadReduction", Test_Of_CanNm_BusLoadReduction },
+  { "Test_Of_CanNm_CbvOff", Test_Of_CanNm_CbvOff },
   { "Test_Of_CanNm_ConfirmPnAvailability", Test_Of_CanNm_ConfirmPnAvailability },
   { "Test_Of_CanNm_TriggerTransmit", Test_Of_CanNm_TriggerTransmit },
+  { "Test_Of_CanNm_Statistics", Test_Of_CanNm_Statistics },
+  { "Test_Of_CanNm_Trace", Test_Of_CanNm_Trace },
+  { "Test_Of_CanNm_Timing", Test_Of_CanNm_Timing },
+  { "Test_Of_CanNm_WakeupLatency", Test_Of_CanNm_WakeupLatency },
+  { "Test_Of_CanNm_BusLoad", Test_Of_CanNm_BusLoad },
+  { "Test_Of_CanNm_Metrics", Test_Of_CanNm_Metrics },
+  TEST_POST_BUILD(Test_Of_CanNm_Pcap)
   { "Test_Of_State_Machine", Test_Of_State_Machine },
+#if (CANNM_CONFIG_VARIANT == CANNM_VARIANT_PRE_COMPILE)
+  { "Test_Of_CanNm_PreCompile", Test_Of_CanNm_PreCompile },
+#endif
   { NULL, NULL }
 };
 